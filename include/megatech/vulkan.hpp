@@ -12,13 +12,20 @@
 #include "vulkan/concepts.hpp"
 #include "vulkan/application_description.hpp"
 #include "vulkan/bitmask.hpp"
+#include "vulkan/completion_reactor.hpp"
+#include "vulkan/completion_source.hpp"
+#include "vulkan/compute.hpp"
 #include "vulkan/debug_messenger_description.hpp"
 #include "vulkan/device.hpp"
+#include "vulkan/device_scheduler.hpp"
 #include "vulkan/error.hpp"
+#include "vulkan/file_streamer.hpp"
 #include "vulkan/instance.hpp"
 #include "vulkan/layer_description.hpp"
 #include "vulkan/loader.hpp"
+#include "vulkan/memory.hpp"
 #include "vulkan/physical_devices.hpp"
+#include "vulkan/transient_allocator.hpp"
 #include "vulkan/version.hpp"
 
 #endif
@@ -0,0 +1,158 @@
+/**
+ * @file completion_reactor.hpp
+ * @brief Coroutine-Based Device Completion
+ * @author Alexander Rothman <[gnomesort@megate.ch](mailto:gnomesort@megate.ch)>
+ * @copyright AGPL-3.0-or-later
+ * @date 2025
+ */
+#ifndef MEGATECH_VULKAN_COMPLETION_REACTOR_HPP
+#define MEGATECH_VULKAN_COMPLETION_REACTOR_HPP
+
+#include <coroutine>
+#include <exception>
+#include <functional>
+#include <memory>
+
+#include "compute.hpp"
+
+#include "concepts/opaque_object.hpp"
+
+namespace megatech::vulkan::internal::base {
+
+  class completion_reactor_impl;
+
+}
+
+namespace megatech::vulkan {
+
+  class device;
+
+  /**
+   * @brief An awaitable that suspends a coroutine until submitted device work completes.
+   * @details completion_awaitables are created by completion_reactor::wait(). They must be awaited at most once.
+   */
+  class completion_awaitable final {
+  public:
+    /**
+     * @brief The internal implementation type of the completion_reactor that resumes the awaiting coroutine.
+     */
+    using reactor_type = internal::base::completion_reactor_impl;
+  private:
+    std::shared_ptr<const reactor_type> m_reactor{ };
+    compute_completion m_completion;
+    std::exception_ptr m_error{ };
+  public:
+    /// @cond
+    completion_awaitable() = delete;
+    /// @endcond
+
+    /**
+     * @brief Construct a completion_awaitable.
+     * @details This constructor is invoked by the API. Unless you know what you are doing, you shouldn't invoke this.
+     * @param reactor A shared_ptr to the completion_reactor's implementation. This must not be null.
+     * @param completion The completion to wait for. It must belong to the reactor's device.
+     */
+    completion_awaitable(const std::shared_ptr<const reactor_type>& reactor, const compute_completion& completion);
+
+    /**
+     * @brief Determine whether or not the work has already completed.
+     * @return True if the work is complete. False otherwise.
+     */
+    bool await_ready() const;
+
+    /**
+     * @brief Hand a suspended coroutine to the completion_reactor.
+     * @param handle The coroutine to resume once the work completes.
+     */
+    void await_suspend(const std::coroutine_handle<> handle);
+
+    /**
+     * @brief Complete the wait.
+     * @throw error If the device couldn't be waited on (e.g., because it was lost).
+     */
+    void await_resume() const;
+  };
+
+  /**
+   * @brief A reactor that resumes coroutines when device work completes.
+   * @details Rather than parking one thread per in-flight job, coroutines `co_await` the result of wait(). A single
+   *          background thread waits for every awaited completion at once and hands each coroutine to an executor
+   *          once its work completes. Without an executor, coroutines are resumed on the reactor's thread, so they
+   *          should quickly move long-running work elsewhere. All methods are thread-safe.
+   */
+  class completion_reactor final {
+  public:
+    /**
+     * @brief The internal implementation type of the completion_reactor.
+     */
+    using implementation_type = internal::base::completion_reactor_impl;
+
+    /**
+     * @brief The type of callable that resumes ready coroutines.
+     * @details Executors are invoked on the reactor's thread. They should schedule the coroutine (e.g., onto a thread
+     *          pool) rather than block. If an executor throws, the coroutine is resumed on the reactor's thread.
+     */
+    using executor_type = std::function<void(std::coroutine_handle<>)>;
+  private:
+    std::shared_ptr<implementation_type> m_impl{ };
+  public:
+    /// @cond
+    completion_reactor() = delete;
+    /// @endcond
+
+    /**
+     * @brief Construct a completion_reactor.
+     * @param parent The device whose work the reactor waits for.
+     * @param executor The callable used to resume ready coroutines. If this is empty, coroutines are resumed on the
+     *                 reactor's thread.
+     */
+    explicit completion_reactor(const device& parent, executor_type executor = { });
+
+    /// @cond
+    completion_reactor(const completion_reactor& other) = delete;
+    completion_reactor(completion_reactor&& other) = delete;
+    /// @endcond
+
+    /**
+     * @brief Destroy a completion_reactor.
+     * @details Pending awaits keep the reactor's background thread alive until they complete.
+     */
+    ~completion_reactor() noexcept = default;
+
+    /// @cond
+    completion_reactor& operator=(const completion_reactor& rhs) = delete;
+    completion_reactor& operator=(completion_reactor&& rhs) = delete;
+    /// @endcond
+
+    /**
+     * @brief Retrieve an opaque reference to the underlying implementation.
+     * @return A reference to the underlying implementation.
+     */
+    const implementation_type& implementation() const;
+
+    /**
+     * @brief Retrieve an opaque reference to the underlying implementation.
+     * @return A reference to the underlying implementation.
+     */
+    implementation_type& implementation();
+
+    /**
+     * @brief Retrieve a sharable reference to the underlying implementation.
+     * @return A shareable reference to the underlying implmentation.
+     */
+    std::shared_ptr<const implementation_type> share_implementation() const;
+
+    /**
+     * @brief Create an awaitable for the completion of submitted device work.
+     * @param completion The completion to wait for. It must belong to the reactor's device.
+     * @return A completion_awaitable that resumes the awaiting coroutine once the work completes.
+     */
+    completion_awaitable wait(const compute_completion& completion) const;
+  };
+
+  static_assert(concepts::opaque_object<completion_reactor>);
+  static_assert(concepts::readonly_sharable_opaque_object<completion_reactor>);
+
+}
+
+#endif
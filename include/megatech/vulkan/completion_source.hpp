@@ -0,0 +1,123 @@
+/**
+ * @file completion_source.hpp
+ * @brief File Descriptor-Based Device Completion
+ * @author Alexander Rothman <[gnomesort@megate.ch](mailto:gnomesort@megate.ch)>
+ * @copyright AGPL-3.0-or-later
+ * @date 2025
+ */
+#ifndef MEGATECH_VULKAN_COMPLETION_SOURCE_HPP
+#define MEGATECH_VULKAN_COMPLETION_SOURCE_HPP
+
+#include <cinttypes>
+#include <cstddef>
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace megatech::vulkan::internal::base {
+
+  class device_impl;
+
+}
+
+namespace megatech::vulkan {
+
+  class device;
+  class compute_completion;
+
+  /**
+   * @brief An event source that turns the completion of device work into a readable file descriptor.
+   * @details Each watched completion is exported as a Linux sync file and registered with a private epoll instance.
+   *          The epoll instance's file descriptor is readable whenever any watched work has completed, so it can be
+   *          added to an application's own epoll set or polled with io_uring (e.g., IORING_OP_POLL_ADD) like any
+   *          other descriptor. When it's readable, dispatch() runs the callbacks of the completed work. No thread is
+   *          ever blocked waiting on the device.
+   *
+   *          completion_sources require Linux and a device that supports sync files (see
+   *          device::supports_sync_fd()). All methods are thread-safe.
+   */
+  class completion_source final {
+  public:
+    /**
+     * @brief The type of callable invoked when watched work completes.
+     * @details Callbacks are invoked by dispatch(), on the thread that calls it.
+     */
+    using callback_type = std::function<void()>;
+  private:
+    struct entry final {
+      int fd{ -1 };
+      callback_type callback{ };
+    };
+
+    std::shared_ptr<const internal::base::device_impl> m_device{ };
+    int m_epoll{ -1 };
+    int m_event{ -1 };
+    mutable std::mutex m_mutex{ };
+    std::unordered_map<std::uint64_t, entry> m_entries{ };
+    std::vector<callback_type> m_ready{ };
+    std::uint64_t m_next_token{ 1 };
+  public:
+    /// @cond
+    completion_source() = delete;
+    /// @endcond
+
+    /**
+     * @brief Construct a completion_source.
+     * @param parent The device whose work is watched.
+     * @throw error If the system doesn't support epoll or the device doesn't support sync files.
+     */
+    explicit completion_source(const device& parent);
+
+    /// @cond
+    completion_source(const completion_source& other) = delete;
+    completion_source(completion_source&& other) = delete;
+    /// @endcond
+
+    /**
+     * @brief Destroy a completion_source.
+     * @details Callbacks of work that hasn't been dispatched are discarded without being invoked.
+     */
+    ~completion_source() noexcept;
+
+    /// @cond
+    completion_source& operator=(const completion_source& rhs) = delete;
+    completion_source& operator=(completion_source&& rhs) = delete;
+    /// @endcond
+
+    /**
+     * @brief Retrieve the completion_source's file descriptor.
+     * @details The descriptor is readable while there is completed work to dispatch. It remains owned by the
+     *          completion_source and must not be closed or read from.
+     * @return A valid file descriptor.
+     */
+    int file_descriptor() const;
+
+    /**
+     * @brief Watch submitted work.
+     * @details Work that has already completed is ready to dispatch immediately.
+     * @param completion The completion to watch. It must belong to the completion_source's device.
+     * @param callback The callable to invoke once the work completes. This must not be empty.
+     * @throw error If the completion belongs to a different device or can't be exported.
+     */
+    void watch(const compute_completion& completion, callback_type callback);
+
+    /**
+     * @brief Invoke the callbacks of every watched piece of work that has completed.
+     * @details This never blocks. Callbacks are invoked without any locks held, so they may watch more work.
+     * @return The number of callbacks invoked.
+     */
+    std::size_t dispatch();
+
+    /**
+     * @brief Retrieve the number of watched pieces of work that haven't been dispatched.
+     * @return The number of pending callbacks.
+     */
+    std::size_t size() const;
+  };
+
+}
+
+#endif
@@ -0,0 +1,659 @@
+/**
+ * @file compute.hpp
+ * @brief Vulkan Compute Dispatch
+ * @author Alexander Rothman <[gnomesort@megate.ch](mailto:gnomesort@megate.ch)>
+ * @copyright AGPL-3.0-or-later
+ * @date 2025
+ */
+#ifndef MEGATECH_VULKAN_COMPUTE_HPP
+#define MEGATECH_VULKAN_COMPUTE_HPP
+
+#include <cinttypes>
+#include <cstddef>
+
+#include <chrono>
+#include <future>
+#include <memory>
+#include <span>
+#include <string>
+#include <type_traits>
+
+#include "concepts/opaque_object.hpp"
+
+namespace megatech::vulkan::internal::base {
+
+  class device_impl;
+  class device_buffer_impl;
+  class dynamic_buffer_impl;
+  class compute_pipeline_impl;
+  class compute_context_impl;
+  class compute_batcher_impl;
+
+}
+
+namespace megatech::vulkan {
+
+  class device;
+
+  /**
+   * @brief A storage buffer that compute kernels can access through its device address.
+   * @details Kernels receive buffers by passing their device addresses through push constants. Destroying a
+   *          device_buffer while a dispatch that uses it is in flight is safe.
+   */
+  class device_buffer final {
+  public:
+    /**
+     * @brief The internal implementation type of the device_buffer.
+     */
+    using implementation_type = internal::base::device_buffer_impl;
+  private:
+    std::shared_ptr<implementation_type> m_impl{ };
+  public:
+    /// @cond
+    device_buffer() = delete;
+    /// @endcond
+
+    /**
+     * @brief Construct a device_buffer.
+     * @param parent The device that the buffer belongs to.
+     * @param size The size of the buffer in bytes. This must be greater than 0.
+     * @param host_visible Whether or not the buffer must be directly accessible by the host. Buffers that aren't
+     *                     host-visible are placed in device-local memory when possible.
+     */
+    device_buffer(const device& parent, const std::uint64_t size, const bool host_visible);
+
+    /// @cond
+    device_buffer(const device_buffer& other) = delete;
+    device_buffer(device_buffer&& other) = delete;
+    /// @endcond
+
+    /**
+     * @brief Destroy a device_buffer.
+     * @details Destruction is deferred until every earlier submission to the device completes, so this never waits.
+     */
+    ~device_buffer() noexcept = default;
+
+    /// @cond
+    device_buffer& operator=(const device_buffer& rhs) = delete;
+    device_buffer& operator=(device_buffer&& rhs) = delete;
+    /// @endcond
+
+    /**
+     * @brief Retrieve an opaque reference to the underlying implementation.
+     * @return A reference to the underlying implementation.
+     */
+    const implementation_type& implementation() const;
+
+    /**
+     * @brief Retrieve an opaque reference to the underlying implementation.
+     * @return A reference to the underlying implementation.
+     */
+    implementation_type& implementation();
+
+    /**
+     * @brief Retrieve a sharable reference to the underlying implementation.
+     * @return A shareable reference to the underlying implmentation.
+     */
+    std::shared_ptr<const implementation_type> share_implementation() const;
+
+    /**
+     * @brief Retrieve the size of the buffer.
+     * @return The size of the buffer in bytes.
+     */
+    std::uint64_t size() const;
+
+    /**
+     * @brief Retrieve the buffer's device address.
+     * @return An address that compute kernels can use to access the buffer.
+     */
+    std::uint64_t device_address() const;
+
+    /**
+     * @brief Retrieve the buffer's host mapping.
+     * @return A view of the buffer's memory. This is empty if the buffer isn't host-visible.
+     */
+    std::span<std::byte> data() const;
+  };
+
+  static_assert(concepts::opaque_object<device_buffer>);
+  static_assert(concepts::readonly_sharable_opaque_object<device_buffer>);
+
+  /**
+   * @brief A description of the specialization constants that a compute_kernel derives from its device.
+   * @details Each ID names a 32-bit unsigned integer specialization constant in the kernel's shader. IDs that are -1
+   *          are left unset, and IDs that the shader doesn't declare are ignored. Values are chosen as follows:
+   *          - The subgroup width is the device's default subgroup size.
+   *          - The workgroup size is the largest multiple of the subgroup width up to 256 invocations that fits the
+   *            device's workgroup limits.
+   *          - The tile size is the largest power of two number of elements that fits in half of the device's shared
+   *            memory, which leaves room for a second resident workgroup.
+   */
+  struct kernel_constants final {
+    /**
+     * @brief The ID of the constant that receives the workgroup size (e.g., local_size_x_id).
+     */
+    std::int64_t workgroup_size_id{ -1 };
+
+    /**
+     * @brief The ID of the constant that receives the subgroup width.
+     */
+    std::int64_t subgroup_size_id{ -1 };
+
+    /**
+     * @brief The ID of the constant that receives the tile size in elements.
+     */
+    std::int64_t tile_size_id{ -1 };
+
+    /**
+     * @brief The number of bytes of shared memory that each tile element occupies. This must be greater than 0.
+     */
+    std::uint32_t shared_bytes_per_element{ 4 };
+  };
+
+  /**
+   * @brief A compute kernel created from SPIR-V.
+   * @details Kernels have no descriptor sets. All of their parameters, including buffer device addresses, are passed
+   *          through a single push constant block.
+   */
+  class compute_kernel final {
+  public:
+    /**
+     * @brief The internal implementation type of the compute_kernel.
+     */
+    using implementation_type = internal::base::compute_pipeline_impl;
+  private:
+    std::shared_ptr<implementation_type> m_impl{ };
+  public:
+    /// @cond
+    compute_kernel() = delete;
+    /// @endcond
+
+    /**
+     * @brief Construct a compute_kernel.
+     * @param parent The device that the kernel belongs to.
+     * @param spirv The SPIR-V code of the kernel's compute shader. This must not be empty.
+     * @param push_constant_size The size of the kernel's push constant block in bytes. This must be a multiple of 4.
+     *                           128 bytes is always supported.
+     * @param entry_point The name of the shader's entry point.
+     */
+    compute_kernel(const device& parent, const std::span<const std::uint32_t> spirv,
+                   const std::uint32_t push_constant_size, const std::string& entry_point = "main");
+
+    /**
+     * @brief Construct a compute_kernel that is specialized for its device.
+     * @details Specialized kernels are cached by their device. Constructing a kernel with the same code, entry point,
+     *          push constant size, and constants as a live kernel shares that kernel's pipeline instead of compiling
+     *          a new one.
+     * @param parent The device that the kernel belongs to.
+     * @param spirv The SPIR-V code of the kernel's compute shader. This must not be empty.
+     * @param push_constant_size The size of the kernel's push constant block in bytes. This must be a multiple of 4.
+     *                           128 bytes is always supported.
+     * @param constants The specialization constants to derive from the device's properties.
+     * @param entry_point The name of the shader's entry point.
+     */
+    compute_kernel(const device& parent, const std::span<const std::uint32_t> spirv,
+                   const std::uint32_t push_constant_size, const kernel_constants& constants,
+                   const std::string& entry_point = "main");
+
+    /// @cond
+    compute_kernel(const compute_kernel& other) = delete;
+    compute_kernel(compute_kernel&& other) = delete;
+    /// @endcond
+
+    /**
+     * @brief Destroy a compute_kernel.
+     * @details In-flight dispatches keep the underlying pipeline alive, so this is always safe.
+     */
+    ~compute_kernel() noexcept = default;
+
+    /// @cond
+    compute_kernel& operator=(const compute_kernel& rhs) = delete;
+    compute_kernel& operator=(compute_kernel&& rhs) = delete;
+    /// @endcond
+
+    /**
+     * @brief Retrieve an opaque reference to the underlying implementation.
+     * @return A reference to the underlying implementation.
+     */
+    const implementation_type& implementation() const;
+
+    /**
+     * @brief Retrieve an opaque reference to the underlying implementation.
+     * @return A reference to the underlying implementation.
+     */
+    implementation_type& implementation();
+
+    /**
+     * @brief Retrieve a sharable reference to the underlying implementation.
+     * @return A shareable reference to the underlying implmentation.
+     */
+    std::shared_ptr<const implementation_type> share_implementation() const;
+
+    /**
+     * @brief Retrieve the size of the kernel's push constant block.
+     * @return The size of the push constant block in bytes.
+     */
+    std::uint32_t push_constant_size() const;
+
+    /**
+     * @brief Retrieve the workgroup size that the kernel was specialized with.
+     * @details Dispatches should divide their work by this value to determine their workgroup counts.
+     * @return The number of invocations per workgroup, or 0 if the kernel isn't specialized.
+     */
+    std::uint32_t workgroup_size() const;
+
+    /**
+     * @brief Retrieve the subgroup width that the kernel was specialized with.
+     * @return The number of invocations per subgroup, or 0 if the kernel isn't specialized.
+     */
+    std::uint32_t subgroup_size() const;
+
+    /**
+     * @brief Retrieve the tile size that the kernel was specialized with.
+     * @return The number of elements per tile, or 0 if the kernel isn't specialized.
+     */
+    std::uint32_t tile_size() const;
+  };
+
+  static_assert(concepts::opaque_object<compute_kernel>);
+  static_assert(concepts::readonly_sharable_opaque_object<compute_kernel>);
+
+  /**
+   * @brief A handle to the completion of submitted device work.
+   * @details compute_completions are cheap to copy. They keep the device that they refer to alive.
+   */
+  class compute_completion final {
+  private:
+    std::shared_ptr<const internal::base::device_impl> m_device{ };
+    std::uint64_t m_timeline_value{ };
+  public:
+    /// @cond
+    compute_completion() = delete;
+    /// @endcond
+
+    /**
+     * @brief Construct a compute_completion.
+     * @details This constructor is invoked by the API. Unless you know what you are doing, you shouldn't invoke this.
+     * @param dev A shared_ptr to the device that the work was submitted to. This must not be null.
+     * @param timeline_value The device timeline value that signals the completion of the work.
+     */
+    compute_completion(const std::shared_ptr<const internal::base::device_impl>& dev,
+                       const std::uint64_t timeline_value);
+
+    /**
+     * @brief Copy a compute_completion.
+     * @param other The compute_completion to copy.
+     */
+    compute_completion(const compute_completion& other) = default;
+
+    /**
+     * @brief Move a compute_completion.
+     * @param other The compute_completion to move.
+     */
+    compute_completion(compute_completion&& other) = default;
+
+    /**
+     * @brief Destroy a compute_completion.
+     */
+    ~compute_completion() noexcept = default;
+
+    /**
+     * @brief Copy-assign a compute_completion.
+     * @param rhs The compute_completion to copy.
+     * @return A reference to the copied-to compute_completion.
+     */
+    compute_completion& operator=(const compute_completion& rhs) = default;
+
+    /**
+     * @brief Move-assign a compute_completion.
+     * @param rhs The compute_completion to move.
+     * @return A reference to the moved-to compute_completion.
+     */
+    compute_completion& operator=(compute_completion&& rhs) = default;
+
+    /**
+     * @brief Retrieve the device timeline value that signals the completion of the work.
+     * @return A timeline value.
+     */
+    std::uint64_t timeline_value() const;
+
+    /**
+     * @brief Retrieve an opaque reference to the implementation of the device that the work was submitted to.
+     * @return A reference to the device's underlying implementation.
+     */
+    const internal::base::device_impl& device_implementation() const;
+
+    /**
+     * @brief Determine whether or not the work has completed without blocking.
+     * @return True if the work is complete. False otherwise.
+     */
+    bool is_ready() const;
+
+    /**
+     * @brief Wait for the work to complete.
+     * @param timeout The maximum time to wait.
+     * @return True if the work completed. False if the wait timed out.
+     */
+    bool wait(const std::chrono::nanoseconds timeout = std::chrono::nanoseconds::max()) const;
+  };
+
+  /**
+   * @brief A device-local storage buffer that the host writes directly, such as per-frame dynamic data.
+   * @details When the device exposes host-visible device-local memory (see
+   *          physical_device_description::host_visible_device_local_memory()), the buffer is persistently mapped
+   *          there and host writes reach video memory without a staging copy. Otherwise, host writes go to a
+   *          persistently mapped staging buffer, and flush() copies them on the same queue that compute_contexts
+   *          dispatch to. Either way, the host must not write a range while submitted work might still read it.
+   *          Destroying a dynamic_buffer while a dispatch that uses it is in flight is safe.
+   */
+  class dynamic_buffer final {
+  public:
+    /**
+     * @brief The internal implementation type of the dynamic_buffer.
+     */
+    using implementation_type = internal::base::dynamic_buffer_impl;
+  private:
+    std::shared_ptr<implementation_type> m_impl{ };
+  public:
+    /// @cond
+    dynamic_buffer() = delete;
+    /// @endcond
+
+    /**
+     * @brief Construct a dynamic_buffer.
+     * @param parent The device that the buffer belongs to.
+     * @param size The size of the buffer in bytes. This must be greater than 0.
+     */
+    dynamic_buffer(const device& parent, const std::uint64_t size);
+
+    /// @cond
+    dynamic_buffer(const dynamic_buffer& other) = delete;
+    dynamic_buffer(dynamic_buffer&& other) = delete;
+    /// @endcond
+
+    /**
+     * @brief Destroy a dynamic_buffer.
+     * @details Destruction is deferred until every earlier submission to the device completes, so this never waits.
+     */
+    ~dynamic_buffer() noexcept = default;
+
+    /// @cond
+    dynamic_buffer& operator=(const dynamic_buffer& rhs) = delete;
+    dynamic_buffer& operator=(dynamic_buffer&& rhs) = delete;
+    /// @endcond
+
+    /**
+     * @brief Retrieve an opaque reference to the underlying implementation.
+     * @return A reference to the underlying implementation.
+     */
+    const implementation_type& implementation() const;
+
+    /**
+     * @brief Retrieve an opaque reference to the underlying implementation.
+     * @return A reference to the underlying implementation.
+     */
+    implementation_type& implementation();
+
+    /**
+     * @brief Retrieve a sharable reference to the underlying implementation.
+     * @return A shareable reference to the underlying implmentation.
+     */
+    std::shared_ptr<const implementation_type> share_implementation() const;
+
+    /**
+     * @brief Retrieve the size of the buffer.
+     * @return The size of the buffer in bytes.
+     */
+    std::uint64_t size() const;
+
+    /**
+     * @brief Retrieve the buffer's device address.
+     * @return An address that compute kernels can use to access the buffer.
+     */
+    std::uint64_t device_address() const;
+
+    /**
+     * @brief Determine whether or not host writes go directly to device-local memory.
+     * @return True if writes skip the staging copy. False otherwise.
+     */
+    bool is_direct() const;
+
+    /**
+     * @brief Retrieve the memory that the host writes.
+     * @return A persistently mapped view of the buffer, or of its staging buffer if is_direct() is false.
+     */
+    std::span<std::byte> data() const;
+
+    /**
+     * @brief Make every host write to the buffer available to later dispatches.
+     * @return A compute_completion for the staging copy. Direct buffers submit nothing, so the completion is
+     *         already ready.
+     */
+    compute_completion flush();
+
+    /**
+     * @brief Make host writes to a range of the buffer available to later dispatches.
+     * @param offset The offset of the range in bytes.
+     * @param size The size of the range in bytes.
+     * @return A compute_completion for the staging copy. Direct buffers submit nothing, so the completion is
+     *         already ready.
+     * @throw error If the range exceeds the buffer.
+     */
+    compute_completion flush(const std::uint64_t offset, const std::uint64_t size);
+  };
+
+  static_assert(concepts::opaque_object<dynamic_buffer>);
+  static_assert(concepts::readonly_sharable_opaque_object<dynamic_buffer>);
+
+  /**
+   * @brief A context for dispatching compute kernels on a device's asynchronous compute queue.
+   * @details Devices without an asynchronous compute queue execute dispatches on their primary queue. Dispatches
+   *          from the same context execute in order, each one observing the writes of the previous ones, and their
+   *          results are visible to the host once they complete. Contexts are thread-safe, but dispatches from one
+   *          context are recorded serially. Threads that dispatch at high rates should use separate contexts.
+   */
+  class compute_context final {
+  public:
+    /**
+     * @brief The internal implementation type of the compute_context.
+     */
+    using implementation_type = internal::base::compute_context_impl;
+  private:
+    std::shared_ptr<implementation_type> m_impl{ };
+  public:
+    /// @cond
+    compute_context() = delete;
+    /// @endcond
+
+    /**
+     * @brief Construct a compute_context.
+     * @param parent The device to dispatch work to.
+     */
+    explicit compute_context(const device& parent);
+
+    /// @cond
+    compute_context(const compute_context& other) = delete;
+    compute_context(compute_context&& other) = delete;
+    /// @endcond
+
+    /**
+     * @brief Destroy a compute_context.
+     * @details Resources used by in-flight dispatches are released once the dispatches complete, so this never
+     *          waits.
+     */
+    ~compute_context() noexcept = default;
+
+    /// @cond
+    compute_context& operator=(const compute_context& rhs) = delete;
+    compute_context& operator=(compute_context&& rhs) = delete;
+    /// @endcond
+
+    /**
+     * @brief Retrieve an opaque reference to the underlying implementation.
+     * @return A reference to the underlying implementation.
+     */
+    const implementation_type& implementation() const;
+
+    /**
+     * @brief Retrieve an opaque reference to the underlying implementation.
+     * @return A reference to the underlying implementation.
+     */
+    implementation_type& implementation();
+
+    /**
+     * @brief Retrieve a sharable reference to the underlying implementation.
+     * @return A shareable reference to the underlying implmentation.
+     */
+    std::shared_ptr<const implementation_type> share_implementation() const;
+
+    /**
+     * @brief Dispatch a compute kernel.
+     * @param kernel The kernel to dispatch. This must belong to the same device as the context.
+     * @param push_constants The contents of the kernel's push constant block. The size must match the kernel's push
+     *                       constant size.
+     * @param x The number of workgroups to dispatch in the X dimension.
+     * @param y The number of workgroups to dispatch in the Y dimension.
+     * @param z The number of workgroups to dispatch in the Z dimension.
+     * @return A compute_completion that completes when the dispatch has finished.
+     */
+    compute_completion dispatch(const compute_kernel& kernel, const std::span<const std::byte> push_constants,
+                                const std::uint32_t x, const std::uint32_t y = 1, const std::uint32_t z = 1);
+
+    /**
+     * @brief Dispatch a compute kernel.
+     * @tparam Type The type of the push constant block. This must be trivially copyable and must not be a view of
+     *              bytes.
+     * @param kernel The kernel to dispatch. This must belong to the same device as the context.
+     * @param push_constants The contents of the kernel's push constant block.
+     * @param x The number of workgroups to dispatch in the X dimension.
+     * @param y The number of workgroups to dispatch in the Y dimension.
+     * @param z The number of workgroups to dispatch in the Z dimension.
+     * @return A compute_completion that completes when the dispatch has finished.
+     */
+    template <typename Type>
+    requires std::is_trivially_copyable_v<Type> && (!std::is_convertible_v<const Type&, std::span<const std::byte>>)
+    compute_completion dispatch(const compute_kernel& kernel, const Type& push_constants, const std::uint32_t x,
+                                const std::uint32_t y = 1, const std::uint32_t z = 1) {
+      return dispatch(kernel, std::as_bytes(std::span<const Type, 1>{ &push_constants, 1 }), x, y, z);
+    }
+  };
+
+  static_assert(concepts::opaque_object<compute_context>);
+  static_assert(concepts::readonly_sharable_opaque_object<compute_context>);
+
+
+  /**
+   * @brief A batching front-end for dispatching many small compute kernels on a device's asynchronous compute queue.
+   * @details Jobs are accumulated until the batch reaches its maximum size, until the oldest job has waited for the
+   *          batching window, or until the batch is flushed. Each batch is recorded into a single command buffer and
+   *          submitted once, and all of its jobs complete from the same timeline signal. Jobs may declare the device
+   *          addresses of the buffers that they read and write. Barriers are only recorded between jobs whose
+   *          declared accesses conflict, so jobs that don't declare any accesses may execute concurrently with the
+   *          rest of their batch. Batches always observe the writes of earlier batches. Batchers are thread-safe.
+   */
+  class compute_batcher final {
+  public:
+    /**
+     * @brief The internal implementation type of the compute_batcher.
+     */
+    using implementation_type = internal::base::compute_batcher_impl;
+  private:
+    std::shared_ptr<implementation_type> m_impl{ };
+  public:
+    /// @cond
+    compute_batcher() = delete;
+    /// @endcond
+
+    /**
+     * @brief Construct a compute_batcher.
+     * @param parent The device to dispatch work to.
+     * @param window The maximum time that a job waits before its batch is submitted.
+     * @param max_batch_size The maximum number of jobs in a batch. This must be greater than 0.
+     */
+    explicit compute_batcher(const device& parent,
+                             const std::chrono::nanoseconds window = std::chrono::microseconds{ 500 },
+                             const std::size_t max_batch_size = 256);
+
+    /// @cond
+    compute_batcher(const compute_batcher& other) = delete;
+    compute_batcher(compute_batcher&& other) = delete;
+    /// @endcond
+
+    /**
+     * @brief Destroy a compute_batcher.
+     * @details Pending jobs are submitted, and this waits for every job to complete.
+     */
+    ~compute_batcher() noexcept = default;
+
+    /// @cond
+    compute_batcher& operator=(const compute_batcher& rhs) = delete;
+    compute_batcher& operator=(compute_batcher&& rhs) = delete;
+    /// @endcond
+
+    /**
+     * @brief Retrieve an opaque reference to the underlying implementation.
+     * @return A reference to the underlying implementation.
+     */
+    const implementation_type& implementation() const;
+
+    /**
+     * @brief Retrieve an opaque reference to the underlying implementation.
+     * @return A reference to the underlying implementation.
+     */
+    implementation_type& implementation();
+
+    /**
+     * @brief Retrieve a sharable reference to the underlying implementation.
+     * @return A shareable reference to the underlying implmentation.
+     */
+    std::shared_ptr<const implementation_type> share_implementation() const;
+
+    /**
+     * @brief Add a compute kernel dispatch to the current batch.
+     * @param kernel The kernel to dispatch. This must belong to the same device as the batcher.
+     * @param push_constants The contents of the kernel's push constant block. The size must match the kernel's push
+     *                       constant size.
+     * @param reads The device addresses of the buffers that the kernel reads.
+     * @param writes The device addresses of the buffers that the kernel writes.
+     * @param x The number of workgroups to dispatch in the X dimension.
+     * @param y The number of workgroups to dispatch in the Y dimension.
+     * @param z The number of workgroups to dispatch in the Z dimension.
+     * @return A future that becomes ready when the dispatch has finished.
+     */
+    std::future<void> enqueue(const compute_kernel& kernel, const std::span<const std::byte> push_constants,
+                              const std::span<const std::uint64_t> reads, const std::span<const std::uint64_t> writes,
+                              const std::uint32_t x, const std::uint32_t y = 1, const std::uint32_t z = 1);
+
+    /**
+     * @brief Add a compute kernel dispatch to the current batch.
+     * @tparam Type The type of the push constant block. This must be trivially copyable and must not be a view of
+     *              bytes.
+     * @param kernel The kernel to dispatch. This must belong to the same device as the batcher.
+     * @param push_constants The contents of the kernel's push constant block.
+     * @param reads The device addresses of the buffers that the kernel reads.
+     * @param writes The device addresses of the buffers that the kernel writes.
+     * @param x The number of workgroups to dispatch in the X dimension.
+     * @param y The number of workgroups to dispatch in the Y dimension.
+     * @param z The number of workgroups to dispatch in the Z dimension.
+     * @return A future that becomes ready when the dispatch has finished.
+     */
+    template <typename Type>
+    requires std::is_trivially_copyable_v<Type> && (!std::is_convertible_v<const Type&, std::span<const std::byte>>)
+    std::future<void> enqueue(const compute_kernel& kernel, const Type& push_constants,
+                              const std::span<const std::uint64_t> reads, const std::span<const std::uint64_t> writes,
+                              const std::uint32_t x, const std::uint32_t y = 1, const std::uint32_t z = 1) {
+      return enqueue(kernel, std::as_bytes(std::span<const Type, 1>{ &push_constants, 1 }), reads, writes, x, y, z);
+    }
+
+    /**
+     * @brief Submit the current batch without waiting for the batching window to elapse.
+     */
+    void flush();
+  };
+
+  static_assert(concepts::opaque_object<compute_batcher>);
+  static_assert(concepts::readonly_sharable_opaque_object<compute_batcher>);
+
+}
+
+#endif
@@ -8,7 +8,11 @@
 #ifndef MEGATECH_VULKAN_DEVICE_HPP
 #define MEGATECH_VULKAN_DEVICE_HPP
 
+#include <chrono>
 #include <memory>
+#include <vector>
+
+#include "memory.hpp"
 
 #include "concepts/opaque_object.hpp"
 
@@ -21,6 +25,8 @@ namespace megatech::vulkan::internal::base {
 namespace megatech::vulkan {
 
   class physical_device_description;
+  class physical_device_group;
+  class compute_completion;
 
   /**
    * @brief A Vulkan device.
@@ -46,6 +52,14 @@ namespace megatech::vulkan {
      */
     explicit device(const physical_device_description& parent);
 
+    /**
+     * @brief Construct a device that drives every member of a physical device group.
+     * @details Devices created from groups with more than one member can split work between linked physical devices
+     *          using device masks. The first member of the group is used to configure the device.
+     * @param group A physical_device_group describing the physical devices to drive.
+     */
+    explicit device(const physical_device_group& group);
+
     /// @cond
     device(const device& other) = delete;
     device(device&& other) = delete;
@@ -80,6 +94,84 @@ namespace megatech::vulkan {
      * @return A shareable reference to the underlying implmentation.
      */
     std::shared_ptr<const implementation_type> share_implementation() const;
+
+    /**
+     * @brief Retrieve the number of physical devices driven by the device.
+     * @return The size of the device's physical device group. This is 1 for devices not created from a group.
+     */
+    std::uint32_t physical_device_count() const;
+
+    /**
+     * @brief Retrieve a device mask that selects every physical device driven by the device.
+     * @details Bit i of a device mask selects the physical device at index i of the device's group. Work can be
+     *          split between linked physical devices by submitting with a subset of this mask (e.g., one bit per
+     *          frame for alternate frame rendering).
+     * @return A bitmask where bit i is set for the physical device at index i.
+     */
+    std::uint32_t device_mask() const;
+
+    /**
+     * @brief Retrieve a snapshot of the device's per-heap memory budget and usage.
+     * @details Snapshots are cached and periodically refreshed. Successive calls within the refresh interval return
+     *          the same values. This is cheap enough to call before every large allocation.
+     * @return An array of memory_heap_budgets. Each budget is stored at the index of the heap it describes (i.e., it
+     *         matches physical_device_description::memory_heaps()).
+     */
+    std::vector<memory_heap_budget> memory_budget() const;
+
+    /**
+     * @brief Refresh and retrieve a snapshot of the device's per-heap memory budget and usage.
+     * @return An array of memory_heap_budgets. Each budget is stored at the index of the heap it describes.
+     */
+    std::vector<memory_heap_budget> refresh_memory_budget() const;
+
+    /**
+     * @brief Set the maximum age of the device's cached memory budget snapshot.
+     * @details The default interval is 100 milliseconds.
+     * @param interval The new refresh interval. This must not be negative.
+     */
+    void set_memory_budget_refresh_interval(const std::chrono::nanoseconds interval);
+
+    /**
+     * @brief Retrieve the fraction of a heap's budget at which the device starts evicting resources.
+     * @details When an allocation would push a heap past this fraction of its budget, idle memory that the device can
+     *          recreate on demand is released, least recently used first. Memory backing objects that were created
+     *          through the public interface is never evicted.
+     * @return A value greater than 0. The default is 0.9.
+     */
+    double residency_threshold() const;
+
+    /**
+     * @brief Set the fraction of a heap's budget at which the device starts evicting resources.
+     * @param threshold The new threshold. This must be a finite value greater than 0.
+     */
+    void set_residency_threshold(const double threshold);
+
+    /**
+     * @brief Release idle evictable memory until every heap is under the residency threshold.
+     * @details Only memory that the device has finished using is released.
+     * @return The total number of bytes released.
+     */
+    std::uint64_t trim_residency();
+
+    /**
+     * @brief Determine whether or not the device can export the completion of its work as Linux sync files.
+     * @details This requires VK_KHR_external_fence_fd and driver support for sync file export. Devices enable the
+     *          extension automatically when it's available.
+     * @return True if export_sync_fd() is supported. False otherwise.
+     */
+    bool supports_sync_fd() const;
+
+    /**
+     * @brief Export the completion of submitted work as a Linux sync file.
+     * @details Sync files become readable (e.g., to poll(), epoll, or io_uring) once the work completes, so event
+     *          loops can observe device completion without dedicating a thread to waiting.
+     * @param completion The completion to export. It must belong to the device.
+     * @return A file descriptor that the caller owns and must close, or -1 if the work has already completed.
+     * @throw error If the completion belongs to a different device, if the device doesn't support sync files, or if
+     *              the export fails.
+     */
+    int export_sync_fd(const compute_completion& completion) const;
   };
 
   static_assert(concepts::opaque_object<device>);
@@ -0,0 +1,191 @@
+/**
+ * @file device_scheduler.hpp
+ * @brief Multi-Device Work Distribution
+ * @author Alexander Rothman <[gnomesort@megate.ch](mailto:gnomesort@megate.ch)>
+ * @copyright AGPL-3.0-or-later
+ * @date 2025
+ */
+#ifndef MEGATECH_VULKAN_DEVICE_SCHEDULER_HPP
+#define MEGATECH_VULKAN_DEVICE_SCHEDULER_HPP
+
+#include <cinttypes>
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "device.hpp"
+
+namespace megatech::vulkan {
+
+  class physical_device_description;
+  class physical_device_list;
+
+  /**
+   * @brief A scheduler that distributes independent jobs across several devices.
+   * @details A device_scheduler opens a device on every entry of a physical_device_list. Each job is assigned to the
+   *          device that is expected to finish it first, based on an exponentially weighted average of the time that
+   *          each device has taken to complete jobs of the same class and on the work already queued on that device.
+   *          Ties are broken in favor of devices that appear earlier in the list, so the list's order acts as a
+   *          ranking. Each device has a thread that waits for its jobs' final timeline values and records when they
+   *          were signaled. All methods are thread-safe.
+   */
+  class device_scheduler final {
+  public:
+    /**
+     * @brief The type used to identify classes of jobs with similar costs.
+     */
+    using job_class = std::uint32_t;
+
+    /**
+     * @brief The type of callable that submits a job.
+     * @details The callable records and submits the job's work to the device that it receives. It returns the
+     *          device timeline value of the job's final submission (e.g., the result of
+     *          internal::base::device_impl::submit()), or 0 if the job didn't submit any work. Callables are invoked
+     *          without any device_scheduler locks held, so they may use the device_scheduler themselves.
+     */
+    using job_type = std::function<std::uint64_t(device&)>;
+  private:
+    struct pending_job final {
+      std::uint64_t id{ };
+      std::uint64_t timeline_value{ };
+      job_class type{ };
+      std::chrono::steady_clock::time_point start{ };
+      std::chrono::steady_clock::time_point completed{ };
+      bool is_submitted{ };
+      bool is_completed{ };
+    };
+
+    std::vector<std::unique_ptr<device>> m_devices{ };
+    std::vector<std::deque<pending_job>> m_pending{ };
+    std::vector<std::chrono::steady_clock::time_point> m_last_retired{ };
+    std::uint64_t m_next_id{ 1 };
+    std::vector<std::unordered_map<job_class, double>> m_estimates{ };
+    double m_smoothing_factor{ 0.2 };
+    mutable std::mutex m_mutex{ };
+    std::condition_variable m_changed{ };
+    bool m_stopping{ };
+    std::vector<std::thread> m_watchers{ };
+
+    double estimate(const std::size_t index, const job_class type) const;
+    std::uint64_t next_completion(const std::size_t index) const;
+    void retire(const std::size_t index);
+    void watch(const std::size_t index);
+    void stop() noexcept;
+  public:
+    /// @cond
+    device_scheduler() = delete;
+    /// @endcond
+
+    /**
+     * @brief Construct a device_scheduler.
+     * @param physical_devices A list of physical devices to distribute work across. Every listed device is opened.
+     *                         This must not be empty.
+     */
+    explicit device_scheduler(const physical_device_list& physical_devices);
+
+    /**
+     * @brief Construct a device_scheduler.
+     * @details The same physical device may be listed more than once. Each entry is opened as a separate device.
+     * @param physical_devices A range of physical devices to distribute work across. Every listed device is opened.
+     *                         This must not be empty.
+     */
+    explicit device_scheduler(const std::span<const physical_device_description> physical_devices);
+
+    /// @cond
+    device_scheduler(const device_scheduler& other) = delete;
+    device_scheduler(device_scheduler&& other) = delete;
+    /// @endcond
+
+    /**
+     * @brief Destroy a device_scheduler.
+     * @details Jobs that are still running on a device aren't waited for, but the device is idled before it's
+     *          destroyed.
+     */
+    ~device_scheduler() noexcept;
+
+    /// @cond
+    device_scheduler& operator=(const device_scheduler& rhs) = delete;
+    device_scheduler& operator=(device_scheduler&& rhs) = delete;
+    /// @endcond
+
+    /**
+     * @brief Retrieve the number of devices managed by the device_scheduler.
+     * @return The number of devices.
+     */
+    std::size_t size() const;
+
+    /**
+     * @brief Retrieve one of the device_scheduler's devices.
+     * @param index The index of the device. This matches the index of its physical_device_description in the list
+     *              used to construct the device_scheduler.
+     * @return A reference to the device.
+     */
+    device& operator[](const std::size_t index);
+
+    /**
+     * @brief Retrieve one of the device_scheduler's devices.
+     * @param index The index of the device.
+     * @return A read-only reference to the device.
+     */
+    const device& operator[](const std::size_t index) const;
+
+    /**
+     * @brief Submit a job to the device that is expected to complete it first.
+     * @details Completed jobs are retired before the job is assigned. The job's place in its device's queue is
+     *          reserved before the job is invoked, so concurrent schedule() calls account for each other. If the job
+     *          throws, its reservation is cancelled and the exception is propagated.
+     * @param type The class of the job.
+     * @param job A callable that submits the job's work. This must not be empty.
+     * @return The index of the device that the job was submitted to.
+     */
+    std::size_t schedule(const job_class type, const job_type& job);
+
+    /**
+     * @brief Retire completed jobs and update each device's throughput estimates.
+     * @details Each job is measured from the later of its submission and the completion of the job queued before it
+     *          until its final timeline value was signaled, so time spent waiting behind other jobs isn't counted
+     *          against it. Completion times are recorded as jobs complete, so they don't depend on how often this is
+     *          called. When several jobs are observed to complete at once, the time they took is divided between
+     *          them in proportion to their current estimates. schedule() retires jobs as well.
+     */
+    void poll();
+
+    /**
+     * @brief Wait for every submitted job to complete and retire it.
+     * @details Jobs whose callables are still running aren't waited for.
+     */
+    void wait_idle();
+
+    /**
+     * @brief Retrieve the number of incomplete jobs on a device.
+     * @param index The index of the device.
+     * @return The number of jobs that have been scheduled on the device and haven't been retired.
+     */
+    std::size_t queue_depth(const std::size_t index) const;
+
+    /**
+     * @brief Retrieve a device's estimated time to complete a class of job.
+     * @param index The index of the device.
+     * @param type The class of job.
+     * @return The estimated duration. 0 if the device hasn't completed a job of this class.
+     */
+    std::chrono::nanoseconds estimated_duration(const std::size_t index, const job_class type) const;
+
+    /**
+     * @brief Set the weight given to new measurements in the device_scheduler's throughput estimates.
+     * @param factor The new smoothing factor. This must be in the range (0, 1]. The default is 0.2.
+     */
+    void set_smoothing_factor(const double factor);
+  };
+
+}
+
+#endif
@@ -0,0 +1,152 @@
+/**
+ * @file file_streamer.hpp
+ * @brief Asynchronous File-to-Device Streaming
+ * @author Alexander Rothman <[gnomesort@megate.ch](mailto:gnomesort@megate.ch)>
+ * @copyright AGPL-3.0-or-later
+ * @date 2025
+ */
+#ifndef MEGATECH_VULKAN_FILE_STREAMER_HPP
+#define MEGATECH_VULKAN_FILE_STREAMER_HPP
+
+#include <cinttypes>
+#include <cstddef>
+
+#include <filesystem>
+#include <memory>
+
+#include "compute.hpp"
+
+#include "concepts/opaque_object.hpp"
+
+namespace megatech::vulkan::internal::base {
+
+  class file_streamer_impl;
+
+}
+
+namespace megatech::vulkan {
+
+  class device;
+
+  /**
+   * @brief A loader that streams file ranges into device_buffers without intermediate host copies.
+   * @details file_streamers read files directly into a persistently mapped staging ring and copy the data to its
+   *          destination on the device's asynchronous transfer queue. On Linux, reads are submitted to an io_uring, so
+   *          disk I/O, transfers, and other device work all overlap. If io_uring isn't available, reads fall back to
+   *          pread(). file_streamers aren't supported on other systems.
+   *
+   *          Data becomes visible to the device's asynchronous compute queue once the compute_completion returned by
+   *          submit() or flush() is reached. All methods are thread-safe.
+   */
+  class file_streamer final {
+  public:
+    /**
+     * @brief The internal implementation type of the file_streamer.
+     */
+    using implementation_type = internal::base::file_streamer_impl;
+  private:
+    std::shared_ptr<implementation_type> m_impl{ };
+  public:
+    /// @cond
+    file_streamer() = delete;
+    /// @endcond
+
+    /**
+     * @brief Construct a file_streamer.
+     * @param parent The device that the streamer belongs to.
+     * @param staging_capacity The size of the staging ring in bytes. Reads are split into chunks of a quarter of this
+     *                         size. This must be at least 4.
+     * @param queue_depth The maximum number of reads in flight at once. This must be greater than 0.
+     * @throw error If the system isn't Linux or if the staging ring can't be allocated.
+     */
+    file_streamer(const device& parent, const std::uint64_t staging_capacity = 1 << 24,
+                  const std::uint32_t queue_depth = 64);
+
+    /// @cond
+    file_streamer(const file_streamer& other) = delete;
+    file_streamer(file_streamer&& other) = delete;
+    /// @endcond
+
+    /**
+     * @brief Destroy a file_streamer.
+     * @details Reads in flight are waited for. Chunks that were read but never submitted are discarded.
+     */
+    ~file_streamer() noexcept = default;
+
+    /// @cond
+    file_streamer& operator=(const file_streamer& rhs) = delete;
+    file_streamer& operator=(file_streamer&& rhs) = delete;
+    /// @endcond
+
+    /**
+     * @brief Retrieve an opaque reference to the underlying implementation.
+     * @return A reference to the underlying implementation.
+     */
+    const implementation_type& implementation() const;
+
+    /**
+     * @brief Retrieve an opaque reference to the underlying implementation.
+     * @return A reference to the underlying implementation.
+     */
+    implementation_type& implementation();
+
+    /**
+     * @brief Retrieve a sharable reference to the underlying implementation.
+     * @return A shareable reference to the underlying implmentation.
+     */
+    std::shared_ptr<const implementation_type> share_implementation() const;
+
+    /**
+     * @brief Retrieve the size of the staging ring.
+     * @return The staging capacity in bytes.
+     */
+    std::uint64_t staging_capacity() const;
+
+    /**
+     * @brief Determine whether or not reads are asynchronous.
+     * @return True if reads are submitted to an io_uring. False if they fall back to pread().
+     */
+    bool uses_io_uring() const;
+
+    /**
+     * @brief Retrieve the number of chunks that haven't been copied to their destinations yet.
+     * @return The number of chunks that are being read or waiting for submit().
+     */
+    std::size_t pending() const;
+
+    /**
+     * @brief Read a range of a file into a device_buffer.
+     * @details The read begins immediately. If the staging ring is full, this first waits for earlier chunks to finish.
+     *          The destination buffer is kept alive until its data has been copied.
+     * @param path The path of the file to read. Files are kept open until the file_streamer is destroyed.
+     * @param file_offset The offset of the range within the file in bytes.
+     * @param size The size of the range in bytes.
+     * @param destination The buffer to read into.
+     * @param destination_offset The offset within the destination buffer in bytes.
+     * @throw error If the file can't be opened or if the range exceeds the destination buffer.
+     */
+    void read(const std::filesystem::path& path, const std::uint64_t file_offset, const std::uint64_t size,
+              const device_buffer& destination, const std::uint64_t destination_offset = 0);
+
+    /**
+     * @brief Copy every chunk that has been read to its destination.
+     * @details This doesn't wait for reads that are still in flight, so it can be called once per frame.
+     * @return The completion of the copies. If nothing was copied, the completion is already reached.
+     * @throw error If a read failed since the last submission or if the submission fails.
+     */
+    compute_completion submit();
+
+    /**
+     * @brief Wait for every read in flight and copy every chunk to its destination.
+     * @return The completion of every copy submitted so far.
+     * @throw error If a read failed or if the submission fails.
+     */
+    compute_completion flush();
+  };
+
+  static_assert(concepts::opaque_object<file_streamer>);
+  static_assert(concepts::readonly_sharable_opaque_object<file_streamer>);
+
+}
+
+#endif
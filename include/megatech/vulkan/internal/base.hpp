@@ -13,7 +13,33 @@
 #include "base/loader_impl.hpp"
 #include "base/instance_impl.hpp"
 #include "base/device_impl.hpp"
+#include "base/memory_allocation.hpp"
+#include "base/residency_manager.hpp"
+#include "base/deletion_queue.hpp"
+#include "base/sync_object_pool.hpp"
+#include "base/resource_state_tracker.hpp"
+#include "base/split_barrier.hpp"
+#include "base/command_buffer_pool.hpp"
+#include "base/buffer_pool.hpp"
+#include "base/offscreen_renderer.hpp"
+#include "base/render_graph.hpp"
+#include "base/device_buffer_impl.hpp"
+#include "base/dynamic_buffer_impl.hpp"
+#include "base/transient_allocator_impl.hpp"
+#include "base/sparse_page_pool.hpp"
+#include "base/sparse_buffer.hpp"
+#include "base/sparse_image.hpp"
+#include "base/file_streamer_impl.hpp"
+#include "base/worker_pool.hpp"
+#include "base/ktx2_texture.hpp"
+#include "base/kernel_specialization.hpp"
+#include "base/compute_pipeline_impl.hpp"
+#include "base/compute_pipeline_cache.hpp"
+#include "base/compute_context_impl.hpp"
+#include "base/compute_batcher_impl.hpp"
+#include "base/completion_reactor_impl.hpp"
 #include "base/layer_description_proxy.hpp"
+#include "base/structure_chain.hpp"
 #include "base/physical_device_description_impl.hpp"
 
 #endif
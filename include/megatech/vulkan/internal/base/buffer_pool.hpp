@@ -0,0 +1,113 @@
+/// @cond INTERNAL
+/**
+ * @file buffer_pool.hpp
+ * @brief Recycled Buffers
+ * @author Alexander Rothman <[gnomesort@megate.ch](mailto:gnomesort@megate.ch)>
+ * @copyright AGPL-3.0-or-later
+ * @date 2025
+ */
+#ifndef MEGATECH_VULKAN_INTERNAL_BASE_BUFFER_POOL_HPP
+#define MEGATECH_VULKAN_INTERNAL_BASE_BUFFER_POOL_HPP
+
+#include <cinttypes>
+
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "../../concepts/child_object.hpp"
+
+#include "vulkandefs.hpp"
+#include "device_impl.hpp"
+#include "memory_allocation.hpp"
+
+namespace megatech::vulkan::internal::base {
+
+  /**
+   * @brief A pool of buffers with identical usage that are recycled once the device has finished using them.
+   * @details Buffers in host-visible memory remain persistently mapped for their entire lifetime, which makes
+   *          buffer_pools suitable for staging uploads and readbacks. This type is thread-safe.
+   */
+  class buffer_pool final {
+  public:
+    /**
+     * @brief The parent object type required to construct a buffer_pool.
+     */
+    using parent_type = device_impl;
+  private:
+    std::shared_ptr<const parent_type> m_parent{ };
+    VkBufferUsageFlags m_usage{ };
+    VkMemoryPropertyFlags m_required{ };
+    VkMemoryPropertyFlags m_preferred{ };
+    mutable std::mutex m_mutex{ };
+    std::vector<buffer_allocation> m_free{ };
+    std::vector<std::pair<std::uint64_t, buffer_allocation>> m_pending{ };
+  public:
+    /// @cond
+    buffer_pool() = delete;
+    /// @endcond
+
+    /**
+     * @brief Construct a buffer_pool.
+     * @param parent A shared_ptr to a read-only device_impl. This must not be null.
+     * @param usage The usage flags of every buffer in the pool.
+     * @param required A set of memory property flags that every buffer's memory must have.
+     * @param preferred A set of memory property flags that every buffer's memory should have, if possible.
+     */
+    buffer_pool(const std::shared_ptr<const parent_type>& parent, const VkBufferUsageFlags usage,
+                const VkMemoryPropertyFlags required, const VkMemoryPropertyFlags preferred);
+
+    /// @cond
+    buffer_pool(const buffer_pool& other) = delete;
+    buffer_pool(buffer_pool&& other) = delete;
+    /// @endcond
+
+    /**
+     * @brief Destroy a buffer_pool.
+     * @details Released buffers that the device may still be using are destroyed through the device's
+     *          deletion_queue. Buffers that are still acquired are leaked.
+     */
+    ~buffer_pool() noexcept;
+
+    /// @cond
+    buffer_pool& operator=(const buffer_pool& rhs) = delete;
+    buffer_pool& operator=(buffer_pool&& rhs) = delete;
+    /// @endcond
+
+    /**
+     * @brief Retrieve the buffer_pool's parent object.
+     * @return A read-only reference to a device_impl.
+     */
+    const parent_type& parent() const;
+
+    /**
+     * @brief Acquire a buffer from the pool.
+     * @details The smallest idle buffer that can hold the requested size is reused. If there is no such buffer, a new
+     *          one is created.
+     * @param size The minimum size of the buffer in bytes.
+     * @return A buffer_allocation whose size is at least the requested size.
+     */
+    buffer_allocation acquire(const VkDeviceSize size);
+
+    /**
+     * @brief Return a buffer to the pool.
+     * @param buffer A buffer previously acquired from the pool.
+     * @param timeline_value The device timeline value of the last submission that used the buffer, or 0 if the device
+     *                       never used it. The buffer isn't reused until this value completes.
+     */
+    void release(const buffer_allocation& buffer, const std::uint64_t timeline_value);
+
+    /**
+     * @brief Destroy every idle buffer in the pool.
+     * @return The number of bytes freed.
+     */
+    VkDeviceSize trim();
+  };
+
+  static_assert(megatech::vulkan::concepts::readonly_child_object<buffer_pool>);
+
+}
+
+#endif
+/// @endcond
@@ -0,0 +1,133 @@
+/// @cond INTERNAL
+/**
+ * @file command_buffer_pool.hpp
+ * @brief Recycled Command Buffers
+ * @author Alexander Rothman <[gnomesort@megate.ch](mailto:gnomesort@megate.ch)>
+ * @copyright AGPL-3.0-or-later
+ * @date 2025
+ */
+#ifndef MEGATECH_VULKAN_INTERNAL_BASE_COMMAND_BUFFER_POOL_HPP
+#define MEGATECH_VULKAN_INTERNAL_BASE_COMMAND_BUFFER_POOL_HPP
+
+#include <cinttypes>
+
+#include <memory>
+#include <mutex>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "../../concepts/child_object.hpp"
+#include "../../concepts/handle_owner.hpp"
+
+#include "vulkandefs.hpp"
+#include "device_impl.hpp"
+
+namespace megatech::vulkan::internal::base {
+
+  /**
+   * @brief A pool of primary command buffers that are recycled once the device has finished executing them.
+   * @details Acquiring, releasing, and submitting command buffers is thread-safe. However, Vulkan requires that
+   *          command buffers allocated from the same pool aren't recorded concurrently, so threads that record in
+   *          parallel must use separate command_buffer_pools.
+   */
+  class command_buffer_pool final {
+  public:
+    /**
+     * @brief The type of Vulkan handle owned by a command_buffer_pool.
+     */
+    using handle_type = VkCommandPool;
+
+    /**
+     * @brief The parent object type required to construct a command_buffer_pool.
+     */
+    using parent_type = device_impl;
+  private:
+    std::shared_ptr<const parent_type> m_parent{ };
+    queue_type m_queue{ };
+    VkCommandPool m_handle{ };
+    mutable std::mutex m_mutex{ };
+    std::vector<VkCommandBuffer> m_free{ };
+    std::vector<std::pair<std::uint64_t, VkCommandBuffer>> m_pending{ };
+    std::uint64_t m_last_submitted{ };
+  public:
+    /// @cond
+    command_buffer_pool() = delete;
+    /// @endcond
+
+    /**
+     * @brief Construct a command_buffer_pool.
+     * @param parent A shared_ptr to a read-only device_impl. This must not be null.
+     * @param queue The queue that the pool's command buffers will be submitted to.
+     */
+    command_buffer_pool(const std::shared_ptr<const parent_type>& parent, const queue_type queue);
+
+    /// @cond
+    command_buffer_pool(const command_buffer_pool& other) = delete;
+    command_buffer_pool(command_buffer_pool&& other) = delete;
+    /// @endcond
+
+    /**
+     * @brief Destroy a command_buffer_pool.
+     * @details The underlying pool is destroyed through the device's deletion_queue once every submitted command
+     *          buffer completes, so this never waits.
+     */
+    ~command_buffer_pool() noexcept;
+
+    /// @cond
+    command_buffer_pool& operator=(const command_buffer_pool& rhs) = delete;
+    command_buffer_pool& operator=(command_buffer_pool&& rhs) = delete;
+    /// @endcond
+
+    /**
+     * @brief Retrieve the command_buffer_pool's underlying Vulkan handle.
+     * @return A valid VkCommandPool.
+     */
+    handle_type handle() const;
+
+    /**
+     * @brief Retrieve the command_buffer_pool's parent object.
+     * @return A read-only reference to a device_impl.
+     */
+    const parent_type& parent() const;
+
+    /**
+     * @brief Retrieve the queue that the command_buffer_pool submits to.
+     * @return A queue_type.
+     */
+    queue_type queue() const;
+
+    /**
+     * @brief Acquire a command buffer in the recording state.
+     * @details Command buffers are begun with VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT.
+     * @return A VkCommandBuffer that is ready to record commands.
+     */
+    VkCommandBuffer acquire();
+
+    /**
+     * @brief Return a command buffer to the command_buffer_pool.
+     * @param command_buffer A command buffer previously acquired from the pool.
+     * @param timeline_value The device timeline value of the submission that used the command buffer, or 0 if it was
+     *                       never submitted. The command buffer isn't reused until this value completes.
+     */
+    void release(const VkCommandBuffer command_buffer, const std::uint64_t timeline_value);
+
+    /**
+     * @brief End, submit, and release a command buffer.
+     * @param command_buffer A command buffer acquired from the pool that is in the recording state.
+     * @param waits Semaphores to wait on before execution.
+     * @param signals Additional semaphores to signal after execution.
+     * @return The device timeline value assigned to the submission.
+     */
+    std::uint64_t submit(const VkCommandBuffer command_buffer,
+                         const std::span<const VkSemaphoreSubmitInfo> waits = { },
+                         const std::span<const VkSemaphoreSubmitInfo> signals = { });
+  };
+
+  static_assert(megatech::vulkan::concepts::readonly_child_object<command_buffer_pool>);
+  static_assert(megatech::vulkan::concepts::handle_owner<command_buffer_pool>);
+
+}
+
+#endif
+/// @endcond
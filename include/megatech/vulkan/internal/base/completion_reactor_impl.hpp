@@ -0,0 +1,193 @@
+/// @cond INTERNAL
+/**
+ * @file completion_reactor_impl.hpp
+ * @brief Completion Reactor Implementation
+ * @author Alexander Rothman <[gnomesort@megate.ch](mailto:gnomesort@megate.ch)>
+ * @copyright AGPL-3.0-or-later
+ * @date 2025
+ */
+#ifndef MEGATECH_VULKAN_INTERNAL_BASE_COMPLETION_REACTOR_IMPL_HPP
+#define MEGATECH_VULKAN_INTERNAL_BASE_COMPLETION_REACTOR_IMPL_HPP
+
+#include <cinttypes>
+#include <cstddef>
+
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../../concepts/child_object.hpp"
+
+#include "vulkandefs.hpp"
+#include "device_impl.hpp"
+
+namespace megatech::vulkan::internal::base {
+
+  /**
+   * @brief The implementation of a megatech::vulkan::completion_reactor.
+   * @details completion_reactor_impls resume suspended coroutines when device work completes. A single background
+   *          thread waits for every watched timeline value at once with one vkWaitSemaphores call using
+   *          VK_SEMAPHORE_WAIT_ANY_BIT. The wait also includes a private timeline semaphore that is signaled from the
+   *          host whenever a new coroutine is watched, so new work never waits behind an earlier wait. Fences can't
+   *          be waited on together with semaphores, so they're polled at fence_poll_interval while any are watched.
+   *
+   *          Ready coroutines are handed to the executor. Without an executor, they're resumed on the reactor's
+   *          thread, and they must not throw from resumption. This type is thread-safe.
+   */
+  class completion_reactor_impl final {
+  public:
+    /**
+     * @brief The parent object type required to construct a completion_reactor_impl.
+     */
+    using parent_type = device_impl;
+
+    /**
+     * @brief The type of callable that resumes ready coroutines.
+     * @details Executors are invoked on the reactor's thread and must not block.
+     */
+    using executor_type = std::function<void(std::coroutine_handle<>)>;
+
+    /**
+     * @brief The interval at which watched fences are polled.
+     */
+    static constexpr std::chrono::milliseconds fence_poll_interval{ 1 };
+  private:
+    struct waiter final {
+      std::uint64_t timeline_value{ };
+      VkFence fence{ };
+      std::coroutine_handle<> handle{ };
+      std::exception_ptr* failure{ };
+    };
+
+    struct shared_state final {
+      std::shared_ptr<const parent_type> parent{ };
+      executor_type executor{ };
+      VkSemaphore wake_semaphore{ };
+      std::mutex mutex{ };
+      std::condition_variable condition{ };
+      std::vector<waiter> incoming{ };
+      std::uint64_t wake_value{ };
+      bool sleeping{ };
+      bool stopping{ };
+
+      ~shared_state() noexcept;
+
+      void wake();
+    };
+
+    // The reactor's thread shares ownership of its state, so resuming a coroutine that destroys the last reference to
+    // the reactor can't invalidate the state that the thread is still using.
+    std::shared_ptr<shared_state> m_state{ };
+    std::thread m_thread{ };
+
+    static void run(const std::shared_ptr<shared_state>& state);
+    static void resume(shared_state& state, const waiter& ready, const std::exception_ptr& failure) noexcept;
+    void watch(waiter&& pending) const;
+  public:
+    /// @cond
+    completion_reactor_impl() = delete;
+    /// @endcond
+
+    /**
+     * @brief Construct a completion_reactor_impl.
+     * @param parent A shared_ptr to a read-only device_impl. This must not be null.
+     * @param executor The callable used to resume ready coroutines. If this is empty, coroutines are resumed on the
+     *                 reactor's thread.
+     */
+    completion_reactor_impl(const std::shared_ptr<const parent_type>& parent, executor_type executor);
+
+    /// @cond
+    completion_reactor_impl(const completion_reactor_impl& other) = delete;
+    completion_reactor_impl(completion_reactor_impl&& other) = delete;
+    /// @endcond
+
+    /**
+     * @brief Destroy a completion_reactor_impl.
+     * @details Coroutines that are still watched are resumed with an error.
+     */
+    ~completion_reactor_impl() noexcept;
+
+    /// @cond
+    completion_reactor_impl& operator=(const completion_reactor_impl& rhs) = delete;
+    completion_reactor_impl& operator=(completion_reactor_impl&& rhs) = delete;
+    /// @endcond
+
+    /**
+     * @brief Retrieve the completion_reactor_impl's parent object.
+     * @return A read-only reference to a device_impl.
+     */
+    const parent_type& parent() const;
+
+    /**
+     * @brief Resume a coroutine once a device timeline value completes.
+     * @param timeline_value The timeline value to wait for. This must not exceed the device's current timeline value.
+     * @param handle The suspended coroutine to resume.
+     * @param failure A location that receives the exception describing a failed wait. It's written before the
+     *                coroutine is resumed, and it must remain valid until then.
+     * @throw error If the timeline value hasn't been submitted.
+     */
+    void watch(const std::uint64_t timeline_value, const std::coroutine_handle<> handle,
+               std::exception_ptr& failure) const;
+
+    /**
+     * @brief Resume a coroutine once a fence is signaled.
+     * @param fence The fence to wait for. This must not be VK_NULL_HANDLE, and it must have been submitted.
+     * @param handle The suspended coroutine to resume.
+     * @param failure A location that receives the exception describing a failed wait. It's written before the
+     *                coroutine is resumed, and it must remain valid until then.
+     */
+    void watch(const VkFence fence, const std::coroutine_handle<> handle, std::exception_ptr& failure) const;
+  };
+
+  static_assert(megatech::vulkan::concepts::readonly_child_object<completion_reactor_impl>);
+
+  /**
+   * @brief An awaitable that suspends a coroutine until a fence is signaled.
+   * @details fence_awaitables must be awaited at most once.
+   */
+  class fence_awaitable final {
+  private:
+    std::shared_ptr<const completion_reactor_impl> m_reactor{ };
+    VkFence m_fence{ };
+    std::exception_ptr m_error{ };
+  public:
+    /// @cond
+    fence_awaitable() = delete;
+    /// @endcond
+
+    /**
+     * @brief Construct a fence_awaitable.
+     * @param reactor A shared_ptr to the completion_reactor_impl that resumes the coroutine. This must not be null.
+     * @param fence The fence to wait for. This must not be VK_NULL_HANDLE, and it must have been submitted.
+     */
+    fence_awaitable(const std::shared_ptr<const completion_reactor_impl>& reactor, const VkFence fence);
+
+    /**
+     * @brief Determine whether or not the fence is already signaled.
+     * @return True if the fence is signaled. False otherwise.
+     */
+    bool await_ready() const;
+
+    /**
+     * @brief Watch the fence.
+     * @param handle The coroutine to resume once the fence is signaled.
+     */
+    void await_suspend(const std::coroutine_handle<> handle);
+
+    /**
+     * @brief Complete the wait.
+     * @throw error If the wait failed.
+     */
+    void await_resume() const;
+  };
+
+}
+
+#endif
+/// @endcond
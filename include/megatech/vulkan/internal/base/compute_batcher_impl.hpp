@@ -0,0 +1,168 @@
+/// @cond INTERNAL
+/**
+ * @file compute_batcher_impl.hpp
+ * @brief Compute Batcher Implementation
+ * @author Alexander Rothman <[gnomesort@megate.ch](mailto:gnomesort@megate.ch)>
+ * @copyright AGPL-3.0-or-later
+ * @date 2025
+ */
+#ifndef MEGATECH_VULKAN_INTERNAL_BASE_COMPUTE_BATCHER_IMPL_HPP
+#define MEGATECH_VULKAN_INTERNAL_BASE_COMPUTE_BATCHER_IMPL_HPP
+
+#include <cinttypes>
+#include <cstddef>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "../../concepts/child_object.hpp"
+
+#include "vulkandefs.hpp"
+#include "device_impl.hpp"
+#include "command_buffer_pool.hpp"
+#include "compute_pipeline_impl.hpp"
+
+namespace megatech::vulkan::internal::base {
+
+  /**
+   * @brief The implementation of a megatech::vulkan::compute_batcher.
+   * @details compute_batcher_impls accumulate small dispatches and submit them together. A batch is submitted when
+   *          it reaches its maximum size, when its oldest job has waited for the batching window, or when a flush is
+   *          requested. Every batch is recorded into a single command buffer. Pipeline barriers are only recorded
+   *          between jobs whose declared buffer accesses conflict, and every job in a batch completes from the
+   *          batch's single timeline signal. Batches are submitted and completed by two background threads. This type
+   *          is thread-safe.
+   */
+  class compute_batcher_impl final {
+  public:
+    /**
+     * @brief The parent object type required to construct a compute_batcher_impl.
+     */
+    using parent_type = device_impl;
+  private:
+    struct job final {
+      std::shared_ptr<const compute_pipeline_impl> pipeline{ };
+      std::vector<std::byte> push_constants{ };
+      std::array<std::uint32_t, 3> group_counts{ };
+      std::vector<VkDeviceAddress> reads{ };
+      std::vector<VkDeviceAddress> writes{ };
+      std::promise<void> promise{ };
+      std::chrono::steady_clock::time_point enqueued{ };
+    };
+
+    struct batch final {
+      std::uint64_t timeline_value{ };
+      std::vector<job> jobs{ };
+    };
+
+    std::shared_ptr<const parent_type> m_parent{ };
+    std::chrono::steady_clock::duration m_window{ };
+    std::size_t m_max_batch_size{ };
+    std::unique_ptr<command_buffer_pool> m_commands{ };
+    mutable std::mutex m_mutex{ };
+    std::condition_variable m_flush_condition{ };
+    std::condition_variable m_completion_condition{ };
+    std::vector<job> m_pending{ };
+    std::deque<batch> m_in_flight{ };
+    bool m_flush_requested{ };
+    bool m_stopping{ };
+    bool m_flusher_stopped{ };
+    std::atomic<std::uint64_t> m_batches_submitted{ };
+    std::atomic<std::uint64_t> m_barriers_recorded{ };
+    std::thread m_flusher{ };
+    std::thread m_completer{ };
+
+    void submit_batch(std::vector<job>&& jobs);
+    void run_flusher();
+    void run_completer();
+  public:
+    /// @cond
+    compute_batcher_impl() = delete;
+    /// @endcond
+
+    /**
+     * @brief Construct a compute_batcher_impl.
+     * @param parent A shared_ptr to a read-only device_impl. This must not be null.
+     * @param window The maximum time that a job waits before its batch is submitted.
+     * @param max_batch_size The maximum number of jobs in a batch. This must be greater than 0.
+     */
+    compute_batcher_impl(const std::shared_ptr<const parent_type>& parent, const std::chrono::nanoseconds window,
+                         const std::size_t max_batch_size);
+
+    /// @cond
+    compute_batcher_impl(const compute_batcher_impl& other) = delete;
+    compute_batcher_impl(compute_batcher_impl&& other) = delete;
+    /// @endcond
+
+    /**
+     * @brief Destroy a compute_batcher_impl.
+     * @details Pending jobs are submitted, and this waits for every job to complete.
+     */
+    ~compute_batcher_impl() noexcept;
+
+    /// @cond
+    compute_batcher_impl& operator=(const compute_batcher_impl& rhs) = delete;
+    compute_batcher_impl& operator=(compute_batcher_impl&& rhs) = delete;
+    /// @endcond
+
+    /**
+     * @brief Retrieve the compute_batcher_impl's parent object.
+     * @return A read-only reference to a device_impl.
+     */
+    const parent_type& parent() const;
+
+    /**
+     * @brief Add a dispatch to the current batch.
+     * @details Jobs in the same batch execute in order of submission, but may overlap unless their declared accesses
+     *          conflict. Jobs that don't declare accesses are assumed to be independent of every other job in their
+     *          batch. Batches are always ordered with respect to earlier batches.
+     * @param pipeline The compute pipeline to dispatch. This must not be null and must belong to the same device.
+     * @param push_constants The contents of the pipeline's push constant block. The size must match the pipeline's
+     *                       push constant size.
+     * @param group_counts The number of workgroups to dispatch in each dimension.
+     * @param reads The device addresses of buffers that the job reads.
+     * @param writes The device addresses of buffers that the job writes.
+     * @return A future that becomes ready when the job completes. If the batch can't be submitted, the future holds
+     *         the resulting exception.
+     */
+    std::future<void> enqueue(const std::shared_ptr<const compute_pipeline_impl>& pipeline,
+                              const std::span<const std::byte> push_constants,
+                              const std::array<std::uint32_t, 3>& group_counts,
+                              const std::span<const VkDeviceAddress> reads,
+                              const std::span<const VkDeviceAddress> writes);
+
+    /**
+     * @brief Submit the current batch without waiting for the batching window to elapse.
+     * @details This doesn't wait for the batch to be submitted.
+     */
+    void flush();
+
+    /**
+     * @brief Retrieve the number of batches that the compute_batcher_impl has submitted.
+     * @return The number of submitted batches.
+     */
+    std::uint64_t batches_submitted() const;
+
+    /**
+     * @brief Retrieve the number of hazard barriers that the compute_batcher_impl has recorded between jobs.
+     * @details The barriers that order each batch with respect to other submissions aren't counted.
+     * @return The number of recorded hazard barriers.
+     */
+    std::uint64_t barriers_recorded() const;
+  };
+
+  static_assert(megatech::vulkan::concepts::readonly_child_object<compute_batcher_impl>);
+
+}
+
+#endif
+/// @endcond
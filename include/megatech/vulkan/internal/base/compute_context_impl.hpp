@@ -0,0 +1,115 @@
+/// @cond INTERNAL
+/**
+ * @file compute_context_impl.hpp
+ * @brief Compute Context Implementation
+ * @author Alexander Rothman <[gnomesort@megate.ch](mailto:gnomesort@megate.ch)>
+ * @copyright AGPL-3.0-or-later
+ * @date 2025
+ */
+#ifndef MEGATECH_VULKAN_INTERNAL_BASE_COMPUTE_CONTEXT_IMPL_HPP
+#define MEGATECH_VULKAN_INTERNAL_BASE_COMPUTE_CONTEXT_IMPL_HPP
+
+#include <cinttypes>
+#include <cstddef>
+
+#include <array>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "../../concepts/child_object.hpp"
+
+#include "vulkandefs.hpp"
+#include "device_impl.hpp"
+#include "command_buffer_pool.hpp"
+#include "compute_pipeline_impl.hpp"
+
+namespace megatech::vulkan::internal::base {
+
+  /**
+   * @brief The implementation of a megatech::vulkan::compute_context.
+   * @details compute_context_impls record dispatches into pooled command buffers and submit them to the
+   *          device's asynchronous compute queue (or the primary queue, if the device has no asynchronous compute
+   *          queue). Dispatches execute in submission order. Each one is separated from the previous one by a full
+   *          compute memory dependency, and its results are made visible to the host. This type is thread-safe.
+   */
+  class compute_context_impl final {
+  public:
+    /**
+     * @brief The parent object type required to construct a compute_context_impl.
+     */
+    using parent_type = device_impl;
+  private:
+    std::shared_ptr<const parent_type> m_parent{ };
+    std::vector<std::pair<std::uint64_t, std::shared_ptr<const compute_pipeline_impl>>> m_in_flight{ };
+    std::unique_ptr<command_buffer_pool> m_commands{ };
+    mutable std::mutex m_mutex{ };
+
+    void retire();
+  public:
+    /// @cond
+    compute_context_impl() = delete;
+    /// @endcond
+
+    /**
+     * @brief Construct a compute_context_impl.
+     * @param parent A shared_ptr to a read-only device_impl. This must not be null.
+     */
+    explicit compute_context_impl(const std::shared_ptr<const parent_type>& parent);
+
+    /// @cond
+    compute_context_impl(const compute_context_impl& other) = delete;
+    compute_context_impl(compute_context_impl&& other) = delete;
+    /// @endcond
+
+    /**
+     * @brief Destroy a compute_context_impl.
+     * @details This waits for every dispatch to complete.
+     */
+    ~compute_context_impl() noexcept = default;
+
+    /// @cond
+    compute_context_impl& operator=(const compute_context_impl& rhs) = delete;
+    compute_context_impl& operator=(compute_context_impl&& rhs) = delete;
+    /// @endcond
+
+    /**
+     * @brief Retrieve the compute_context_impl's parent object.
+     * @return A read-only reference to a device_impl.
+     */
+    const parent_type& parent() const;
+
+    /**
+     * @brief Retrieve a sharable reference to the compute_context_impl's parent object.
+     * @return A shared_ptr to a read-only device_impl.
+     */
+    std::shared_ptr<const parent_type> share_parent() const;
+
+    /**
+     * @brief Retrieve the queue that the compute_context_impl submits to.
+     * @return queue_type::async_compute. The device_impl aliases this to the primary queue when necessary.
+     */
+    queue_type queue() const;
+
+    /**
+     * @brief Record and submit a single dispatch.
+     * @details The pipeline is kept alive until the dispatch completes.
+     * @param pipeline The compute pipeline to dispatch. This must not be null and must belong to the same device.
+     * @param push_constants The contents of the pipeline's push constant block. The size must match the pipeline's
+     *                       push constant size.
+     * @param group_counts The number of workgroups to dispatch in each dimension.
+     * @return The device timeline value that signals the completion of the dispatch.
+     */
+    std::uint64_t dispatch(const std::shared_ptr<const compute_pipeline_impl>& pipeline,
+                           const std::span<const std::byte> push_constants,
+                           const std::array<std::uint32_t, 3>& group_counts);
+  };
+
+  static_assert(megatech::vulkan::concepts::readonly_child_object<compute_context_impl>);
+
+}
+
+#endif
+/// @endcond
@@ -0,0 +1,125 @@
+/// @cond INTERNAL
+/**
+ * @file compute_pipeline_cache.hpp
+ * @brief Per-Device Specialized Compute Pipeline Cache
+ * @author Alexander Rothman <[gnomesort@megate.ch](mailto:gnomesort@megate.ch)>
+ * @copyright AGPL-3.0-or-later
+ * @date 2025
+ */
+#ifndef MEGATECH_VULKAN_INTERNAL_BASE_COMPUTE_PIPELINE_CACHE_HPP
+#define MEGATECH_VULKAN_INTERNAL_BASE_COMPUTE_PIPELINE_CACHE_HPP
+
+#include <cinttypes>
+#include <cstddef>
+
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../../compute.hpp"
+
+#include "vulkandefs.hpp"
+
+namespace megatech::vulkan::internal::base {
+
+  class device_impl;
+  class compute_pipeline_impl;
+
+  /**
+   * @brief A cache of device-specialized compute pipelines.
+   * @details Pipelines are keyed by their shader code, entry point, push constant size, and resolved specialization
+   *          constants. The code is hashed to find candidate pipelines, but each entry keeps a copy of its code so a
+   *          hash collision never returns another shader's pipeline. The cache only holds weak references, so
+   *          pipelines are destroyed as soon as their last kernel is. Pipelines that are recompiled after being
+   *          destroyed still benefit from the cache's VkPipelineCache. All methods are thread-safe.
+   */
+  class compute_pipeline_cache final {
+  public:
+    /**
+     * @brief The type of Vulkan handle owned by a compute_pipeline_cache.
+     */
+    using handle_type = VkPipelineCache;
+
+    /**
+     * @brief The parent object type required to construct a compute_pipeline_cache.
+     */
+    using parent_type = device_impl;
+  private:
+    struct entry final {
+      std::vector<std::uint32_t> spirv{ };
+      std::weak_ptr<compute_pipeline_impl> pipeline{ };
+    };
+
+    const parent_type* m_parent{ };
+    VkPipelineCache m_handle{ };
+    mutable std::mutex m_mutex{ };
+    std::unordered_map<std::string, std::vector<entry>> m_pipelines{ };
+  public:
+    /// @cond
+    compute_pipeline_cache() = delete;
+    /// @endcond
+
+    /**
+     * @brief Construct a compute_pipeline_cache.
+     * @param parent The device_impl that owns the compute_pipeline_cache.
+     */
+    explicit compute_pipeline_cache(const parent_type& parent);
+
+    /// @cond
+    compute_pipeline_cache(const compute_pipeline_cache& other) = delete;
+    compute_pipeline_cache(compute_pipeline_cache&& other) = delete;
+    /// @endcond
+
+    /**
+     * @brief Destroy a compute_pipeline_cache.
+     */
+    ~compute_pipeline_cache() noexcept;
+
+    /// @cond
+    compute_pipeline_cache& operator=(const compute_pipeline_cache& rhs) = delete;
+    compute_pipeline_cache& operator=(compute_pipeline_cache&& rhs) = delete;
+    /// @endcond
+
+    /**
+     * @brief Retrieve the compute_pipeline_cache's underlying Vulkan handle.
+     * @return A valid VkPipelineCache.
+     */
+    handle_type handle() const;
+
+    /**
+     * @brief Retrieve the compute_pipeline_cache's parent object.
+     * @return A read-only reference to a device_impl.
+     */
+    const parent_type& parent() const;
+
+    /**
+     * @brief Retrieve a compute pipeline specialized for the cache's device, compiling it if necessary.
+     * @details Compilation happens without holding the cache's lock. If two threads compile the same pipeline at
+     *          once, both receive whichever pipeline was inserted first.
+     * @param device A shared_ptr to the cache's parent. This must not be null.
+     * @param spirv The SPIR-V code of the compute shader. This must not be empty.
+     * @param entry_point The name of the shader's entry point.
+     * @param push_constant_size The size of the shader's push constant block in bytes.
+     * @param constants The specialization constants to derive from the device's properties.
+     * @return A shared_ptr to a compute_pipeline_impl.
+     */
+    std::shared_ptr<compute_pipeline_impl> acquire(const std::shared_ptr<const parent_type>& device,
+                                                   const std::span<const std::uint32_t> spirv,
+                                                   const std::string& entry_point,
+                                                   const std::uint32_t push_constant_size,
+                                                   const kernel_constants& constants);
+
+    /**
+     * @brief Retrieve the number of live pipelines in the cache.
+     * @return The number of cached pipelines that haven't been destroyed.
+     */
+    std::size_t size() const;
+  };
+
+}
+
+#endif
+/// @endcond
@@ -0,0 +1,138 @@
+/// @cond INTERNAL
+/**
+ * @file compute_pipeline_impl.hpp
+ * @brief Compute Pipeline Implementation
+ * @author Alexander Rothman <[gnomesort@megate.ch](mailto:gnomesort@megate.ch)>
+ * @copyright AGPL-3.0-or-later
+ * @date 2025
+ */
+#ifndef MEGATECH_VULKAN_INTERNAL_BASE_COMPUTE_PIPELINE_IMPL_HPP
+#define MEGATECH_VULKAN_INTERNAL_BASE_COMPUTE_PIPELINE_IMPL_HPP
+
+#include <cinttypes>
+
+#include <memory>
+#include <span>
+#include <string>
+
+#include "../../concepts/child_object.hpp"
+#include "../../concepts/handle_owner.hpp"
+
+#include "vulkandefs.hpp"
+#include "device_impl.hpp"
+#include "kernel_specialization.hpp"
+
+namespace megatech::vulkan::internal::base {
+
+  /**
+   * @brief The implementation of a megatech::vulkan::compute_kernel.
+   * @details Compute pipelines don't use descriptor sets. Shaders receive buffers as device addresses through a
+   *          single push constant range that covers the entire push constant block.
+   */
+  class compute_pipeline_impl final {
+  public:
+    /**
+     * @brief The type of Vulkan handle owned by a compute_pipeline_impl.
+     */
+    using handle_type = VkPipeline;
+
+    /**
+     * @brief The parent object type required to construct a compute_pipeline_impl.
+     */
+    using parent_type = device_impl;
+  private:
+    std::shared_ptr<const parent_type> m_parent{ };
+    VkPipelineLayout m_layout{ };
+    VkPipeline m_handle{ };
+    std::uint32_t m_push_constant_size{ };
+    kernel_specialization m_specialization{ };
+
+    void create(const std::span<const std::uint32_t> spirv, const std::string& entry_point,
+                const VkSpecializationInfo* specialization, const VkPipelineCache cache);
+  public:
+    /// @cond
+    compute_pipeline_impl() = delete;
+    /// @endcond
+
+    /**
+     * @brief Construct a compute_pipeline_impl.
+     * @param parent A shared_ptr to a read-only device_impl. This must not be null.
+     * @param spirv The SPIR-V code of the compute shader. This must not be empty.
+     * @param entry_point The name of the shader's entry point.
+     * @param push_constant_size The size of the shader's push constant block in bytes. This must be a multiple of 4
+     *                           that doesn't exceed the device's maxPushConstantsSize limit.
+     * @param specialization Optional specialization constants for the shader.
+     */
+    compute_pipeline_impl(const std::shared_ptr<const parent_type>& parent, const std::span<const std::uint32_t> spirv,
+                          const std::string& entry_point, const std::uint32_t push_constant_size,
+                          const VkSpecializationInfo* specialization = nullptr);
+
+    /**
+     * @brief Construct a compute_pipeline_impl with device-derived specialization constants.
+     * @param parent A shared_ptr to a read-only device_impl. This must not be null.
+     * @param spirv The SPIR-V code of the compute shader. This must not be empty.
+     * @param entry_point The name of the shader's entry point.
+     * @param push_constant_size The size of the shader's push constant block in bytes. This must be a multiple of 4
+     *                           that doesn't exceed the device's maxPushConstantsSize limit.
+     * @param specialization The specialization constants for the shader. The compute_pipeline_impl keeps a copy.
+     * @param cache A VkPipelineCache to accelerate pipeline creation with. This may be VK_NULL_HANDLE.
+     */
+    compute_pipeline_impl(const std::shared_ptr<const parent_type>& parent, const std::span<const std::uint32_t> spirv,
+                          const std::string& entry_point, const std::uint32_t push_constant_size,
+                          const kernel_specialization& specialization, const VkPipelineCache cache);
+
+    /// @cond
+    compute_pipeline_impl(const compute_pipeline_impl& other) = delete;
+    compute_pipeline_impl(compute_pipeline_impl&& other) = delete;
+    /// @endcond
+
+    /**
+     * @brief Destroy a compute_pipeline_impl.
+     * @details The pipeline is destroyed through the device's deletion_queue once every earlier submission completes.
+     */
+    ~compute_pipeline_impl() noexcept;
+
+    /// @cond
+    compute_pipeline_impl& operator=(const compute_pipeline_impl& rhs) = delete;
+    compute_pipeline_impl& operator=(compute_pipeline_impl&& rhs) = delete;
+    /// @endcond
+
+    /**
+     * @brief Retrieve the compute_pipeline_impl's underlying Vulkan handle.
+     * @return A valid VkPipeline.
+     */
+    handle_type handle() const;
+
+    /**
+     * @brief Retrieve the compute_pipeline_impl's parent object.
+     * @return A read-only reference to a device_impl.
+     */
+    const parent_type& parent() const;
+
+    /**
+     * @brief Retrieve the compute_pipeline_impl's pipeline layout.
+     * @return A valid VkPipelineLayout.
+     */
+    VkPipelineLayout layout() const;
+
+    /**
+     * @brief Retrieve the size of the compute_pipeline_impl's push constant block.
+     * @return The size of the push constant block in bytes.
+     */
+    std::uint32_t push_constant_size() const;
+
+    /**
+     * @brief Retrieve the compute_pipeline_impl's device-derived specialization constants.
+     * @return A read-only reference to a kernel_specialization. This is empty if the pipeline wasn't constructed with
+     *         one.
+     */
+    const kernel_specialization& specialization() const;
+  };
+
+  static_assert(megatech::vulkan::concepts::readonly_child_object<compute_pipeline_impl>);
+  static_assert(megatech::vulkan::concepts::handle_owner<compute_pipeline_impl>);
+
+}
+
+#endif
+/// @endcond
@@ -0,0 +1,211 @@
+/// @cond INTERNAL
+/**
+ * @file deletion_queue.hpp
+ * @brief Timeline-Deferred Resource Destruction
+ * @author Alexander Rothman <[gnomesort@megate.ch](mailto:gnomesort@megate.ch)>
+ * @copyright AGPL-3.0-or-later
+ * @date 2025
+ */
+#ifndef MEGATECH_VULKAN_INTERNAL_BASE_DELETION_QUEUE_HPP
+#define MEGATECH_VULKAN_INTERNAL_BASE_DELETION_QUEUE_HPP
+
+#include <cinttypes>
+#include <cstddef>
+
+#include <deque>
+#include <functional>
+#include <limits>
+#include <mutex>
+
+#include "vulkandefs.hpp"
+#include "memory_allocation.hpp"
+
+namespace megatech::vulkan::internal::base {
+
+  class device_impl;
+
+  /**
+   * @brief A queue of destructions deferred until the device finishes with the destroyed objects.
+   * @details Each destruction is keyed by a device timeline value. Destructions run in bulk once the device's
+   *          completed timeline value reaches their key, so destroying an object that may still be in use never
+   *          requires waiting for the device. Keys default to the device's current timeline value, which covers
+   *          every submission made so far. All methods are thread-safe.
+   */
+  class deletion_queue final {
+  public:
+    /**
+     * @brief The type of function that destroys a deferred object.
+     * @details Deleters run without any deletion_queue locks held and must not throw.
+     */
+    using deleter_type = std::function<void()>;
+
+    /**
+     * @brief The parent object type required to construct a deletion_queue.
+     */
+    using parent_type = device_impl;
+
+    /**
+     * @brief A key that is replaced by the device's current timeline value when an object is enqueued.
+     */
+    static constexpr std::uint64_t current_value{ std::numeric_limits<std::uint64_t>::max() };
+  private:
+    struct entry final {
+      std::uint64_t timeline_value{ };
+      deleter_type deleter{ };
+    };
+
+    const parent_type* m_parent{ };
+    mutable std::mutex m_mutex{ };
+    std::deque<entry> m_entries{ };
+
+    void wait_for(const std::uint64_t timeline_value) const noexcept;
+
+    template <typename Deleter>
+    void defer(Deleter deleter, const std::uint64_t timeline_value) noexcept {
+      try
+      {
+        enqueue(deleter, timeline_value);
+      }
+      catch (...)
+      {
+        // Enqueueing only fails when memory is exhausted. Waiting is the only other safe way to destroy the object.
+        wait_for(timeline_value);
+        deleter();
+      }
+    }
+  public:
+    /// @cond
+    deletion_queue() = delete;
+    /// @endcond
+
+    /**
+     * @brief Construct a deletion_queue.
+     * @param parent The device_impl that owns the destroyed objects. This must outlive the deletion_queue.
+     */
+    explicit deletion_queue(const parent_type& parent);
+
+    /// @cond
+    deletion_queue(const deletion_queue& other) = delete;
+    deletion_queue(deletion_queue&& other) = delete;
+    /// @endcond
+
+    /**
+     * @brief Destroy a deletion_queue.
+     * @details Every remaining destruction runs immediately. The device must be idle.
+     */
+    ~deletion_queue() noexcept;
+
+    /// @cond
+    deletion_queue& operator=(const deletion_queue& rhs) = delete;
+    deletion_queue& operator=(deletion_queue&& rhs) = delete;
+    /// @endcond
+
+    /**
+     * @brief Retrieve the deletion_queue's parent object.
+     * @return A read-only reference to a device_impl.
+     */
+    const parent_type& parent() const;
+
+    /**
+     * @brief Defer an arbitrary destruction.
+     * @param deleter The function that destroys the object. This must not be empty.
+     * @param timeline_value The device timeline value that must complete before the deleter runs.
+     */
+    void enqueue(deleter_type deleter, const std::uint64_t timeline_value = current_value);
+
+    /**
+     * @brief Defer the destruction of a buffer and its memory.
+     * @param buffer The buffer to destroy. It's reset to an empty buffer_allocation.
+     * @param timeline_value The device timeline value that must complete before the buffer is destroyed.
+     */
+    void destroy_buffer(buffer_allocation& buffer, const std::uint64_t timeline_value = current_value) noexcept;
+
+    /**
+     * @brief Defer the destruction of a buffer that doesn't own its memory.
+     * @param buffer The buffer to destroy.
+     * @param timeline_value The device timeline value that must complete before the buffer is destroyed.
+     */
+    void destroy_buffer(const VkBuffer buffer, const std::uint64_t timeline_value = current_value) noexcept;
+
+    /**
+     * @brief Defer the destruction of an image and its memory.
+     * @param image The image to destroy. It's reset to an empty image_allocation.
+     * @param timeline_value The device timeline value that must complete before the image is destroyed.
+     */
+    void destroy_image(image_allocation& image, const std::uint64_t timeline_value = current_value) noexcept;
+
+    /**
+     * @brief Defer the destruction of an image that doesn't own its memory.
+     * @param image The image to destroy.
+     * @param timeline_value The device timeline value that must complete before the image is destroyed.
+     */
+    void destroy_image(const VkImage image, const std::uint64_t timeline_value = current_value) noexcept;
+
+    /**
+     * @brief Defer freeing device memory.
+     * @param allocation The memory to free. It's reset to an empty memory_allocation.
+     * @param timeline_value The device timeline value that must complete before the memory is freed.
+     */
+    void free_memory(memory_allocation& allocation, const std::uint64_t timeline_value = current_value) noexcept;
+
+    /**
+     * @brief Defer the destruction of an image view.
+     * @param view The image view to destroy.
+     * @param timeline_value The device timeline value that must complete before the view is destroyed.
+     */
+    void destroy_image_view(const VkImageView view, const std::uint64_t timeline_value = current_value) noexcept;
+
+    /**
+     * @brief Defer the destruction of a pipeline.
+     * @param pipeline The pipeline to destroy.
+     * @param timeline_value The device timeline value that must complete before the pipeline is destroyed.
+     */
+    void destroy_pipeline(const VkPipeline pipeline, const std::uint64_t timeline_value = current_value) noexcept;
+
+    /**
+     * @brief Defer the destruction of a pipeline layout.
+     * @param layout The pipeline layout to destroy.
+     * @param timeline_value The device timeline value that must complete before the layout is destroyed.
+     */
+    void destroy_pipeline_layout(const VkPipelineLayout layout,
+                                 const std::uint64_t timeline_value = current_value) noexcept;
+
+    /**
+     * @brief Defer the destruction of a descriptor pool.
+     * @param pool The descriptor pool to destroy. Its descriptor sets are freed with it.
+     * @param timeline_value The device timeline value that must complete before the pool is destroyed.
+     */
+    void destroy_descriptor_pool(const VkDescriptorPool pool,
+                                 const std::uint64_t timeline_value = current_value) noexcept;
+
+    /**
+     * @brief Defer the destruction of a command pool.
+     * @param pool The command pool to destroy. Its command buffers are freed with it.
+     * @param timeline_value The device timeline value that must complete before the pool is destroyed.
+     */
+    void destroy_command_pool(const VkCommandPool pool, const std::uint64_t timeline_value = current_value) noexcept;
+
+    /**
+     * @brief Run every destruction whose timeline value has completed.
+     * @return The number of destructions that ran.
+     */
+    std::size_t collect();
+
+    /**
+     * @brief Run every destruction, regardless of its timeline value.
+     * @details The device must be idle.
+     * @return The number of destructions that ran.
+     */
+    std::size_t flush() noexcept;
+
+    /**
+     * @brief Retrieve the number of destructions waiting to run.
+     * @return The number of pending destructions.
+     */
+    std::size_t size() const;
+  };
+
+}
+
+#endif
+/// @endcond
@@ -0,0 +1,105 @@
+/// @cond INTERNAL
+/**
+ * @file device_buffer_impl.hpp
+ * @brief Device Buffer Implementation
+ * @author Alexander Rothman <[gnomesort@megate.ch](mailto:gnomesort@megate.ch)>
+ * @copyright AGPL-3.0-or-later
+ * @date 2025
+ */
+#ifndef MEGATECH_VULKAN_INTERNAL_BASE_DEVICE_BUFFER_IMPL_HPP
+#define MEGATECH_VULKAN_INTERNAL_BASE_DEVICE_BUFFER_IMPL_HPP
+
+#include <memory>
+
+#include "../../concepts/child_object.hpp"
+#include "../../concepts/handle_owner.hpp"
+
+#include "vulkandefs.hpp"
+#include "device_impl.hpp"
+#include "memory_allocation.hpp"
+
+namespace megatech::vulkan::internal::base {
+
+  /**
+   * @brief The implementation of a megatech::vulkan::device_buffer.
+   * @details device_buffer_impls are storage buffers that can be addressed from shaders through their device
+   *          address.
+   */
+  class device_buffer_impl final {
+  public:
+    /**
+     * @brief The type of Vulkan handle owned by a device_buffer_impl.
+     */
+    using handle_type = VkBuffer;
+
+    /**
+     * @brief The parent object type required to construct a device_buffer_impl.
+     */
+    using parent_type = device_impl;
+  private:
+    std::shared_ptr<const parent_type> m_parent{ };
+    buffer_allocation m_buffer{ };
+    VkDeviceAddress m_device_address{ };
+  public:
+    /// @cond
+    device_buffer_impl() = delete;
+    /// @endcond
+
+    /**
+     * @brief Construct a device_buffer_impl.
+     * @param parent A shared_ptr to a read-only device_impl. This must not be null.
+     * @param size The size of the buffer in bytes. This must be greater than 0.
+     * @param host_visible Whether or not the buffer must be mapped into host memory. Host-visible buffers are always
+     *                     host-coherent.
+     */
+    device_buffer_impl(const std::shared_ptr<const parent_type>& parent, const VkDeviceSize size,
+                       const bool host_visible);
+
+    /// @cond
+    device_buffer_impl(const device_buffer_impl& other) = delete;
+    device_buffer_impl(device_buffer_impl&& other) = delete;
+    /// @endcond
+
+    /**
+     * @brief Destroy a device_buffer_impl.
+     * @details The buffer is destroyed through the device's deletion_queue once every earlier submission completes.
+     */
+    ~device_buffer_impl() noexcept;
+
+    /// @cond
+    device_buffer_impl& operator=(const device_buffer_impl& rhs) = delete;
+    device_buffer_impl& operator=(device_buffer_impl&& rhs) = delete;
+    /// @endcond
+
+    /**
+     * @brief Retrieve the device_buffer_impl's underlying Vulkan handle.
+     * @return A valid VkBuffer.
+     */
+    handle_type handle() const;
+
+    /**
+     * @brief Retrieve the device_buffer_impl's parent object.
+     * @return A read-only reference to a device_impl.
+     */
+    const parent_type& parent() const;
+
+    /**
+     * @brief Retrieve the device_buffer_impl's buffer and memory.
+     * @return A read-only reference to a buffer_allocation.
+     */
+    const buffer_allocation& allocation() const;
+
+    /**
+     * @brief Retrieve the device_buffer_impl's device address.
+     * @return A VkDeviceAddress that shaders can use to access the buffer.
+     */
+    VkDeviceAddress device_address() const;
+  };
+
+  static_assert(megatech::vulkan::concepts::readonly_child_object<device_buffer_impl>);
+  static_assert(megatech::vulkan::concepts::handle_owner<device_buffer_impl>);
+
+}
+
+#endif
+/// @endcond
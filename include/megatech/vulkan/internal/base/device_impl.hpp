@@ -9,8 +9,18 @@
 #ifndef MEGATECH_VULKAN_INTERNAL_BASE_DEVICE_IMPL_HPP
 #define MEGATECH_VULKAN_INTERNAL_BASE_DEVICE_IMPL_HPP
 
+#include <cinttypes>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <span>
 #include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include <megatech/vulkan/dispatch/tables.hpp>
 
@@ -20,10 +30,73 @@
 #include "../../concepts/handle_owner.hpp"
 
 #include "vulkandefs.hpp"
+#include "memory_allocation.hpp"
+#include "residency_manager.hpp"
+#include "deletion_queue.hpp"
+#include "sync_object_pool.hpp"
 
 namespace megatech::vulkan::internal::base {
 
   class physical_device_description_impl;
+  struct format_feature_flags;
+  class compute_pipeline_cache;
+
+  /**
+   * @brief The kinds of queue owned by a device_impl.
+   * @details Devices that lack a dedicated asynchronous queue family alias that queue to the primary queue. The sparse
+   *          binding queue aliases whichever earlier queue shares its family.
+   */
+  enum class queue_type {
+    /**
+     * @brief The general purpose graphics and compute queue.
+     */
+    primary,
+    /**
+     * @brief The asynchronous compute queue.
+     */
+    async_compute,
+    /**
+     * @brief The asynchronous transfer queue.
+     */
+    async_transfer,
+    /**
+     * @brief The queue that sparse memory binding operations are submitted to.
+     */
+    sparse_binding
+  };
+
+  /**
+   * @brief Device extensions that a device_impl enables whenever they're available.
+   * @details Each extension's features are enabled along with it. Higher layers can check
+   *          device_impl::has_optional_extension() to select faster code paths.
+   */
+  enum class optional_extension {
+    /**
+     * @brief VK_EXT_memory_priority, which allows allocations to be prioritized for residency.
+     */
+    memory_priority,
+    /**
+     * @brief VK_EXT_pageable_device_local_memory, which allows the driver to page device-local memory out under
+     *        pressure. This requires memory_priority.
+     */
+    pageable_device_local_memory,
+    /**
+     * @brief VK_KHR_maintenance5.
+     */
+    maintenance5,
+    /**
+     * @brief VK_KHR_maintenance6.
+     */
+    maintenance6,
+    /**
+     * @brief VK_EXT_descriptor_buffer, without capture and replay support.
+     */
+    descriptor_buffer,
+    /**
+     * @brief VK_KHR_pipeline_binary. This requires maintenance5.
+     */
+    pipeline_binary
+  };
 
   /**
    * @brief The implementation of a megatech::vulkan::device.
@@ -40,11 +113,48 @@ namespace megatech::vulkan::internal::base {
      */
     using parent_type = physical_device_description_impl;
   private:
+    struct queue_state final {
+      VkQueue queue{ };
+      std::uint32_t family_index{ };
+      VkSemaphore timeline{ };
+      std::uint64_t last_submitted{ };
+      std::mutex mutex{ };
+    };
+
     std::unique_ptr<dispatch::device::table> m_ddt{ };
     std::shared_ptr<const parent_type> m_parent{ };
-    VkQueue m_primary_queue{ };
-    VkQueue m_async_compute_queue{ };
-    VkQueue m_async_transfer_queue{ };
+    std::vector<std::shared_ptr<const parent_type>> m_physical_devices{ };
+    mutable std::array<queue_state, 4> m_queues{ };
+    std::array<std::size_t, 4> m_queue_slots{ };
+    bool m_sparse_binding{ };
+    mutable std::atomic<std::uint64_t> m_timeline_value{ 0 };
+    std::unordered_set<std::string> m_enabled_extensions{ };
+    bool m_fence_sync_fd{ };
+    bool m_semaphore_sync_fd{ };
+    std::uint32_t m_optional_extensions{ };
+    mutable std::mutex m_memory_budget_mutex{ };
+    mutable VkPhysicalDeviceMemoryBudgetPropertiesEXT m_memory_budget{ };
+    mutable std::chrono::steady_clock::time_point m_memory_budget_timestamp{ };
+    std::chrono::steady_clock::duration m_memory_budget_refresh_interval{ std::chrono::milliseconds{ 100 } };
+    mutable std::array<std::atomic<VkDeviceSize>, VK_MAX_MEMORY_HEAPS> m_allocated_bytes{ };
+    std::unique_ptr<residency_manager> m_residency{ };
+    std::unique_ptr<deletion_queue> m_deletions{ };
+    std::unique_ptr<fence_pool> m_fences{ };
+    std::unique_ptr<semaphore_pool> m_semaphores{ };
+    std::unique_ptr<event_pool> m_events{ };
+    std::unique_ptr<compute_pipeline_cache> m_pipelines{ };
+
+    void destroy() noexcept;
+    void query_memory_budget() const;
+    queue_state& state(const queue_type type) const;
+    VkResult try_allocate_memory(const VkMemoryAllocateInfo& allocate_info, VkDeviceMemory& memory) const;
+    memory_allocation allocate_selected_memory(const VkMemoryRequirements& requirements,
+                                               const std::function<std::int64_t(std::uint32_t)>& select,
+                                               const void* next) const;
+    buffer_allocation create_selected_buffer(const VkDeviceSize size, const VkBufferUsageFlags usage,
+                                             const std::function<std::int64_t(std::uint32_t)>& select) const;
+    image_allocation create_selected_image(const VkImageCreateInfo& image_info,
+                                           const std::function<std::int64_t(std::uint32_t)>& select) const;
   public:
     /// @cond
     device_impl() = delete;
@@ -56,6 +166,15 @@ namespace megatech::vulkan::internal::base {
      */
     device_impl(const std::shared_ptr<const parent_type>& parent);
 
+    /**
+     * @brief Construct a device_impl that drives a physical device group.
+     * @details The first member of the group is the device_impl's parent. Its requirements are used to configure the
+     *          whole group.
+     * @param group An array of shared_ptrs to read-only physical_device_description_impls. This must contain between
+     *              1 and 32 non-null members that belong to the same instance and were reported as one group.
+     */
+    explicit device_impl(const std::vector<std::shared_ptr<const parent_type>>& group);
+
     /// @cond
     device_impl(const device_impl& other) = delete;
     device_impl(device_impl&& other) = delete;
@@ -89,11 +208,379 @@ namespace megatech::vulkan::internal::base {
      */
     const parent_type& parent() const;
 
+    /**
+     * @brief Retrieve the number of physical devices driven by the device_impl.
+     * @return The size of the device_impl's physical device group. This is 1 for devices not created from a group.
+     */
+    std::uint32_t physical_device_count() const;
+
+    /**
+     * @brief Retrieve a device mask that selects every physical device driven by the device_impl.
+     * @details Device masks select the physical devices that execute a command buffer (see
+     *          VkCommandBufferSubmitInfo::deviceMask and vkCmdSetDeviceMask). Alternate frame rendering submits with
+     *          one bit per frame, while split frame rendering submits with this mask and restricts the rendering
+     *          area of each device.
+     * @return A bitmask where bit i is set for the physical device at index i.
+     */
+    std::uint32_t device_mask() const;
+
     /**
      * @brief Retrieve the device_impl's set of enabled extensions.
      * @return A read-only reference to a set of extensions.
      */
     const std::unordered_set<std::string>& enabled_extensions() const;
+
+    /**
+     * @brief Retrieve the features that a device_impl supports for a format.
+     * @details This is the parent's format table, except that formats belonging to extensions that the device_impl
+     *          didn't enable are unsupported.
+     * @param format The format to look up.
+     * @return A read-only reference to the format's features. Every flag is clear if the format is unsupported or
+     *         unknown.
+     */
+    const format_feature_flags& format_features(const VkFormat format) const;
+
+    /**
+     * @brief Determine whether or not a device_impl supports a set of image format features.
+     * @param format The format to check.
+     * @param tiling The tiling of the image. This must be VK_IMAGE_TILING_LINEAR or VK_IMAGE_TILING_OPTIMAL.
+     * @param features The features that the format must support (e.g., VK_FORMAT_FEATURE_2_STORAGE_IMAGE_BIT).
+     * @return True if every feature is supported. False otherwise.
+     */
+    bool has_format_features(const VkFormat format, const VkImageTiling tiling,
+                             const VkFormatFeatureFlags2 features) const;
+
+    /**
+     * @brief Determine whether or not a device_impl supports a set of buffer format features.
+     * @param format The format to check.
+     * @param features The features that the format must support (e.g., VK_FORMAT_FEATURE_2_VERTEX_BUFFER_BIT).
+     * @return True if every feature is supported. False otherwise.
+     */
+    bool has_buffer_format_features(const VkFormat format, const VkFormatFeatureFlags2 features) const;
+
+    /**
+     * @brief Determine whether or not the device_impl's memory budget is reported by the driver.
+     * @return True if VK_EXT_memory_budget is enabled. False if the budget is estimated.
+     */
+    bool has_memory_budget() const;
+
+    /**
+     * @brief Determine whether or not the device_impl enabled an optional extension.
+     * @details Optional extensions never affect device selection. Extensions that the physical device description
+     *          requires aren't reported here, since their features are configured by the description instead. Check
+     *          enabled_extensions() for those.
+     * @param extension The optional extension to check.
+     * @return True if the extension and its features are enabled. False otherwise.
+     */
+    bool has_optional_extension(const optional_extension extension) const;
+
+    /**
+     * @brief Determine whether or not the device_impl's fences can be exported as Linux sync files.
+     * @details This requires VK_KHR_external_fence_fd and driver support for
+     *          VK_EXTERNAL_FENCE_HANDLE_TYPE_SYNC_FD_BIT. When it's true, every fence created by fences() is
+     *          exportable.
+     * @return True if fences can be exported as sync files. False otherwise.
+     */
+    bool can_export_fence_sync_fd() const;
+
+    /**
+     * @brief Determine whether or not the device_impl's binary semaphores can be exported as Linux sync files.
+     * @details This requires VK_KHR_external_semaphore_fd and driver support for
+     *          VK_EXTERNAL_SEMAPHORE_HANDLE_TYPE_SYNC_FD_BIT. When it's true, every binary semaphore created by
+     *          semaphores() is exportable.
+     * @return True if binary semaphores can be exported as sync files. False otherwise.
+     */
+    bool can_export_semaphore_sync_fd() const;
+
+    /**
+     * @brief Export a fence as a Linux sync file.
+     * @details Sync files have copy semantics, so exporting resets the fence. The sync file becomes readable once the
+     *          fence's pending signal operation completes.
+     * @param fence An exportable fence that is signaled or has a pending signal operation.
+     * @return A sync file descriptor that the caller owns, or -1 if the fence was already signaled.
+     * @throw error If fences can't be exported or the export fails.
+     */
+    int export_sync_fd(const VkFence fence) const;
+
+    /**
+     * @brief Export a binary semaphore as a Linux sync file.
+     * @details Sync files have copy semantics, so exporting has the same effect on the semaphore as waiting on it.
+     * @param semaphore An exportable binary semaphore that has a pending signal operation.
+     * @return A sync file descriptor that the caller owns, or -1 if the semaphore was already signaled.
+     * @throw error If binary semaphores can't be exported or the export fails.
+     */
+    int export_sync_fd(const VkSemaphore semaphore) const;
+
+    /**
+     * @brief Export the completion of a device timeline value as a Linux sync file.
+     * @details Timeline semaphores can't be exported as sync files, so this submits an empty batch to the primary
+     *          queue that waits for the value and signals a pooled fence, and then exports the fence.
+     * @param value The timeline value to export. This must not exceed current_timeline_value().
+     * @return A sync file descriptor that the caller owns, or -1 if the value has already completed.
+     * @throw error If fences can't be exported, the value hasn't been submitted, or the export fails.
+     */
+    int export_sync_fd(const std::uint64_t value) const;
+
+    /**
+     * @brief Retrieve a snapshot of the device_impl's per-heap memory budget and usage.
+     * @details The snapshot is cached and only requeried once it is older than the refresh interval. Heap indices
+     *          match the indices of parent().memory_properties().memoryHeaps. When VK_EXT_memory_budget isn't
+     *          enabled, the budget of each heap is estimated as a fraction of its size. This method is thread-safe.
+     * @return A copy of the current VkPhysicalDeviceMemoryBudgetPropertiesEXT snapshot. The pNext member is always
+     *         nullptr.
+     */
+    VkPhysicalDeviceMemoryBudgetPropertiesEXT memory_budget() const;
+
+    /**
+     * @brief Requery and retrieve the device_impl's per-heap memory budget and usage.
+     * @details This behaves like memory_budget(), except that the cached snapshot is always refreshed. This method
+     *          is thread-safe.
+     * @return A copy of the refreshed VkPhysicalDeviceMemoryBudgetPropertiesEXT snapshot. The pNext member is always
+     *         nullptr.
+     */
+    VkPhysicalDeviceMemoryBudgetPropertiesEXT refresh_memory_budget() const;
+
+    /**
+     * @brief Set the maximum age of the device_impl's cached memory budget snapshot.
+     * @param interval The new refresh interval. A zero interval causes every call to memory_budget() to requery
+     *                 the driver.
+     */
+    void set_memory_budget_refresh_interval(const std::chrono::nanoseconds interval);
+
+    /**
+     * @brief Retrieve one of the device_impl's queues.
+     * @details The returned queue requires external synchronization. Prefer submit() where possible.
+     * @param type The kind of queue to retrieve.
+     * @return A valid VkQueue. Asynchronous queues that don't exist alias the primary queue.
+     */
+    VkQueue queue(const queue_type type) const;
+
+    /**
+     * @brief Retrieve the queue family index of one of the device_impl's queues.
+     * @param type The kind of queue to query.
+     * @return The queue family index of the (possibly aliased) queue.
+     */
+    std::uint32_t queue_family_index(const queue_type type) const;
+
+    /**
+     * @brief Retrieve the timeline semaphore signaled by submissions to one of the device_impl's queues.
+     * @param type The kind of queue to query.
+     * @return A valid VkSemaphore with the VK_SEMAPHORE_TYPE_TIMELINE type.
+     */
+    VkSemaphore timeline_semaphore(const queue_type type) const;
+
+    /**
+     * @brief Submit work to one of the device_impl's queues.
+     * @details Every submission is assigned a value from a single device-wide timeline. Each queue's timeline
+     *          semaphore is signaled with that value when the submission completes, in addition to any signals passed
+     *          by the caller. This method is thread-safe.
+     * @param type The kind of queue to submit to.
+     * @param command_buffers The command buffers to execute. This may be empty.
+     * @param waits Semaphores to wait on before execution.
+     * @param signals Additional semaphores to signal after execution.
+     * @param fence An optional fence to signal after execution.
+     * @return The timeline value assigned to the submission.
+     * @throw error If a device mask or device index doesn't select a physical device driven by the device_impl, or
+     *              if the submission fails.
+     */
+    std::uint64_t submit(const queue_type type, const std::span<const VkCommandBufferSubmitInfo> command_buffers,
+                         const std::span<const VkSemaphoreSubmitInfo> waits = { },
+                         const std::span<const VkSemaphoreSubmitInfo> signals = { },
+                         const VkFence fence = VK_NULL_HANDLE) const;
+
+    /**
+     * @brief Determine whether or not the device_impl can bind sparse memory.
+     * @return True if the sparseBinding feature is enabled and a queue family supports sparse binding. False
+     *         otherwise.
+     */
+    bool has_sparse_binding() const;
+
+    /**
+     * @brief Bind or unbind sparse resource memory.
+     * @details Every bind is submitted to the sparse binding queue in a single vkQueueBindSparse call. Like submit(),
+     *          the operation is assigned a value from the device-wide timeline and signals the sparse binding queue's
+     *          timeline semaphore with it. Work that uses the new bindings must wait for that value. This method is
+     *          thread-safe.
+     * @param buffers Buffer memory binds.
+     * @param opaque_images Opaque image memory binds, such as mip tail binds.
+     * @param images Image memory binds.
+     * @param wait_value A device timeline value to wait for before binding, or 0 to bind immediately. This must not
+     *                   exceed current_timeline_value(). Memory that is unbound or rebound must not be in use after it.
+     * @return The timeline value assigned to the operation.
+     * @throw error If the device_impl can't bind sparse memory, if the wait value hasn't been submitted, or if the
+     *              operation fails.
+     */
+    std::uint64_t bind_sparse(const std::span<const VkSparseBufferMemoryBindInfo> buffers,
+                              const std::span<const VkSparseImageOpaqueMemoryBindInfo> opaque_images,
+                              const std::span<const VkSparseImageMemoryBindInfo> images,
+                              const std::uint64_t wait_value = 0) const;
+
+    /**
+     * @brief Retrieve the timeline value assigned to the most recent submission.
+     * @return The most recently assigned timeline value. 0 if nothing has been submitted.
+     */
+    std::uint64_t current_timeline_value() const;
+
+    /**
+     * @brief Retrieve the greatest timeline value at which every earlier submission has completed.
+     * @details Work is considered complete on every queue, so this value never exceeds current_timeline_value().
+     * @return A conservative completed timeline value.
+     */
+    std::uint64_t completed_timeline_value() const;
+
+    /**
+     * @brief Retrieve the queue timeline semaphore values that a timeline value completes at.
+     * @details A timeline value is complete once every returned semaphore reaches its paired value. Callers that
+     *          wait on many timeline values at once can use these to build a single vkWaitSemaphores call.
+     * @param value The timeline value to query. This must not exceed current_timeline_value().
+     * @return A list of timeline semaphores, one per distinct queue, paired with the values to wait for.
+     * @throw error If the value hasn't been submitted.
+     */
+    std::vector<std::pair<VkSemaphore, std::uint64_t>> timeline_targets(const std::uint64_t value) const;
+
+    /**
+     * @brief Wait for every submission at or before a timeline value to complete.
+     * @param value The timeline value to wait for. This must not exceed current_timeline_value().
+     * @param timeout The maximum time to wait.
+     * @return True if the submissions completed. False if the wait timed out.
+     * @throw error If the value hasn't been submitted or if the wait fails.
+     */
+    bool wait_for_timeline_value(const std::uint64_t value,
+                                 const std::chrono::nanoseconds timeout = std::chrono::nanoseconds::max()) const;
+
+    /**
+     * @brief Allocate device memory.
+     * @details Allocations that would push their heap past the residency pressure threshold first ask the
+     *          residency_manager to release memory. If the driver still reports VK_ERROR_OUT_OF_DEVICE_MEMORY, the
+     *          allocation is retried after eviction and, when device-local memory is only preferred, in host-visible
+     *          memory. Host-visible allocations are persistently mapped. This method is thread-safe.
+     * @param requirements The memory requirements of the resource to allocate memory for.
+     * @param required A set of memory property flags that the allocation must have.
+     * @param preferred A set of memory property flags that the allocation should have, if possible.
+     * @param next An optional pNext chain to append to the VkMemoryAllocateInfo.
+     * @return A memory_allocation describing the new memory.
+     * @throw error If no suitable memory type exists or if the allocation can't be satisfied.
+     */
+    memory_allocation allocate_memory(const VkMemoryRequirements& requirements, const VkMemoryPropertyFlags required,
+                                      const VkMemoryPropertyFlags preferred, const void* next = nullptr) const;
+
+    /**
+     * @brief Allocate device memory for a memory_usage.
+     * @details This behaves like the flag-based overload, except that memory types are resolved through the
+     *          physical device's precomputed memory_usage table.
+     * @param requirements The memory requirements of the resource to allocate memory for.
+     * @param usage The way in which the memory will be accessed.
+     * @param next An optional pNext chain to append to the VkMemoryAllocateInfo.
+     * @return A memory_allocation describing the new memory.
+     * @throw error If no suitable memory type exists or if the allocation can't be satisfied.
+     */
+    memory_allocation allocate_memory(const VkMemoryRequirements& requirements, const memory_usage usage,
+                                      const void* next = nullptr) const;
+
+    /**
+     * @brief Free device memory allocated by allocate_memory().
+     * @param allocation The allocation to free. Its memory member is reset to VK_NULL_HANDLE.
+     */
+    void free_memory(memory_allocation& allocation) const noexcept;
+
+    /**
+     * @brief Create a buffer and bind it to newly allocated memory.
+     * @param size The size of the buffer in bytes.
+     * @param usage The buffer's usage flags.
+     * @param required A set of memory property flags that the buffer's memory must have.
+     * @param preferred A set of memory property flags that the buffer's memory should have, if possible.
+     * @return A buffer_allocation describing the new buffer and its memory.
+     * @throw error If the buffer can't be created or its memory can't be allocated.
+     */
+    buffer_allocation create_buffer(const VkDeviceSize size, const VkBufferUsageFlags usage,
+                                    const VkMemoryPropertyFlags required, const VkMemoryPropertyFlags preferred) const;
+
+    /**
+     * @brief Create a buffer and bind it to newly allocated memory for a memory_usage.
+     * @param size The size of the buffer in bytes.
+     * @param usage The buffer's usage flags.
+     * @param memory The way in which the buffer's memory will be accessed.
+     * @return A buffer_allocation describing the new buffer and its memory.
+     * @throw error If the buffer can't be created or its memory can't be allocated.
+     */
+    buffer_allocation create_buffer(const VkDeviceSize size, const VkBufferUsageFlags usage,
+                                    const memory_usage memory) const;
+
+    /**
+     * @brief Destroy a buffer created by create_buffer() and free its memory.
+     * @param buffer The buffer to destroy. Its buffer member is reset to VK_NULL_HANDLE.
+     */
+    void destroy_buffer(buffer_allocation& buffer) const noexcept;
+
+    /**
+     * @brief Create an image and bind it to newly allocated memory.
+     * @param image_info A description of the image to create.
+     * @param required A set of memory property flags that the image's memory must have.
+     * @param preferred A set of memory property flags that the image's memory should have, if possible.
+     * @return An image_allocation describing the new image and its memory.
+     * @throw error If the image can't be created or its memory can't be allocated.
+     */
+    image_allocation create_image(const VkImageCreateInfo& image_info, const VkMemoryPropertyFlags required,
+                                  const VkMemoryPropertyFlags preferred) const;
+
+    /**
+     * @brief Create an image and bind it to newly allocated memory for a memory_usage.
+     * @param image_info A description of the image to create.
+     * @param memory The way in which the image's memory will be accessed.
+     * @return An image_allocation describing the new image and its memory.
+     * @throw error If the image can't be created or its memory can't be allocated.
+     */
+    image_allocation create_image(const VkImageCreateInfo& image_info, const memory_usage memory) const;
+
+    /**
+     * @brief Destroy an image created by create_image() and free its memory.
+     * @param image The image to destroy. Its image member is reset to VK_NULL_HANDLE.
+     */
+    void destroy_image(image_allocation& image) const noexcept;
+
+    /**
+     * @brief Retrieve the number of bytes allocated through the device_impl in a memory heap.
+     * @param heap_index The index of the heap.
+     * @return The total size of all live allocations in the heap.
+     */
+    VkDeviceSize allocated_bytes(const std::uint32_t heap_index) const;
+
+    /**
+     * @brief Retrieve the device_impl's residency_manager.
+     * @return A reference to a residency_manager.
+     */
+    residency_manager& residency() const;
+
+    /**
+     * @brief Retrieve the device_impl's deletion_queue.
+     * @details Completed destructions are collected opportunistically after each submission.
+     * @return A reference to a deletion_queue.
+     */
+    deletion_queue& deletions() const;
+
+    /**
+     * @brief Retrieve the device_impl's fence_pool.
+     * @return A reference to a fence_pool.
+     */
+    fence_pool& fences() const;
+
+    /**
+     * @brief Retrieve the device_impl's pool of binary semaphores.
+     * @return A reference to a semaphore_pool.
+     */
+    semaphore_pool& semaphores() const;
+
+    /**
+     * @brief Retrieve the device_impl's event_pool.
+     * @return A reference to an event_pool.
+     */
+    event_pool& events() const;
+
+    /**
+     * @brief Retrieve the device_impl's cache of specialized compute pipelines.
+     * @return A reference to a compute_pipeline_cache.
+     */
+    compute_pipeline_cache& pipelines() const;
   };
 
   static_assert(megatech::vulkan::concepts::readonly_child_object<device_impl>);
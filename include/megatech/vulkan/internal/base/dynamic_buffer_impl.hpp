@@ -0,0 +1,151 @@
+/// @cond INTERNAL
+/**
+ * @file dynamic_buffer_impl.hpp
+ * @brief Dynamic Buffer Implementation
+ * @author Alexander Rothman <[gnomesort@megate.ch](mailto:gnomesort@megate.ch)>
+ * @copyright AGPL-3.0-or-later
+ * @date 2025
+ */
+#ifndef MEGATECH_VULKAN_INTERNAL_BASE_DYNAMIC_BUFFER_IMPL_HPP
+#define MEGATECH_VULKAN_INTERNAL_BASE_DYNAMIC_BUFFER_IMPL_HPP
+
+#include <cinttypes>
+#include <cstddef>
+
+#include <memory>
+#include <mutex>
+#include <span>
+
+#include "../../concepts/child_object.hpp"
+#include "../../concepts/handle_owner.hpp"
+
+#include "vulkandefs.hpp"
+#include "device_impl.hpp"
+#include "memory_allocation.hpp"
+#include "command_buffer_pool.hpp"
+
+namespace megatech::vulkan::internal::base {
+
+  /**
+   * @brief The implementation of a megatech::vulkan::dynamic_buffer.
+   * @details dynamic_buffer_impls are device-local storage buffers that the host writes every frame. When the device
+   *          has host-visible device-local memory (see
+   *          physical_device_description_impl::host_visible_device_local_heap_index()), the buffer is allocated there
+   *          and persistently mapped, so host writes reach video memory directly. Otherwise, or if that heap is
+   *          exhausted, the host writes a persistently mapped staging buffer, and flush() copies the written range on
+   *          the asynchronous compute queue.
+   */
+  class dynamic_buffer_impl final {
+  public:
+    /**
+     * @brief The type of Vulkan handle owned by a dynamic_buffer_impl.
+     */
+    using handle_type = VkBuffer;
+
+    /**
+     * @brief The parent object type required to construct a dynamic_buffer_impl.
+     */
+    using parent_type = device_impl;
+  private:
+    std::shared_ptr<const parent_type> m_parent{ };
+    buffer_allocation m_buffer{ };
+    buffer_allocation m_staging{ };
+    VkDeviceAddress m_device_address{ };
+    std::mutex m_mutex{ };
+    std::unique_ptr<command_buffer_pool> m_commands{ };
+  public:
+    /// @cond
+    dynamic_buffer_impl() = delete;
+    /// @endcond
+
+    /**
+     * @brief Construct a dynamic_buffer_impl.
+     * @param parent A shared_ptr to a read-only device_impl. This must not be null.
+     * @param size The size of the buffer in bytes. This must be greater than 0.
+     */
+    dynamic_buffer_impl(const std::shared_ptr<const parent_type>& parent, const VkDeviceSize size);
+
+    /// @cond
+    dynamic_buffer_impl(const dynamic_buffer_impl& other) = delete;
+    dynamic_buffer_impl(dynamic_buffer_impl&& other) = delete;
+    /// @endcond
+
+    /**
+     * @brief Destroy a dynamic_buffer_impl.
+     * @details The buffers are destroyed through the device's deletion_queue once every earlier submission completes.
+     */
+    ~dynamic_buffer_impl() noexcept;
+
+    /// @cond
+    dynamic_buffer_impl& operator=(const dynamic_buffer_impl& rhs) = delete;
+    dynamic_buffer_impl& operator=(dynamic_buffer_impl&& rhs) = delete;
+    /// @endcond
+
+    /**
+     * @brief Retrieve the dynamic_buffer_impl's underlying Vulkan handle.
+     * @return A valid VkBuffer. This is the buffer that the device reads, not the staging buffer.
+     */
+    handle_type handle() const;
+
+    /**
+     * @brief Retrieve the dynamic_buffer_impl's parent object.
+     * @return A read-only reference to a device_impl.
+     */
+    const parent_type& parent() const;
+
+    /**
+     * @brief Retrieve a sharable reference to the dynamic_buffer_impl's parent object.
+     * @return A shared_ptr to a read-only device_impl.
+     */
+    std::shared_ptr<const parent_type> share_parent() const;
+
+    /**
+     * @brief Retrieve the dynamic_buffer_impl's buffer and memory.
+     * @return A read-only reference to a buffer_allocation.
+     */
+    const buffer_allocation& allocation() const;
+
+    /**
+     * @brief Retrieve the dynamic_buffer_impl's staging buffer and memory.
+     * @return A read-only reference to a buffer_allocation. Its buffer is VK_NULL_HANDLE if is_direct() is true.
+     */
+    const buffer_allocation& staging() const;
+
+    /**
+     * @brief Retrieve the dynamic_buffer_impl's device address.
+     * @return A VkDeviceAddress that shaders can use to access the buffer.
+     */
+    VkDeviceAddress device_address() const;
+
+    /**
+     * @brief Determine whether or not host writes go directly to the device-local buffer.
+     * @return True if the buffer is host-visible. False if writes are staged.
+     */
+    bool is_direct() const;
+
+    /**
+     * @brief Retrieve the memory that the host writes.
+     * @return A view of the persistently mapped buffer or staging buffer.
+     */
+    std::span<std::byte> data() const;
+
+    /**
+     * @brief Make host writes to a range of the buffer available to the device.
+     * @details Direct buffers are host-coherent, so nothing is submitted. Staged buffers copy the range and then
+     *          make it visible to every later command submitted to the asynchronous compute queue. This method is
+     *          thread-safe.
+     * @param offset The offset of the range in bytes.
+     * @param size The size of the range in bytes.
+     * @return The device timeline value of the copy, or 0 if nothing was submitted.
+     * @throw error If the range exceeds the buffer.
+     */
+    std::uint64_t flush(const VkDeviceSize offset, const VkDeviceSize size);
+  };
+
+  static_assert(megatech::vulkan::concepts::readonly_child_object<dynamic_buffer_impl>);
+  static_assert(megatech::vulkan::concepts::handle_owner<dynamic_buffer_impl>);
+
+}
+
+#endif
+/// @endcond
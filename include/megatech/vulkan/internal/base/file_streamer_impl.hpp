@@ -0,0 +1,194 @@
+/// @cond INTERNAL
+/**
+ * @file file_streamer_impl.hpp
+ * @brief File Streamer Implementation
+ * @author Alexander Rothman <[gnomesort@megate.ch](mailto:gnomesort@megate.ch)>
+ * @copyright AGPL-3.0-or-later
+ * @date 2025
+ */
+#ifndef MEGATECH_VULKAN_INTERNAL_BASE_FILE_STREAMER_IMPL_HPP
+#define MEGATECH_VULKAN_INTERNAL_BASE_FILE_STREAMER_IMPL_HPP
+
+#include <cinttypes>
+#include <cstddef>
+
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../../concepts/child_object.hpp"
+
+#include "vulkandefs.hpp"
+#include "device_impl.hpp"
+#include "memory_allocation.hpp"
+#include "command_buffer_pool.hpp"
+
+namespace megatech::vulkan::internal::base {
+
+  class device_buffer_impl;
+
+  /**
+   * @brief The implementation of a megatech::vulkan::file_streamer.
+   * @details file_streamer_impls own a persistently mapped staging buffer that is used as a ring. Each read is split
+   *          into chunks that are reserved from the ring and read directly into it, so file data is never copied on
+   *          the host. On Linux, reads are submitted to an io_uring and complete in the background. If io_uring isn't
+   *          available (e.g., because it's disabled by a sandbox), reads fall back to pread() on the calling thread.
+   *
+   *          submit() collects the chunks whose reads have completed and copies them to their destinations on the
+   *          asynchronous transfer queue in a single submission. When that queue belongs to a different family than
+   *          the asynchronous compute queue, ownership of the destination ranges is transferred to the compute
+   *          family. Staging memory is reused once the copies complete.
+   */
+  class file_streamer_impl final {
+  public:
+    /**
+     * @brief The parent object type required to construct a file_streamer_impl.
+     */
+    using parent_type = device_impl;
+  private:
+    struct io_ring;
+
+    struct chunk final {
+      std::uint64_t id{ };
+      int fd{ -1 };
+      std::uint64_t file_offset{ };
+      std::shared_ptr<const device_buffer_impl> destination{ };
+      VkDeviceSize destination_offset{ };
+      VkDeviceSize staging_offset{ };
+      VkDeviceSize size{ };
+      VkDeviceSize completed{ };
+      bool is_read{ };
+      bool is_failed{ };
+      std::uint64_t timeline_value{ };
+    };
+
+    std::shared_ptr<const parent_type> m_parent{ };
+    buffer_allocation m_staging{ };
+    VkDeviceSize m_chunk_size{ };
+    std::uint32_t m_queue_depth{ };
+    std::unique_ptr<io_ring> m_ring{ };
+    std::unique_ptr<command_buffer_pool> m_transfer{ };
+    std::unique_ptr<command_buffer_pool> m_acquire{ };
+    mutable std::mutex m_mutex{ };
+    std::unordered_map<std::string, int> m_files{ };
+    std::deque<chunk> m_chunks{ };
+    std::uint64_t m_next_id{ };
+    VkDeviceSize m_head{ };
+    std::uint32_t m_in_flight{ };
+    std::uint32_t m_unsubmitted{ };
+    std::uint64_t m_last_value{ };
+    std::vector<std::string> m_failures{ };
+
+    void destroy() noexcept;
+    int open_file(const std::filesystem::path& path);
+    bool reserve(const VkDeviceSize size, VkDeviceSize& offset);
+    void reclaim();
+    void issue(chunk& current);
+    void complete(const std::uint64_t id, const std::int64_t result);
+    void reap(const bool wait);
+    std::uint64_t submit_locked();
+  public:
+    /// @cond
+    file_streamer_impl() = delete;
+    /// @endcond
+
+    /**
+     * @brief Construct a file_streamer_impl.
+     * @param parent A shared_ptr to a read-only device_impl. This must not be null.
+     * @param staging_capacity The size of the staging ring in bytes. This must be at least 4.
+     * @param queue_depth The maximum number of reads in flight at once. This must be greater than 0.
+     * @throw error If the system isn't Linux or if the staging buffer can't be allocated.
+     */
+    file_streamer_impl(const std::shared_ptr<const parent_type>& parent, const VkDeviceSize staging_capacity,
+                       const std::uint32_t queue_depth);
+
+    /// @cond
+    file_streamer_impl(const file_streamer_impl& other) = delete;
+    file_streamer_impl(file_streamer_impl&& other) = delete;
+    /// @endcond
+
+    /**
+     * @brief Destroy a file_streamer_impl.
+     * @details Reads in flight are waited for. The staging buffer is destroyed through the device's deletion_queue.
+     */
+    ~file_streamer_impl() noexcept;
+
+    /// @cond
+    file_streamer_impl& operator=(const file_streamer_impl& rhs) = delete;
+    file_streamer_impl& operator=(file_streamer_impl&& rhs) = delete;
+    /// @endcond
+
+    /**
+     * @brief Retrieve the file_streamer_impl's parent object.
+     * @return A read-only reference to a device_impl.
+     */
+    const parent_type& parent() const;
+
+    /**
+     * @brief Retrieve a sharable reference to the file_streamer_impl's parent object.
+     * @return A shared_ptr to a read-only device_impl.
+     */
+    std::shared_ptr<const parent_type> share_parent() const;
+
+    /**
+     * @brief Retrieve the size of the staging ring.
+     * @return The staging capacity in bytes.
+     */
+    VkDeviceSize staging_capacity() const;
+
+    /**
+     * @brief Determine whether or not reads are submitted to an io_uring.
+     * @return True if reads are asynchronous. False if they fall back to pread().
+     */
+    bool uses_io_uring() const;
+
+    /**
+     * @brief Retrieve the number of chunks that haven't been copied to their destinations yet.
+     * @return The number of chunks that are being read or waiting for submit().
+     */
+    std::size_t pending() const;
+
+    /**
+     * @brief Read a range of a file into a device buffer.
+     * @details The read begins immediately. If the staging ring is full, this first waits for earlier chunks to be
+     *          read and copied. Files are opened on first use and kept open until the file_streamer_impl is destroyed.
+     *          This method is thread-safe.
+     * @param path The path of the file to read.
+     * @param file_offset The offset of the range within the file in bytes.
+     * @param size The size of the range in bytes.
+     * @param destination The buffer to copy the range into. This must not be null.
+     * @param destination_offset The offset within the destination buffer in bytes.
+     * @throw error If the file can't be opened, if the destination range exceeds the buffer, or if waiting fails.
+     */
+    void read(const std::filesystem::path& path, const std::uint64_t file_offset, const VkDeviceSize size,
+              const std::shared_ptr<const device_buffer_impl>& destination, const VkDeviceSize destination_offset);
+
+    /**
+     * @brief Copy every chunk that has been read to its destination.
+     * @details This doesn't wait for reads that are still in flight. This method is thread-safe.
+     * @return The device timeline value after which the copied data is visible to the asynchronous compute queue. 0 if
+     *         nothing was copied.
+     * @throw error If a read failed since the last submit() or if the submission fails.
+     */
+    std::uint64_t submit();
+
+    /**
+     * @brief Wait for every read in flight and copy every chunk to its destination.
+     * @details This method is thread-safe.
+     * @return The device timeline value after which all of the data read so far is visible to the asynchronous
+     *         compute queue. 0 if nothing was copied.
+     * @throw error If a read failed or if the submission fails.
+     */
+    std::uint64_t flush();
+  };
+
+  static_assert(megatech::vulkan::concepts::readonly_child_object<file_streamer_impl>);
+
+}
+
+#endif
+/// @endcond
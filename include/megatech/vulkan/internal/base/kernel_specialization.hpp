@@ -0,0 +1,110 @@
+/// @cond INTERNAL
+/**
+ * @file kernel_specialization.hpp
+ * @brief Device-Derived Compute Kernel Specialization
+ * @author Alexander Rothman <[gnomesort@megate.ch](mailto:gnomesort@megate.ch)>
+ * @copyright AGPL-3.0-or-later
+ * @date 2025
+ */
+#ifndef MEGATECH_VULKAN_INTERNAL_BASE_KERNEL_SPECIALIZATION_HPP
+#define MEGATECH_VULKAN_INTERNAL_BASE_KERNEL_SPECIALIZATION_HPP
+
+#include <cinttypes>
+
+#include <string>
+#include <vector>
+
+#include "../../compute.hpp"
+
+#include "vulkandefs.hpp"
+
+namespace megatech::vulkan::internal::base {
+
+  class physical_device_description_impl;
+
+  /**
+   * @brief A set of specialization constants derived from a physical device's properties.
+   * @details A kernel_specialization resolves a megatech::vulkan::kernel_constants description into concrete values
+   *          for a specific physical device. Default constructed kernel_specializations are empty, select no values,
+   *          and produce a VkSpecializationInfo without any map entries.
+   */
+  class kernel_specialization final {
+  public:
+    /**
+     * @brief The largest workgroup size that a kernel_specialization selects.
+     * @details Larger workgroups rarely improve throughput, and they reduce the number of workgroups that can be
+     *          resident at once.
+     */
+    static constexpr std::uint32_t max_workgroup_size{ 256 };
+  private:
+    std::vector<VkSpecializationMapEntry> m_entries{ };
+    std::vector<std::uint32_t> m_data{ };
+    std::uint32_t m_workgroup_size{ };
+    std::uint32_t m_subgroup_size{ };
+    std::uint32_t m_tile_size{ };
+
+    void add_constant(const std::int64_t id, const std::uint32_t value);
+  public:
+    /**
+     * @brief Construct an empty kernel_specialization.
+     */
+    kernel_specialization() = default;
+
+    /**
+     * @brief Construct a kernel_specialization.
+     * @param physical_device The physical device to derive constant values from.
+     * @param constants The constants to derive. Every ID that isn't -1 must be a distinct 32-bit unsigned integer,
+     *                  and shared_bytes_per_element must be greater than 0.
+     */
+    kernel_specialization(const physical_device_description_impl& physical_device, const kernel_constants& constants);
+
+    /// @cond
+    kernel_specialization(const kernel_specialization& other) = default;
+    kernel_specialization(kernel_specialization&& other) = default;
+    ~kernel_specialization() noexcept = default;
+    kernel_specialization& operator=(const kernel_specialization& rhs) = default;
+    kernel_specialization& operator=(kernel_specialization&& rhs) = default;
+    /// @endcond
+
+    /**
+     * @brief Produce a VkSpecializationInfo that refers to the kernel_specialization's constants.
+     * @details The result remains valid until the kernel_specialization is modified or destroyed.
+     * @return A VkSpecializationInfo. If the kernel_specialization is empty, the info contains no map entries.
+     */
+    VkSpecializationInfo info() const;
+
+    /**
+     * @brief Produce a key that uniquely identifies the kernel_specialization's constants.
+     * @return A string containing every constant ID and its value.
+     */
+    std::string key() const;
+
+    /**
+     * @brief Determine whether the kernel_specialization contains any constants.
+     * @return True if there are no constants. False otherwise.
+     */
+    bool empty() const;
+
+    /**
+     * @brief Retrieve the selected workgroup size.
+     * @return The number of invocations per workgroup, or 0 if the kernel_specialization was default constructed.
+     */
+    std::uint32_t workgroup_size() const;
+
+    /**
+     * @brief Retrieve the selected subgroup width.
+     * @return The number of invocations per subgroup, or 0 if the kernel_specialization was default constructed.
+     */
+    std::uint32_t subgroup_size() const;
+
+    /**
+     * @brief Retrieve the selected tile size.
+     * @return The number of elements per tile, or 0 if the kernel_specialization was default constructed.
+     */
+    std::uint32_t tile_size() const;
+  };
+
+}
+
+#endif
+/// @endcond
@@ -0,0 +1,195 @@
+/// @cond INTERNAL
+/**
+ * @file ktx2_texture.hpp
+ * @brief Progressively Streamed KTX2 Textures
+ * @author Alexander Rothman <[gnomesort@megate.ch](mailto:gnomesort@megate.ch)>
+ * @copyright AGPL-3.0-or-later
+ * @date 2025
+ */
+#ifndef MEGATECH_VULKAN_INTERNAL_BASE_KTX2_TEXTURE_HPP
+#define MEGATECH_VULKAN_INTERNAL_BASE_KTX2_TEXTURE_HPP
+
+#include <cinttypes>
+#include <cstddef>
+
+#include <filesystem>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <vector>
+
+#include "../../concepts/child_object.hpp"
+#include "../../concepts/handle_owner.hpp"
+
+#include "vulkandefs.hpp"
+#include "device_impl.hpp"
+#include "memory_allocation.hpp"
+#include "command_buffer_pool.hpp"
+#include "worker_pool.hpp"
+
+namespace megatech::vulkan::internal::base {
+
+  /**
+   * @brief A sampled image loaded from a KTX2 file, smallest mip levels first.
+   * @details The file is memory-mapped. Construction uploads the smallest mip levels that fit in one frame's budget,
+   *          so the image is usable as soon as that upload completes. Every call to stream() uploads at most one
+   *          frame's budget of the remaining levels, from smallest to largest. A level that is larger than the budget
+   *          is uploaded a few block rows at a time over several frames.
+   *
+   *          Files that are supercompressed with Zstandard are decoded one level at a time on a worker_pool, one level
+   *          ahead of the upload. stream() never waits for decoding. It simply uploads nothing until the next level
+   *          is ready. BasisLZ and zlib supercompression aren't supported.
+   *
+   *          The image is owned by the primary queue family and is in the VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+   *          layout between uploads, including the levels that haven't been uploaded yet. Consumers should restrict
+   *          sampling to resident_level() and above (e.g., with the sampler's minLod). All methods are thread-safe.
+   */
+  class ktx2_texture final {
+  public:
+    /**
+     * @brief The type of Vulkan handle owned by a ktx2_texture.
+     */
+    using handle_type = VkImage;
+
+    /**
+     * @brief The parent object type required to construct a ktx2_texture.
+     */
+    using parent_type = device_impl;
+  private:
+    struct level final {
+      VkExtent3D extent{ };
+      std::span<const std::byte> source{ };
+      VkDeviceSize size{ };
+      VkDeviceSize row_size{ };
+      std::uint32_t rows_per_image{ };
+      std::uint32_t rows{ };
+      std::uint32_t uploaded_rows{ };
+      std::future<std::vector<std::byte>> decoding{ };
+      std::vector<std::byte> decoded{ };
+      std::uint64_t timeline_value{ };
+    };
+
+    struct piece final {
+      std::uint32_t level{ };
+      std::uint32_t first_row{ };
+      std::uint32_t rows{ };
+    };
+
+    std::shared_ptr<const parent_type> m_parent{ };
+    std::shared_ptr<worker_pool> m_workers{ };
+    image_allocation m_image{ };
+    VkImageCreateInfo m_image_info{ };
+    VkExtent3D m_block_extent{ };
+    VkDeviceSize m_copy_alignment{ };
+    std::uint32_t m_faces{ };
+    std::uint32_t m_supercompression{ };
+    VkDeviceSize m_frame_budget{ };
+    void* m_mapping{ };
+    std::size_t m_mapping_size{ };
+    std::vector<std::byte> m_contents{ };
+    std::vector<level> m_levels{ };
+    std::unique_ptr<command_buffer_pool> m_commands{ };
+    mutable std::mutex m_mutex{ };
+    std::uint32_t m_remaining_levels{ };
+
+    void destroy() noexcept;
+    std::span<const std::byte> map(const std::filesystem::path& path);
+    void unmap() noexcept;
+    void parse(const std::span<const std::byte> file);
+    void decode(const std::uint32_t index);
+    std::span<const std::byte> level_data(const std::uint32_t index, const bool wait);
+    std::uint64_t upload(const bool is_initial);
+  public:
+    /// @cond
+    ktx2_texture() = delete;
+    /// @endcond
+
+    /**
+     * @brief Construct a ktx2_texture.
+     * @details This waits for the smallest levels to be decoded, but it doesn't wait for them to be uploaded.
+     * @param parent A shared_ptr to a read-only device_impl. This must not be null.
+     * @param path The path of the KTX2 file to load.
+     * @param frame_budget The maximum number of bytes to upload per frame. This must be greater than 0. At least one
+     *                     block row is uploaded per frame, even if it's larger than the budget.
+     * @param workers A worker_pool to decode supercompressed levels on. If this is null, levels are decoded by stream()
+     *                on the calling thread.
+     * @throw error If the file can't be read, if it isn't a valid KTX2 file, if it uses an unsupported
+     *              supercompression scheme, or if the image can't be created.
+     */
+    ktx2_texture(const std::shared_ptr<const parent_type>& parent, const std::filesystem::path& path,
+                 const VkDeviceSize frame_budget, const std::shared_ptr<worker_pool>& workers = nullptr);
+
+    /// @cond
+    ktx2_texture(const ktx2_texture& other) = delete;
+    ktx2_texture(ktx2_texture&& other) = delete;
+    /// @endcond
+
+    /**
+     * @brief Destroy a ktx2_texture.
+     * @details Decoding in progress is waited for. The image is destroyed through the device's deletion_queue.
+     */
+    ~ktx2_texture() noexcept;
+
+    /// @cond
+    ktx2_texture& operator=(const ktx2_texture& rhs) = delete;
+    ktx2_texture& operator=(ktx2_texture&& rhs) = delete;
+    /// @endcond
+
+    /**
+     * @brief Retrieve the ktx2_texture's underlying Vulkan handle.
+     * @return A valid VkImage.
+     */
+    handle_type handle() const;
+
+    /**
+     * @brief Retrieve the ktx2_texture's parent object.
+     * @return A read-only reference to a device_impl.
+     */
+    const parent_type& parent() const;
+
+    /**
+     * @brief Retrieve a description of the ktx2_texture's image.
+     * @return The VkImageCreateInfo that the image was created with.
+     */
+    const VkImageCreateInfo& image_info() const;
+
+    /**
+     * @brief Retrieve the number of bytes uploaded per frame.
+     * @return The frame budget in bytes.
+     */
+    VkDeviceSize frame_budget() const;
+
+    /**
+     * @brief Retrieve the largest mip level that the device can sample.
+     * @details A level is resident once the upload that completed it has finished on the device. Levels below it may
+     *          contain undefined data.
+     * @return The index of the lowest resident mip level. This equals the image's level count if no level is
+     *         resident yet.
+     */
+    std::uint32_t resident_level() const;
+
+    /**
+     * @brief Determine whether or not every level has been uploaded.
+     * @details The final upload may still be executing on the device.
+     * @return True if there is nothing left to stream. False otherwise.
+     */
+    bool is_complete() const;
+
+    /**
+     * @brief Upload the next frame's worth of mip data.
+     * @details This should be called once per frame. Once every level is uploaded, the file is unmapped.
+     * @return The device timeline value of the upload. 0 if nothing was uploaded, either because every level is
+     *         complete or because the next level is still being decoded.
+     * @throw error If decoding fails or if the upload can't be submitted.
+     */
+    std::uint64_t stream();
+  };
+
+  static_assert(megatech::vulkan::concepts::readonly_child_object<ktx2_texture>);
+  static_assert(megatech::vulkan::concepts::handle_owner<ktx2_texture>);
+
+}
+
+#endif
+/// @endcond
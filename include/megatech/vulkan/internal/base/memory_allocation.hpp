@@ -0,0 +1,116 @@
+/// @cond INTERNAL
+/**
+ * @file memory_allocation.hpp
+ * @brief Device Memory Allocation Records
+ * @author Alexander Rothman <[gnomesort@megate.ch](mailto:gnomesort@megate.ch)>
+ * @copyright AGPL-3.0-or-later
+ * @date 2025
+ */
+#ifndef MEGATECH_VULKAN_INTERNAL_BASE_MEMORY_ALLOCATION_HPP
+#define MEGATECH_VULKAN_INTERNAL_BASE_MEMORY_ALLOCATION_HPP
+
+#include <cinttypes>
+
+#include "vulkandefs.hpp"
+
+namespace megatech::vulkan::internal::base {
+
+  /**
+   * @brief The ways in which the host and device access a memory allocation.
+   */
+  enum class memory_usage : std::uint8_t {
+    /**
+     * @brief Memory that only the device accesses. Device-local memory is preferred and host-visible memory is
+     *        avoided so that the host-visible device-local heap isn't wasted.
+     */
+    gpu_only,
+    /**
+     * @brief Host-coherent memory that the host writes sequentially and the device reads once (e.g., staging
+     *        buffers). Uncached system memory is preferred.
+     */
+    upload,
+    /**
+     * @brief Host-coherent memory that the device writes and the host reads. Host-cached memory is preferred.
+     */
+    readback,
+    /**
+     * @brief Host-coherent memory that the host writes and the device reads every frame. Device-local memory is
+     *        preferred.
+     */
+    dynamic
+  };
+
+  /**
+   * @brief A record of a single block of device memory allocated by a device_impl.
+   */
+  struct memory_allocation final {
+    /**
+     * @brief The underlying Vulkan memory handle.
+     */
+    VkDeviceMemory memory;
+
+    /**
+     * @brief The size of the allocation in bytes.
+     */
+    VkDeviceSize size;
+
+    /**
+     * @brief The index of the memory type that the allocation was made from.
+     */
+    std::uint32_t memory_type_index;
+
+    /**
+     * @brief The index of the memory heap that the allocation was made from.
+     */
+    std::uint32_t heap_index;
+
+    /**
+     * @brief The memory property flags of the allocation's memory type.
+     */
+    VkMemoryPropertyFlags flags;
+
+    /**
+     * @brief A persistent host mapping of the allocation, or nullptr if the memory isn't host-visible.
+     */
+    void* mapped;
+  };
+
+  /**
+   * @brief A record of a buffer bound to its own block of device memory.
+   */
+  struct buffer_allocation final {
+    /**
+     * @brief The underlying Vulkan buffer handle.
+     */
+    VkBuffer buffer;
+
+    /**
+     * @brief The size of the buffer in bytes. This can be smaller than the size of its memory.
+     */
+    VkDeviceSize size;
+
+    /**
+     * @brief The memory bound to the buffer.
+     */
+    memory_allocation allocation;
+  };
+
+  /**
+   * @brief A record of an image bound to its own block of device memory.
+   */
+  struct image_allocation final {
+    /**
+     * @brief The underlying Vulkan image handle.
+     */
+    VkImage image;
+
+    /**
+     * @brief The memory bound to the image.
+     */
+    memory_allocation allocation;
+  };
+
+}
+
+#endif
+/// @endcond
@@ -0,0 +1,236 @@
+/// @cond INTERNAL
+/**
+ * @file offscreen_renderer.hpp
+ * @brief Headless Rendering and Readback
+ * @author Alexander Rothman <[gnomesort@megate.ch](mailto:gnomesort@megate.ch)>
+ * @copyright AGPL-3.0-or-later
+ * @date 2025
+ */
+#ifndef MEGATECH_VULKAN_INTERNAL_BASE_OFFSCREEN_RENDERER_HPP
+#define MEGATECH_VULKAN_INTERNAL_BASE_OFFSCREEN_RENDERER_HPP
+
+#include <cinttypes>
+#include <cstddef>
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <span>
+
+#include "../../concepts/child_object.hpp"
+
+#include "vulkandefs.hpp"
+#include "device_impl.hpp"
+#include "memory_allocation.hpp"
+#include "buffer_pool.hpp"
+#include "command_buffer_pool.hpp"
+#include "resource_state_tracker.hpp"
+
+namespace megatech::vulkan::internal::base {
+
+  /**
+   * @brief The pending result of an offscreen_renderer::render() call.
+   * @details An offscreen_readback owns a persistently mapped buffer that receives the rendered color image. The
+   *          buffer is returned to its pool when the offscreen_readback is destroyed.
+   */
+  class offscreen_readback final {
+  private:
+    std::shared_ptr<buffer_pool> m_pool{ };
+    buffer_allocation m_buffer{ };
+    VkDeviceSize m_size{ };
+    std::uint64_t m_timeline_value{ };
+    VkExtent2D m_extent{ };
+    VkFormat m_format{ };
+    bool m_invalidated{ };
+  public:
+    /// @cond
+    offscreen_readback() = delete;
+    /// @endcond
+
+    /**
+     * @brief Construct an offscreen_readback.
+     * @param pool The pool that owns the readback buffer. This must not be null.
+     * @param buffer The buffer that receives the rendered image. This must be persistently mapped.
+     * @param size The number of bytes of image data written to the buffer.
+     * @param timeline_value The device timeline value of the submission that writes the buffer.
+     * @param extent The dimensions of the rendered image.
+     * @param format The format of the rendered image.
+     */
+    offscreen_readback(const std::shared_ptr<buffer_pool>& pool, const buffer_allocation& buffer,
+                       const VkDeviceSize size, const std::uint64_t timeline_value, const VkExtent2D extent,
+                       const VkFormat format);
+
+    /// @cond
+    offscreen_readback(const offscreen_readback& other) = delete;
+    /// @endcond
+
+    /**
+     * @brief Move an offscreen_readback.
+     * @param other The offscreen_readback to move.
+     */
+    offscreen_readback(offscreen_readback&& other) noexcept;
+
+    /**
+     * @brief Destroy an offscreen_readback.
+     */
+    ~offscreen_readback() noexcept;
+
+    /// @cond
+    offscreen_readback& operator=(const offscreen_readback& rhs) = delete;
+    /// @endcond
+
+    /**
+     * @brief Move-assign an offscreen_readback.
+     * @param rhs The offscreen_readback to move.
+     * @return A reference to the moved-to offscreen_readback.
+     */
+    offscreen_readback& operator=(offscreen_readback&& rhs) noexcept;
+
+    /**
+     * @brief Retrieve the device timeline value that signals the completion of the readback.
+     * @return A timeline value that can be waited on through the device_impl.
+     */
+    std::uint64_t timeline_value() const;
+
+    /**
+     * @brief Retrieve the dimensions of the rendered image.
+     * @return The extent of the image in texels.
+     */
+    VkExtent2D extent() const;
+
+    /**
+     * @brief Retrieve the format of the rendered image.
+     * @return The VkFormat of the image data.
+     */
+    VkFormat format() const;
+
+    /**
+     * @brief Determine whether or not the rendered image has reached host memory without blocking.
+     * @return True if the readback is complete. False otherwise.
+     */
+    bool is_ready() const;
+
+    /**
+     * @brief Wait for the rendered image to reach host memory.
+     * @param timeout The maximum time to wait.
+     * @return True if the readback completed. False if the wait timed out.
+     */
+    bool wait(const std::chrono::nanoseconds timeout = std::chrono::nanoseconds::max()) const;
+
+    /**
+     * @brief Retrieve the rendered image data.
+     * @details This waits for the readback to complete. Rows are tightly packed.
+     * @return A read-only view of the image data.
+     */
+    std::span<const std::byte> data();
+  };
+
+  /**
+   * @brief A renderer that draws into offscreen images and streams the results back to host memory.
+   * @details offscreen_renderers don't require a surface. Each render begins dynamic rendering into a color image and
+   *          an optional depth image, invokes a caller-supplied recording function, and copies the color image into
+   *          a persistently mapped readback buffer. Renders are submitted to the primary queue without waiting, so
+   *          several can be in flight at once. This type is thread-safe.
+   */
+  class offscreen_renderer final {
+  public:
+    /**
+     * @brief The parent object type required to construct an offscreen_renderer.
+     */
+    using parent_type = device_impl;
+
+    /**
+     * @brief The type of function used to record rendering commands.
+     * @details The function is invoked between vkCmdBeginRendering and vkCmdEndRendering. The viewport and scissor
+     *          are set to cover the entire render target.
+     */
+    using record_function = std::function<void(VkCommandBuffer)>;
+  private:
+    std::shared_ptr<const parent_type> m_parent{ };
+    VkExtent2D m_extent{ };
+    VkFormat m_color_format{ };
+    VkFormat m_depth_format{ };
+    image_allocation m_color_image{ };
+    image_allocation m_depth_image{ };
+    VkImageView m_color_view{ };
+    VkImageView m_depth_view{ };
+    VkDeviceSize m_readback_size{ };
+    std::unique_ptr<resource_state_tracker> m_states{ };
+    std::shared_ptr<command_buffer_pool> m_commands{ };
+    std::shared_ptr<buffer_pool> m_readbacks{ };
+    std::uint64_t m_last_submitted{ };
+    mutable std::mutex m_mutex{ };
+
+    void destroy() noexcept;
+  public:
+    /// @cond
+    offscreen_renderer() = delete;
+    /// @endcond
+
+    /**
+     * @brief Construct an offscreen_renderer.
+     * @param parent A shared_ptr to a read-only device_impl. This must not be null.
+     * @param extent The dimensions of the render target. Both dimensions must be greater than 0.
+     * @param color_format The format of the color image. This must be an uncompressed color format.
+     * @param depth_format The format of the depth image, or VK_FORMAT_UNDEFINED to render without depth.
+     */
+    offscreen_renderer(const std::shared_ptr<const parent_type>& parent, const VkExtent2D extent,
+                       const VkFormat color_format, const VkFormat depth_format = VK_FORMAT_UNDEFINED);
+
+    /// @cond
+    offscreen_renderer(const offscreen_renderer& other) = delete;
+    offscreen_renderer(offscreen_renderer&& other) = delete;
+    /// @endcond
+
+    /**
+     * @brief Destroy an offscreen_renderer.
+     * @details The render targets are destroyed through the device's deletion_queue once every in-flight render
+     *          completes. Outstanding offscreen_readbacks remain valid.
+     */
+    ~offscreen_renderer() noexcept;
+
+    /// @cond
+    offscreen_renderer& operator=(const offscreen_renderer& rhs) = delete;
+    offscreen_renderer& operator=(offscreen_renderer&& rhs) = delete;
+    /// @endcond
+
+    /**
+     * @brief Retrieve the offscreen_renderer's parent object.
+     * @return A read-only reference to a device_impl.
+     */
+    const parent_type& parent() const;
+
+    /**
+     * @brief Retrieve the dimensions of the render target.
+     * @return The extent of the render target in texels.
+     */
+    VkExtent2D extent() const;
+
+    /**
+     * @brief Retrieve the format of the color image.
+     * @return A VkFormat.
+     */
+    VkFormat color_format() const;
+
+    /**
+     * @brief Retrieve the format of the depth image.
+     * @return A VkFormat. VK_FORMAT_UNDEFINED if the offscreen_renderer doesn't use depth.
+     */
+    VkFormat depth_format() const;
+
+    /**
+     * @brief Render a frame and begin streaming it back to host memory.
+     * @param clear_color The value that the color image is cleared to. The depth image is always cleared to 1.
+     * @param record A function that records rendering commands. This may be empty.
+     * @return An offscreen_readback that completes when the rendered image is available to the host.
+     */
+    offscreen_readback render(const VkClearColorValue& clear_color, const record_function& record);
+  };
+
+  static_assert(megatech::vulkan::concepts::readonly_child_object<offscreen_renderer>);
+
+}
+
+#endif
+/// @endcond
@@ -9,19 +9,46 @@
 #ifndef MEGATECH_VULKAN_INTERNAL_BASE_PHYSICAL_DEVICE_DESCRIPTION_IMPL_HPP
 #define MEGATECH_VULKAN_INTERNAL_BASE_PHYSICAL_DEVICE_DESCRIPTION_IMPL_HPP
 
+#include <array>
+#include <atomic>
+#include <mutex>
 #include <unordered_set>
 #include <vector>
 #include <memory>
 
+#include "../../physical_devices.hpp"
+
 #include "../../concepts/child_object.hpp"
 #include "../../concepts/handle_owner.hpp"
 
 #include "vulkandefs.hpp"
+#include "memory_allocation.hpp"
+#include "structure_chain.hpp"
 
 namespace megatech::vulkan::internal::base {
 
   class instance_impl;
 
+  /**
+   * @brief The features that a physical device supports for a format.
+   */
+  struct format_feature_flags final {
+    /**
+     * @brief The features supported by images created with VK_IMAGE_TILING_LINEAR.
+     */
+    VkFormatFeatureFlags2 linear_tiling;
+
+    /**
+     * @brief The features supported by images created with VK_IMAGE_TILING_OPTIMAL.
+     */
+    VkFormatFeatureFlags2 optimal_tiling;
+
+    /**
+     * @brief The features supported by buffers.
+     */
+    VkFormatFeatureFlags2 buffer;
+  };
+
   /**
    * @brief An implementation of a megatech::vulkan::physical_device_description.
    * @details Adaptor implementors that wish to customize the configuration of devices must extend this type and
@@ -41,8 +68,17 @@ namespace megatech::vulkan::internal::base {
     VkPhysicalDeviceVulkan12Features m_features_1_2{ };
     VkPhysicalDeviceVulkan13Features m_features_1_3{ };
     VkPhysicalDeviceDynamicRenderingLocalReadFeaturesKHR m_dynamic_rendering_local_read_features{ };
+    VkPhysicalDeviceMemoryProperties m_memory_properties{ };
     std::vector<VkQueueFamilyProperties> m_queue_family_properties{ };
     std::unordered_set<std::string> m_available_extensions{ };
+    std::vector<format_feature_flags> m_format_features{ };
+    std::uint32_t m_memory_class_count{ };
+    std::array<std::uint32_t, 8> m_memory_class_types{ };
+    std::array<std::array<std::uint8_t, 256>, 4> m_memory_class_masks{ };
+    std::array<std::array<std::int8_t, 256>, 4> m_memory_usage_classes{ };
+    mutable std::mutex m_cached_properties_mutex{ };
+    mutable std::array<std::shared_ptr<const void>, 32> m_cached_property_storage{ };
+    mutable std::array<std::atomic<const void*>, 32> m_cached_properties{ };
     int64_t m_primary_queue_family{ -1 };
     int64_t m_async_compute_queue_family{ -1 };
     int64_t m_async_transfer_queue_family{ -1 };
@@ -52,6 +88,16 @@ namespace megatech::vulkan::internal::base {
     VkPhysicalDeviceVulkan12Features m_required_features_1_2{ };
     VkPhysicalDeviceVulkan13Features m_required_features_1_3{ };
     VkPhysicalDeviceDynamicRenderingLocalReadFeaturesKHR m_required_dynamic_rendering_local_read_features{ };
+
+    static std::size_t allocate_property_slot();
+
+    template <typename Properties>
+    static std::size_t property_slot() {
+      static const auto slot = allocate_property_slot();
+      return slot;
+    }
+
+    const void* cache_properties(const std::size_t slot, const std::shared_ptr<void>& storage) const;
   protected:
     /**
      * @brief Manually set the physical_device_description_impl's selected queue families.
@@ -107,7 +153,8 @@ namespace megatech::vulkan::internal::base {
      * @details This is a strictly non-owning operation. The pointer is appended to the pNext chain of the required
      *          feature object naively. All of the pointed-to objects in the extended chain must have their lifetimes
      *          controlled by the extended class. They must share the same lifetime as the
-     *          physical_device_description_impl.
+     *          physical_device_description_impl. The simplest way to do this is to store a structure_chain member and
+     *          pass the result of its link() method.
      * @param next A pointer to a pNext chain for VkPhysicalDeviceFeatures2. This must not contain any feature object
      *             already in the chain. This means it cannot contain VkPhysicalDeviceVulkan11Features,
      *             VkPhysicalDeviceVulkan12Features, VkPhysicalDeviceVulkan13Features, or
@@ -119,7 +166,8 @@ namespace megatech::vulkan::internal::base {
 
     /**
      * @brief Validate the availability of extended features in the physical_device_description_impl.
-     * @details Adaptor implementors who need to use append_extended_feature_chain should override this. The
+     * @details Adaptor implementors who need to use append_extended_feature_chain should override this. When the
+     *          extended chain is a structure_chain, the override can simply return has_features() for it. The
      *          default implementation always returns true. This is called by is_valid.
      * @return True if all of the extended features are available. False otherwise.
      */
@@ -223,6 +271,174 @@ namespace megatech::vulkan::internal::base {
      */
     const VkPhysicalDeviceVulkan13Features& features_1_3() const;
 
+    /**
+     * @brief Query an arbitrary chain of extended features from a physical_device_description_impl.
+     * @details The entire chain is filled by a single call to vkGetPhysicalDeviceFeatures2.
+     * @param next A pNext chain for VkPhysicalDeviceFeatures2. Every structure in it must have its sType set.
+     * @return The Vulkan 1.0 features reported by the same query.
+     * @throw error If vkGetPhysicalDeviceFeatures2 can't be resolved.
+     */
+    VkPhysicalDeviceFeatures query_features(void *const next) const;
+
+    /**
+     * @brief Query a structure_chain of extended features from a physical_device_description_impl.
+     * @param features The chain to fill. Every structure in it must have its sType set. It's unlinked afterward.
+     * @return The Vulkan 1.0 features reported by the same query.
+     * @throw error If vkGetPhysicalDeviceFeatures2 can't be resolved.
+     */
+    template <vk_chainable_structure... Features>
+    VkPhysicalDeviceFeatures query_features(structure_chain<Features...>& features) const {
+      const auto result = query_features(features.link());
+      features.unlink();
+      return result;
+    }
+
+    /**
+     * @brief Query an arbitrary chain of extended properties from a physical_device_description_impl.
+     * @details The entire chain is filled by a single call to vkGetPhysicalDeviceProperties2.
+     * @param next A pNext chain for VkPhysicalDeviceProperties2. Every structure in it must have its sType set.
+     * @return The Vulkan 1.0 properties reported by the same query.
+     * @throw error If vkGetPhysicalDeviceProperties2 can't be resolved.
+     */
+    VkPhysicalDeviceProperties query_properties(void *const next) const;
+
+    /**
+     * @brief Query a structure_chain of extended properties from a physical_device_description_impl.
+     * @param properties The chain to fill. Every structure in it must have its sType set. It's unlinked afterward.
+     * @return The Vulkan 1.0 properties reported by the same query.
+     * @throw error If vkGetPhysicalDeviceProperties2 can't be resolved.
+     */
+    template <vk_chainable_structure... Properties>
+    VkPhysicalDeviceProperties query_properties(structure_chain<Properties...>& properties) const {
+      const auto result = query_properties(properties.link());
+      properties.unlink();
+      return result;
+    }
+
+    /**
+     * @brief Retrieve an extended property structure describing a physical_device_description_impl.
+     * @details The structure is queried the first time it's requested and cached afterward, so properties that
+     *          aren't needed never cost anything. Each type is cached in its own slot, which is shared by every
+     *          physical_device_description_impl. After the first query, this is a single atomic load. This method is
+     *          thread-safe.
+     * @tparam Properties The type of property structure to retrieve. structure_type_v must be specialized for it,
+     *                    and the extension or Vulkan version that defines it must be available.
+     * @return A read-only reference to the cached structure. Its pNext member is nullptr.
+     * @throw error If more than 32 different property types are requested or if the query fails.
+     */
+    template <vk_chainable_structure Properties>
+    const Properties& properties() const {
+      static_assert(structure_type_v<Properties> != VK_STRUCTURE_TYPE_MAX_ENUM,
+                    "structure_type_v must be specialized for the requested property structure.");
+      const auto slot = property_slot<Properties>();
+      if (slot < m_cached_properties.size())
+      {
+        if (const auto* cached = m_cached_properties[slot].load(std::memory_order_acquire); cached)
+        {
+          return *static_cast<const Properties*>(cached);
+        }
+      }
+      const auto storage = std::make_shared<Properties>(make_structure<Properties>(structure_type_v<Properties>));
+      return *static_cast<const Properties*>(cache_properties(slot, storage));
+    }
+
+    /**
+     * @brief Determine whether or not a physical_device_description_impl supports a chain of extended features.
+     * @details The available features are queried into a copy of the required chain, so this doesn't allocate.
+     * @param required A chain of required features. Every structure in it must have its sType set.
+     * @return True if every feature that's enabled in required is available. False otherwise.
+     * @throw error If vkGetPhysicalDeviceFeatures2 can't be resolved.
+     */
+    template <vk_extended_feature_type... Features>
+    bool has_features(const structure_chain<Features...>& required) const {
+      auto actual = required;
+      query_features(actual);
+      return featurecmp(actual, required);
+    }
+
+    /**
+     * @brief Retrieve the memory heaps and memory types available to a physical_device_description_impl.
+     * @return A read-only reference to a VkPhysicalDeviceMemoryProperties object.
+     */
+    const VkPhysicalDeviceMemoryProperties& memory_properties() const;
+
+    /**
+     * @brief Select a memory type available to a physical_device_description_impl.
+     * @details Memory types are ranked by the number of preferred property flags that they share. Ties are broken by
+     *          the order in which the driver reports the types, since Vulkan requires that faster types are reported
+     *          first.
+     * @param type_bits A bitmask of acceptable memory type indices (e.g., VkMemoryRequirements::memoryTypeBits).
+     * @param required A set of property flags that the selected type must have.
+     * @param preferred A set of property flags that the selected type should have, if possible.
+     * @return An integer in the range [0, memory_properties().memoryTypeCount) if a suitable memory type exists. -1
+     *         otherwise.
+     */
+    std::int64_t memory_type_index(const std::uint32_t type_bits, const VkMemoryPropertyFlags required,
+                                   const VkMemoryPropertyFlags preferred) const;
+
+    /**
+     * @brief Select a memory type available to a physical_device_description_impl for a memory_usage.
+     * @details Memory types with identical property flags and heaps are grouped into classes. At construction, the
+     *          best class is ranked for every usage and every combination of classes, so this is a few table lookups
+     *          as long as there are at most 8 classes. Otherwise, it falls back to scanning the memory types.
+     *          Lazily allocated, protected, and AMD device-coherent types are never selected.
+     * @param type_bits A bitmask of acceptable memory type indices (e.g., VkMemoryRequirements::memoryTypeBits).
+     * @param usage The way in which the memory will be accessed.
+     * @return An integer in the range [0, memory_properties().memoryTypeCount) if a suitable memory type exists. -1
+     *         otherwise.
+     */
+    std::int64_t memory_type_index(const std::uint32_t type_bits, const memory_usage usage) const;
+
+    /**
+     * @brief Select the memory heap that the host can map and the device can access at full speed.
+     * @details Heaps are eligible if they back a memory type that is device-local, host-visible, and host-coherent.
+     *          On discrete GPUs, this is the PCIe BAR, which covers all of video memory when resizable BAR is enabled.
+     *          On integrated GPUs, it's usually system memory. When several heaps are eligible, the largest is chosen.
+     * @return An integer in the range [0, memory_properties().memoryHeapCount) if an eligible heap exists. -1
+     *         otherwise.
+     */
+    std::int64_t host_visible_device_local_heap_index() const;
+
+    /**
+     * @brief Retrieve the features that a physical_device_description_impl supports for a format.
+     * @details Every Vulkan 1.3 format, and every format from an available extension that defines formats, is queried
+     *          once at construction. This is a table lookup, so it's suitable for hot code. Extension formats are
+     *          reported as they'd be supported if their extension were enabled. Devices should use the overload that
+     *          takes their enabled extensions instead.
+     * @param format The format to look up.
+     * @return A read-only reference to the format's features. Every flag is clear if the format is unsupported or
+     *         unknown.
+     */
+    const format_feature_flags& format_features(const VkFormat format) const;
+
+    /**
+     * @brief Retrieve the features that a physical_device_description_impl supports for a format on a device.
+     * @param format The format to look up.
+     * @param enabled_extensions The extensions enabled on the device.
+     * @return A read-only reference to the format's features. Every flag is clear if the format is unsupported,
+     *         unknown, or belongs to an extension that isn't in enabled_extensions.
+     */
+    const format_feature_flags& format_features(const VkFormat format,
+                                                const std::unordered_set<std::string>& enabled_extensions) const;
+
+    /**
+     * @brief Determine whether or not a physical_device_description_impl supports a set of image format features.
+     * @param format The format to check.
+     * @param tiling The tiling of the image. This must be VK_IMAGE_TILING_LINEAR or VK_IMAGE_TILING_OPTIMAL.
+     * @param features The features that the format must support (e.g., VK_FORMAT_FEATURE_2_STORAGE_IMAGE_BIT).
+     * @return True if every feature is supported. False otherwise.
+     */
+    bool has_format_features(const VkFormat format, const VkImageTiling tiling,
+                             const VkFormatFeatureFlags2 features) const;
+
+    /**
+     * @brief Determine whether or not a physical_device_description_impl supports a set of buffer format features.
+     * @param format The format to check.
+     * @param features The features that the format must support (e.g., VK_FORMAT_FEATURE_2_VERTEX_BUFFER_BIT).
+     * @return True if every feature is supported. False otherwise.
+     */
+    bool has_buffer_format_features(const VkFormat format, const VkFormatFeatureFlags2 features) const;
+
     /**
      * @brief Retrieve the extensions available to a physical_device_description_impl.
      * @return A read-only reference to a set of Vulkan extensions.
@@ -258,6 +474,17 @@ namespace megatech::vulkan::internal::base {
      */
     int64_t async_transfer_queue_family_index() const;
 
+    /**
+     * @brief Retrieve the index of the queue family that a physical_device_description_impl binds sparse memory on.
+     * @details Families that are already selected are preferred so that sparse binding doesn't require another queue.
+     *          The asynchronous transfer family is preferred over the asynchronous compute family, which is preferred
+     *          over the primary family. If none of them support VK_QUEUE_SPARSE_BINDING_BIT, the first family that
+     *          does is selected.
+     * @return An integer in the range [0, queue_family_properties().size()) if a queue family supports sparse binding.
+     *         -1 otherwise.
+     */
+    int64_t sparse_binding_queue_family_index() const;
+
     /**
      * @brief Retrieve the properties of a physical_device_description_impl's primary queue family.
      * @return A the properties of the primary queue family.
@@ -305,5 +532,14 @@ namespace megatech::vulkan::internal::base {
 
 }
 
+namespace megatech::vulkan {
+
+  template <typename Properties>
+  const Properties& physical_device_description::properties() const {
+    return m_impl->template properties<Properties>();
+  }
+
+}
+
 #endif
 /// @endcond
@@ -0,0 +1,345 @@
+/// @cond INTERNAL
+/**
+ * @file render_graph.hpp
+ * @brief Frame Graph With Transient Resource Aliasing
+ * @author Alexander Rothman <[gnomesort@megate.ch](mailto:gnomesort@megate.ch)>
+ * @copyright AGPL-3.0-or-later
+ * @date 2025
+ */
+#ifndef MEGATECH_VULKAN_INTERNAL_BASE_RENDER_GRAPH_HPP
+#define MEGATECH_VULKAN_INTERNAL_BASE_RENDER_GRAPH_HPP
+
+#include <cinttypes>
+#include <cstddef>
+
+#include <array>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../../concepts/child_object.hpp"
+
+#include "vulkandefs.hpp"
+#include "device_impl.hpp"
+#include "memory_allocation.hpp"
+#include "command_buffer_pool.hpp"
+#include "resource_state_tracker.hpp"
+
+namespace megatech::vulkan::internal::base {
+
+  /**
+   * @brief The kinds of work that a render_graph pass can perform.
+   */
+  enum class render_pass_type {
+    /**
+     * @brief The pass records graphics work. Graphics passes always execute on the primary queue.
+     */
+    graphics,
+    /**
+     * @brief The pass only records compute or transfer work. Compute passes execute on the asynchronous compute
+     *        queue when the device has one.
+     */
+    compute
+  };
+
+  /**
+   * @brief A frame graph that schedules passes and manages their transient resources.
+   * @details Passes declare the resources that they read and write. Compiling the graph culls passes that don't
+   *          contribute to an imported resource or have side effects, orders the remaining passes, assigns them to
+   *          queues, and creates the transient resources that they use. Transient resources whose lifetimes don't
+   *          overlap share memory. Attachment-only images use lazily allocated memory when the device provides it.
+   *
+   *          Executing the graph records each run of passes on the same queue into one command buffer. Barriers are
+   *          computed by per-queue resource_state_trackers, and passes on different queues are ordered by the
+   *          device's timeline semaphores. Transient contents never survive between executions. Imported resources
+   *          keep their state between executions. The graph never transfers queue family ownership, so imported
+   *          resources that passes on both queues access must be declared concurrent. The graph can't be modified
+   *          once it's compiled. render_graphs aren't thread-safe.
+   */
+  class render_graph final {
+  public:
+    /**
+     * @brief The parent object type required to construct a render_graph.
+     */
+    using parent_type = device_impl;
+
+    /**
+     * @brief The type used to identify resources.
+     */
+    using resource_id = std::uint32_t;
+
+    /**
+     * @brief The type used to identify passes.
+     */
+    using pass_id = std::uint32_t;
+
+    /**
+     * @brief The type of function that records a pass.
+     * @details The function receives the command buffer to record into and the graph, which can be used to look up
+     *          physical resources. Barriers for the pass's declared accesses have already been recorded.
+     */
+    using record_function = std::function<void(const VkCommandBuffer, const render_graph&)>;
+  private:
+    static constexpr std::uint32_t invalid_index{ std::numeric_limits<std::uint32_t>::max() };
+
+    struct access final {
+      resource_id resource{ };
+      VkPipelineStageFlags2 stages{ };
+      VkAccessFlags2 accesses{ };
+      VkImageLayout layout{ };
+      bool write{ };
+    };
+
+    struct pass final {
+      std::string name{ };
+      render_pass_type type{ };
+      record_function record{ };
+      std::vector<access> accesses{ };
+      bool side_effects{ };
+      bool culled{ };
+      queue_type queue{ };
+    };
+
+    struct resource final {
+      bool imported{ };
+      bool concurrent{ };
+      bool is_image{ };
+      VkImageCreateInfo image_info{ };
+      VkImageSubresourceRange range{ };
+      VkImageLayout initial_layout{ };
+      VkDeviceSize size{ };
+      VkBufferUsageFlags buffer_usage{ };
+      VkImage image{ };
+      VkBuffer buffer{ };
+      VkImageView view{ };
+      VkMemoryRequirements requirements{ };
+      bool lazy{ };
+      std::uint32_t block{ invalid_index };
+      std::uint32_t first_use{ invalid_index };
+      std::uint32_t last_use{ };
+      std::uint32_t queue_mask{ };
+      std::uint32_t tracked_queue{ invalid_index };
+      std::uint32_t last_queue{ invalid_index };
+      std::uint64_t last_value{ };
+      std::uint64_t last_execution{ };
+    };
+
+    struct memory_block final {
+      memory_allocation allocation{ };
+      VkMemoryRequirements requirements{ };
+      bool is_image{ };
+      bool lazy{ };
+      std::uint32_t queue{ };
+      std::vector<resource_id> occupants{ };
+      resource_id last_occupant{ invalid_index };
+    };
+
+    std::shared_ptr<const parent_type> m_parent{ };
+    std::vector<resource> m_resources{ };
+    std::vector<pass> m_passes{ };
+    std::vector<pass_id> m_order{ };
+    std::vector<memory_block> m_blocks{ };
+    std::array<std::unique_ptr<resource_state_tracker>, 2> m_states{ };
+    std::array<std::unique_ptr<command_buffer_pool>, 2> m_commands{ };
+    bool m_compiled{ };
+    std::uint64_t m_executions{ };
+    std::uint64_t m_last_submitted{ };
+
+    void destroy() noexcept;
+    void check_mutable() const;
+    void declare(const pass_id pass, const resource_id resource, const VkPipelineStageFlags2 stages,
+                 const VkAccessFlags2 accesses, const VkImageLayout layout, const bool write);
+    void cull();
+    void schedule();
+    void create_resources();
+    void alias_resources();
+    void prepare(const std::uint32_t queue, const access& use, std::array<std::uint64_t, 2>& waits,
+                 std::array<VkPipelineStageFlags2, 2>& wait_stages);
+  public:
+    /// @cond
+    render_graph() = delete;
+    /// @endcond
+
+    /**
+     * @brief Construct an empty render_graph.
+     * @param parent A shared_ptr to a read-only device_impl. This must not be null.
+     */
+    explicit render_graph(const std::shared_ptr<const parent_type>& parent);
+
+    /// @cond
+    render_graph(const render_graph& other) = delete;
+    render_graph(render_graph&& other) = delete;
+    /// @endcond
+
+    /**
+     * @brief Destroy a render_graph.
+     * @details Transient resources are destroyed through the device's deletion_queue once the last execution
+     *          completes.
+     */
+    ~render_graph() noexcept;
+
+    /// @cond
+    render_graph& operator=(const render_graph& rhs) = delete;
+    render_graph& operator=(render_graph&& rhs) = delete;
+    /// @endcond
+
+    /**
+     * @brief Retrieve the render_graph's parent object.
+     * @return A read-only reference to a device_impl.
+     */
+    const parent_type& parent() const;
+
+    /**
+     * @brief Declare a transient image.
+     * @param image_info A description of the image. The sharing mode and queue families are chosen by the graph, and
+     *                   the initial layout must be VK_IMAGE_LAYOUT_UNDEFINED.
+     * @param aspect The aspects of the image that passes access.
+     * @return The new resource's ID.
+     */
+    resource_id create_image(const VkImageCreateInfo& image_info, const VkImageAspectFlags aspect);
+
+    /**
+     * @brief Declare a transient buffer.
+     * @param size The size of the buffer in bytes.
+     * @param usage The buffer's usage flags.
+     * @return The new resource's ID.
+     */
+    resource_id create_buffer(const VkDeviceSize size, const VkBufferUsageFlags usage);
+
+    /**
+     * @brief Import an image that's owned outside of the graph.
+     * @details Imported resources are never culled, aliased, or destroyed by the graph.
+     * @param image The image to import.
+     * @param range The subresources of the image that passes access.
+     * @param layout The current layout of the image.
+     * @param concurrent Whether the image was created with VK_SHARING_MODE_CONCURRENT for the primary and
+     *                   asynchronous compute queue families. Compiling fails if passes on both queues access an image
+     *                   that isn't concurrent.
+     * @return The new resource's ID.
+     */
+    resource_id import_image(const VkImage image, const VkImageSubresourceRange& range, const VkImageLayout layout,
+                             const bool concurrent = false);
+
+    /**
+     * @brief Import a buffer that's owned outside of the graph.
+     * @details Imported resources are never culled, aliased, or destroyed by the graph.
+     * @param buffer The buffer to import.
+     * @param concurrent Whether the buffer was created with VK_SHARING_MODE_CONCURRENT for the primary and
+     *                   asynchronous compute queue families. Compiling fails if passes on both queues access a buffer
+     *                   that isn't concurrent.
+     * @return The new resource's ID.
+     */
+    resource_id import_buffer(const VkBuffer buffer, const bool concurrent = false);
+
+    /**
+     * @brief Add a pass to the graph.
+     * @param name A name for the pass.
+     * @param type The kind of work that the pass records.
+     * @param record The function that records the pass.
+     * @param side_effects Whether or not the pass has effects outside of the graph. Passes with side effects are
+     *                     never culled.
+     * @return The new pass's ID.
+     */
+    pass_id add_pass(const std::string& name, const render_pass_type type, const record_function& record,
+                     const bool side_effects = false);
+
+    /**
+     * @brief Declare that a pass reads a resource.
+     * @param pass The pass that reads the resource.
+     * @param resource The resource to read.
+     * @param stages The pipeline stages that read the resource.
+     * @param accesses The types of read access that the stages perform.
+     * @param layout The layout that the pass requires. This is ignored for buffers.
+     */
+    void read(const pass_id pass, const resource_id resource, const VkPipelineStageFlags2 stages,
+              const VkAccessFlags2 accesses, const VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED);
+
+    /**
+     * @brief Declare that a pass writes a resource.
+     * @param pass The pass that writes the resource.
+     * @param resource The resource to write.
+     * @param stages The pipeline stages that write the resource.
+     * @param accesses The types of access that the stages perform.
+     * @param layout The layout that the pass requires. This is ignored for buffers.
+     */
+    void write(const pass_id pass, const resource_id resource, const VkPipelineStageFlags2 stages,
+               const VkAccessFlags2 accesses, const VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED);
+
+    /**
+     * @brief Cull, order, and assign queues to the graph's passes and create its transient resources.
+     * @details Compiling an already compiled graph does nothing.
+     * @throw error If a pass reads a transient resource that no earlier pass writes, or if transient resources can't
+     *              be created.
+     */
+    void compile();
+
+    /**
+     * @brief Record and submit every pass in the graph.
+     * @details The graph is compiled first if necessary.
+     * @return The device timeline value at which the execution completes.
+     */
+    std::uint64_t execute();
+
+    /**
+     * @brief Retrieve the physical image of a resource.
+     * @param resource The resource to look up.
+     * @return The image, or VK_NULL_HANDLE if the resource is a culled transient or a buffer.
+     */
+    VkImage image(const resource_id resource) const;
+
+    /**
+     * @brief Retrieve a view of every subresource of a transient image.
+     * @param resource The resource to look up.
+     * @return The view, or VK_NULL_HANDLE if the resource is imported, culled, or a buffer.
+     */
+    VkImageView image_view(const resource_id resource) const;
+
+    /**
+     * @brief Retrieve the physical buffer of a resource.
+     * @param resource The resource to look up.
+     * @return The buffer, or VK_NULL_HANDLE if the resource is a culled transient or an image.
+     */
+    VkBuffer buffer(const resource_id resource) const;
+
+    /**
+     * @brief Retrieve the order that the graph's passes execute in.
+     * @details Culled passes aren't included. The order is empty until the graph is compiled.
+     * @return A list of pass IDs.
+     */
+    const std::vector<pass_id>& order() const;
+
+    /**
+     * @brief Determine whether or not a pass was culled.
+     * @param pass The pass to query.
+     * @return True if the graph has been compiled and the pass won't execute. False otherwise.
+     */
+    bool is_culled(const pass_id pass) const;
+
+    /**
+     * @brief Retrieve the queue that a pass executes on.
+     * @param pass The pass to query.
+     * @return The pass's queue_type.
+     */
+    queue_type pass_queue(const pass_id pass) const;
+
+    /**
+     * @brief Retrieve the number of memory allocations that back the graph's transient resources.
+     * @return The number of allocations.
+     */
+    std::size_t memory_block_count() const;
+
+    /**
+     * @brief Retrieve the total size of the memory that backs the graph's transient resources.
+     * @return The size in bytes.
+     */
+    VkDeviceSize transient_memory_size() const;
+  };
+
+  static_assert(megatech::vulkan::concepts::readonly_child_object<render_graph>);
+
+}
+
+#endif
+/// @endcond
@@ -0,0 +1,182 @@
+/// @cond INTERNAL
+/**
+ * @file residency_manager.hpp
+ * @brief Budget-Driven Device Memory Residency
+ * @author Alexander Rothman <[gnomesort@megate.ch](mailto:gnomesort@megate.ch)>
+ * @copyright AGPL-3.0-or-later
+ * @date 2025
+ */
+#ifndef MEGATECH_VULKAN_INTERNAL_BASE_RESIDENCY_MANAGER_HPP
+#define MEGATECH_VULKAN_INTERNAL_BASE_RESIDENCY_MANAGER_HPP
+
+#include <cinttypes>
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "vulkandefs.hpp"
+
+namespace megatech::vulkan::internal::base {
+
+  class device_impl;
+
+  /**
+   * @brief A tracker for evictable device memory.
+   * @details Memory that its owner can release and recreate on demand is registered with the residency_manager along
+   *          with the timeline value of its last use. When a heap nears its budget, the least recently used memory that
+   *          the device has finished with is evicted until enough memory is released. All methods are thread-safe.
+   */
+  class residency_manager final {
+  public:
+    /**
+     * @brief The type of object used to identify tracked resources.
+     */
+    using id_type = std::uint64_t;
+
+    /**
+     * @brief The type of callback invoked to evict a resource.
+     * @details The callback releases the resource's memory and returns the number of bytes that it released from the
+     *          resource's heap. The owner is expected to recreate the resource on demand. A callback that returns 0
+     *          is assumed to have failed and the resource remains tracked. Otherwise, the resource is no longer
+     *          tracked and must be tracked again if it should remain evictable.
+     *          Callbacks are invoked without any residency_manager locks held, so they may allocate memory. Callbacks
+     *          must not throw.
+     */
+    using callback_type = std::function<VkDeviceSize()>;
+
+    /**
+     * @brief The parent object type required to construct a residency_manager.
+     */
+    using parent_type = device_impl;
+  private:
+    struct entry final {
+      std::uint32_t heap_index{ };
+      VkDeviceSize size{ };
+      std::uint64_t last_use{ };
+      callback_type callback{ };
+    };
+
+    const parent_type* m_parent{ };
+    mutable std::mutex m_mutex{ };
+    id_type m_next_id{ 1 };
+    std::unordered_map<id_type, entry> m_entries{ };
+    std::unordered_set<id_type> m_evicting{ };
+    std::unordered_set<id_type> m_running{ };
+    std::condition_variable m_callback_finished{ };
+    std::vector<std::set<std::pair<std::uint64_t, id_type>>> m_lru{ };
+    double m_pressure_threshold{ 0.9 };
+  public:
+    /// @cond
+    residency_manager() = delete;
+    /// @endcond
+
+    /**
+     * @brief Construct a residency_manager.
+     * @param parent The device_impl whose memory will be managed. This must outlive the residency_manager.
+     */
+    explicit residency_manager(const parent_type& parent);
+
+    /// @cond
+    residency_manager(const residency_manager& other) = delete;
+    residency_manager(residency_manager&& other) = delete;
+    /// @endcond
+
+    /**
+     * @brief Destroy a residency_manager.
+     */
+    ~residency_manager() noexcept = default;
+
+    /// @cond
+    residency_manager& operator=(const residency_manager& rhs) = delete;
+    residency_manager& operator=(residency_manager&& rhs) = delete;
+    /// @endcond
+
+    /**
+     * @brief Retrieve the residency_manager's parent object.
+     * @return A read-only reference to a device_impl.
+     */
+    const parent_type& parent() const;
+
+    /**
+     * @brief Begin tracking an evictable resource.
+     * @param heap_index The index of the heap that the resource's memory belongs to.
+     * @param size The number of bytes that evicting the resource is expected to release.
+     * @param last_use The device timeline value of the resource's most recent use.
+     * @param callback The callback used to evict the resource. This must not be empty.
+     * @return A new id identifying the tracked resource.
+     */
+    id_type track(const std::uint32_t heap_index, const VkDeviceSize size, const std::uint64_t last_use,
+                  callback_type callback);
+
+    /**
+     * @brief Record a new use of a tracked resource.
+     * @details Unknown ids are ignored, since the resource may have been evicted concurrently.
+     * @param id The id of the resource.
+     * @param last_use The device timeline value of the resource's most recent use. Values older than the currently
+     *                 recorded value are ignored.
+     */
+    void touch(const id_type id, const std::uint64_t last_use);
+
+    /**
+     * @brief Stop tracking a resource.
+     * @details Unknown ids are ignored. If the resource's callback is running, untrack() waits for it to return, and
+     *          the resource isn't tracked again even if the callback fails. Consequently, untrack() must not be called
+     *          from a residency callback, or while holding a lock that the resource's callback acquires.
+     * @param id The id of the resource.
+     */
+    void untrack(const id_type id) noexcept;
+
+    /**
+     * @brief Retrieve the number of bytes being tracked in a heap.
+     * @param heap_index The index of the heap.
+     * @return The total size of all tracked resources in the heap.
+     */
+    VkDeviceSize tracked_bytes(const std::uint32_t heap_index) const;
+
+    /**
+     * @brief Retrieve the fraction of a heap's budget at which the residency_manager starts evicting resources.
+     * @return A value greater than 0. The default is 0.9.
+     */
+    double pressure_threshold() const;
+
+    /**
+     * @brief Set the fraction of a heap's budget at which the residency_manager starts evicting resources.
+     * @param threshold The new threshold. This must be greater than 0.
+     */
+    void set_pressure_threshold(const double threshold);
+
+    /**
+     * @brief Determine whether an allocation would push a heap past the pressure threshold.
+     * @param heap_index The index of the heap.
+     * @param bytes The size of the prospective allocation.
+     * @return The number of bytes that must be released to keep the heap under the threshold. 0 if the allocation
+     *         fits.
+     */
+    VkDeviceSize overcommitment(const std::uint32_t heap_index, const VkDeviceSize bytes) const;
+
+    /**
+     * @brief Evict the least recently used resources in a heap.
+     * @details Only resources whose last use has completed on the device are considered.
+     * @param heap_index The index of the heap.
+     * @param bytes The number of bytes to release.
+     * @return The number of bytes actually released. This can be less than or greater than the requested number.
+     */
+    VkDeviceSize make_room(const std::uint32_t heap_index, const VkDeviceSize bytes);
+
+    /**
+     * @brief Evict resources until every heap is under the pressure threshold.
+     * @return The total number of bytes released.
+     */
+    VkDeviceSize trim();
+  };
+
+}
+
+#endif
+/// @endcond
@@ -0,0 +1,251 @@
+/// @cond INTERNAL
+/**
+ * @file resource_state_tracker.hpp
+ * @brief Automatic Resource State Tracking
+ * @author Alexander Rothman <[gnomesort@megate.ch](mailto:gnomesort@megate.ch)>
+ * @copyright AGPL-3.0-or-later
+ * @date 2025
+ */
+#ifndef MEGATECH_VULKAN_INTERNAL_BASE_RESOURCE_STATE_TRACKER_HPP
+#define MEGATECH_VULKAN_INTERNAL_BASE_RESOURCE_STATE_TRACKER_HPP
+
+#include <cinttypes>
+
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include "vulkandefs.hpp"
+
+namespace megatech::vulkan::internal::base {
+
+  class device_impl;
+
+  /**
+   * @brief A tracker for the synchronization state of buffers and images.
+   * @details Callers declare how the commands that they're about to record use each resource. The tracker compares
+   *          each declaration to the resource's last access, stage, layout, and queue family and computes the minimal
+   *          dependency that orders them. Pending dependencies are merged and recorded as a single
+   *          vkCmdPipelineBarrier2 when the batch is resolved. Dependencies that don't transition a layout or a queue
+   *          family are folded into one global memory barrier.
+   *
+   *          Every use declared between two resolutions is treated as part of the same batch, so declaring the same
+   *          resource twice in a batch merges the declarations. Images can't be used with two different layouts in
+   *          the same batch.
+   *
+   *          Tracked state persists between command buffers, so a tracker must only be used for command buffers that
+   *          are submitted to a single queue in the order that they're recorded. When a resource with exclusive
+   *          sharing moves to a different queue family, the tracker records the acquire half of the ownership
+   *          transfer. The matching release must be recorded on the source queue by the caller. Trackers aren't
+   *          thread-safe.
+   */
+  class resource_state_tracker final {
+  public:
+    /**
+     * @brief The parent object type required to construct a resource_state_tracker.
+     */
+    using parent_type = device_impl;
+  private:
+    struct access_state final {
+      VkPipelineStageFlags2 write_stages{ };
+      VkAccessFlags2 write_accesses{ };
+      VkPipelineStageFlags2 read_stages{ };
+      VkPipelineStageFlags2 visible_stages{ };
+      VkAccessFlags2 visible_accesses{ };
+      std::uint32_t queue_family_index{ VK_QUEUE_FAMILY_IGNORED };
+    };
+
+    struct pending_use final {
+      VkPipelineStageFlags2 stages{ };
+      VkAccessFlags2 accesses{ };
+      VkImageLayout layout{ VK_IMAGE_LAYOUT_UNDEFINED };
+      bool discard{ };
+      std::uint32_t queue_family_index{ VK_QUEUE_FAMILY_IGNORED };
+    };
+
+    struct buffer_state final {
+      access_state access{ };
+      std::optional<pending_use> pending{ };
+    };
+
+    struct image_state final {
+      access_state access{ };
+      VkImageLayout layout{ VK_IMAGE_LAYOUT_UNDEFINED };
+      VkImageSubresourceRange range{ };
+      std::optional<pending_use> pending{ };
+    };
+
+    const parent_type* m_parent{ };
+    std::unordered_map<VkBuffer, buffer_state> m_buffers{ };
+    std::unordered_map<VkImage, image_state> m_images{ };
+    std::vector<VkBuffer> m_pending_buffers{ };
+    std::vector<VkImage> m_pending_images{ };
+    VkMemoryBarrier2 m_memory_barrier{ };
+    std::vector<VkBufferMemoryBarrier2> m_buffer_barriers{ };
+    std::vector<VkImageMemoryBarrier2> m_image_barriers{ };
+    std::uint64_t m_barriers_recorded{ };
+
+    static void merge(std::optional<pending_use>& pending, const pending_use& use);
+    static bool transition(access_state& state, const pending_use& use, const bool force,
+                           VkPipelineStageFlags2& src_stages, VkAccessFlags2& src_accesses,
+                           VkPipelineStageFlags2& dst_stages, VkAccessFlags2& dst_accesses);
+  public:
+    /// @cond
+    resource_state_tracker() = delete;
+    /// @endcond
+
+    /**
+     * @brief Construct a resource_state_tracker.
+     * @param parent The device_impl that owns the tracked resources.
+     */
+    explicit resource_state_tracker(const parent_type& parent);
+
+    /// @cond
+    resource_state_tracker(const resource_state_tracker& other) = delete;
+    resource_state_tracker(resource_state_tracker&& other) = delete;
+    /// @endcond
+
+    /**
+     * @brief Destroy a resource_state_tracker.
+     */
+    ~resource_state_tracker() noexcept = default;
+
+    /// @cond
+    resource_state_tracker& operator=(const resource_state_tracker& rhs) = delete;
+    resource_state_tracker& operator=(resource_state_tracker&& rhs) = delete;
+    /// @endcond
+
+    /**
+     * @brief Retrieve the resource_state_tracker's parent object.
+     * @return A read-only reference to a device_impl.
+     */
+    const parent_type& parent() const;
+
+    /**
+     * @brief Begin tracking a buffer.
+     * @details Newly tracked buffers have no outstanding accesses other than prior_stages.
+     * @param buffer The buffer to track. This must not already be tracked.
+     * @param queue_family_index The queue family that owns the buffer, or VK_QUEUE_FAMILY_IGNORED if ownership
+     *                           doesn't need to be tracked.
+     * @param prior_stages The stages that earlier work on the buffer was made available to through external
+     *                     synchronization (e.g., the stage mask of a semaphore wait). The first barrier on the buffer
+     *                     waits for them, so it chains with that synchronization.
+     */
+    void track_buffer(const VkBuffer buffer, const std::uint32_t queue_family_index = VK_QUEUE_FAMILY_IGNORED,
+                      const VkPipelineStageFlags2 prior_stages = VK_PIPELINE_STAGE_2_NONE);
+
+    /**
+     * @brief Begin tracking an image.
+     * @details Newly tracked images have no outstanding accesses other than prior_stages.
+     * @param image The image to track. This must not already be tracked.
+     * @param range The subresources of the image that are tracked. Every barrier on the image uses this range.
+     * @param layout The current layout of the image.
+     * @param queue_family_index The queue family that owns the image, or VK_QUEUE_FAMILY_IGNORED if ownership doesn't
+     *                           need to be tracked.
+     * @param prior_stages The stages that earlier work on the image was made available to through external
+     *                     synchronization (e.g., the stage mask of a semaphore wait). The first barrier on the image,
+     *                     including a layout transition, waits for them, so it chains with that synchronization.
+     */
+    void track_image(const VkImage image, const VkImageSubresourceRange& range,
+                     const VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED,
+                     const std::uint32_t queue_family_index = VK_QUEUE_FAMILY_IGNORED,
+                     const VkPipelineStageFlags2 prior_stages = VK_PIPELINE_STAGE_2_NONE);
+
+    /**
+     * @brief Stop tracking a buffer.
+     * @details Any pending use of the buffer is discarded.
+     * @param buffer The buffer to stop tracking.
+     */
+    void untrack_buffer(const VkBuffer buffer);
+
+    /**
+     * @brief Stop tracking an image.
+     * @details Any pending use of the image is discarded.
+     * @param image The image to stop tracking.
+     */
+    void untrack_image(const VkImage image);
+
+    /**
+     * @brief Make a buffer inherit the outstanding accesses of another buffer that shares its memory.
+     * @details The next use of the aliasing buffer waits for every access to the aliased buffer that the tracker
+     *          knows of. Both buffers must be tracked.
+     * @param buffer The buffer that now occupies the memory.
+     * @param aliased The buffer that previously occupied the memory.
+     */
+    void alias_buffer(const VkBuffer buffer, const VkBuffer aliased);
+
+    /**
+     * @brief Make an image inherit the outstanding accesses of another image that shares its memory.
+     * @details The next use of the aliasing image waits for every access to the aliased image that the tracker knows
+     *          of. That use should discard the image's contents. Both images must be tracked.
+     * @param image The image that now occupies the memory.
+     * @param aliased The image that previously occupied the memory.
+     */
+    void alias_image(const VkImage image, const VkImage aliased);
+
+    /**
+     * @brief Declare a use of a buffer by the next commands to be recorded.
+     * @param buffer The buffer to use. This must be tracked.
+     * @param stages The pipeline stages that access the buffer.
+     * @param accesses The types of access that the stages perform.
+     * @param queue_family_index The queue family that uses the buffer, or VK_QUEUE_FAMILY_IGNORED to keep the
+     *                           current owner.
+     */
+    void use_buffer(const VkBuffer buffer, const VkPipelineStageFlags2 stages, const VkAccessFlags2 accesses,
+                    const std::uint32_t queue_family_index = VK_QUEUE_FAMILY_IGNORED);
+
+    /**
+     * @brief Declare a use of an image by the next commands to be recorded.
+     * @param image The image to use. This must be tracked.
+     * @param stages The pipeline stages that access the image.
+     * @param accesses The types of access that the stages perform.
+     * @param layout The layout that the stages require.
+     * @param discard Whether or not the current contents of the image can be discarded. Discarding images always
+     *                transition from VK_IMAGE_LAYOUT_UNDEFINED, which never requires earlier writes to be made visible.
+     * @param queue_family_index The queue family that uses the image, or VK_QUEUE_FAMILY_IGNORED to keep the
+     *                           current owner.
+     */
+    void use_image(const VkImage image, const VkPipelineStageFlags2 stages, const VkAccessFlags2 accesses,
+                   const VkImageLayout layout, const bool discard = false,
+                   const std::uint32_t queue_family_index = VK_QUEUE_FAMILY_IGNORED);
+
+    /**
+     * @brief Retrieve the layout of an image once every pending use has been resolved.
+     * @param image The image to query. This must be tracked.
+     * @return The image's layout.
+     */
+    VkImageLayout image_layout(const VkImage image) const;
+
+    /**
+     * @brief Determine whether or not any uses are waiting to be resolved.
+     * @return True if there are pending uses. False otherwise.
+     */
+    bool has_pending_uses() const;
+
+    /**
+     * @brief Resolve every pending use into a single dependency.
+     * @details Tracked state is updated as if the dependency had been recorded.
+     * @return A VkDependencyInfo describing the minimal dependency. If no barriers are required, every barrier count
+     *         is 0. The returned pointers remain valid until the next call to resolve() or flush().
+     */
+    VkDependencyInfo resolve();
+
+    /**
+     * @brief Resolve every pending use and record the result.
+     * @details This records at most one vkCmdPipelineBarrier2. Nothing is recorded when no barriers are required.
+     * @param command_buffer The command buffer to record into.
+     * @return True if a barrier was recorded. False otherwise.
+     */
+    bool flush(const VkCommandBuffer command_buffer);
+
+    /**
+     * @brief Retrieve the number of barrier commands that the resource_state_tracker has recorded.
+     * @return The number of vkCmdPipelineBarrier2 commands recorded by flush().
+     */
+    std::uint64_t barriers_recorded() const;
+  };
+
+}
+
+#endif
+/// @endcond
@@ -0,0 +1,167 @@
+/// @cond INTERNAL
+/**
+ * @file sparse_buffer.hpp
+ * @brief Sparse-Resident Buffers
+ * @author Alexander Rothman <[gnomesort@megate.ch](mailto:gnomesort@megate.ch)>
+ * @copyright AGPL-3.0-or-later
+ * @date 2025
+ */
+#ifndef MEGATECH_VULKAN_INTERNAL_BASE_SPARSE_BUFFER_HPP
+#define MEGATECH_VULKAN_INTERNAL_BASE_SPARSE_BUFFER_HPP
+
+#include <cinttypes>
+#include <cstddef>
+
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "../../concepts/child_object.hpp"
+#include "../../concepts/handle_owner.hpp"
+
+#include "vulkandefs.hpp"
+#include "device_impl.hpp"
+#include "sparse_page_pool.hpp"
+
+namespace megatech::vulkan::internal::base {
+
+  /**
+   * @brief A buffer whose pages are bound to memory on demand.
+   * @details sparse_buffers are created with VK_BUFFER_CREATE_SPARSE_RESIDENCY_BIT, so only the pages that are
+   *          committed occupy memory. commit() and evict() only update the sparse_buffer's page table. The changes are
+   *          sent to the device in a single batch by flush(). Committed pages have undefined contents until they're
+   *          written.
+   */
+  class sparse_buffer final {
+  public:
+    /**
+     * @brief The type of Vulkan handle owned by a sparse_buffer.
+     */
+    using handle_type = VkBuffer;
+
+    /**
+     * @brief The parent object type required to construct a sparse_buffer.
+     */
+    using parent_type = device_impl;
+  private:
+    std::shared_ptr<const parent_type> m_parent{ };
+    VkBuffer m_buffer{ };
+    VkDeviceSize m_size{ };
+    std::unique_ptr<sparse_page_pool> m_pages{ };
+    std::vector<std::optional<sparse_page>> m_page_table{ };
+    std::vector<std::size_t> m_dirty{ };
+    std::vector<bool> m_is_dirty{ };
+
+    void mark_dirty(const std::size_t page);
+  public:
+    /// @cond
+    sparse_buffer() = delete;
+    /// @endcond
+
+    /**
+     * @brief Construct a sparse_buffer.
+     * @param parent A shared_ptr to a read-only device_impl. This must not be null.
+     * @param size The size of the buffer in bytes. This must be greater than 0.
+     * @param usage The buffer's usage flags.
+     * @param resident_pages The maximum number of pages that can be resident at once. This must be greater than 0.
+     * @throw error If the device doesn't support sparse-resident buffers or if the buffer can't be created.
+     */
+    sparse_buffer(const std::shared_ptr<const parent_type>& parent, const VkDeviceSize size,
+                  const VkBufferUsageFlags usage, const std::uint32_t resident_pages);
+
+    /// @cond
+    sparse_buffer(const sparse_buffer& other) = delete;
+    sparse_buffer(sparse_buffer&& other) = delete;
+    /// @endcond
+
+    /**
+     * @brief Destroy a sparse_buffer.
+     * @details The buffer and its pages are destroyed through the device's deletion_queue once every earlier
+     *          submission completes.
+     */
+    ~sparse_buffer() noexcept;
+
+    /// @cond
+    sparse_buffer& operator=(const sparse_buffer& rhs) = delete;
+    sparse_buffer& operator=(sparse_buffer&& rhs) = delete;
+    /// @endcond
+
+    /**
+     * @brief Retrieve the sparse_buffer's underlying Vulkan handle.
+     * @return A valid VkBuffer.
+     */
+    handle_type handle() const;
+
+    /**
+     * @brief Retrieve the sparse_buffer's parent object.
+     * @return A read-only reference to a device_impl.
+     */
+    const parent_type& parent() const;
+
+    /**
+     * @brief Retrieve the size of the sparse_buffer.
+     * @return The size of the buffer in bytes.
+     */
+    VkDeviceSize size() const;
+
+    /**
+     * @brief Retrieve the size of the sparse_buffer's pages.
+     * @return The page size in bytes. Residency is tracked at this granularity.
+     */
+    VkDeviceSize page_size() const;
+
+    /**
+     * @brief Retrieve the number of pages in the sparse_buffer's page table.
+     * @return The number of pages that cover the buffer.
+     */
+    std::size_t page_count() const;
+
+    /**
+     * @brief Determine whether or not a page is committed.
+     * @details This reflects the page table, which may be ahead of the device until flush() is called.
+     * @param page The index of the page to query. This must be less than page_count().
+     * @return True if the page is committed. False otherwise.
+     */
+    bool is_resident(const std::size_t page) const;
+
+    /**
+     * @brief Retrieve the number of committed pages.
+     * @return The number of pages that are committed in the page table.
+     */
+    std::uint32_t resident_pages() const;
+
+    /**
+     * @brief Commit every page that overlaps a range of the sparse_buffer.
+     * @param offset The offset of the range in bytes.
+     * @param size The size of the range in bytes.
+     * @throw error If the range exceeds the buffer or if there aren't enough free pages.
+     */
+    void commit(const VkDeviceSize offset, const VkDeviceSize size);
+
+    /**
+     * @brief Evict every page that overlaps a range of the sparse_buffer.
+     * @details Evicted pages are reused by later commits. The flush() that applies the eviction must wait for the
+     *          device to finish using them.
+     * @param offset The offset of the range in bytes.
+     * @param size The size of the range in bytes.
+     * @throw error If the range exceeds the buffer.
+     */
+    void evict(const VkDeviceSize offset, const VkDeviceSize size);
+
+    /**
+     * @brief Send every page table change since the last flush() to the device in a single batch.
+     * @param wait_value A device timeline value to wait for before binding. Every use of an evicted page must be
+     *                   complete at this value.
+     * @return The device timeline value of the binding operation, or 0 if nothing changed.
+     * @throw error If the binding operation fails.
+     */
+    std::uint64_t flush(const std::uint64_t wait_value = 0);
+  };
+
+  static_assert(megatech::vulkan::concepts::readonly_child_object<sparse_buffer>);
+  static_assert(megatech::vulkan::concepts::handle_owner<sparse_buffer>);
+
+}
+
+#endif
+/// @endcond
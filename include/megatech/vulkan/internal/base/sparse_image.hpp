@@ -0,0 +1,280 @@
+/// @cond INTERNAL
+/**
+ * @file sparse_image.hpp
+ * @brief Sparse-Resident Images with Tile Streaming
+ * @author Alexander Rothman <[gnomesort@megate.ch](mailto:gnomesort@megate.ch)>
+ * @copyright AGPL-3.0-or-later
+ * @date 2025
+ */
+#ifndef MEGATECH_VULKAN_INTERNAL_BASE_SPARSE_IMAGE_HPP
+#define MEGATECH_VULKAN_INTERNAL_BASE_SPARSE_IMAGE_HPP
+
+#include <cinttypes>
+#include <cstddef>
+
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "../../concepts/child_object.hpp"
+#include "../../concepts/handle_owner.hpp"
+
+#include "vulkandefs.hpp"
+#include "device_impl.hpp"
+#include "memory_allocation.hpp"
+#include "buffer_pool.hpp"
+#include "command_buffer_pool.hpp"
+#include "sparse_page_pool.hpp"
+
+namespace megatech::vulkan::internal::base {
+
+  /**
+   * @brief The coordinates of a tile in a sparse_image.
+   * @details Tiles are measured in units of the image's sparse block size, so tile (1, 0) of a level begins one block
+   *          to the right of tile (0, 0).
+   */
+  struct sparse_tile final {
+    /**
+     * @brief The mip level that contains the tile.
+     */
+    std::uint32_t mip_level;
+
+    /**
+     * @brief The array layer that contains the tile.
+     */
+    std::uint32_t array_layer;
+
+    /**
+     * @brief The horizontal tile coordinate.
+     */
+    std::uint32_t x;
+
+    /**
+     * @brief The vertical tile coordinate.
+     */
+    std::uint32_t y;
+
+    /**
+     * @brief Compare two sparse_tiles for equality.
+     * @param rhs The sparse_tile to compare with.
+     * @return True if the tiles have the same coordinates. False otherwise.
+     */
+    bool operator==(const sparse_tile& rhs) const = default;
+  };
+
+  /**
+   * @brief A hash function for sparse_tiles.
+   */
+  struct sparse_tile_hash final {
+    /**
+     * @brief Hash a sparse_tile.
+     * @param tile The sparse_tile to hash.
+     * @return A hash of the tile's coordinates.
+     */
+    std::size_t operator()(const sparse_tile& tile) const noexcept;
+  };
+
+  /**
+   * @brief A 2D image whose tiles are made resident on request and streamed in from the host.
+   * @details sparse_images are created with VK_IMAGE_CREATE_SPARSE_RESIDENCY_BIT. The mip tail (the levels that are
+   *          smaller than a tile) is always resident. Every other tile is resident only after it's requested and
+   *          committed. Each tile occupies one page from a fixed budget. When the budget is exhausted, the least
+   *          recently requested tiles are evicted to make room. A tile is only evicted once the device has completed
+   *          its last use, which is its upload or the latest timeline value recorded for it with touch().
+   *
+   *          commit() processes every request since the previous commit() as a batch. It asks the tile_loader to fill
+   *          a staging page for each new tile, binds and unbinds every tile in a single vkQueueBindSparse call, and
+   *          then copies the new tiles into the image on the primary queue. Only the subresources that receive tiles
+   *          are transitioned for the copy. Staging buffers are recycled once the copy that reads them completes.
+   *          Between commits, the image is in the VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL layout. All methods are
+   *          thread-safe.
+   */
+  class sparse_image final {
+  public:
+    /**
+     * @brief The type of Vulkan handle owned by a sparse_image.
+     */
+    using handle_type = VkImage;
+
+    /**
+     * @brief The parent object type required to construct a sparse_image.
+     */
+    using parent_type = device_impl;
+
+    /**
+     * @brief The type of callback that fills a tile with texel data.
+     * @details The data is laid out as a whole tile in row-major order, even if the tile is clipped by the edge of
+     *          its mip level. The span is exactly one page large.
+     */
+    using tile_loader = std::function<void(const sparse_tile&, std::span<std::byte>)>;
+  private:
+    struct resident_tile final {
+      sparse_page page{ };
+      std::list<sparse_tile>::iterator lru{ };
+      std::uint64_t last_use{ };
+    };
+
+    std::shared_ptr<const parent_type> m_parent{ };
+    VkImage m_image{ };
+    VkImageCreateInfo m_image_info{ };
+    VkExtent3D m_granularity{ };
+    std::uint32_t m_mip_tail_first_level{ };
+    tile_loader m_loader{ };
+    std::unique_ptr<sparse_page_pool> m_pages{ };
+    std::unique_ptr<command_buffer_pool> m_commands{ };
+    std::unique_ptr<buffer_pool> m_staging{ };
+    std::vector<memory_allocation> m_mip_tail{ };
+    mutable std::mutex m_mutex{ };
+    std::unordered_map<sparse_tile, resident_tile, sparse_tile_hash> m_resident{ };
+    std::list<sparse_tile> m_lru{ };
+    std::unordered_set<sparse_tile, sparse_tile_hash> m_requested{ };
+    std::vector<sparse_tile> m_mip_tail_loads{ };
+    std::uint64_t m_bind_value{ };
+    bool m_initialized{ };
+
+    void destroy() noexcept;
+    void validate(const sparse_tile& tile) const;
+    bool is_mip_tail(const sparse_tile& tile) const;
+    VkExtent3D tile_extent(const sparse_tile& tile) const;
+  public:
+    /// @cond
+    sparse_image() = delete;
+    /// @endcond
+
+    /**
+     * @brief Construct a sparse_image.
+     * @param parent A shared_ptr to a read-only device_impl. This must not be null.
+     * @param image_info A description of the image to create. It must describe a single-sampled, optimally tiled 2D
+     *                   color image. The sparse flags and VK_IMAGE_USAGE_TRANSFER_DST_BIT are added automatically.
+     * @param resident_tiles The maximum number of tiles outside of the mip tail that can be resident at once. This must
+     *                       be greater than 0.
+     * @param loader A callback that fills each tile when it becomes resident. This must not be empty.
+     * @throw error If the device doesn't support sparse-resident images of the given format or if the image can't be
+     *              created.
+     */
+    sparse_image(const std::shared_ptr<const parent_type>& parent, const VkImageCreateInfo& image_info,
+                 const std::uint32_t resident_tiles, tile_loader loader);
+
+    /// @cond
+    sparse_image(const sparse_image& other) = delete;
+    sparse_image(sparse_image&& other) = delete;
+    /// @endcond
+
+    /**
+     * @brief Destroy a sparse_image.
+     * @details The image and its memory are destroyed through the device's deletion_queue once every earlier
+     *          submission completes.
+     */
+    ~sparse_image() noexcept;
+
+    /// @cond
+    sparse_image& operator=(const sparse_image& rhs) = delete;
+    sparse_image& operator=(sparse_image&& rhs) = delete;
+    /// @endcond
+
+    /**
+     * @brief Retrieve the sparse_image's underlying Vulkan handle.
+     * @return A valid VkImage.
+     */
+    handle_type handle() const;
+
+    /**
+     * @brief Retrieve the sparse_image's parent object.
+     * @return A read-only reference to a device_impl.
+     */
+    const parent_type& parent() const;
+
+    /**
+     * @brief Retrieve the size of a tile in texels.
+     * @return The image's sparse block size.
+     */
+    const VkExtent3D& tile_granularity() const;
+
+    /**
+     * @brief Retrieve the size of a tile's memory.
+     * @return The page size in bytes.
+     */
+    VkDeviceSize tile_size() const;
+
+    /**
+     * @brief Retrieve the first mip level of the mip tail.
+     * @return The index of the first mip level that is always resident. This equals the image's level count if there
+     *         is no mip tail.
+     */
+    std::uint32_t mip_tail_first_level() const;
+
+    /**
+     * @brief Retrieve the number of tiles that cover a mip level.
+     * @param mip_level The mip level to query. This must be less than the image's level count.
+     * @return The width and height of the mip level in tiles.
+     */
+    VkExtent2D tile_count(const std::uint32_t mip_level) const;
+
+    /**
+     * @brief Retrieve the maximum number of tiles outside of the mip tail that can be resident at once.
+     * @return The tile budget.
+     */
+    std::uint32_t tile_budget() const;
+
+    /**
+     * @brief Retrieve the number of tiles outside of the mip tail that are resident.
+     * @return The number of resident tiles.
+     */
+    std::uint32_t resident_tiles() const;
+
+    /**
+     * @brief Determine whether or not a tile is resident.
+     * @details Tiles in the mip tail are always resident. Other tiles are resident once the commit() that loaded them
+     *          has been issued. The device must still wait for that commit before sampling them.
+     * @param tile The tile to query.
+     * @return True if the tile is resident. False otherwise.
+     * @throw error If the tile is outside of the image.
+     */
+    bool is_resident(const sparse_tile& tile) const;
+
+    /**
+     * @brief Request that a tile become resident.
+     * @details Requesting a resident tile marks it as recently used, which protects it from eviction.
+     * @param tile The tile to request.
+     * @throw error If the tile is outside of the image.
+     */
+    void request(const sparse_tile& tile);
+
+    /**
+     * @brief Record a use of a resident tile by submitted work.
+     * @details The tile isn't evicted until the device completes the timeline value. Tiles that aren't resident and
+     *          tiles in the mip tail are ignored.
+     * @param tile The tile that the work samples.
+     * @param timeline_value The device timeline value that completes the work. Values older than the tile's current
+     *                       last use are ignored.
+     * @throw error If the tile is outside of the image.
+     */
+    void touch(const sparse_tile& tile, const std::uint64_t timeline_value);
+
+    /**
+     * @brief Load every requested tile and update the image's bindings in a single batch.
+     * @details If there are more requests than the budget allows, the remaining requests are kept for the next
+     *          commit(). The same is true when every tile that could be evicted is still in use by the device, so
+     *          committing never waits for earlier work. If the tile_loader throws, nothing is bound, and every request
+     *          is kept. The tile_loader is invoked while the sparse_image is locked, so it must not call the
+     *          sparse_image's methods.
+     * @param wait_value A device timeline value to wait for before binding, or 0 to bind as soon as possible.
+     * @return The device timeline value of the upload. Work that samples the image must wait for it. 0 if nothing
+     *         was committed.
+     * @throw error If binding or uploading fails.
+     */
+    std::uint64_t commit(const std::uint64_t wait_value);
+  };
+
+  static_assert(megatech::vulkan::concepts::readonly_child_object<sparse_image>);
+  static_assert(megatech::vulkan::concepts::handle_owner<sparse_image>);
+
+}
+
+#endif
+/// @endcond
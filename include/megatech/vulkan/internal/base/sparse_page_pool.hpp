@@ -0,0 +1,160 @@
+/// @cond INTERNAL
+/**
+ * @file sparse_page_pool.hpp
+ * @brief Pooled Memory Pages for Sparse Resources
+ * @author Alexander Rothman <[gnomesort@megate.ch](mailto:gnomesort@megate.ch)>
+ * @copyright AGPL-3.0-or-later
+ * @date 2025
+ */
+#ifndef MEGATECH_VULKAN_INTERNAL_BASE_SPARSE_PAGE_POOL_HPP
+#define MEGATECH_VULKAN_INTERNAL_BASE_SPARSE_PAGE_POOL_HPP
+
+#include <cinttypes>
+#include <cstddef>
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "../../concepts/child_object.hpp"
+
+#include "vulkandefs.hpp"
+#include "device_impl.hpp"
+#include "memory_allocation.hpp"
+#include "residency_manager.hpp"
+
+namespace megatech::vulkan::internal::base {
+
+  /**
+   * @brief A page of device memory that can be bound to a sparse resource.
+   */
+  struct sparse_page final {
+    /**
+     * @brief The memory that contains the page.
+     */
+    VkDeviceMemory memory;
+
+    /**
+     * @brief The offset of the page within its memory, in bytes.
+     */
+    VkDeviceSize offset;
+  };
+
+  /**
+   * @brief A pool of equally sized device memory pages for sparse resources.
+   * @details Pages are carved out of larger blocks of device-local memory so that paging a resource in and out doesn't
+   *          allocate. Blocks are allocated on demand until the pool reaches its capacity. Every block is tracked by
+   *          the device's residency_manager, so blocks whose pages have all been released are freed, least recently
+   *          used first, once the device is finished with them and their heap nears its budget. sparse_page_pools
+   *          don't track bindings. Callers must unbind a page, or rebind it after the device is finished with it,
+   *          before reusing it. All methods are thread-safe.
+   */
+  class sparse_page_pool final {
+  public:
+    /**
+     * @brief The parent object type required to construct a sparse_page_pool.
+     */
+    using parent_type = device_impl;
+  private:
+    struct block final {
+      memory_allocation memory{ };
+      residency_manager::id_type residency_id{ };
+      std::uint32_t pages{ };
+      std::uint32_t free_pages{ };
+    };
+
+    std::shared_ptr<const parent_type> m_parent{ };
+    VkMemoryRequirements m_requirements{ };
+    std::uint32_t m_pages_per_block{ };
+    std::uint32_t m_capacity{ };
+    VkMemoryAllocateFlags m_allocate_flags{ };
+    mutable std::mutex m_mutex{ };
+    std::vector<block> m_blocks{ };
+    std::vector<sparse_page> m_free{ };
+    std::uint32_t m_allocated_pages{ };
+
+    block& find_block(const VkDeviceMemory memory);
+    VkDeviceSize evict_block(const VkDeviceMemory memory);
+  public:
+    /// @cond
+    sparse_page_pool() = delete;
+    /// @endcond
+
+    /**
+     * @brief Construct a sparse_page_pool.
+     * @param parent A shared_ptr to a read-only device_impl. This must not be null.
+     * @param requirements The memory requirements of the sparse resource. The alignment is used as the page size.
+     * @param capacity The maximum number of pages that the pool can allocate. This must be greater than 0.
+     * @param pages_per_block The number of pages allocated at once. This must be greater than 0.
+     * @param allocate_flags Flags to allocate each block with. For example, buffers that can be addressed from shaders
+     *                       need VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT.
+     */
+    sparse_page_pool(const std::shared_ptr<const parent_type>& parent, const VkMemoryRequirements& requirements,
+                     const std::uint32_t capacity, const std::uint32_t pages_per_block = 16,
+                     const VkMemoryAllocateFlags allocate_flags = 0);
+
+    /// @cond
+    sparse_page_pool(const sparse_page_pool& other) = delete;
+    sparse_page_pool(sparse_page_pool&& other) = delete;
+    /// @endcond
+
+    /**
+     * @brief Destroy a sparse_page_pool.
+     * @details The blocks stop being tracked by the device's residency_manager and are freed through the device's
+     *          deletion_queue once every earlier submission completes.
+     */
+    ~sparse_page_pool() noexcept;
+
+    /// @cond
+    sparse_page_pool& operator=(const sparse_page_pool& rhs) = delete;
+    sparse_page_pool& operator=(sparse_page_pool&& rhs) = delete;
+    /// @endcond
+
+    /**
+     * @brief Retrieve the sparse_page_pool's parent object.
+     * @return A read-only reference to a device_impl.
+     */
+    const parent_type& parent() const;
+
+    /**
+     * @brief Retrieve the size of each page.
+     * @return The page size in bytes.
+     */
+    VkDeviceSize page_size() const;
+
+    /**
+     * @brief Retrieve the maximum number of pages that the sparse_page_pool can allocate.
+     * @return The capacity of the pool in pages.
+     */
+    std::uint32_t capacity() const;
+
+    /**
+     * @brief Retrieve the number of pages that can be acquired without exceeding the capacity.
+     * @return The number of free or unallocated pages.
+     */
+    std::uint32_t available() const;
+
+    /**
+     * @brief Acquire a page.
+     * @details If no page is free, another block is allocated. Allocation happens without holding the pool's lock,
+     *          since making room for the block may evict the pool's own idle blocks.
+     * @return A sparse_page whose contents are undefined.
+     * @throw error If the pool is at capacity or if a block can't be allocated.
+     */
+    sparse_page acquire();
+
+    /**
+     * @brief Return a page to the sparse_page_pool.
+     * @details The page's block is marked as used at the device's current timeline value, so it can't be evicted
+     *          until every earlier submission completes.
+     * @param page A page previously acquired from the pool.
+     */
+    void release(const sparse_page& page);
+  };
+
+  static_assert(megatech::vulkan::concepts::readonly_child_object<sparse_page_pool>);
+
+}
+
+#endif
+/// @endcond
@@ -0,0 +1,156 @@
+/// @cond INTERNAL
+/**
+ * @file split_barrier.hpp
+ * @brief Event-Based Split Barriers
+ * @author Alexander Rothman <[gnomesort@megate.ch](mailto:gnomesort@megate.ch)>
+ * @copyright AGPL-3.0-or-later
+ * @date 2025
+ */
+#ifndef MEGATECH_VULKAN_INTERNAL_BASE_SPLIT_BARRIER_HPP
+#define MEGATECH_VULKAN_INTERNAL_BASE_SPLIT_BARRIER_HPP
+
+#include <cinttypes>
+
+#include <vector>
+
+#include "vulkandefs.hpp"
+
+namespace megatech::vulkan::internal::base {
+
+  class device_impl;
+
+  /**
+   * @brief A pipeline barrier split into a signal after its producer and a wait before its consumer.
+   * @details vkCmdPipelineBarrier2 makes every later command wait for the barrier's source stages, including commands
+   *          that have nothing to do with the barrier. A split_barrier instead records vkCmdSetEvent2 immediately after
+   *          the producing commands and vkCmdWaitEvents2 immediately before the consuming commands. Commands recorded
+   *          between the two keep running while the producer finishes.
+   *
+   *          Barriers are added before the signal is recorded (e.g., from resource_state_tracker::resolve()). The same
+   *          dependency is used for both halves, as Vulkan requires. The signal and the wait must be recorded in that
+   *          order on the same queue, though they may be in different command buffers. The event is borrowed from the
+   *          device's event pool and must be returned by retire() once the commands that use it have been submitted.
+   *          split_barriers aren't thread-safe.
+   */
+  class split_barrier final {
+  public:
+    /**
+     * @brief The parent object type required to construct a split_barrier.
+     */
+    using parent_type = device_impl;
+  private:
+    const parent_type* m_parent{ };
+    VkEvent m_event{ VK_NULL_HANDLE };
+    std::vector<VkMemoryBarrier2> m_memory_barriers{ };
+    std::vector<VkBufferMemoryBarrier2> m_buffer_barriers{ };
+    std::vector<VkImageMemoryBarrier2> m_image_barriers{ };
+    bool m_signaled{ };
+    bool m_waited{ };
+
+    VkDependencyInfo dependency_info() const;
+  public:
+    /// @cond
+    split_barrier() = delete;
+    /// @endcond
+
+    /**
+     * @brief Construct a split_barrier.
+     * @param parent The device_impl that records the barrier. This must outlive the split_barrier.
+     */
+    explicit split_barrier(const parent_type& parent);
+
+    /// @cond
+    split_barrier(const split_barrier& other) = delete;
+    split_barrier(split_barrier&& other) = delete;
+    /// @endcond
+
+    /**
+     * @brief Destroy a split_barrier.
+     * @details A split_barrier whose signal was recorded must be retired first. If it wasn't, its event is leaked,
+     *          since there's no way to know when the device is finished with it. Unsignaled events are returned to the
+     *          pool immediately.
+     */
+    ~split_barrier() noexcept;
+
+    /// @cond
+    split_barrier& operator=(const split_barrier& rhs) = delete;
+    split_barrier& operator=(split_barrier&& rhs) = delete;
+    /// @endcond
+
+    /**
+     * @brief Retrieve the split_barrier's parent object.
+     * @return A read-only reference to a device_impl.
+     */
+    const parent_type& parent() const;
+
+    /**
+     * @brief Retrieve the event that the split_barrier signals.
+     * @return A VkEvent, or VK_NULL_HANDLE if the split_barrier was retired.
+     */
+    VkEvent event() const;
+
+    /**
+     * @brief Add every barrier in a dependency to the split_barrier.
+     * @param dependency The barriers to add. Dependency flags are ignored.
+     * @throw error If the signal was already recorded.
+     */
+    void add(const VkDependencyInfo& dependency);
+
+    /**
+     * @brief Add a global memory barrier to the split_barrier.
+     * @param barrier The barrier to add.
+     * @throw error If the signal was already recorded.
+     */
+    void add(const VkMemoryBarrier2& barrier);
+
+    /**
+     * @brief Add a buffer memory barrier to the split_barrier.
+     * @details Queue family ownership transfers can't be split, so the barrier's queue family indices are ignored.
+     * @param barrier The barrier to add.
+     * @throw error If the signal was already recorded.
+     */
+    void add(const VkBufferMemoryBarrier2& barrier);
+
+    /**
+     * @brief Add an image memory barrier to the split_barrier.
+     * @details Queue family ownership transfers can't be split, so the barrier's queue family indices are ignored.
+     * @param barrier The barrier to add.
+     * @throw error If the signal was already recorded.
+     */
+    void add(const VkImageMemoryBarrier2& barrier);
+
+    /**
+     * @brief Determine whether or not the split_barrier has any barriers to record.
+     * @return True if no barriers were added. False otherwise.
+     */
+    bool empty() const;
+
+    /**
+     * @brief Record the signaling half of the barrier after the producing commands.
+     * @details Nothing is recorded if the split_barrier is empty.
+     * @param command_buffer The command buffer to record into.
+     * @throw error If the signal was already recorded or the split_barrier was retired.
+     */
+    void signal(const VkCommandBuffer command_buffer);
+
+    /**
+     * @brief Record the waiting half of the barrier before the consuming commands.
+     * @details Nothing is recorded if the split_barrier is empty.
+     * @param command_buffer The command buffer to record into.
+     * @throw error If the signal wasn't recorded or the wait was already recorded.
+     */
+    void wait(const VkCommandBuffer command_buffer);
+
+    /**
+     * @brief Return the split_barrier's event to the device's event pool.
+     * @details The split_barrier can't be recorded afterward.
+     * @param timeline_value The device timeline value that completes the last command buffer that recorded the
+     *                       barrier, or 0 if no submitted command buffer recorded it.
+     */
+    void retire(const std::uint64_t timeline_value);
+  };
+
+}
+
+#endif
+/// @endcond
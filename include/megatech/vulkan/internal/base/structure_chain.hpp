@@ -0,0 +1,355 @@
+/// @cond INTERNAL
+/**
+ * @file structure_chain.hpp
+ * @brief Typed Vulkan Structure Chains
+ * @author Alexander Rothman <[gnomesort@megate.ch](mailto:gnomesort@megate.ch)>
+ * @copyright AGPL-3.0-or-later
+ * @date 2025
+ */
+#ifndef MEGATECH_VULKAN_INTERNAL_BASE_STRUCTURE_CHAIN_HPP
+#define MEGATECH_VULKAN_INTERNAL_BASE_STRUCTURE_CHAIN_HPP
+
+#include <cstddef>
+
+#include <bit>
+#include <concepts>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "vulkandefs.hpp"
+
+/**
+ * @def MEGATECH_VULKAN_INTERNAL_BASE_NO_UNIQUE_ADDRESS
+ * @brief Mark a member as potentially overlapping.
+ * @details Allegedly, Microsoft ignores [[no_unique_address]], even in C++20 mode. The MSVC specific attribute
+ *          shouldn't be ignored.
+ */
+#ifdef _MSC_VER
+  #define MEGATECH_VULKAN_INTERNAL_BASE_NO_UNIQUE_ADDRESS [[msvc::no_unique_address]]
+#else
+  #define MEGATECH_VULKAN_INTERNAL_BASE_NO_UNIQUE_ADDRESS [[no_unique_address]]
+#endif
+
+namespace megatech::vulkan::internal::base {
+
+  /**
+   * @brief A concept describing Vulkan structures that can be part of a pNext chain.
+   */
+  template <typename Type>
+  concept vk_chainable_structure = std::is_trivially_copyable_v<Type> && requires (Type&& t) {
+    { t.sType } -> std::convertible_to<VkStructureType>;
+    { t.pNext } -> std::convertible_to<const void*>;
+  };
+
+  /**
+   * @brief A concept describing extended Vulkan feature structures.
+   * @details These are structures that contain nothing but an sType, a pNext, and VkBool32 members.
+   */
+  template <typename Type>
+  concept vk_extended_feature_type = requires (Type&& t) {
+    alignof(Type) >= sizeof(VkBool32);
+    { t.sType } -> std::convertible_to<VkStructureType>;
+    { t.pNext } -> std::convertible_to<void*>;
+  };
+
+  /// @cond
+  // All of this stuff is so that I can safely compare and merge Vulkan features in a way that isn't disastrously
+  // unmaintainable. It is, merely, sort of unmaintainable.
+  namespace detail {
+
+    template <std::size_t Padding>
+    struct padding final {
+      char pad[Padding];
+    };
+
+    struct empty final { };
+
+    template <vk_extended_feature_type Type>
+    struct padded_feature final {
+      VkBool32 value;
+
+      // This is required to ensure that pad is 0 when sizeof(void*) <= 4.
+      MEGATECH_VULKAN_INTERNAL_BASE_NO_UNIQUE_ADDRESS
+      std::conditional_t<(alignof(Type) > sizeof(VkBool32)), padding<alignof(Type) - sizeof(VkBool32)>, empty> pad;
+    };
+
+    template <vk_extended_feature_type Type>
+    constexpr std::size_t feature_count() {
+      return (sizeof(Type) - (alignof(Type) << 1)) / sizeof(padded_feature<Type>);
+    }
+
+    template <vk_extended_feature_type Type>
+    struct extended_feature_array final {
+      VkStructureType sType;
+      void* pNext;
+      padded_feature<Type> elements[feature_count<Type>()];
+    };
+
+    struct basic_feature_array final {
+      VkBool32 elements[sizeof(VkPhysicalDeviceFeatures) / sizeof(VkBool32)];
+    };
+
+  }
+  /// @endcond
+
+  /**
+   * @brief Determine whether or not a set of extended features satisfies a set of required features.
+   * @details This works by converting the feature objects into an array-esque type and then doing the comparison
+   *          iteratively.
+   * @param actual The available features.
+   * @param required The required features.
+   * @return False if any feature is enabled in required but not in actual. True otherwise.
+   */
+  template <vk_extended_feature_type Feature>
+  bool featurecmp(const Feature& actual, const Feature& required) {
+    const auto a_arr = std::bit_cast<detail::extended_feature_array<Feature>>(actual);
+    const auto r_arr = std::bit_cast<detail::extended_feature_array<Feature>>(required);
+    for (auto i = std::size_t{ 0 }; i < detail::feature_count<Feature>(); ++i)
+    {
+      if (r_arr.elements[i].value && !a_arr.elements[i].value)
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /**
+   * @brief Determine whether or not a set of Vulkan 1.0 features satisfies a set of required features.
+   * @param actual The available features.
+   * @param required The required features.
+   * @return False if any feature is enabled in required but not in actual. True otherwise.
+   */
+  inline bool featurecmp(const VkPhysicalDeviceFeatures& actual, const VkPhysicalDeviceFeatures& required) {
+    const auto a_arr = std::bit_cast<detail::basic_feature_array>(actual);
+    const auto r_arr = std::bit_cast<detail::basic_feature_array>(required);
+    for (auto i = std::size_t{ 0 }; i < (sizeof(VkPhysicalDeviceFeatures) / sizeof(VkBool32)); ++i)
+    {
+      if (r_arr.elements[i] && !a_arr.elements[i])
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /**
+   * @brief Merge two sets of extended features.
+   * @param a The first set of features. Its sType and pNext are preserved.
+   * @param b The second set of features.
+   * @return A set of features where each feature is enabled if it's enabled in either a or b.
+   */
+  template <vk_extended_feature_type Feature>
+  Feature featuremerge(const Feature& a, const Feature& b) {
+    auto a_arr = std::bit_cast<detail::extended_feature_array<Feature>>(a);
+    const auto b_arr = std::bit_cast<detail::extended_feature_array<Feature>>(b);
+    for (auto i = std::size_t{ 0 }; i < detail::feature_count<Feature>(); ++i) {
+      a_arr.elements[i].value = a_arr.elements[i].value || b_arr.elements[i].value;
+    }
+    return std::bit_cast<Feature>(a_arr);
+  }
+
+  /**
+   * @brief Merge two sets of Vulkan 1.0 features.
+   * @param a The first set of features.
+   * @param b The second set of features.
+   * @return A set of features where each feature is enabled if it's enabled in either a or b.
+   */
+  inline VkPhysicalDeviceFeatures featuremerge(const VkPhysicalDeviceFeatures& a, const VkPhysicalDeviceFeatures& b) {
+    auto a_arr = std::bit_cast<detail::basic_feature_array>(a);
+    const auto b_arr = std::bit_cast<detail::basic_feature_array>(b);
+    for (auto i = std::size_t{ 0 }; i < (sizeof(VkPhysicalDeviceFeatures) / sizeof(VkBool32)); ++i) {
+      a_arr.elements[i] = a_arr.elements[i] || b_arr.elements[i];
+    }
+    return std::bit_cast<VkPhysicalDeviceFeatures>(a_arr);
+  }
+
+  /**
+   * @brief The VkStructureType of a Vulkan structure.
+   * @details This is VK_STRUCTURE_TYPE_MAX_ENUM unless it's specialized. Specializations are provided for the
+   *          extended property structures that this library uses. Others can be added as needed.
+   * @tparam Structure The type of structure.
+   */
+  template <typename Structure>
+  inline constexpr VkStructureType structure_type_v = VK_STRUCTURE_TYPE_MAX_ENUM;
+
+  /// @cond
+  template <>
+  inline constexpr VkStructureType structure_type_v<VkPhysicalDeviceVulkan11Properties> =
+    VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_1_PROPERTIES;
+
+  template <>
+  inline constexpr VkStructureType structure_type_v<VkPhysicalDeviceVulkan12Properties> =
+    VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_PROPERTIES;
+
+  template <>
+  inline constexpr VkStructureType structure_type_v<VkPhysicalDeviceVulkan13Properties> =
+    VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_PROPERTIES;
+
+  template <>
+  inline constexpr VkStructureType structure_type_v<VkPhysicalDeviceSubgroupSizeControlProperties> =
+    VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SUBGROUP_SIZE_CONTROL_PROPERTIES;
+
+  template <>
+  inline constexpr VkStructureType structure_type_v<VkPhysicalDeviceDriverProperties> =
+    VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DRIVER_PROPERTIES;
+
+  template <>
+  inline constexpr VkStructureType structure_type_v<VkPhysicalDevicePushDescriptorPropertiesKHR> =
+    VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PUSH_DESCRIPTOR_PROPERTIES_KHR;
+
+  template <>
+  inline constexpr VkStructureType structure_type_v<VkPhysicalDeviceDescriptorBufferPropertiesEXT> =
+    VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_PROPERTIES_EXT;
+  /// @endcond
+
+  /**
+   * @brief Create a zeroed Vulkan structure with its sType set.
+   * @tparam Structure The type of structure to create.
+   * @param type The structure's VkStructureType.
+   * @return A Structure with every member except sType set to 0.
+   */
+  template <vk_chainable_structure Structure>
+  constexpr Structure make_structure(const VkStructureType type) {
+    auto result = Structure{ };
+    result.sType = type;
+    return result;
+  }
+
+  /**
+   * @brief A fixed set of Vulkan structures that can be linked into a single pNext chain.
+   * @details The structures are stored inline, so building and querying a chain never allocates. Chains are only
+   *          linked on request. link() connects every structure in order and unlink() resets every pNext to nullptr.
+   *          Copies of a chain are always unlinked, because a linked chain points into its own storage.
+   * @tparam Structures The types of structures in the chain. Each type must appear only once.
+   */
+  template <vk_chainable_structure... Structures>
+  requires (sizeof...(Structures) > 0)
+  class structure_chain final {
+  private:
+    std::tuple<Structures...> m_structures{ };
+
+    template <std::size_t... Indices>
+    void* link(void *const next, std::index_sequence<Indices...>) {
+      auto* current = next;
+      // Linking back to front leaves current pointing at the first structure.
+      ((std::get<sizeof...(Structures) - 1 - Indices>(m_structures).pNext = current,
+        current = &std::get<sizeof...(Structures) - 1 - Indices>(m_structures)), ...);
+      return current;
+    }
+  public:
+    /**
+     * @brief Construct a structure_chain of zeroed structures.
+     * @details Every sType is 0. This is mostly useful as a target for assignment.
+     */
+    constexpr structure_chain() = default;
+
+    /**
+     * @brief Construct a structure_chain from a set of structures.
+     * @param structures The initial values of the structures in the chain. Their pNext members are ignored.
+     */
+    constexpr explicit structure_chain(const Structures&... structures) :
+    m_structures{ structures... } {
+      unlink();
+    }
+
+    /**
+     * @brief Copy a structure_chain.
+     * @param other The chain to copy. The copy is unlinked.
+     */
+    constexpr structure_chain(const structure_chain& other) :
+    m_structures{ other.m_structures } {
+      unlink();
+    }
+
+    /**
+     * @brief Destroy a structure_chain.
+     */
+    constexpr ~structure_chain() noexcept = default;
+
+    /**
+     * @brief Copy-assign a structure_chain.
+     * @param rhs The chain to copy. The result is unlinked.
+     * @return A reference to the assigned chain.
+     */
+    constexpr structure_chain& operator=(const structure_chain& rhs) {
+      m_structures = rhs.m_structures;
+      unlink();
+      return *this;
+    }
+
+    /**
+     * @brief Retrieve the number of structures in a structure_chain.
+     * @return The number of structures.
+     */
+    static constexpr std::size_t size() {
+      return sizeof...(Structures);
+    }
+
+    /**
+     * @brief Retrieve a structure from a structure_chain.
+     * @tparam Structure The type of structure to retrieve.
+     * @return A reference to the structure.
+     */
+    template <typename Structure>
+    constexpr Structure& get() {
+      return std::get<Structure>(m_structures);
+    }
+
+    /**
+     * @brief Retrieve a structure from a structure_chain.
+     * @tparam Structure The type of structure to retrieve.
+     * @return A read-only reference to the structure.
+     */
+    template <typename Structure>
+    constexpr const Structure& get() const {
+      return std::get<Structure>(m_structures);
+    }
+
+    /**
+     * @brief Link every structure in a structure_chain into a single pNext chain.
+     * @details The chain must not be moved or copied while it's linked, since the links would dangle.
+     * @param next An optional pointer to append after the last structure.
+     * @return A pointer to the first structure. This is suitable for the pNext member of a chain's head (e.g.,
+     *         VkPhysicalDeviceFeatures2).
+     */
+    void* link(void *const next = nullptr) {
+      return link(next, std::index_sequence_for<Structures...>{ });
+    }
+
+    /**
+     * @brief Reset the pNext member of every structure in a structure_chain to nullptr.
+     */
+    constexpr void unlink() {
+      ((std::get<Structures>(m_structures).pNext = nullptr), ...);
+    }
+  };
+
+  /**
+   * @brief Determine whether or not a chain of extended features satisfies a chain of required features.
+   * @param actual The available features.
+   * @param required The required features.
+   * @return False if any feature is enabled in required but not in actual. True otherwise.
+   */
+  template <vk_extended_feature_type... Features>
+  bool featurecmp(const structure_chain<Features...>& actual, const structure_chain<Features...>& required) {
+    return (featurecmp(actual.template get<Features>(), required.template get<Features>()) && ...);
+  }
+
+  /**
+   * @brief Merge two chains of extended features.
+   * @param a The first chain of features.
+   * @param b The second chain of features.
+   * @return An unlinked chain where each feature is enabled if it's enabled in either a or b.
+   */
+  template <vk_extended_feature_type... Features>
+  structure_chain<Features...> featuremerge(const structure_chain<Features...>& a,
+                                            const structure_chain<Features...>& b) {
+    return structure_chain<Features...>{ featuremerge(a.template get<Features>(), b.template get<Features>())... };
+  }
+
+}
+
+#endif
+/// @endcond
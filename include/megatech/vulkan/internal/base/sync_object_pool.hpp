@@ -0,0 +1,200 @@
+/// @cond INTERNAL
+/**
+ * @file sync_object_pool.hpp
+ * @brief Recycled Fences, Binary Semaphores, and Events
+ * @author Alexander Rothman <[gnomesort@megate.ch](mailto:gnomesort@megate.ch)>
+ * @copyright AGPL-3.0-or-later
+ * @date 2025
+ */
+#ifndef MEGATECH_VULKAN_INTERNAL_BASE_SYNC_OBJECT_POOL_HPP
+#define MEGATECH_VULKAN_INTERNAL_BASE_SYNC_OBJECT_POOL_HPP
+
+#include <cinttypes>
+#include <cstddef>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "vulkandefs.hpp"
+
+namespace megatech::vulkan::internal::base {
+
+  class device_impl;
+
+  /**
+   * @brief Operations for pooling VkFences.
+   * @details Fences are created unsignaled and reset in batches with a single vkResetFences call. They're exportable
+   *          as sync files when the device supports it.
+   */
+  struct fence_traits final {
+    using handle_type = VkFence;
+
+    static constexpr bool needs_reset{ true };
+
+    static handle_type create(const device_impl& device);
+    static void reset(const device_impl& device, const std::span<const handle_type> handles);
+    static void destroy(const device_impl& device, const handle_type handle) noexcept;
+  };
+
+  /**
+   * @brief Operations for pooling binary VkSemaphores.
+   * @details Binary semaphores are unsignaled once the wait that consumed them completes, so they never need to be
+   *          reset. They're exportable as sync files when the device supports it.
+   */
+  struct semaphore_traits final {
+    using handle_type = VkSemaphore;
+
+    static constexpr bool needs_reset{ false };
+
+    static handle_type create(const device_impl& device);
+    static void reset(const device_impl& device, const std::span<const handle_type> handles);
+    static void destroy(const device_impl& device, const handle_type handle) noexcept;
+  };
+
+  /**
+   * @brief Operations for pooling VkEvents.
+   * @details Events are reset from the host, so they aren't created with VK_EVENT_CREATE_DEVICE_ONLY_BIT.
+   */
+  struct event_traits final {
+    using handle_type = VkEvent;
+
+    static constexpr bool needs_reset{ true };
+
+    static handle_type create(const device_impl& device);
+    static void reset(const device_impl& device, const std::span<const handle_type> handles);
+    static void destroy(const device_impl& device, const handle_type handle) noexcept;
+  };
+
+  /**
+   * @brief A pool of synchronization objects that are recycled instead of destroyed.
+   * @details Each thread that uses a sync_object_pool gets a small cache in front of the pool's shared free list.
+   *          Acquiring and releasing objects only touches the calling thread's cache until it runs dry or overflows,
+   *          at which point half a cache's worth of objects moves to or from the shared list under a lock. Objects
+   *          that need to be reset are reset in batches when a cache or the shared list is refilled. Once the caches
+   *          and free lists reach their steady state sizes, neither acquiring nor releasing allocates.
+   *
+   *          Objects released with a timeline value wait in the shared list until the device completes that value.
+   *          When a thread exits, the objects in its cache are returned to the shared list. All methods are
+   *          thread-safe.
+   * @tparam Traits One of fence_traits, semaphore_traits, or event_traits.
+   */
+  template <typename Traits>
+  class sync_object_pool final {
+  public:
+    /**
+     * @brief The type of Vulkan object that a sync_object_pool recycles.
+     */
+    using handle_type = typename Traits::handle_type;
+
+    /**
+     * @brief The parent object type required to construct a sync_object_pool.
+     */
+    using parent_type = device_impl;
+
+    /**
+     * @brief The maximum number of objects that a single thread caches in each of its ready and reset lists.
+     */
+    static constexpr std::size_t cache_capacity{ 16 };
+  private:
+    struct local_cache final {
+      std::mutex mutex{ };
+      sync_object_pool* pool{ };
+      std::vector<handle_type> ready{ };
+      std::vector<handle_type> dirty{ };
+    };
+
+    const parent_type* m_parent{ };
+    std::uint64_t m_id{ };
+    mutable std::mutex m_mutex{ };
+    std::vector<handle_type> m_free{ };
+    std::vector<handle_type> m_dirty{ };
+    std::vector<std::pair<std::uint64_t, handle_type>> m_pending{ };
+    std::vector<std::shared_ptr<local_cache>> m_caches{ };
+    std::atomic<std::size_t> m_size{ };
+
+    local_cache& local();
+    void reclaim(local_cache& cache) noexcept;
+    void refill(local_cache& cache);
+    void spill(std::vector<handle_type>& list, std::vector<handle_type>& destination);
+  public:
+    /// @cond
+    sync_object_pool() = delete;
+    /// @endcond
+
+    /**
+     * @brief Construct a sync_object_pool.
+     * @param parent The device_impl that owns the pooled objects. This must outlive the sync_object_pool.
+     */
+    explicit sync_object_pool(const parent_type& parent);
+
+    /// @cond
+    sync_object_pool(const sync_object_pool& other) = delete;
+    sync_object_pool(sync_object_pool&& other) = delete;
+    /// @endcond
+
+    /**
+     * @brief Destroy a sync_object_pool.
+     * @details Every pooled object is destroyed immediately. The device must be idle, and no other thread may be
+     *          using the pool.
+     */
+    ~sync_object_pool() noexcept;
+
+    /// @cond
+    sync_object_pool& operator=(const sync_object_pool& rhs) = delete;
+    sync_object_pool& operator=(sync_object_pool&& rhs) = delete;
+    /// @endcond
+
+    /**
+     * @brief Retrieve the sync_object_pool's parent object.
+     * @return A read-only reference to a device_impl.
+     */
+    const parent_type& parent() const;
+
+    /**
+     * @brief Acquire an unsignaled object.
+     * @return A handle that is ready to use. It must be returned with release() rather than destroyed.
+     */
+    handle_type acquire();
+
+    /**
+     * @brief Return an object to the sync_object_pool.
+     * @param handle An object previously acquired from the pool. It may be signaled.
+     * @param timeline_value The device timeline value that must complete before the object can be reused, or 0 if
+     *                       no pending device work uses the object.
+     */
+    void release(const handle_type handle, const std::uint64_t timeline_value = 0);
+
+    /**
+     * @brief Retrieve the number of objects owned by the sync_object_pool.
+     * @return The number of objects that the pool has created, whether they're acquired or not.
+     */
+    std::size_t size() const;
+  };
+
+  extern template class sync_object_pool<fence_traits>;
+  extern template class sync_object_pool<semaphore_traits>;
+  extern template class sync_object_pool<event_traits>;
+
+  /**
+   * @brief A sync_object_pool of VkFences.
+   */
+  using fence_pool = sync_object_pool<fence_traits>;
+
+  /**
+   * @brief A sync_object_pool of binary VkSemaphores.
+   */
+  using semaphore_pool = sync_object_pool<semaphore_traits>;
+
+  /**
+   * @brief A sync_object_pool of VkEvents.
+   */
+  using event_pool = sync_object_pool<event_traits>;
+
+}
+
+#endif
+/// @endcond
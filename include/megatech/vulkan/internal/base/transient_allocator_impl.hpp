@@ -0,0 +1,167 @@
+/// @cond INTERNAL
+/**
+ * @file transient_allocator_impl.hpp
+ * @brief Transient Allocator Implementation
+ * @author Alexander Rothman <[gnomesort@megate.ch](mailto:gnomesort@megate.ch)>
+ * @copyright AGPL-3.0-or-later
+ * @date 2025
+ */
+#ifndef MEGATECH_VULKAN_INTERNAL_BASE_TRANSIENT_ALLOCATOR_IMPL_HPP
+#define MEGATECH_VULKAN_INTERNAL_BASE_TRANSIENT_ALLOCATOR_IMPL_HPP
+
+#include <cinttypes>
+#include <cstddef>
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "../../concepts/child_object.hpp"
+
+#include "vulkandefs.hpp"
+#include "device_impl.hpp"
+#include "memory_allocation.hpp"
+
+namespace megatech::vulkan::internal::base {
+
+  /**
+   * @brief A block of memory allocated by a transient_allocator_impl.
+   */
+  struct transient_block final {
+    /**
+     * @brief A host pointer to the block.
+     */
+    std::byte* data;
+
+    /**
+     * @brief The device address of the block.
+     */
+    VkDeviceAddress device_address;
+
+    /**
+     * @brief The buffer that contains the block.
+     */
+    VkBuffer buffer;
+
+    /**
+     * @brief The offset of the block within its buffer, in bytes.
+     */
+    VkDeviceSize offset;
+  };
+
+  /**
+   * @brief The implementation of a megatech::vulkan::transient_allocator.
+   * @details transient_allocator_impls own one persistently mapped buffer per frame in flight. Each frame allocates
+   *          from its buffer by bumping an atomic offset with a compare-and-swap, so an uncontended allocation is a
+   *          single atomic operation. An allocation that doesn't fit leaves the offset untouched. When the next
+   *          frame begins, the oldest buffer is reused once the device completes the timeline value of the last frame
+   *          that used it. Buffers are placed in device-local memory when the host can write it directly and in
+   *          host memory otherwise.
+   */
+  class transient_allocator_impl final {
+  public:
+    /**
+     * @brief The parent object type required to construct a transient_allocator_impl.
+     */
+    using parent_type = device_impl;
+
+    /**
+     * @brief The granularity of every allocation in bytes.
+     * @details Allocation sizes are rounded up to a multiple of this, so alignments up to this never cost padding.
+     */
+    static constexpr VkDeviceSize granularity{ 16 };
+  private:
+    struct frame final {
+      buffer_allocation buffer{ };
+      VkDeviceAddress device_address{ };
+      std::uint64_t timeline_value{ };
+    };
+
+    std::shared_ptr<const parent_type> m_parent{ };
+    std::vector<frame> m_frames{ };
+    std::size_t m_current{ };
+    VkDeviceSize m_capacity{ };
+    std::atomic<VkDeviceSize> m_offset{ };
+
+    void destroy() noexcept;
+  public:
+    /// @cond
+    transient_allocator_impl() = delete;
+    /// @endcond
+
+    /**
+     * @brief Construct a transient_allocator_impl.
+     * @param parent A shared_ptr to a read-only device_impl. This must not be null.
+     * @param capacity The number of bytes that each frame can allocate. This must be greater than 0.
+     * @param frames_in_flight The number of frames that can be in flight at once. This must be greater than 0.
+     */
+    transient_allocator_impl(const std::shared_ptr<const parent_type>& parent, const VkDeviceSize capacity,
+                             const std::uint32_t frames_in_flight);
+
+    /// @cond
+    transient_allocator_impl(const transient_allocator_impl& other) = delete;
+    transient_allocator_impl(transient_allocator_impl&& other) = delete;
+    /// @endcond
+
+    /**
+     * @brief Destroy a transient_allocator_impl.
+     * @details The buffers are destroyed through the device's deletion_queue once every earlier submission completes.
+     */
+    ~transient_allocator_impl() noexcept;
+
+    /// @cond
+    transient_allocator_impl& operator=(const transient_allocator_impl& rhs) = delete;
+    transient_allocator_impl& operator=(transient_allocator_impl&& rhs) = delete;
+    /// @endcond
+
+    /**
+     * @brief Retrieve the transient_allocator_impl's parent object.
+     * @return A read-only reference to a device_impl.
+     */
+    const parent_type& parent() const;
+
+    /**
+     * @brief Retrieve the number of bytes that each frame can allocate.
+     * @return The capacity of each frame's buffer in bytes.
+     */
+    VkDeviceSize capacity() const;
+
+    /**
+     * @brief Retrieve the number of frames that can be in flight at once.
+     * @return The number of frame buffers.
+     */
+    std::uint32_t frames_in_flight() const;
+
+    /**
+     * @brief Retrieve the number of bytes reserved from the current frame's buffer.
+     * @details This includes rounding and alignment padding. It can exceed capacity() after a failed allocation.
+     * @return The current frame's offset in bytes.
+     */
+    VkDeviceSize used() const;
+
+    /**
+     * @brief Allocate memory from the current frame's buffer.
+     * @details This method is thread-safe, but it must not be called concurrently with advance().
+     * @param size The size of the allocation in bytes. This must be greater than 0.
+     * @param alignment The alignment of the allocation's device address in bytes. This must be a power of 2.
+     * @return A transient_block describing the allocation. It remains valid until the frame's buffer is reused.
+     * @throw error If the size or the alignment is invalid, or if the current frame's buffer is exhausted.
+     */
+    transient_block allocate(const VkDeviceSize size, const VkDeviceSize alignment = granularity);
+
+    /**
+     * @brief End the current frame and begin the next one.
+     * @details If the next frame's buffer is still in use by the device, this waits for it.
+     * @param timeline_value The device timeline value that completes every submission that used the current frame's
+     *                       allocations. This must not exceed parent().current_timeline_value().
+     * @throw error If the wait fails.
+     */
+    void advance(const std::uint64_t timeline_value);
+  };
+
+  static_assert(megatech::vulkan::concepts::readonly_child_object<transient_allocator_impl>);
+
+}
+
+#endif
+/// @endcond
@@ -0,0 +1,92 @@
+/// @cond INTERNAL
+/**
+ * @file worker_pool.hpp
+ * @brief Host Worker Threads
+ * @author Alexander Rothman <[gnomesort@megate.ch](mailto:gnomesort@megate.ch)>
+ * @copyright AGPL-3.0-or-later
+ * @date 2025
+ */
+#ifndef MEGATECH_VULKAN_INTERNAL_BASE_WORKER_POOL_HPP
+#define MEGATECH_VULKAN_INTERNAL_BASE_WORKER_POOL_HPP
+
+#include <cinttypes>
+#include <cstddef>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace megatech::vulkan::internal::base {
+
+  /**
+   * @brief A fixed set of threads that run host jobs, such as decompression, in the background.
+   * @details Jobs run in the order they're enqueued. worker_pools are meant to be shared by every object that needs
+   *          background work, so that the number of threads doesn't grow with the number of objects. This type is
+   *          thread-safe.
+   */
+  class worker_pool final {
+  private:
+    std::vector<std::thread> m_workers{ };
+    std::mutex m_mutex{ };
+    std::condition_variable m_condition{ };
+    std::deque<std::function<void()>> m_jobs{ };
+    bool m_is_stopping{ };
+
+    void run();
+    void push(std::function<void()>&& job);
+  public:
+    /**
+     * @brief Construct a worker_pool.
+     * @param size The number of threads to start. If this is 0, one thread is started per hardware thread.
+     */
+    explicit worker_pool(const std::uint32_t size = 0);
+
+    /// @cond
+    worker_pool(const worker_pool& other) = delete;
+    worker_pool(worker_pool&& other) = delete;
+    /// @endcond
+
+    /**
+     * @brief Destroy a worker_pool.
+     * @details Jobs that are already enqueued are run before the threads are joined.
+     */
+    ~worker_pool() noexcept;
+
+    /// @cond
+    worker_pool& operator=(const worker_pool& rhs) = delete;
+    worker_pool& operator=(worker_pool&& rhs) = delete;
+    /// @endcond
+
+    /**
+     * @brief Retrieve the number of threads in the worker_pool.
+     * @return The number of worker threads.
+     */
+    std::uint32_t size() const;
+
+    /**
+     * @brief Run a job on a worker thread.
+     * @tparam Function The type of the job. It must be invocable with no arguments.
+     * @param job The job to run.
+     * @return A future that receives the job's result or the exception that it throws.
+     */
+    template <typename Function>
+    std::future<std::invoke_result_t<Function>> enqueue(Function&& job) {
+      // std::function must be copyable, so the task is held through a shared_ptr.
+      auto task = std::make_shared<std::packaged_task<std::invoke_result_t<Function>()>>(std::forward<Function>(job));
+      auto result = task->get_future();
+      push([task]() { (*task)(); });
+      return result;
+    }
+  };
+
+}
+
+#endif
+/// @endcond
@@ -0,0 +1,193 @@
+/**
+ * @file memory.hpp
+ * @brief Vulkan Device Memory Descriptions
+ * @author Alexander Rothman <[gnomesort@megate.ch](mailto:gnomesort@megate.ch)>
+ * @copyright AGPL-3.0-or-later
+ * @date 2025
+ */
+#ifndef MEGATECH_VULKAN_MEMORY_HPP
+#define MEGATECH_VULKAN_MEMORY_HPP
+
+#include <cinttypes>
+
+#include "bitmask.hpp"
+
+namespace megatech::vulkan {
+
+/**
+ * @brief Constants for describing the properties of device memory heaps.
+ */
+namespace memory_heap_flags {
+
+  /**
+   * @brief An empty set of heap properties.
+   */
+  MEGATECH_VULKAN_DECLARE_ZERO_BIT(none);
+
+  /**
+   * @brief The heap is local to the device (e.g., video memory on a discrete GPU).
+   */
+  MEGATECH_VULKAN_DECLARE_BIT(device_local, 0);
+
+  /**
+   * @brief Allocations from the heap are replicated to each physical device in a device group.
+   */
+  MEGATECH_VULKAN_DECLARE_BIT(multi_instance, 1);
+
+}
+
+  /**
+   * @brief A description of a physical device memory heap.
+   * @details Memory heaps are the physical pools of memory that device allocations are ultimately drawn from. Every
+   *          memory type available to a device belongs to exactly one heap.
+   */
+  class memory_heap_description final {
+  private:
+    std::uint64_t m_size{ };
+    bitmask m_flags{ };
+  public:
+    /**
+     * @brief Construct a memory_heap_description.
+     * @param size The size of the heap in bytes.
+     * @param flags A bitmask of memory_heap_flags describing the heap.
+     */
+    memory_heap_description(const std::uint64_t size, const bitmask flags);
+
+    /**
+     * @brief Copy a memory_heap_description.
+     * @param other The memory_heap_description to copy.
+     */
+    memory_heap_description(const memory_heap_description& other) = default;
+
+    /**
+     * @brief Move a memory_heap_description.
+     * @param other The memory_heap_description to move.
+     */
+    memory_heap_description(memory_heap_description&& other) = default;
+
+    /**
+     * @brief Destroy a memory_heap_description.
+     */
+    ~memory_heap_description() noexcept = default;
+
+    /**
+     * @brief Copy-assign a memory_heap_description.
+     * @param rhs The memory_heap_description to copy.
+     * @return A reference to the copied-to memory_heap_description.
+     */
+    memory_heap_description& operator=(const memory_heap_description& rhs) = default;
+
+    /**
+     * @brief Move-assign a memory_heap_description.
+     * @param rhs The memory_heap_description to move.
+     * @return A reference to the moved-to memory_heap_description.
+     */
+    memory_heap_description& operator=(memory_heap_description&& rhs) = default;
+
+    /**
+     * @brief Retrieve the size of a described heap.
+     * @return The size of the heap in bytes.
+     */
+    std::uint64_t size() const;
+
+    /**
+     * @brief Retrieve the properties of a described heap.
+     * @return A bitmask of memory_heap_flags.
+     */
+    bitmask flags() const;
+
+    /**
+     * @brief Determine whether or not a described heap is local to the device.
+     * @return True if the heap has the memory_heap_flags::device_local_bit set. False otherwise.
+     */
+    bool is_device_local() const;
+  };
+
+  /**
+   * @brief A snapshot of the budget and usage of a single device memory heap.
+   * @details Budgets are an estimate, provided by the driver, of how much memory the current process can allocate
+   *          from a heap before allocations are likely to fail or to degrade performance. Usage is an estimate of
+   *          how much of the heap the current process is already using. When the driver can't provide these values
+   *          (i.e., when VK_EXT_memory_budget is unavailable), the budget is 80% of the heap size and the usage only
+   *          counts device memory that the device has allocated itself. Memory allocated by other processes, or
+   *          through other APIs, is never counted.
+   */
+  class memory_heap_budget final {
+  private:
+    std::uint64_t m_size{ };
+    std::uint64_t m_budget{ };
+    std::uint64_t m_usage{ };
+  public:
+    /**
+     * @brief Construct a memory_heap_budget.
+     * @param size The total size of the heap in bytes.
+     * @param budget The estimated number of bytes that the process can use.
+     * @param usage The estimated number of bytes that the process is using.
+     */
+    memory_heap_budget(const std::uint64_t size, const std::uint64_t budget, const std::uint64_t usage);
+
+    /**
+     * @brief Copy a memory_heap_budget.
+     * @param other The memory_heap_budget to copy.
+     */
+    memory_heap_budget(const memory_heap_budget& other) = default;
+
+    /**
+     * @brief Move a memory_heap_budget.
+     * @param other The memory_heap_budget to move.
+     */
+    memory_heap_budget(memory_heap_budget&& other) = default;
+
+    /**
+     * @brief Destroy a memory_heap_budget.
+     */
+    ~memory_heap_budget() noexcept = default;
+
+    /**
+     * @brief Copy-assign a memory_heap_budget.
+     * @param rhs The memory_heap_budget to copy.
+     * @return A reference to the copied-to memory_heap_budget.
+     */
+    memory_heap_budget& operator=(const memory_heap_budget& rhs) = default;
+
+    /**
+     * @brief Move-assign a memory_heap_budget.
+     * @param rhs The memory_heap_budget to move.
+     * @return A reference to the moved-to memory_heap_budget.
+     */
+    memory_heap_budget& operator=(memory_heap_budget&& rhs) = default;
+
+    /**
+     * @brief Retrieve the total size of the heap.
+     * @return The size of the heap in bytes.
+     */
+    std::uint64_t size() const;
+
+    /**
+     * @brief Retrieve the heap's budget.
+     * @return The estimated number of bytes that the process can use.
+     */
+    std::uint64_t budget() const;
+
+    /**
+     * @brief Retrieve the heap's usage.
+     * @return The estimated number of bytes that the process is using.
+     */
+    std::uint64_t usage() const;
+
+    /**
+     * @brief Retrieve the amount of the heap's budget that is still available.
+     * @return The difference between the budget and the usage, or 0 if the usage exceeds the budget.
+     */
+    std::uint64_t available() const;
+
+    /**
+     * @brief Retrieve the fraction of the heap's budget that is currently used.
+     * @return The ratio of usage to budget. This can be greater than 1 when the process is over budget.
+     */
+    double pressure() const;
+  };
+
+}
+
+#endif
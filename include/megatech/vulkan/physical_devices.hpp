@@ -8,9 +8,13 @@
 #ifndef MEGATECH_VULKAN_PHYSICAL_DEVICES_HPP
 #define MEGATECH_VULKAN_PHYSICAL_DEVICES_HPP
 
+#include <cinttypes>
+
 #include <memory>
 #include <vector>
 
+#include "memory.hpp"
+
 #include "concepts/opaque_object.hpp"
 
 namespace megatech::vulkan::internal::base {
@@ -150,11 +154,154 @@ namespace async_transfer_support {
      *         transfer queue isn't available. async_transfer_support::none otherwise.
      */
     int supports_async_transfer() const;
+
+    /**
+     * @brief Check whether or not a described physical device can report per-heap memory budgets.
+     * @details Devices that support this report budgets and usage through the VK_EXT_memory_budget extension. Devices
+     *          that don't support it still report budgets, but the values are estimated by Megatech-Vulkan.
+     * @return True if the driver can report memory budgets. False otherwise.
+     */
+    bool supports_memory_budget() const;
+
+    /**
+     * @brief Retrieve descriptions of the memory heaps available to a described physical device.
+     * @return An array of memory_heap_descriptions. Each description is stored at the index of the heap it
+     *         describes.
+     */
+    std::vector<memory_heap_description> memory_heaps() const;
+
+    /**
+     * @brief Retrieve the amount of device-local memory that a described physical device lets the host write
+     *        directly.
+     * @details On discrete GPUs, this is the size of the PCIe BAR. It's typically 256 MiB, or all of video memory
+     *          when resizable BAR (or Smart Access Memory) is enabled. dynamic_buffers are placed in this memory when
+     *          it's available, so the host can write them without a staging copy.
+     * @return The size of the memory in bytes, or 0 if the host can't map any device-local memory.
+     */
+    std::uint64_t host_visible_device_local_memory() const;
+
+    /**
+     * @brief Retrieve an extended Vulkan property structure describing a described physical device.
+     * @details This forwards to the implementation, which queries each structure type once and caches it. It's
+     *          defined in megatech/vulkan/internal/base/physical_device_description_impl.hpp, which must be included
+     *          to use it, because the property structures are Vulkan types.
+     * @tparam Properties The type of property structure to retrieve (e.g.,
+     *                    VkPhysicalDeviceSubgroupSizeControlProperties).
+     * @return A read-only reference to the cached structure. Its pNext member is nullptr.
+     * @throw error If the structure can't be queried.
+     */
+    template <typename Properties>
+    const Properties& properties() const;
   };
 
   static_assert(concepts::opaque_object<physical_device_description>);
   static_assert(concepts::readonly_sharable_opaque_object<physical_device_description>);
 
+  /**
+   * @brief A description of a Vulkan physical device group.
+   * @details Physical device groups are sets of physical devices that can be driven by a single logical device (e.g.,
+   *          linked GPUs). Every physical device is a member of exactly one group, so most groups contain a single
+   *          device.
+   */
+  class physical_device_group final {
+  private:
+    std::vector<physical_device_description> m_physical_devices{ };
+    bool m_subset_allocation{ };
+  public:
+    /**
+     * @brief The read-only iterator type used by the physical_device_group.
+     */
+    using const_iterator = std::vector<physical_device_description>::const_iterator;
+
+    /// @cond
+    physical_device_group() = delete;
+    /// @endcond
+
+    /**
+     * @brief Construct a physical_device_group.
+     * @details This constructor is invoked by the API to generate groups based on results returned directly by the
+     *          associated Vulkan instance. Unless you know what you are doing, you shouldn't invoke this.
+     * @param physical_devices The members of the group. This must not be empty.
+     * @param subset_allocation Whether or not memory can be allocated on a subset of the group's devices.
+     */
+    physical_device_group(std::vector<physical_device_description>&& physical_devices, const bool subset_allocation);
+
+    /**
+     * @brief Copy a physical_device_group.
+     * @param other The physical_device_group to copy.
+     */
+    physical_device_group(const physical_device_group& other) = default;
+
+    /**
+     * @brief Move a physical_device_group.
+     * @param other The physical_device_group to move.
+     */
+    physical_device_group(physical_device_group&& other) = default;
+
+    /**
+     * @brief Destroy a physical_device_group.
+     */
+    ~physical_device_group() noexcept = default;
+
+    /**
+     * @brief Copy-assign a physical_device_group.
+     * @param rhs The physical_device_group to copy.
+     * @return A reference to the copied-to physical_device_group.
+     */
+    physical_device_group& operator=(const physical_device_group& rhs) = default;
+
+    /**
+     * @brief Move-assign a physical_device_group.
+     * @param rhs The physical_device_group to move.
+     * @return A reference to the moved-to physical_device_group.
+     */
+    physical_device_group& operator=(physical_device_group&& rhs) = default;
+
+    /**
+     * @brief Retrieve the member physical_device_description at the given index.
+     * @details A member's index is also its device index within a device created from the group.
+     * @param index The index of the desired member. No bounds checking is performed.
+     * @return A read-only reference to the desired physical_device_description.
+     */
+    const physical_device_description& operator[](const std::size_t index) const;
+
+    /**
+     * @brief Retrieve the first member of the group.
+     * @return A read-only reference to the first physical_device_description in the group.
+     */
+    const physical_device_description& front() const;
+
+    /**
+     * @brief Retrieve an iterator to the beginning of the group.
+     * @return An iterator to the beginning of the group.
+     */
+    const_iterator begin() const;
+
+    /**
+     * @brief Retrieve an iterator to the end of the group.
+     * @return An iterator to the end of the group.
+     */
+    const_iterator end() const;
+
+    /**
+     * @brief Retrieve the number of physical devices in the group.
+     * @return The size of the group. This is always at least 1.
+     */
+    std::size_t size() const;
+
+    /**
+     * @brief Retrieve a device mask that selects every member of the group.
+     * @return A bitmask where bit i is set for the member at index i.
+     */
+    std::uint32_t device_mask() const;
+
+    /**
+     * @brief Check whether or not memory can be allocated on a subset of the group's devices.
+     * @return True if subset allocation is supported. False otherwise.
+     */
+    bool supports_subset_allocation() const;
+  };
+
   /**
    * @brief A list of Vulkan physical_device_descriptions.
    * @details physical_device_lists are, essentially, an immutable collection of physical_device_description objects.
@@ -163,6 +310,7 @@ namespace async_transfer_support {
   class physical_device_list final {
   private:
     std::vector<physical_device_description> m_physical_devices;
+    std::vector<physical_device_group> m_groups{ };
 
     explicit physical_device_list(std::vector<physical_device_description>&& filtered_list);
   public:
@@ -342,6 +490,14 @@ namespace async_transfer_support {
      * @return The size of the collection.
      */
     size_type size() const;
+
+    /**
+     * @brief Retrieve the physical device groups formed by the listed devices.
+     * @details Groups are enumerated with vkEnumeratePhysicalDeviceGroups. Groups containing any device that isn't in
+     *          the list are omitted.
+     * @return A read-only reference to an array of physical_device_groups.
+     */
+    const std::vector<physical_device_group>& groups() const;
   };
 
 }
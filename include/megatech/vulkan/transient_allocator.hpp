@@ -0,0 +1,209 @@
+/**
+ * @file transient_allocator.hpp
+ * @brief Per-Frame Transient Allocation
+ * @author Alexander Rothman <[gnomesort@megate.ch](mailto:gnomesort@megate.ch)>
+ * @copyright AGPL-3.0-or-later
+ * @date 2025
+ */
+#ifndef MEGATECH_VULKAN_TRANSIENT_ALLOCATOR_HPP
+#define MEGATECH_VULKAN_TRANSIENT_ALLOCATOR_HPP
+
+#include <cinttypes>
+#include <cstddef>
+
+#include <memory>
+#include <span>
+
+#include "compute.hpp"
+
+#include "concepts/opaque_object.hpp"
+
+namespace megatech::vulkan::internal::base {
+
+  class transient_allocator_impl;
+
+}
+
+namespace megatech::vulkan {
+
+  class device;
+
+  /**
+   * @brief A block of memory allocated by a transient_allocator.
+   */
+  class transient_allocation final {
+  private:
+    std::span<std::byte> m_data{ };
+    std::uint64_t m_device_address{ };
+  public:
+    /// @cond
+    transient_allocation() = delete;
+    /// @endcond
+
+    /**
+     * @brief Construct a transient_allocation.
+     * @details This constructor is invoked by the API. Unless you know what you are doing, you shouldn't invoke this.
+     * @param data A host view of the block.
+     * @param device_address The device address of the block.
+     */
+    transient_allocation(const std::span<std::byte> data, const std::uint64_t device_address);
+
+    /**
+     * @brief Copy a transient_allocation.
+     * @param other The transient_allocation to copy.
+     */
+    transient_allocation(const transient_allocation& other) = default;
+
+    /**
+     * @brief Move a transient_allocation.
+     * @param other The transient_allocation to move.
+     */
+    transient_allocation(transient_allocation&& other) = default;
+
+    /**
+     * @brief Destroy a transient_allocation.
+     * @details The block isn't freed. It's reclaimed along with the rest of its frame.
+     */
+    ~transient_allocation() noexcept = default;
+
+    /**
+     * @brief Copy-assign a transient_allocation.
+     * @param rhs The transient_allocation to copy.
+     * @return A reference to the copied-to transient_allocation.
+     */
+    transient_allocation& operator=(const transient_allocation& rhs) = default;
+
+    /**
+     * @brief Move-assign a transient_allocation.
+     * @param rhs The transient_allocation to move.
+     * @return A reference to the moved-to transient_allocation.
+     */
+    transient_allocation& operator=(transient_allocation&& rhs) = default;
+
+    /**
+     * @brief Retrieve the block's host mapping.
+     * @return A view of the block's memory. Writes are visible to work submitted afterward.
+     */
+    std::span<std::byte> data() const;
+
+    /**
+     * @brief Retrieve the block's device address.
+     * @return An address that compute kernels can use to access the block.
+     */
+    std::uint64_t device_address() const;
+  };
+
+  /**
+   * @brief A per-frame bump allocator for short-lived data such as per-dispatch constants.
+   * @details transient_allocators own one large persistently mapped buffer per frame in flight. Allocating is a
+   *          lock-free atomic bump that returns both a host pointer and a device address, so any number of threads can
+   *          allocate at once. Nothing is freed individually. Instead, next_frame() moves to the next buffer and
+   *          resets it as a whole once the device has finished the last frame that used it.
+   *
+   *          allocate() is thread-safe, but next_frame() must not be called concurrently with any other method.
+   */
+  class transient_allocator final {
+  public:
+    /**
+     * @brief The internal implementation type of the transient_allocator.
+     */
+    using implementation_type = internal::base::transient_allocator_impl;
+  private:
+    std::shared_ptr<implementation_type> m_impl{ };
+  public:
+    /// @cond
+    transient_allocator() = delete;
+    /// @endcond
+
+    /**
+     * @brief Construct a transient_allocator.
+     * @param parent The device that the allocator belongs to.
+     * @param frame_capacity The number of bytes that each frame can allocate. This must be greater than 0.
+     * @param frames_in_flight The number of frames that can be in flight at once. This must be greater than 0.
+     */
+    transient_allocator(const device& parent, const std::uint64_t frame_capacity,
+                        const std::uint32_t frames_in_flight = 2);
+
+    /// @cond
+    transient_allocator(const transient_allocator& other) = delete;
+    transient_allocator(transient_allocator&& other) = delete;
+    /// @endcond
+
+    /**
+     * @brief Destroy a transient_allocator.
+     * @details Destruction is deferred until every earlier submission to the device completes, so this never waits.
+     */
+    ~transient_allocator() noexcept = default;
+
+    /// @cond
+    transient_allocator& operator=(const transient_allocator& rhs) = delete;
+    transient_allocator& operator=(transient_allocator&& rhs) = delete;
+    /// @endcond
+
+    /**
+     * @brief Retrieve an opaque reference to the underlying implementation.
+     * @return A reference to the underlying implementation.
+     */
+    const implementation_type& implementation() const;
+
+    /**
+     * @brief Retrieve an opaque reference to the underlying implementation.
+     * @return A reference to the underlying implementation.
+     */
+    implementation_type& implementation();
+
+    /**
+     * @brief Retrieve a sharable reference to the underlying implementation.
+     * @return A shareable reference to the underlying implmentation.
+     */
+    std::shared_ptr<const implementation_type> share_implementation() const;
+
+    /**
+     * @brief Retrieve the number of bytes that each frame can allocate.
+     * @return The capacity of each frame in bytes.
+     */
+    std::uint64_t frame_capacity() const;
+
+    /**
+     * @brief Retrieve the number of frames that can be in flight at once.
+     * @return The number of frames in flight.
+     */
+    std::uint32_t frames_in_flight() const;
+
+    /**
+     * @brief Retrieve the number of bytes allocated in the current frame, including padding.
+     * @return The number of bytes allocated.
+     */
+    std::uint64_t used() const;
+
+    /**
+     * @brief Allocate memory in the current frame.
+     * @param size The size of the allocation in bytes. This must be greater than 0.
+     * @param alignment The alignment of the allocation's device address in bytes. This must be a power of 2.
+     *                  Alignments up to 16 bytes never waste memory.
+     * @return A transient_allocation that remains valid until its frame is reused.
+     * @throw error If the size or the alignment is invalid, or if the current frame is full.
+     */
+    transient_allocation allocate(const std::uint64_t size, const std::uint64_t alignment = 16);
+
+    /**
+     * @brief End the current frame and begin the next one.
+     * @details The current frame is reused once all of the work submitted to the device so far has completed. If the
+     *          next frame is still in use, this waits for it.
+     */
+    void next_frame();
+
+    /**
+     * @brief End the current frame and begin the next one.
+     * @details If the next frame is still in use, this waits for it.
+     * @param last_use The completion of the last work that uses the current frame's allocations.
+     */
+    void next_frame(const compute_completion& last_use);
+  };
+
+  static_assert(concepts::opaque_object<transient_allocator>);
+  static_assert(concepts::readonly_sharable_opaque_object<transient_allocator>);
+
+}
+
+#endif
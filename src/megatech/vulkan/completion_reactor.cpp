@@ -0,0 +1,72 @@
+/**
+ * @file completion_reactor.cpp
+ * @brief Coroutine-Based Device Completion
+ * @author Alexander Rothman <[gnomesort@megate.ch](mailto:gnomesort@megate.ch)>
+ * @copyright AGPL-3.0-or-later
+ * @date 2025
+ */
+#include "megatech/vulkan/completion_reactor.hpp"
+
+#include <utility>
+
+#include <megatech/assertions.hpp>
+
+#include "megatech/vulkan/device.hpp"
+#include "megatech/vulkan/error.hpp"
+
+#include "megatech/vulkan/internal/base/completion_reactor_impl.hpp"
+
+namespace megatech::vulkan {
+
+  completion_awaitable::completion_awaitable(const std::shared_ptr<const reactor_type>& reactor,
+                                             const compute_completion& completion) :
+  m_reactor{ reactor },
+  m_completion{ completion } {
+    if (!m_reactor)
+    {
+      throw error{ "The completion reactor cannot be null." };
+    }
+  }
+
+  bool completion_awaitable::await_ready() const {
+    return m_completion.is_ready();
+  }
+
+  void completion_awaitable::await_suspend(const std::coroutine_handle<> handle) {
+    MEGATECH_PRECONDITION(m_reactor != nullptr);
+    m_reactor->watch(m_completion.timeline_value(), handle, m_error);
+  }
+
+  void completion_awaitable::await_resume() const {
+    if (m_error)
+    {
+      std::rethrow_exception(m_error);
+    }
+  }
+
+  completion_reactor::completion_reactor(const device& parent, executor_type executor) :
+  m_impl{ new implementation_type{ parent.share_implementation(), std::move(executor) } } {
+    MEGATECH_POSTCONDITION(m_impl != nullptr);
+  }
+
+  const completion_reactor::implementation_type& completion_reactor::implementation() const {
+    MEGATECH_PRECONDITION(m_impl != nullptr);
+    return *m_impl;
+  }
+
+  completion_reactor::implementation_type& completion_reactor::implementation() {
+    MEGATECH_PRECONDITION(m_impl != nullptr);
+    return *m_impl;
+  }
+
+  std::shared_ptr<const completion_reactor::implementation_type> completion_reactor::share_implementation() const {
+    MEGATECH_PRECONDITION(m_impl != nullptr);
+    return m_impl;
+  }
+
+  completion_awaitable completion_reactor::wait(const compute_completion& completion) const {
+    MEGATECH_PRECONDITION(m_impl != nullptr);
+    return completion_awaitable{ m_impl, completion };
+  }
+
+}
@@ -0,0 +1,215 @@
+/**
+ * @file completion_source.cpp
+ * @brief File Descriptor-Based Device Completion
+ * @author Alexander Rothman <[gnomesort@megate.ch](mailto:gnomesort@megate.ch)>
+ * @copyright AGPL-3.0-or-later
+ * @date 2025
+ */
+#include "megatech/vulkan/completion_source.hpp"
+
+#include <algorithm>
+#include <array>
+#include <exception>
+#include <iterator>
+#include <utility>
+
+#include <megatech/assertions.hpp>
+
+#include "config.hpp"
+
+#ifdef CONFIG_SYSTEM_LINUX
+  #include <cerrno>
+
+  #include <sys/epoll.h>
+  #include <sys/eventfd.h>
+  #include <unistd.h>
+#endif
+
+#include "megatech/vulkan/device.hpp"
+#include "megatech/vulkan/compute.hpp"
+#include "megatech/vulkan/error.hpp"
+
+#include "megatech/vulkan/internal/base/device_impl.hpp"
+
+namespace megatech::vulkan {
+
+#ifdef CONFIG_SYSTEM_LINUX
+  namespace {
+
+    // The token of the eventfd that signals work that had already completed when it was watched.
+    constexpr auto ready_token = std::uint64_t{ 0 };
+
+  }
+
+  completion_source::completion_source(const device& parent) : m_device{ parent.share_implementation() } {
+    if (!m_device->can_export_fence_sync_fd())
+    {
+      throw error{ "The device can't export sync files." };
+    }
+    m_epoll = epoll_create1(EPOLL_CLOEXEC);
+    if (m_epoll == -1)
+    {
+      throw error{ "Failed to create an epoll instance." };
+    }
+    m_event = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    auto event = epoll_event{ };
+    event.events = EPOLLIN;
+    event.data.u64 = ready_token;
+    if (m_event == -1 || epoll_ctl(m_epoll, EPOLL_CTL_ADD, m_event, &event) == -1)
+    {
+      if (m_event != -1)
+      {
+        close(m_event);
+      }
+      close(m_epoll);
+      throw error{ "Failed to create an eventfd." };
+    }
+    MEGATECH_POSTCONDITION(m_epoll != -1);
+    MEGATECH_POSTCONDITION(m_event != -1);
+  }
+
+  completion_source::~completion_source() noexcept {
+    for (const auto& [token, current] : m_entries)
+    {
+      close(current.fd);
+    }
+    close(m_event);
+    close(m_epoll);
+  }
+
+  int completion_source::file_descriptor() const {
+    return m_epoll;
+  }
+
+  void completion_source::watch(const compute_completion& completion, callback_type callback) {
+    if (!callback)
+    {
+      throw error{ "The callback cannot be empty." };
+    }
+    if (&completion.device_implementation() != m_device.get())
+    {
+      throw error{ "The compute completion must belong to the completion source's device." };
+    }
+    const auto fd = m_device->export_sync_fd(completion.timeline_value());
+    auto lock = std::unique_lock<std::mutex>{ m_mutex };
+    if (fd == -1)
+    {
+      m_ready.emplace_back(std::move(callback));
+      const auto increment = std::uint64_t{ 1 };
+      // Writing only fails if the counter would overflow, in which case the eventfd is already readable.
+      [[maybe_unused]] const auto written = write(m_event, &increment, sizeof(increment));
+      return;
+    }
+    const auto token = m_next_token++;
+    auto event = epoll_event{ };
+    event.events = EPOLLIN;
+    event.data.u64 = token;
+    if (epoll_ctl(m_epoll, EPOLL_CTL_ADD, fd, &event) == -1)
+    {
+      close(fd);
+      throw error{ "Failed to register a sync file with epoll." };
+    }
+    try
+    {
+      m_entries.emplace(token, entry{ fd, std::move(callback) });
+    }
+    catch (...)
+    {
+      epoll_ctl(m_epoll, EPOLL_CTL_DEL, fd, nullptr);
+      close(fd);
+      throw;
+    }
+  }
+
+  std::size_t completion_source::dispatch() {
+    auto callbacks = std::vector<callback_type>{ };
+    {
+      auto lock = std::unique_lock<std::mutex>{ m_mutex };
+      auto events = std::array<epoll_event, 64>{ };
+      auto count = int{ };
+      do
+      {
+        count = epoll_wait(m_epoll, events.data(), events.size(), 0);
+        if (count == -1)
+        {
+          if (errno == EINTR)
+          {
+            continue;
+          }
+          throw error{ "Failed to poll sync files." };
+        }
+        for (auto i = 0; i < count; ++i)
+        {
+          if (events[i].data.u64 == ready_token)
+          {
+            auto value = std::uint64_t{ };
+            [[maybe_unused]] const auto read_bytes = read(m_event, &value, sizeof(value));
+            std::ranges::move(m_ready, std::back_inserter(callbacks));
+            m_ready.clear();
+            continue;
+          }
+          const auto itr = m_entries.find(events[i].data.u64);
+          if (itr == m_entries.end())
+          {
+            continue;
+          }
+          epoll_ctl(m_epoll, EPOLL_CTL_DEL, itr->second.fd, nullptr);
+          close(itr->second.fd);
+          callbacks.emplace_back(std::move(itr->second.callback));
+          m_entries.erase(itr);
+        }
+      }
+      while (count == -1 || static_cast<std::size_t>(count) == events.size());
+    }
+    // Every callback runs even if an earlier one throws. The first exception is rethrown afterward.
+    auto failure = std::exception_ptr{ };
+    for (auto& callback : callbacks)
+    {
+      try
+      {
+        callback();
+      }
+      catch (...)
+      {
+        if (!failure)
+        {
+          failure = std::current_exception();
+        }
+      }
+    }
+    if (failure)
+    {
+      std::rethrow_exception(failure);
+    }
+    return callbacks.size();
+  }
+
+  std::size_t completion_source::size() const {
+    auto lock = std::unique_lock<std::mutex>{ m_mutex };
+    return m_entries.size() + m_ready.size();
+  }
+#else
+  completion_source::completion_source(const device& parent) : m_device{ parent.share_implementation() } {
+    throw error{ "Completion sources require epoll, which isn't available on this system." };
+  }
+
+  completion_source::~completion_source() noexcept { }
+
+  int completion_source::file_descriptor() const {
+    return m_epoll;
+  }
+
+  void completion_source::watch(const compute_completion&, callback_type) {
+    throw error{ "Completion sources require epoll, which isn't available on this system." };
+  }
+
+  std::size_t completion_source::dispatch() {
+    return 0;
+  }
+
+  std::size_t completion_source::size() const {
+    return 0;
+  }
+#endif
+
+}
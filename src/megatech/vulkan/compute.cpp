@@ -0,0 +1,257 @@
+/**
+ * @file compute.cpp
+ * @brief Vulkan Compute Dispatch
+ * @author Alexander Rothman <[gnomesort@megate.ch](mailto:gnomesort@megate.ch)>
+ * @copyright AGPL-3.0-or-later
+ * @date 2025
+ */
+#include "megatech/vulkan/compute.hpp"
+
+#include <megatech/assertions.hpp>
+
+#include "megatech/vulkan/device.hpp"
+#include "megatech/vulkan/error.hpp"
+
+#include "megatech/vulkan/internal/base/device_impl.hpp"
+#include "megatech/vulkan/internal/base/device_buffer_impl.hpp"
+#include "megatech/vulkan/internal/base/dynamic_buffer_impl.hpp"
+#include "megatech/vulkan/internal/base/compute_pipeline_impl.hpp"
+#include "megatech/vulkan/internal/base/compute_pipeline_cache.hpp"
+#include "megatech/vulkan/internal/base/compute_context_impl.hpp"
+#include "megatech/vulkan/internal/base/compute_batcher_impl.hpp"
+
+namespace megatech::vulkan {
+
+  device_buffer::device_buffer(const device& parent, const std::uint64_t size, const bool host_visible) :
+  m_impl{ new implementation_type{ parent.share_implementation(), size, host_visible } } {
+    MEGATECH_POSTCONDITION(m_impl != nullptr);
+  }
+
+  const device_buffer::implementation_type& device_buffer::implementation() const {
+    MEGATECH_PRECONDITION(m_impl != nullptr);
+    return *m_impl;
+  }
+
+  device_buffer::implementation_type& device_buffer::implementation() {
+    MEGATECH_PRECONDITION(m_impl != nullptr);
+    return *m_impl;
+  }
+
+  std::shared_ptr<const device_buffer::implementation_type> device_buffer::share_implementation() const {
+    MEGATECH_PRECONDITION(m_impl != nullptr);
+    return m_impl;
+  }
+
+  std::uint64_t device_buffer::size() const {
+    MEGATECH_PRECONDITION(m_impl != nullptr);
+    return m_impl->allocation().size;
+  }
+
+  std::uint64_t device_buffer::device_address() const {
+    MEGATECH_PRECONDITION(m_impl != nullptr);
+    return m_impl->device_address();
+  }
+
+  std::span<std::byte> device_buffer::data() const {
+    MEGATECH_PRECONDITION(m_impl != nullptr);
+    const auto& buffer = m_impl->allocation();
+    if (!buffer.allocation.mapped)
+    {
+      return { };
+    }
+    return { static_cast<std::byte*>(buffer.allocation.mapped), buffer.size };
+  }
+
+  compute_kernel::compute_kernel(const device& parent, const std::span<const std::uint32_t> spirv,
+                                 const std::uint32_t push_constant_size, const std::string& entry_point) :
+  m_impl{ new implementation_type{ parent.share_implementation(), spirv, entry_point, push_constant_size } } {
+    MEGATECH_POSTCONDITION(m_impl != nullptr);
+  }
+
+  compute_kernel::compute_kernel(const device& parent, const std::span<const std::uint32_t> spirv,
+                                 const std::uint32_t push_constant_size, const kernel_constants& constants,
+                                 const std::string& entry_point) :
+  m_impl{ parent.implementation().pipelines().acquire(parent.share_implementation(), spirv, entry_point,
+                                                      push_constant_size, constants) } {
+    MEGATECH_POSTCONDITION(m_impl != nullptr);
+  }
+
+  const compute_kernel::implementation_type& compute_kernel::implementation() const {
+    MEGATECH_PRECONDITION(m_impl != nullptr);
+    return *m_impl;
+  }
+
+  compute_kernel::implementation_type& compute_kernel::implementation() {
+    MEGATECH_PRECONDITION(m_impl != nullptr);
+    return *m_impl;
+  }
+
+  std::shared_ptr<const compute_kernel::implementation_type> compute_kernel::share_implementation() const {
+    MEGATECH_PRECONDITION(m_impl != nullptr);
+    return m_impl;
+  }
+
+  std::uint32_t compute_kernel::push_constant_size() const {
+    MEGATECH_PRECONDITION(m_impl != nullptr);
+    return m_impl->push_constant_size();
+  }
+
+  std::uint32_t compute_kernel::workgroup_size() const {
+    MEGATECH_PRECONDITION(m_impl != nullptr);
+    return m_impl->specialization().workgroup_size();
+  }
+
+  std::uint32_t compute_kernel::subgroup_size() const {
+    MEGATECH_PRECONDITION(m_impl != nullptr);
+    return m_impl->specialization().subgroup_size();
+  }
+
+  std::uint32_t compute_kernel::tile_size() const {
+    MEGATECH_PRECONDITION(m_impl != nullptr);
+    return m_impl->specialization().tile_size();
+  }
+
+  compute_completion::compute_completion(const std::shared_ptr<const internal::base::device_impl>& dev,
+                                         const std::uint64_t timeline_value) :
+  m_device{ dev },
+  m_timeline_value{ timeline_value } {
+    if (!m_device)
+    {
+      throw error{ "The device of a compute_completion cannot be null." };
+    }
+  }
+
+  std::uint64_t compute_completion::timeline_value() const {
+    return m_timeline_value;
+  }
+
+  const internal::base::device_impl& compute_completion::device_implementation() const {
+    MEGATECH_PRECONDITION(m_device != nullptr);
+    return *m_device;
+  }
+
+  bool compute_completion::is_ready() const {
+    MEGATECH_PRECONDITION(m_device != nullptr);
+    return m_device->completed_timeline_value() >= m_timeline_value;
+  }
+
+  bool compute_completion::wait(const std::chrono::nanoseconds timeout) const {
+    MEGATECH_PRECONDITION(m_device != nullptr);
+    return is_ready() || m_device->wait_for_timeline_value(m_timeline_value, timeout);
+  }
+
+  dynamic_buffer::dynamic_buffer(const device& parent, const std::uint64_t size) :
+  m_impl{ new implementation_type{ parent.share_implementation(), size } } {
+    MEGATECH_POSTCONDITION(m_impl != nullptr);
+  }
+
+  const dynamic_buffer::implementation_type& dynamic_buffer::implementation() const {
+    MEGATECH_PRECONDITION(m_impl != nullptr);
+    return *m_impl;
+  }
+
+  dynamic_buffer::implementation_type& dynamic_buffer::implementation() {
+    MEGATECH_PRECONDITION(m_impl != nullptr);
+    return *m_impl;
+  }
+
+  std::shared_ptr<const dynamic_buffer::implementation_type> dynamic_buffer::share_implementation() const {
+    MEGATECH_PRECONDITION(m_impl != nullptr);
+    return m_impl;
+  }
+
+  std::uint64_t dynamic_buffer::size() const {
+    MEGATECH_PRECONDITION(m_impl != nullptr);
+    return m_impl->allocation().size;
+  }
+
+  std::uint64_t dynamic_buffer::device_address() const {
+    MEGATECH_PRECONDITION(m_impl != nullptr);
+    return m_impl->device_address();
+  }
+
+  bool dynamic_buffer::is_direct() const {
+    MEGATECH_PRECONDITION(m_impl != nullptr);
+    return m_impl->is_direct();
+  }
+
+  std::span<std::byte> dynamic_buffer::data() const {
+    MEGATECH_PRECONDITION(m_impl != nullptr);
+    return m_impl->data();
+  }
+
+  compute_completion dynamic_buffer::flush() {
+    return flush(0, size());
+  }
+
+  compute_completion dynamic_buffer::flush(const std::uint64_t offset, const std::uint64_t size) {
+    MEGATECH_PRECONDITION(m_impl != nullptr);
+    const auto timeline_value = m_impl->flush(offset, size);
+    return compute_completion{ m_impl->share_parent(), timeline_value };
+  }
+
+  compute_context::compute_context(const device& parent) :
+  m_impl{ new implementation_type{ parent.share_implementation() } } {
+    MEGATECH_POSTCONDITION(m_impl != nullptr);
+  }
+
+  const compute_context::implementation_type& compute_context::implementation() const {
+    MEGATECH_PRECONDITION(m_impl != nullptr);
+    return *m_impl;
+  }
+
+  compute_context::implementation_type& compute_context::implementation() {
+    MEGATECH_PRECONDITION(m_impl != nullptr);
+    return *m_impl;
+  }
+
+  std::shared_ptr<const compute_context::implementation_type> compute_context::share_implementation() const {
+    MEGATECH_PRECONDITION(m_impl != nullptr);
+    return m_impl;
+  }
+
+  compute_completion compute_context::dispatch(const compute_kernel& kernel,
+                                               const std::span<const std::byte> push_constants, const std::uint32_t x,
+                                               const std::uint32_t y, const std::uint32_t z) {
+    MEGATECH_PRECONDITION(m_impl != nullptr);
+    const auto timeline_value = m_impl->dispatch(kernel.share_implementation(), push_constants, { x, y, z });
+    return compute_completion{ m_impl->share_parent(), timeline_value };
+  }
+
+
+  compute_batcher::compute_batcher(const device& parent, const std::chrono::nanoseconds window,
+                                   const std::size_t max_batch_size) :
+  m_impl{ new implementation_type{ parent.share_implementation(), window, max_batch_size } } {
+    MEGATECH_POSTCONDITION(m_impl != nullptr);
+  }
+
+  const compute_batcher::implementation_type& compute_batcher::implementation() const {
+    MEGATECH_PRECONDITION(m_impl != nullptr);
+    return *m_impl;
+  }
+
+  compute_batcher::implementation_type& compute_batcher::implementation() {
+    MEGATECH_PRECONDITION(m_impl != nullptr);
+    return *m_impl;
+  }
+
+  std::shared_ptr<const compute_batcher::implementation_type> compute_batcher::share_implementation() const {
+    MEGATECH_PRECONDITION(m_impl != nullptr);
+    return m_impl;
+  }
+
+  std::future<void> compute_batcher::enqueue(const compute_kernel& kernel,
+                                             const std::span<const std::byte> push_constants,
+                                             const std::span<const std::uint64_t> reads,
+                                             const std::span<const std::uint64_t> writes, const std::uint32_t x,
+                                             const std::uint32_t y, const std::uint32_t z) {
+    MEGATECH_PRECONDITION(m_impl != nullptr);
+    return m_impl->enqueue(kernel.share_implementation(), push_constants, { x, y, z }, reads, writes);
+  }
+
+  void compute_batcher::flush() {
+    MEGATECH_PRECONDITION(m_impl != nullptr);
+    m_impl->flush();
+  }
+
+}
@@ -11,9 +11,28 @@
 
 #include <megatech/assertions.hpp>
 
+#include "megatech/vulkan/error.hpp"
 #include "megatech/vulkan/physical_devices.hpp"
+#include "megatech/vulkan/compute.hpp"
 
 #include "megatech/vulkan/internal/base/device_impl.hpp"
+#include "megatech/vulkan/internal/base/physical_device_description_impl.hpp"
+
+namespace {
+
+  std::vector<megatech::vulkan::memory_heap_budget>
+  to_heap_budgets(const VkPhysicalDeviceMemoryProperties& memory_properties,
+                  const VkPhysicalDeviceMemoryBudgetPropertiesEXT& budget) {
+    auto result = std::vector<megatech::vulkan::memory_heap_budget>{ };
+    result.reserve(memory_properties.memoryHeapCount);
+    for (auto i = std::uint32_t{ 0 }; i < memory_properties.memoryHeapCount; ++i)
+    {
+      result.emplace_back(memory_properties.memoryHeaps[i].size, budget.heapBudget[i], budget.heapUsage[i]);
+    }
+    return result;
+  }
+
+}
 
 namespace megatech::vulkan {
 
@@ -22,6 +41,16 @@ namespace megatech::vulkan {
     MEGATECH_POSTCONDITION(m_impl != nullptr);
   }
 
+  device::device(const physical_device_group& group) {
+    auto members = std::vector<std::shared_ptr<const physical_device_description::implementation_type>>{ };
+    for (const auto& member : group)
+    {
+      members.emplace_back(member.share_implementation());
+    }
+    m_impl.reset(new implementation_type{ members });
+    MEGATECH_POSTCONDITION(m_impl != nullptr);
+  }
+
   device::implementation_type& device::implementation() {
     MEGATECH_PRECONDITION(m_impl != nullptr);
     return *m_impl;
@@ -37,4 +66,58 @@ namespace megatech::vulkan {
     return m_impl;
   }
 
+  std::uint32_t device::physical_device_count() const {
+    MEGATECH_PRECONDITION(m_impl != nullptr);
+    return m_impl->physical_device_count();
+  }
+
+  std::uint32_t device::device_mask() const {
+    MEGATECH_PRECONDITION(m_impl != nullptr);
+    return m_impl->device_mask();
+  }
+
+  std::vector<memory_heap_budget> device::memory_budget() const {
+    MEGATECH_PRECONDITION(m_impl != nullptr);
+    return to_heap_budgets(m_impl->parent().memory_properties(), m_impl->memory_budget());
+  }
+
+  std::vector<memory_heap_budget> device::refresh_memory_budget() const {
+    MEGATECH_PRECONDITION(m_impl != nullptr);
+    return to_heap_budgets(m_impl->parent().memory_properties(), m_impl->refresh_memory_budget());
+  }
+
+  void device::set_memory_budget_refresh_interval(const std::chrono::nanoseconds interval) {
+    MEGATECH_PRECONDITION(m_impl != nullptr);
+    m_impl->set_memory_budget_refresh_interval(interval);
+  }
+
+  double device::residency_threshold() const {
+    MEGATECH_PRECONDITION(m_impl != nullptr);
+    return m_impl->residency().pressure_threshold();
+  }
+
+  void device::set_residency_threshold(const double threshold) {
+    MEGATECH_PRECONDITION(m_impl != nullptr);
+    m_impl->residency().set_pressure_threshold(threshold);
+  }
+
+  std::uint64_t device::trim_residency() {
+    MEGATECH_PRECONDITION(m_impl != nullptr);
+    return m_impl->residency().trim();
+  }
+
+  bool device::supports_sync_fd() const {
+    MEGATECH_PRECONDITION(m_impl != nullptr);
+    return m_impl->can_export_fence_sync_fd();
+  }
+
+  int device::export_sync_fd(const compute_completion& completion) const {
+    MEGATECH_PRECONDITION(m_impl != nullptr);
+    if (&completion.device_implementation() != m_impl.get())
+    {
+      throw error{ "The compute completion must belong to the device." };
+    }
+    return m_impl->export_sync_fd(completion.timeline_value());
+  }
+
 }
@@ -0,0 +1,321 @@
+/**
+ * @file device_scheduler.cpp
+ * @brief Multi-Device Work Distribution
+ * @author Alexander Rothman <[gnomesort@megate.ch](mailto:gnomesort@megate.ch)>
+ * @copyright AGPL-3.0-or-later
+ * @date 2025
+ */
+#include "megatech/vulkan/device_scheduler.hpp"
+
+#include <algorithm>
+#include <tuple>
+
+#include <megatech/assertions.hpp>
+
+#include "megatech/vulkan/error.hpp"
+#include "megatech/vulkan/physical_devices.hpp"
+
+#include "megatech/vulkan/internal/base/device_impl.hpp"
+
+namespace megatech::vulkan {
+
+  double device_scheduler::estimate(const std::size_t index, const job_class type) const {
+    MEGATECH_PRECONDITION(index < m_estimates.size());
+    if (const auto found = m_estimates[index].find(type); found != m_estimates[index].end())
+    {
+      return found->second;
+    }
+    // Devices that haven't run a class of job yet are assumed to be average. This ensures that every device is
+    // eventually measured.
+    auto total = 0.0;
+    auto count = std::size_t{ 0 };
+    for (const auto& estimates : m_estimates)
+    {
+      if (const auto found = estimates.find(type); found != estimates.end())
+      {
+        total += found->second;
+        ++count;
+      }
+    }
+    return count ? total / count : 0.0;
+  }
+
+  std::uint64_t device_scheduler::next_completion(const std::size_t index) const {
+    MEGATECH_PRECONDITION(index < m_pending.size());
+    auto result = std::uint64_t{ 0 };
+    for (const auto& pending : m_pending[index])
+    {
+      if (pending.is_submitted && !pending.is_completed && (!result || pending.timeline_value < result))
+      {
+        result = pending.timeline_value;
+      }
+    }
+    return result;
+  }
+
+  void device_scheduler::retire(const std::size_t index) {
+    MEGATECH_PRECONDITION(index < m_devices.size());
+    auto& pending = m_pending[index];
+    auto retired = std::size_t{ 0 };
+    while (retired < pending.size() && pending[retired].is_completed)
+    {
+      ++retired;
+    }
+    if (!retired)
+    {
+      return;
+    }
+    // Jobs that complete before the watcher wakes share a completion time, so the interval that ends there is shared
+    // by every one of them. Jobs can't start before the job queued ahead of them finishes, so each job's share begins
+    // no earlier than the end of the previous job's share.
+    auto cursor = m_last_retired[index];
+    for (auto first = std::size_t{ 0 }; first < retired;)
+    {
+      const auto end = pending[first].completed;
+      auto last = first;
+      auto weights = std::vector<double>{ };
+      auto total_weight = 0.0;
+      for (; last < retired && pending[last].completed == end; ++last)
+      {
+        total_weight += weights.emplace_back(std::max(estimate(index, pending[last].type), 1.0));
+      }
+      for (auto i = first; i < last; ++i)
+      {
+        const auto& job = pending[i];
+        const auto begin = std::max(job.start, cursor);
+        const auto elapsed = end > begin ? end - begin : std::chrono::steady_clock::duration{ };
+        const auto weight = weights[i - first];
+        const auto share = std::chrono::duration<double, std::nano>{ elapsed } * (weight / total_weight);
+        total_weight -= weight;
+        cursor = begin + std::chrono::duration_cast<std::chrono::steady_clock::duration>(share);
+        const auto sample = share.count();
+        auto [itr, inserted] = m_estimates[index].try_emplace(job.type, sample);
+        if (!inserted)
+        {
+          itr->second += m_smoothing_factor * (sample - itr->second);
+        }
+      }
+      cursor = std::max(cursor, end);
+      first = last;
+    }
+    pending.erase(pending.begin(), pending.begin() + retired);
+    m_last_retired[index] = cursor;
+  }
+
+  void device_scheduler::watch(const std::size_t index) {
+    MEGATECH_PRECONDITION(index < m_devices.size());
+    auto& device = m_devices[index]->implementation();
+    auto lock = std::unique_lock<std::mutex>{ m_mutex };
+    while (true)
+    {
+      auto target = std::uint64_t{ 0 };
+      m_changed.wait(lock, [&]() {
+        target = next_completion(index);
+        return m_stopping || target;
+      });
+      if (m_stopping)
+      {
+        return;
+      }
+      lock.unlock();
+      // The wait times out periodically so that the scheduler can be destroyed while a job is still running.
+      auto is_complete = false;
+      try
+      {
+        is_complete = device.wait_for_timeline_value(target, std::chrono::milliseconds{ 10 });
+      }
+      catch (...)
+      {
+        // The wait only fails if the device is lost. Its jobs will never complete, so they're retired rather than
+        // waited for forever.
+        is_complete = true;
+      }
+      const auto now = std::chrono::steady_clock::now();
+      lock.lock();
+      if (is_complete)
+      {
+        for (auto& pending : m_pending[index])
+        {
+          if (pending.is_submitted && !pending.is_completed && pending.timeline_value <= target)
+          {
+            pending.completed = now;
+            pending.is_completed = true;
+          }
+        }
+        m_changed.notify_all();
+      }
+    }
+  }
+
+  void device_scheduler::stop() noexcept {
+    {
+      auto lock = std::unique_lock<std::mutex>{ m_mutex };
+      m_stopping = true;
+    }
+    m_changed.notify_all();
+    for (auto& watcher : m_watchers)
+    {
+      watcher.join();
+    }
+    m_watchers.clear();
+  }
+
+  device_scheduler::device_scheduler(const physical_device_list& physical_devices) :
+  device_scheduler{ std::vector<physical_device_description>{ physical_devices.begin(), physical_devices.end() } } { }
+
+  device_scheduler::device_scheduler(const std::span<const physical_device_description> physical_devices) {
+    if (physical_devices.empty())
+    {
+      throw error{ "A device_scheduler requires at least one physical device." };
+    }
+    m_devices.reserve(physical_devices.size());
+    for (const auto& physical_device : physical_devices)
+    {
+      m_devices.emplace_back(new device{ physical_device });
+    }
+    m_pending.resize(m_devices.size());
+    m_last_retired.resize(m_devices.size());
+    m_estimates.resize(m_devices.size());
+    m_watchers.reserve(m_devices.size());
+    try
+    {
+      for (auto i = std::size_t{ 0 }; i < m_devices.size(); ++i)
+      {
+        m_watchers.emplace_back(&device_scheduler::watch, this, i);
+      }
+    }
+    catch (...)
+    {
+      stop();
+      throw;
+    }
+    MEGATECH_POSTCONDITION(m_devices.size() == physical_devices.size());
+    MEGATECH_POSTCONDITION(m_watchers.size() == m_devices.size());
+  }
+
+  device_scheduler::~device_scheduler() noexcept {
+    stop();
+  }
+
+  std::size_t device_scheduler::size() const {
+    return m_devices.size();
+  }
+
+  device& device_scheduler::operator[](const std::size_t index) {
+    MEGATECH_PRECONDITION(index < m_devices.size());
+    return *m_devices[index];
+  }
+
+  const device& device_scheduler::operator[](const std::size_t index) const {
+    MEGATECH_PRECONDITION(index < m_devices.size());
+    return *m_devices[index];
+  }
+
+  std::size_t device_scheduler::schedule(const job_class type, const job_type& job) {
+    if (!job)
+    {
+      throw error{ "The scheduled job cannot be empty." };
+    }
+    auto lock = std::unique_lock<std::mutex>{ m_mutex };
+    auto best = std::size_t{ 0 };
+    auto best_cost = std::tuple<double, std::size_t>{ };
+    for (auto i = std::size_t{ 0 }; i < m_devices.size(); ++i)
+    {
+      retire(i);
+      // The expected completion time of a new job is the estimated time of everything already queued on the device
+      // plus the estimated time of the new job.
+      auto queued = estimate(i, type);
+      for (const auto& pending : m_pending[i])
+      {
+        queued += estimate(i, pending.type);
+      }
+      const auto cost = std::tuple{ queued, m_pending[i].size() };
+      if (i == 0 || cost < best_cost)
+      {
+        best = i;
+        best_cost = cost;
+      }
+    }
+    // The job is reserved before it's invoked so that concurrent calls see it. It runs without the lock held, since it
+    // may take a long time to record and may use the scheduler itself.
+    const auto id = m_next_id++;
+    m_pending[best].emplace_back(id, 0, type, std::chrono::steady_clock::now());
+    lock.unlock();
+    const auto find = [&]() {
+      return std::ranges::find_if(m_pending[best], [&](const pending_job& pending) { return pending.id == id; });
+    };
+    auto timeline_value = std::uint64_t{ };
+    try
+    {
+      timeline_value = job(*m_devices[best]);
+    }
+    catch (...)
+    {
+      lock.lock();
+      m_pending[best].erase(find());
+      throw;
+    }
+    lock.lock();
+    auto reserved = find();
+    reserved->timeline_value = timeline_value;
+    reserved->is_submitted = true;
+    if (!timeline_value)
+    {
+      // Jobs that didn't submit anything are complete as soon as they return.
+      reserved->completed = std::chrono::steady_clock::now();
+      reserved->is_completed = true;
+    }
+    lock.unlock();
+    m_changed.notify_all();
+    return best;
+  }
+
+  void device_scheduler::poll() {
+    auto lock = std::unique_lock<std::mutex>{ m_mutex };
+    for (auto i = std::size_t{ 0 }; i < m_devices.size(); ++i)
+    {
+      retire(i);
+    }
+  }
+
+  void device_scheduler::wait_idle() {
+    auto lock = std::unique_lock<std::mutex>{ m_mutex };
+    m_changed.wait(lock, [&]() {
+      const auto is_done = [](const pending_job& job) { return !job.is_submitted || job.is_completed; };
+      return std::ranges::all_of(m_pending, [&](const std::deque<pending_job>& pending) {
+        return std::ranges::all_of(pending, is_done);
+      });
+    });
+    for (auto i = std::size_t{ 0 }; i < m_devices.size(); ++i)
+    {
+      retire(i);
+    }
+  }
+
+  std::size_t device_scheduler::queue_depth(const std::size_t index) const {
+    MEGATECH_PRECONDITION(index < m_devices.size());
+    auto lock = std::unique_lock<std::mutex>{ m_mutex };
+    return m_pending[index].size();
+  }
+
+  std::chrono::nanoseconds device_scheduler::estimated_duration(const std::size_t index, const job_class type) const {
+    MEGATECH_PRECONDITION(index < m_devices.size());
+    auto lock = std::unique_lock<std::mutex>{ m_mutex };
+    const auto found = m_estimates[index].find(type);
+    if (found == m_estimates[index].end())
+    {
+      return std::chrono::nanoseconds{ 0 };
+    }
+    return std::chrono::nanoseconds{ static_cast<std::chrono::nanoseconds::rep>(found->second) };
+  }
+
+  void device_scheduler::set_smoothing_factor(const double factor) {
+    if (!(factor > 0.0 && factor <= 1.0))
+    {
+      throw error{ "The smoothing factor must be in the range (0, 1]." };
+    }
+    auto lock = std::unique_lock<std::mutex>{ m_mutex };
+    m_smoothing_factor = factor;
+  }
+
+}
@@ -0,0 +1,74 @@
+/**
+ * @file file_streamer.cpp
+ * @brief Asynchronous File-to-Device Streaming
+ * @author Alexander Rothman <[gnomesort@megate.ch](mailto:gnomesort@megate.ch)>
+ * @copyright AGPL-3.0-or-later
+ * @date 2025
+ */
+#include "megatech/vulkan/file_streamer.hpp"
+
+#include <megatech/assertions.hpp>
+
+#include "megatech/vulkan/device.hpp"
+
+#include "megatech/vulkan/internal/base/device_impl.hpp"
+#include "megatech/vulkan/internal/base/file_streamer_impl.hpp"
+
+namespace megatech::vulkan {
+
+  file_streamer::file_streamer(const device& parent, const std::uint64_t staging_capacity,
+                               const std::uint32_t queue_depth) :
+  m_impl{ new implementation_type{ parent.share_implementation(), staging_capacity, queue_depth } } {
+    MEGATECH_POSTCONDITION(m_impl != nullptr);
+  }
+
+  const file_streamer::implementation_type& file_streamer::implementation() const {
+    MEGATECH_PRECONDITION(m_impl != nullptr);
+    return *m_impl;
+  }
+
+  file_streamer::implementation_type& file_streamer::implementation() {
+    MEGATECH_PRECONDITION(m_impl != nullptr);
+    return *m_impl;
+  }
+
+  std::shared_ptr<const file_streamer::implementation_type> file_streamer::share_implementation() const {
+    MEGATECH_PRECONDITION(m_impl != nullptr);
+    return m_impl;
+  }
+
+  std::uint64_t file_streamer::staging_capacity() const {
+    MEGATECH_PRECONDITION(m_impl != nullptr);
+    return m_impl->staging_capacity();
+  }
+
+  bool file_streamer::uses_io_uring() const {
+    MEGATECH_PRECONDITION(m_impl != nullptr);
+    return m_impl->uses_io_uring();
+  }
+
+  std::size_t file_streamer::pending() const {
+    MEGATECH_PRECONDITION(m_impl != nullptr);
+    return m_impl->pending();
+  }
+
+  void file_streamer::read(const std::filesystem::path& path, const std::uint64_t file_offset,
+                           const std::uint64_t size, const device_buffer& destination,
+                           const std::uint64_t destination_offset) {
+    MEGATECH_PRECONDITION(m_impl != nullptr);
+    m_impl->read(path, file_offset, size, destination.share_implementation(), destination_offset);
+  }
+
+  compute_completion file_streamer::submit() {
+    MEGATECH_PRECONDITION(m_impl != nullptr);
+    const auto timeline_value = m_impl->submit();
+    return compute_completion{ m_impl->share_parent(), timeline_value };
+  }
+
+  compute_completion file_streamer::flush() {
+    MEGATECH_PRECONDITION(m_impl != nullptr);
+    const auto timeline_value = m_impl->flush();
+    return compute_completion{ m_impl->share_parent(), timeline_value };
+  }
+
+}
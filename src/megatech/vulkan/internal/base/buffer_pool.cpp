@@ -0,0 +1,100 @@
+/**
+ * @file buffer_pool.cpp
+ * @brief Recycled Buffers
+ * @author Alexander Rothman <[gnomesort@megate.ch](mailto:gnomesort@megate.ch)>
+ * @copyright AGPL-3.0-or-later
+ * @date 2025
+ */
+#include "megatech/vulkan/internal/base/buffer_pool.hpp"
+
+#include <algorithm>
+
+#include <megatech/assertions.hpp>
+
+#include "megatech/vulkan/error.hpp"
+
+namespace megatech::vulkan::internal::base {
+
+  buffer_pool::buffer_pool(const std::shared_ptr<const parent_type>& parent, const VkBufferUsageFlags usage,
+                           const VkMemoryPropertyFlags required, const VkMemoryPropertyFlags preferred) :
+  m_parent{ parent },
+  m_usage{ usage },
+  m_required{ required },
+  m_preferred{ preferred } {
+    if (!m_parent)
+    {
+      throw error{ "The parent device cannot be null." };
+    }
+  }
+
+  buffer_pool::~buffer_pool() noexcept {
+    auto& deletions = m_parent->deletions();
+    for (auto& buffer : m_free)
+    {
+      m_parent->destroy_buffer(buffer);
+    }
+    for (auto& [value, buffer] : m_pending)
+    {
+      deletions.destroy_buffer(buffer, value);
+    }
+  }
+
+  const buffer_pool::parent_type& buffer_pool::parent() const {
+    MEGATECH_PRECONDITION(m_parent != nullptr);
+    return *m_parent;
+  }
+
+  buffer_allocation buffer_pool::acquire(const VkDeviceSize size) {
+    {
+      auto lock = std::unique_lock<std::mutex>{ m_mutex };
+      if (!m_pending.empty())
+      {
+        const auto completed = m_parent->completed_timeline_value();
+        const auto itr = std::ranges::partition(m_pending, [&](const auto& p){ return p.first > completed; }).begin();
+        for (auto cur = itr; cur != m_pending.end(); ++cur)
+        {
+          m_free.emplace_back(cur->second);
+        }
+        m_pending.erase(itr, m_pending.end());
+      }
+      auto best = m_free.end();
+      for (auto itr = m_free.begin(); itr != m_free.end(); ++itr)
+      {
+        if (itr->size >= size && (best == m_free.end() || itr->size < best->size))
+        {
+          best = itr;
+        }
+      }
+      if (best != m_free.end())
+      {
+        const auto result = *best;
+        m_free.erase(best);
+        return result;
+      }
+    }
+    return m_parent->create_buffer(size, m_usage, m_required, m_preferred);
+  }
+
+  void buffer_pool::release(const buffer_allocation& buffer, const std::uint64_t timeline_value) {
+    auto lock = std::unique_lock<std::mutex>{ m_mutex };
+    if (!timeline_value)
+    {
+      m_free.emplace_back(buffer);
+      return;
+    }
+    m_pending.emplace_back(timeline_value, buffer);
+  }
+
+  VkDeviceSize buffer_pool::trim() {
+    auto lock = std::unique_lock<std::mutex>{ m_mutex };
+    auto result = VkDeviceSize{ 0 };
+    for (auto& buffer : m_free)
+    {
+      result += buffer.allocation.size;
+      m_parent->destroy_buffer(buffer);
+    }
+    m_free.clear();
+    return result;
+  }
+
+}
@@ -0,0 +1,138 @@
+/**
+ * @file command_buffer_pool.cpp
+ * @brief Recycled Command Buffers
+ * @author Alexander Rothman <[gnomesort@megate.ch](mailto:gnomesort@megate.ch)>
+ * @copyright AGPL-3.0-or-later
+ * @date 2025
+ */
+#include "megatech/vulkan/internal/base/command_buffer_pool.hpp"
+
+#include <algorithm>
+
+#include <megatech/assertions.hpp>
+
+#include "megatech/vulkan/error.hpp"
+
+#define DECLARE_DEVICE_PFN(dt, cmd) MEGATECH_VULKAN_INTERNAL_BASE_DECLARE_DEVICE_PFN(dt, cmd)
+#define VK_CHECK(exp) MEGATECH_VULKAN_INTERNAL_BASE_VK_CHECK(exp)
+
+namespace megatech::vulkan::internal::base {
+
+  command_buffer_pool::command_buffer_pool(const std::shared_ptr<const parent_type>& parent, const queue_type queue) :
+  m_parent{ parent },
+  m_queue{ queue } {
+    if (!m_parent)
+    {
+      throw error{ "The parent device cannot be null." };
+    }
+    auto pool_info = VkCommandPoolCreateInfo{ };
+    pool_info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    pool_info.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT | VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+    pool_info.queueFamilyIndex = m_parent->queue_family_index(m_queue);
+    DECLARE_DEVICE_PFN(m_parent->dispatch_table(), vkCreateCommandPool);
+    VK_CHECK(vkCreateCommandPool(m_parent->handle(), &pool_info, nullptr, &m_handle));
+    MEGATECH_POSTCONDITION(m_handle != VK_NULL_HANDLE);
+  }
+
+  command_buffer_pool::~command_buffer_pool() noexcept {
+    // Destroying the pool frees its command buffers, so it's deferred until the last one completes.
+    m_parent->deletions().destroy_command_pool(m_handle, m_last_submitted);
+  }
+
+  command_buffer_pool::handle_type command_buffer_pool::handle() const {
+    return m_handle;
+  }
+
+  const command_buffer_pool::parent_type& command_buffer_pool::parent() const {
+    MEGATECH_PRECONDITION(m_parent != nullptr);
+    return *m_parent;
+  }
+
+  queue_type command_buffer_pool::queue() const {
+    return m_queue;
+  }
+
+  VkCommandBuffer command_buffer_pool::acquire() {
+    auto command_buffer = VkCommandBuffer{ };
+    {
+      auto lock = std::unique_lock<std::mutex>{ m_mutex };
+      if (m_free.empty() && !m_pending.empty())
+      {
+        const auto completed = m_parent->completed_timeline_value();
+        const auto itr = std::ranges::partition(m_pending, [&](const auto& p){ return p.first > completed; }).begin();
+        for (auto cur = itr; cur != m_pending.end(); ++cur)
+        {
+          m_free.emplace_back(cur->second);
+        }
+        m_pending.erase(itr, m_pending.end());
+      }
+      if (m_free.empty())
+      {
+        auto allocate_info = VkCommandBufferAllocateInfo{ };
+        allocate_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocate_info.commandPool = m_handle;
+        allocate_info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocate_info.commandBufferCount = 1;
+        DECLARE_DEVICE_PFN(m_parent->dispatch_table(), vkAllocateCommandBuffers);
+        VK_CHECK(vkAllocateCommandBuffers(m_parent->handle(), &allocate_info, &command_buffer));
+      }
+      else
+      {
+        command_buffer = m_free.back();
+        m_free.pop_back();
+      }
+    }
+    // Beginning a command buffer from a pool created with VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT implicitly
+    // resets it.
+    auto begin_info = VkCommandBufferBeginInfo{ };
+    begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    DECLARE_DEVICE_PFN(m_parent->dispatch_table(), vkBeginCommandBuffer);
+    if (const auto res = vkBeginCommandBuffer(command_buffer, &begin_info); res != VK_SUCCESS)
+    {
+      release(command_buffer, 0);
+      throw error{ "Failed to begin a command buffer.", res };
+    }
+    MEGATECH_POSTCONDITION(command_buffer != VK_NULL_HANDLE);
+    return command_buffer;
+  }
+
+  void command_buffer_pool::release(const VkCommandBuffer command_buffer, const std::uint64_t timeline_value) {
+    auto lock = std::unique_lock<std::mutex>{ m_mutex };
+    if (!timeline_value)
+    {
+      m_free.emplace_back(command_buffer);
+      return;
+    }
+    m_pending.emplace_back(timeline_value, command_buffer);
+    m_last_submitted = std::max(m_last_submitted, timeline_value);
+  }
+
+  std::uint64_t command_buffer_pool::submit(const VkCommandBuffer command_buffer,
+                                            const std::span<const VkSemaphoreSubmitInfo> waits,
+                                            const std::span<const VkSemaphoreSubmitInfo> signals) {
+    DECLARE_DEVICE_PFN(m_parent->dispatch_table(), vkEndCommandBuffer);
+    if (const auto res = vkEndCommandBuffer(command_buffer); res != VK_SUCCESS)
+    {
+      release(command_buffer, 0);
+      throw error{ "Failed to end a command buffer.", res };
+    }
+    auto command_buffer_info = VkCommandBufferSubmitInfo{ };
+    command_buffer_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO;
+    command_buffer_info.commandBuffer = command_buffer;
+    command_buffer_info.deviceMask = m_parent->device_mask();
+    auto timeline_value = std::uint64_t{ };
+    try
+    {
+      timeline_value = m_parent->submit(m_queue, { &command_buffer_info, 1 }, waits, signals);
+    }
+    catch (...)
+    {
+      release(command_buffer, 0);
+      throw;
+    }
+    release(command_buffer, timeline_value);
+    return timeline_value;
+  }
+
+}
@@ -0,0 +1,301 @@
+/**
+ * @file completion_reactor_impl.cpp
+ * @brief Completion Reactor Implementation
+ * @author Alexander Rothman <[gnomesort@megate.ch](mailto:gnomesort@megate.ch)>
+ * @copyright AGPL-3.0-or-later
+ * @date 2025
+ */
+#include "megatech/vulkan/internal/base/completion_reactor_impl.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+#include <megatech/assertions.hpp>
+
+#include "megatech/vulkan/error.hpp"
+
+#define DECLARE_DEVICE_PFN(dt, cmd) MEGATECH_VULKAN_INTERNAL_BASE_DECLARE_DEVICE_PFN(dt, cmd)
+#define DECLARE_DEVICE_PFN_NO_THROW(dt, cmd) MEGATECH_VULKAN_INTERNAL_BASE_DECLARE_DEVICE_PFN_NO_THROW(dt, cmd)
+#define VK_CHECK(exp) MEGATECH_VULKAN_INTERNAL_BASE_VK_CHECK(exp)
+
+namespace megatech::vulkan::internal::base {
+
+  completion_reactor_impl::shared_state::~shared_state() noexcept {
+    DECLARE_DEVICE_PFN_NO_THROW(parent->dispatch_table(), vkDestroySemaphore);
+    vkDestroySemaphore(parent->handle(), wake_semaphore, nullptr);
+  }
+
+  void completion_reactor_impl::shared_state::wake() {
+    // The reactor only needs to be woken when it might be blocked in vkWaitSemaphores. Otherwise, it observes new
+    // waiters the next time that it locks the state.
+    if (!sleeping)
+    {
+      return;
+    }
+    auto signal_info = VkSemaphoreSignalInfo{ };
+    signal_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SIGNAL_INFO;
+    signal_info.semaphore = wake_semaphore;
+    signal_info.value = wake_value + 1;
+    DECLARE_DEVICE_PFN(parent->dispatch_table(), vkSignalSemaphore);
+    VK_CHECK(vkSignalSemaphore(parent->handle(), &signal_info));
+    ++wake_value;
+  }
+
+  void completion_reactor_impl::run(const std::shared_ptr<shared_state>& state) {
+    const auto& device = *state->parent;
+    DECLARE_DEVICE_PFN_NO_THROW(device.dispatch_table(), vkGetFenceStatus);
+    DECLARE_DEVICE_PFN_NO_THROW(device.dispatch_table(), vkGetSemaphoreCounterValue);
+    DECLARE_DEVICE_PFN_NO_THROW(device.dispatch_table(), vkWaitSemaphores);
+    auto watching = std::vector<waiter>{ };
+    auto semaphores = std::vector<VkSemaphore>{ };
+    auto values = std::vector<std::uint64_t>{ };
+    auto lock = std::unique_lock<std::mutex>{ state->mutex };
+    while (true)
+    {
+      state->condition.wait(lock, [&]() { return state->stopping || !state->incoming.empty() || !watching.empty(); });
+      watching.insert(watching.end(), state->incoming.begin(), state->incoming.end());
+      state->incoming.clear();
+      if (state->stopping)
+      {
+        break;
+      }
+      const auto observed = state->wake_value;
+      state->sleeping = true;
+      lock.unlock();
+      auto failure = std::exception_ptr{ };
+      auto ready = watching.end();
+      try
+      {
+        const auto completed = device.completed_timeline_value();
+        ready = std::partition(watching.begin(), watching.end(), [&](const waiter& current) {
+          if (current.fence == VK_NULL_HANDLE)
+          {
+            return current.timeline_value > completed;
+          }
+          const auto status = vkGetFenceStatus(device.handle(), current.fence);
+          if (status != VK_SUCCESS && status != VK_NOT_READY)
+          {
+            throw error{ "Failed to query the status of a fence.", status };
+          }
+          return status == VK_NOT_READY;
+        });
+        if (ready == watching.end())
+        {
+          // Everything that's watched shares one wait. Only the earliest timeline value can complete first, and only
+          // the queues that haven't reached it yet are waited on. Otherwise, the wait could return immediately
+          // forever.
+          semaphores.assign(1, state->wake_semaphore);
+          values.assign(1, observed + 1);
+          auto earliest = std::numeric_limits<std::uint64_t>::max();
+          auto has_fences = false;
+          for (const auto& current : watching)
+          {
+            has_fences = has_fences || current.fence != VK_NULL_HANDLE;
+            if (current.fence == VK_NULL_HANDLE)
+            {
+              earliest = std::min(earliest, current.timeline_value);
+            }
+          }
+          if (earliest != std::numeric_limits<std::uint64_t>::max())
+          {
+            for (const auto& target : device.timeline_targets(earliest))
+            {
+              auto counter = std::uint64_t{ };
+              VK_CHECK(vkGetSemaphoreCounterValue(device.handle(), target.first, &counter));
+              if (counter < target.second)
+              {
+                semaphores.emplace_back(target.first);
+                values.emplace_back(target.second);
+              }
+            }
+          }
+          // If every queue already reached the earliest value, it completed after it was checked.
+          if (earliest == std::numeric_limits<std::uint64_t>::max() || semaphores.size() > 1)
+          {
+            auto wait_info = VkSemaphoreWaitInfo{ };
+            wait_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+            wait_info.flags = VK_SEMAPHORE_WAIT_ANY_BIT;
+            wait_info.semaphoreCount = semaphores.size();
+            wait_info.pSemaphores = semaphores.data();
+            wait_info.pValues = values.data();
+            auto timeout = std::numeric_limits<std::uint64_t>::max();
+            if (has_fences)
+            {
+              timeout = std::chrono::duration_cast<std::chrono::nanoseconds>(fence_poll_interval).count();
+            }
+            const auto result = vkWaitSemaphores(device.handle(), &wait_info, timeout);
+            if (result != VK_SUCCESS && result != VK_TIMEOUT)
+            {
+              throw error{ "Failed to wait for device work.", result };
+            }
+          }
+        }
+      }
+      catch (...)
+      {
+        // A failed wait (e.g., a lost device) fails everything that's watched. Otherwise, it would fail forever.
+        failure = std::current_exception();
+        ready = watching.begin();
+      }
+      for (auto cur = ready; cur != watching.end(); ++cur)
+      {
+        resume(*state, *cur, failure);
+      }
+      watching.erase(ready, watching.end());
+      lock.lock();
+      state->sleeping = false;
+    }
+    lock.unlock();
+    const auto stopped = std::make_exception_ptr(error{ "The completion reactor was destroyed." });
+    for (const auto& current : watching)
+    {
+      resume(*state, current, stopped);
+    }
+  }
+
+  void completion_reactor_impl::resume(shared_state& state, const waiter& ready,
+                                       const std::exception_ptr& failure) noexcept {
+    *ready.failure = failure;
+    if (state.executor)
+    {
+      try
+      {
+        state.executor(ready.handle);
+        return;
+      }
+      catch (...)
+      {
+        // An executor that can't accept the coroutine mustn't strand it.
+      }
+    }
+    ready.handle.resume();
+  }
+
+  void completion_reactor_impl::watch(waiter&& pending) const {
+    auto lock = std::unique_lock<std::mutex>{ m_state->mutex };
+    m_state->incoming.emplace_back(std::move(pending));
+    try
+    {
+      m_state->wake();
+    }
+    catch (...)
+    {
+      m_state->incoming.pop_back();
+      throw;
+    }
+    m_state->condition.notify_one();
+  }
+
+  completion_reactor_impl::completion_reactor_impl(const std::shared_ptr<const parent_type>& parent,
+                                                   executor_type executor) {
+    if (!parent)
+    {
+      throw error{ "The parent device cannot be null." };
+    }
+    auto timeline_info = VkSemaphoreTypeCreateInfo{ };
+    timeline_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+    timeline_info.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+    auto semaphore_info = VkSemaphoreCreateInfo{ };
+    semaphore_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    semaphore_info.pNext = &timeline_info;
+    m_state.reset(new shared_state{ });
+    m_state->parent = parent;
+    m_state->executor = std::move(executor);
+    DECLARE_DEVICE_PFN(parent->dispatch_table(), vkCreateSemaphore);
+    VK_CHECK(vkCreateSemaphore(parent->handle(), &semaphore_info, nullptr, &m_state->wake_semaphore));
+    m_thread = std::thread{ [state = m_state]() { run(state); } };
+    MEGATECH_POSTCONDITION(m_state != nullptr);
+    MEGATECH_POSTCONDITION(m_state->wake_semaphore != VK_NULL_HANDLE);
+  }
+
+  completion_reactor_impl::~completion_reactor_impl() noexcept {
+    {
+      auto lock = std::unique_lock<std::mutex>{ m_state->mutex };
+      m_state->stopping = true;
+      try
+      {
+        m_state->wake();
+      }
+      catch (...)
+      {
+        // The device is lost, so the reactor's wait fails on its own.
+      }
+      m_state->condition.notify_one();
+    }
+    // The last reference can be released by a coroutine resumed on the reactor's own thread. That thread can't be
+    // joined from itself, but it owns a reference to the state, so it finishes safely on its own.
+    if (m_thread.get_id() == std::this_thread::get_id())
+    {
+      m_thread.detach();
+    }
+    else
+    {
+      m_thread.join();
+    }
+  }
+
+  const completion_reactor_impl::parent_type& completion_reactor_impl::parent() const {
+    MEGATECH_PRECONDITION(m_state != nullptr);
+    return *m_state->parent;
+  }
+
+  void completion_reactor_impl::watch(const std::uint64_t timeline_value, const std::coroutine_handle<> handle,
+                                      std::exception_ptr& failure) const {
+    MEGATECH_PRECONDITION(m_state != nullptr);
+    if (timeline_value > m_state->parent->current_timeline_value())
+    {
+      throw error{ "The requested timeline value hasn't been submitted." };
+    }
+    watch(waiter{ timeline_value, VK_NULL_HANDLE, handle, &failure });
+  }
+
+  void completion_reactor_impl::watch(const VkFence fence, const std::coroutine_handle<> handle,
+                                      std::exception_ptr& failure) const {
+    MEGATECH_PRECONDITION(m_state != nullptr);
+    if (fence == VK_NULL_HANDLE)
+    {
+      throw error{ "The fence cannot be null." };
+    }
+    watch(waiter{ 0, fence, handle, &failure });
+  }
+
+  fence_awaitable::fence_awaitable(const std::shared_ptr<const completion_reactor_impl>& reactor,
+                                   const VkFence fence) :
+  m_reactor{ reactor },
+  m_fence{ fence } {
+    if (!m_reactor)
+    {
+      throw error{ "The completion reactor cannot be null." };
+    }
+    if (m_fence == VK_NULL_HANDLE)
+    {
+      throw error{ "The fence cannot be null." };
+    }
+  }
+
+  bool fence_awaitable::await_ready() const {
+    MEGATECH_PRECONDITION(m_reactor != nullptr);
+    const auto& device = m_reactor->parent();
+    DECLARE_DEVICE_PFN(device.dispatch_table(), vkGetFenceStatus);
+    const auto status = vkGetFenceStatus(device.handle(), m_fence);
+    if (status != VK_SUCCESS && status != VK_NOT_READY)
+    {
+      throw error{ "Failed to query the status of a fence.", status };
+    }
+    return status == VK_SUCCESS;
+  }
+
+  void fence_awaitable::await_suspend(const std::coroutine_handle<> handle) {
+    MEGATECH_PRECONDITION(m_reactor != nullptr);
+    m_reactor->watch(m_fence, handle, m_error);
+  }
+
+  void fence_awaitable::await_resume() const {
+    if (m_error)
+    {
+      std::rethrow_exception(m_error);
+    }
+  }
+
+}
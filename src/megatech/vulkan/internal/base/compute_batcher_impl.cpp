@@ -0,0 +1,281 @@
+/**
+ * @file compute_batcher_impl.cpp
+ * @brief Compute Batcher Implementation
+ * @author Alexander Rothman <[gnomesort@megate.ch](mailto:gnomesort@megate.ch)>
+ * @copyright AGPL-3.0-or-later
+ * @date 2025
+ */
+#include "megatech/vulkan/internal/base/compute_batcher_impl.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <iterator>
+#include <unordered_set>
+#include <utility>
+
+#include <megatech/assertions.hpp>
+
+#include "megatech/vulkan/error.hpp"
+
+#define DECLARE_DEVICE_PFN(dt, cmd) MEGATECH_VULKAN_INTERNAL_BASE_DECLARE_DEVICE_PFN(dt, cmd)
+
+namespace megatech::vulkan::internal::base {
+
+  void compute_batcher_impl::submit_batch(std::vector<job>&& jobs) {
+    const auto& ddt = m_parent->dispatch_table();
+    DECLARE_DEVICE_PFN(ddt, vkCmdPipelineBarrier2);
+    DECLARE_DEVICE_PFN(ddt, vkCmdBindPipeline);
+    DECLARE_DEVICE_PFN(ddt, vkCmdPushConstants);
+    DECLARE_DEVICE_PFN(ddt, vkCmdDispatch);
+    auto barrier = VkMemoryBarrier2{ };
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2;
+    barrier.srcStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+    barrier.srcAccessMask = VK_ACCESS_2_SHADER_WRITE_BIT;
+    barrier.dstStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+    barrier.dstAccessMask = VK_ACCESS_2_SHADER_READ_BIT | VK_ACCESS_2_SHADER_WRITE_BIT;
+    auto dependency_info = VkDependencyInfo{ };
+    dependency_info.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+    dependency_info.memoryBarrierCount = 1;
+    dependency_info.pMemoryBarriers = &barrier;
+    auto timeline_value = std::uint64_t{ 0 };
+    try
+    {
+      const auto command_buffer = m_commands->acquire();
+      try
+      {
+        // Batches are ordered against every earlier submission on the queue.
+        vkCmdPipelineBarrier2(command_buffer, &dependency_info);
+        // Within a batch, barriers are only needed when a job touches a buffer that was written since the last barrier
+        // or writes a buffer that was accessed since the last barrier.
+        auto reads = std::unordered_set<VkDeviceAddress>{ };
+        auto writes = std::unordered_set<VkDeviceAddress>{ };
+        auto bound = VkPipeline{ VK_NULL_HANDLE };
+        auto barriers = std::uint64_t{ 0 };
+        for (const auto& current : jobs)
+        {
+          const auto hazard = std::ranges::any_of(current.reads, [&](const auto address) {
+            return writes.contains(address);
+          }) || std::ranges::any_of(current.writes, [&](const auto address) {
+            return writes.contains(address) || reads.contains(address);
+          });
+          if (hazard)
+          {
+            vkCmdPipelineBarrier2(command_buffer, &dependency_info);
+            reads.clear();
+            writes.clear();
+            ++barriers;
+          }
+          if (current.pipeline->handle() != bound)
+          {
+            bound = current.pipeline->handle();
+            vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, bound);
+          }
+          if (!current.push_constants.empty())
+          {
+            vkCmdPushConstants(command_buffer, current.pipeline->layout(), VK_SHADER_STAGE_COMPUTE_BIT, 0,
+                               current.push_constants.size(), current.push_constants.data());
+          }
+          vkCmdDispatch(command_buffer, current.group_counts[0], current.group_counts[1], current.group_counts[2]);
+          reads.insert(current.reads.begin(), current.reads.end());
+          writes.insert(current.writes.begin(), current.writes.end());
+        }
+        barrier.dstStageMask = VK_PIPELINE_STAGE_2_HOST_BIT;
+        barrier.dstAccessMask = VK_ACCESS_2_HOST_READ_BIT;
+        vkCmdPipelineBarrier2(command_buffer, &dependency_info);
+        m_barriers_recorded += barriers;
+      }
+      catch (...)
+      {
+        m_commands->release(command_buffer, 0);
+        throw;
+      }
+      timeline_value = m_commands->submit(command_buffer);
+    }
+    catch (...)
+    {
+      const auto exception = std::current_exception();
+      for (auto& current : jobs)
+      {
+        current.promise.set_exception(exception);
+      }
+      return;
+    }
+    ++m_batches_submitted;
+    {
+      auto lock = std::unique_lock<std::mutex>{ m_mutex };
+      m_in_flight.emplace_back(timeline_value, std::move(jobs));
+    }
+    m_completion_condition.notify_one();
+  }
+
+  void compute_batcher_impl::run_flusher() {
+    auto lock = std::unique_lock<std::mutex>{ m_mutex };
+    while (!m_stopping || !m_pending.empty())
+    {
+      if (m_pending.empty())
+      {
+        m_flush_condition.wait(lock);
+        continue;
+      }
+      m_flush_condition.wait_until(lock, m_pending.front().enqueued + m_window, [&]() {
+        return m_stopping || m_flush_requested || m_pending.size() >= m_max_batch_size;
+      });
+      // Producers can outpace the flusher, so batches are capped here. Leftover jobs keep their enqueue times and are
+      // flushed on the next iteration, immediately if their window has already elapsed.
+      const auto count = std::min(m_pending.size(), m_max_batch_size);
+      auto jobs = std::vector<job>{ };
+      jobs.reserve(count);
+      std::move(m_pending.begin(), m_pending.begin() + count, std::back_inserter(jobs));
+      m_pending.erase(m_pending.begin(), m_pending.begin() + count);
+      m_flush_requested = m_flush_requested && !m_pending.empty();
+      lock.unlock();
+      submit_batch(std::move(jobs));
+      lock.lock();
+    }
+    m_flusher_stopped = true;
+    m_completion_condition.notify_one();
+  }
+
+  void compute_batcher_impl::run_completer() {
+    auto lock = std::unique_lock<std::mutex>{ m_mutex };
+    while (true)
+    {
+      m_completion_condition.wait(lock, [&]() { return !m_in_flight.empty() || m_flusher_stopped; });
+      if (m_in_flight.empty())
+      {
+        break;
+      }
+      const auto timeline_value = m_in_flight.front().timeline_value;
+      lock.unlock();
+      auto exception = std::exception_ptr{ };
+      try
+      {
+        m_parent->wait_for_timeline_value(timeline_value);
+      }
+      catch (...)
+      {
+        exception = std::current_exception();
+      }
+      lock.lock();
+      auto completed = std::move(m_in_flight.front());
+      m_in_flight.pop_front();
+      lock.unlock();
+      for (auto& current : completed.jobs)
+      {
+        if (exception)
+        {
+          current.promise.set_exception(exception);
+        }
+        else
+        {
+          current.promise.set_value();
+        }
+      }
+      completed.jobs.clear();
+      lock.lock();
+    }
+  }
+
+  compute_batcher_impl::compute_batcher_impl(const std::shared_ptr<const parent_type>& parent,
+                                             const std::chrono::nanoseconds window, const std::size_t max_batch_size) :
+  m_parent{ parent },
+  m_window{ std::chrono::duration_cast<std::chrono::steady_clock::duration>(window) },
+  m_max_batch_size{ max_batch_size } {
+    if (!m_parent)
+    {
+      throw error{ "The parent device cannot be null." };
+    }
+    if (window < std::chrono::nanoseconds::zero())
+    {
+      throw error{ "The batching window cannot be negative." };
+    }
+    if (m_max_batch_size == 0)
+    {
+      throw error{ "The maximum batch size must be greater than 0." };
+    }
+    m_commands.reset(new command_buffer_pool{ m_parent, queue_type::async_compute });
+    m_flusher = std::thread{ &compute_batcher_impl::run_flusher, this };
+    try
+    {
+      m_completer = std::thread{ &compute_batcher_impl::run_completer, this };
+    }
+    catch (...)
+    {
+      {
+        auto lock = std::unique_lock<std::mutex>{ m_mutex };
+        m_stopping = true;
+      }
+      m_flush_condition.notify_one();
+      m_flusher.join();
+      throw;
+    }
+    MEGATECH_POSTCONDITION(m_commands != nullptr);
+  }
+
+  compute_batcher_impl::~compute_batcher_impl() noexcept {
+    {
+      auto lock = std::unique_lock<std::mutex>{ m_mutex };
+      m_stopping = true;
+    }
+    m_flush_condition.notify_one();
+    m_flusher.join();
+    m_completer.join();
+  }
+
+  const compute_batcher_impl::parent_type& compute_batcher_impl::parent() const {
+    MEGATECH_PRECONDITION(m_parent != nullptr);
+    return *m_parent;
+  }
+
+  std::future<void> compute_batcher_impl::enqueue(const std::shared_ptr<const compute_pipeline_impl>& pipeline,
+                                                  const std::span<const std::byte> push_constants,
+                                                  const std::array<std::uint32_t, 3>& group_counts,
+                                                  const std::span<const VkDeviceAddress> reads,
+                                                  const std::span<const VkDeviceAddress> writes) {
+    if (!pipeline || &pipeline->parent() != m_parent.get())
+    {
+      throw error{ "The compute pipeline must belong to the compute batcher's device." };
+    }
+    if (push_constants.size() != pipeline->push_constant_size())
+    {
+      throw error{ "The push constant data doesn't match the compute pipeline's push constant size." };
+    }
+    auto current = job{ };
+    current.pipeline = pipeline;
+    current.push_constants.assign(push_constants.begin(), push_constants.end());
+    current.group_counts = group_counts;
+    current.reads.assign(reads.begin(), reads.end());
+    current.writes.assign(writes.begin(), writes.end());
+    auto result = current.promise.get_future();
+    auto notify = false;
+    {
+      auto lock = std::unique_lock<std::mutex>{ m_mutex };
+      notify = m_pending.empty();
+      current.enqueued = std::chrono::steady_clock::now();
+      m_pending.emplace_back(std::move(current));
+      notify = notify || m_pending.size() >= m_max_batch_size;
+    }
+    if (notify)
+    {
+      m_flush_condition.notify_one();
+    }
+    return result;
+  }
+
+  void compute_batcher_impl::flush() {
+    {
+      auto lock = std::unique_lock<std::mutex>{ m_mutex };
+      m_flush_requested = !m_pending.empty();
+    }
+    m_flush_condition.notify_one();
+  }
+
+  std::uint64_t compute_batcher_impl::batches_submitted() const {
+    return m_batches_submitted;
+  }
+
+  std::uint64_t compute_batcher_impl::barriers_recorded() const {
+    return m_barriers_recorded;
+  }
+
+}
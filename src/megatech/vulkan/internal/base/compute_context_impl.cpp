@@ -0,0 +1,104 @@
+/**
+ * @file compute_context_impl.cpp
+ * @brief Compute Context Implementation
+ * @author Alexander Rothman <[gnomesort@megate.ch](mailto:gnomesort@megate.ch)>
+ * @copyright AGPL-3.0-or-later
+ * @date 2025
+ */
+#include "megatech/vulkan/internal/base/compute_context_impl.hpp"
+
+#include <algorithm>
+
+#include <megatech/assertions.hpp>
+
+#include "megatech/vulkan/error.hpp"
+
+#define DECLARE_DEVICE_PFN(dt, cmd) MEGATECH_VULKAN_INTERNAL_BASE_DECLARE_DEVICE_PFN(dt, cmd)
+
+namespace megatech::vulkan::internal::base {
+
+  void compute_context_impl::retire() {
+    const auto completed = m_parent->completed_timeline_value();
+    std::erase_if(m_in_flight, [&](const auto& p){ return p.first <= completed; });
+  }
+
+  compute_context_impl::compute_context_impl(const std::shared_ptr<const parent_type>& parent) :
+  m_parent{ parent } {
+    if (!m_parent)
+    {
+      throw error{ "The parent device cannot be null." };
+    }
+    m_commands.reset(new command_buffer_pool{ m_parent, queue_type::async_compute });
+    MEGATECH_POSTCONDITION(m_commands != nullptr);
+  }
+
+  const compute_context_impl::parent_type& compute_context_impl::parent() const {
+    MEGATECH_PRECONDITION(m_parent != nullptr);
+    return *m_parent;
+  }
+
+  std::shared_ptr<const compute_context_impl::parent_type> compute_context_impl::share_parent() const {
+    MEGATECH_PRECONDITION(m_parent != nullptr);
+    return m_parent;
+  }
+
+  queue_type compute_context_impl::queue() const {
+    return queue_type::async_compute;
+  }
+
+  std::uint64_t compute_context_impl::dispatch(const std::shared_ptr<const compute_pipeline_impl>& pipeline,
+                                               const std::span<const std::byte> push_constants,
+                                               const std::array<std::uint32_t, 3>& group_counts) {
+    if (!pipeline || &pipeline->parent() != m_parent.get())
+    {
+      throw error{ "The compute pipeline must belong to the compute context's device." };
+    }
+    if (push_constants.size() != pipeline->push_constant_size())
+    {
+      throw error{ "The push constant data doesn't match the compute pipeline's push constant size." };
+    }
+    const auto& ddt = m_parent->dispatch_table();
+    DECLARE_DEVICE_PFN(ddt, vkCmdPipelineBarrier2);
+    DECLARE_DEVICE_PFN(ddt, vkCmdBindPipeline);
+    DECLARE_DEVICE_PFN(ddt, vkCmdPushConstants);
+    DECLARE_DEVICE_PFN(ddt, vkCmdDispatch);
+    auto lock = std::unique_lock<std::mutex>{ m_mutex };
+    retire();
+    const auto command_buffer = m_commands->acquire();
+    try
+    {
+      // Submissions aren't implicitly ordered with respect to memory, so each dispatch waits for the writes of every
+      // earlier dispatch on the queue.
+      auto barrier = VkMemoryBarrier2{ };
+      barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2;
+      barrier.srcStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+      barrier.srcAccessMask = VK_ACCESS_2_SHADER_WRITE_BIT;
+      barrier.dstStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+      barrier.dstAccessMask = VK_ACCESS_2_SHADER_READ_BIT | VK_ACCESS_2_SHADER_WRITE_BIT;
+      auto dependency_info = VkDependencyInfo{ };
+      dependency_info.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+      dependency_info.memoryBarrierCount = 1;
+      dependency_info.pMemoryBarriers = &barrier;
+      vkCmdPipelineBarrier2(command_buffer, &dependency_info);
+      vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline->handle());
+      if (!push_constants.empty())
+      {
+        vkCmdPushConstants(command_buffer, pipeline->layout(), VK_SHADER_STAGE_COMPUTE_BIT, 0, push_constants.size(),
+                           push_constants.data());
+      }
+      vkCmdDispatch(command_buffer, group_counts[0], group_counts[1], group_counts[2]);
+      barrier.dstStageMask = VK_PIPELINE_STAGE_2_HOST_BIT;
+      barrier.dstAccessMask = VK_ACCESS_2_HOST_READ_BIT;
+      vkCmdPipelineBarrier2(command_buffer, &dependency_info);
+    }
+    catch (...)
+    {
+      m_commands->release(command_buffer, 0);
+      throw;
+    }
+    const auto timeline_value = m_commands->submit(command_buffer);
+    m_in_flight.emplace_back(timeline_value, pipeline);
+    return timeline_value;
+  }
+
+}
@@ -0,0 +1,125 @@
+/**
+ * @file compute_pipeline_cache.cpp
+ * @brief Per-Device Specialized Compute Pipeline Cache
+ * @author Alexander Rothman <[gnomesort@megate.ch](mailto:gnomesort@megate.ch)>
+ * @copyright AGPL-3.0-or-later
+ * @date 2025
+ */
+#include "megatech/vulkan/internal/base/compute_pipeline_cache.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+#include <megatech/assertions.hpp>
+
+#include "megatech/vulkan/error.hpp"
+
+#include "megatech/vulkan/internal/base/device_impl.hpp"
+#include "megatech/vulkan/internal/base/compute_pipeline_impl.hpp"
+#include "megatech/vulkan/internal/base/kernel_specialization.hpp"
+
+#define DECLARE_DEVICE_PFN(dt, cmd) MEGATECH_VULKAN_INTERNAL_BASE_DECLARE_DEVICE_PFN(dt, cmd)
+#define DECLARE_DEVICE_PFN_NO_THROW(dt, cmd) MEGATECH_VULKAN_INTERNAL_BASE_DECLARE_DEVICE_PFN_NO_THROW(dt, cmd)
+#define VK_CHECK(exp) MEGATECH_VULKAN_INTERNAL_BASE_VK_CHECK(exp)
+
+namespace {
+
+  std::uint64_t hash_code(const std::span<const std::uint32_t> spirv) {
+    // FNV-1a over the code's words. SPIR-V is already word aligned, so hashing words instead of bytes is sufficient.
+    auto res = std::uint64_t{ 0xcbf29ce484222325 };
+    for (const auto word : spirv)
+    {
+      res ^= word;
+      res *= std::uint64_t{ 0x100000001b3 };
+    }
+    return res;
+  }
+
+}
+
+namespace megatech::vulkan::internal::base {
+
+  compute_pipeline_cache::compute_pipeline_cache(const parent_type& parent) : m_parent{ &parent } {
+    auto cache_info = VkPipelineCacheCreateInfo{ };
+    cache_info.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    DECLARE_DEVICE_PFN(m_parent->dispatch_table(), vkCreatePipelineCache);
+    VK_CHECK(vkCreatePipelineCache(m_parent->handle(), &cache_info, nullptr, &m_handle));
+    MEGATECH_POSTCONDITION(m_handle != VK_NULL_HANDLE);
+  }
+
+  compute_pipeline_cache::~compute_pipeline_cache() noexcept {
+    // Pipeline caches are never used by submitted work, so the cache doesn't need to be deferred.
+    DECLARE_DEVICE_PFN_NO_THROW(m_parent->dispatch_table(), vkDestroyPipelineCache);
+    vkDestroyPipelineCache(m_parent->handle(), m_handle, nullptr);
+  }
+
+  compute_pipeline_cache::handle_type compute_pipeline_cache::handle() const {
+    return m_handle;
+  }
+
+  const compute_pipeline_cache::parent_type& compute_pipeline_cache::parent() const {
+    MEGATECH_PRECONDITION(m_parent != nullptr);
+    return *m_parent;
+  }
+
+  std::shared_ptr<compute_pipeline_impl>
+  compute_pipeline_cache::acquire(const std::shared_ptr<const parent_type>& device,
+                                  const std::span<const std::uint32_t> spirv, const std::string& entry_point,
+                                  const std::uint32_t push_constant_size, const kernel_constants& constants) {
+    MEGATECH_PRECONDITION(device.get() == m_parent);
+    const auto specialization = kernel_specialization{ m_parent->parent(), constants };
+    // Every input except the code is included in the key verbatim. The code is only hashed, so entries that share a
+    // key are compared against the full code before they're reused.
+    const auto key = std::to_string(hash_code(spirv)) + ":" + std::to_string(spirv.size()) + ":" +
+                     std::to_string(push_constant_size) + ":" + specialization.key() + entry_point;
+    const auto same_code = [&](const entry& e) { return std::ranges::equal(e.spirv, spirv); };
+    {
+      auto lock = std::unique_lock<std::mutex>{ m_mutex };
+      if (const auto found = m_pipelines.find(key); found != m_pipelines.end())
+      {
+        if (const auto itr = std::ranges::find_if(found->second, same_code); itr != found->second.end())
+        {
+          if (auto res = itr->pipeline.lock(); res)
+          {
+            return res;
+          }
+        }
+      }
+    }
+    auto res = std::make_shared<compute_pipeline_impl>(device, spirv, entry_point, push_constant_size, specialization,
+                                                       m_handle);
+    auto lock = std::unique_lock<std::mutex>{ m_mutex };
+    auto& entries = m_pipelines[key];
+    if (const auto itr = std::ranges::find_if(entries, same_code); itr != entries.end())
+    {
+      if (auto existing = itr->pipeline.lock(); existing)
+      {
+        return existing;
+      }
+      itr->pipeline = res;
+    }
+    else
+    {
+      entries.emplace_back(std::vector<std::uint32_t>(spirv.begin(), spirv.end()), res);
+    }
+    for (auto itr = m_pipelines.begin(); itr != m_pipelines.end();)
+    {
+      std::erase_if(itr->second, [](const entry& e) { return e.pipeline.expired(); });
+      itr = itr->second.empty() ? m_pipelines.erase(itr) : std::next(itr);
+    }
+    return res;
+  }
+
+  std::size_t compute_pipeline_cache::size() const {
+    auto lock = std::unique_lock<std::mutex>{ m_mutex };
+    auto res = std::size_t{ 0 };
+    for (const auto& [key, entries] : m_pipelines)
+    {
+      res += static_cast<std::size_t>(std::ranges::count_if(entries, [](const entry& e) {
+        return !e.pipeline.expired();
+      }));
+    }
+    return res;
+  }
+
+}
@@ -0,0 +1,134 @@
+/**
+ * @file compute_pipeline_impl.cpp
+ * @brief Compute Pipeline Implementation
+ * @author Alexander Rothman <[gnomesort@megate.ch](mailto:gnomesort@megate.ch)>
+ * @copyright AGPL-3.0-or-later
+ * @date 2025
+ */
+#include "megatech/vulkan/internal/base/compute_pipeline_impl.hpp"
+
+#include <megatech/assertions.hpp>
+
+#include "megatech/vulkan/error.hpp"
+
+#include "megatech/vulkan/internal/base/physical_device_description_impl.hpp"
+
+#define DECLARE_DEVICE_PFN(dt, cmd) MEGATECH_VULKAN_INTERNAL_BASE_DECLARE_DEVICE_PFN(dt, cmd)
+#define VK_CHECK(exp) MEGATECH_VULKAN_INTERNAL_BASE_VK_CHECK(exp)
+
+namespace megatech::vulkan::internal::base {
+
+  compute_pipeline_impl::compute_pipeline_impl(const std::shared_ptr<const parent_type>& parent,
+                                               const std::span<const std::uint32_t> spirv,
+                                               const std::string& entry_point,
+                                               const std::uint32_t push_constant_size,
+                                               const VkSpecializationInfo* specialization) :
+  m_parent{ parent },
+  m_push_constant_size{ push_constant_size } {
+    create(spirv, entry_point, specialization, VK_NULL_HANDLE);
+    MEGATECH_POSTCONDITION(m_layout != VK_NULL_HANDLE);
+    MEGATECH_POSTCONDITION(m_handle != VK_NULL_HANDLE);
+  }
+
+  compute_pipeline_impl::compute_pipeline_impl(const std::shared_ptr<const parent_type>& parent,
+                                               const std::span<const std::uint32_t> spirv,
+                                               const std::string& entry_point,
+                                               const std::uint32_t push_constant_size,
+                                               const kernel_specialization& specialization,
+                                               const VkPipelineCache cache) :
+  m_parent{ parent },
+  m_push_constant_size{ push_constant_size },
+  m_specialization{ specialization } {
+    const auto info = m_specialization.info();
+    create(spirv, entry_point, &info, cache);
+    MEGATECH_POSTCONDITION(m_layout != VK_NULL_HANDLE);
+    MEGATECH_POSTCONDITION(m_handle != VK_NULL_HANDLE);
+  }
+
+  void compute_pipeline_impl::create(const std::span<const std::uint32_t> spirv, const std::string& entry_point,
+                                     const VkSpecializationInfo* specialization, const VkPipelineCache cache) {
+    if (!m_parent)
+    {
+      throw error{ "The parent device cannot be null." };
+    }
+    if (spirv.empty())
+    {
+      throw error{ "The compute shader's SPIR-V code cannot be empty." };
+    }
+    const auto& limits = m_parent->parent().properties_1_0().limits;
+    if (m_push_constant_size % 4 || m_push_constant_size > limits.maxPushConstantsSize)
+    {
+      throw error{ "The push constant size must be a multiple of 4 that doesn't exceed maxPushConstantsSize." };
+    }
+    const auto& ddt = m_parent->dispatch_table();
+    auto push_constant_range = VkPushConstantRange{ };
+    push_constant_range.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    push_constant_range.size = m_push_constant_size;
+    auto layout_info = VkPipelineLayoutCreateInfo{ };
+    layout_info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    layout_info.pushConstantRangeCount = m_push_constant_size > 0;
+    layout_info.pPushConstantRanges = &push_constant_range;
+    DECLARE_DEVICE_PFN(ddt, vkCreatePipelineLayout);
+    VK_CHECK(vkCreatePipelineLayout(m_parent->handle(), &layout_info, nullptr, &m_layout));
+    // Shader modules are only needed during pipeline creation. Passing the code directly (via maintenance5) isn't
+    // guaranteed to be available, so a temporary module is created instead.
+    auto module_info = VkShaderModuleCreateInfo{ };
+    module_info.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+    module_info.codeSize = spirv.size_bytes();
+    module_info.pCode = spirv.data();
+    auto shader_module = VkShaderModule{ };
+    DECLARE_DEVICE_PFN(ddt, vkCreateShaderModule);
+    DECLARE_DEVICE_PFN(ddt, vkDestroyShaderModule);
+    DECLARE_DEVICE_PFN(ddt, vkDestroyPipelineLayout);
+    if (const auto res = vkCreateShaderModule(m_parent->handle(), &module_info, nullptr, &shader_module);
+        res != VK_SUCCESS)
+    {
+      vkDestroyPipelineLayout(m_parent->handle(), m_layout, nullptr);
+      throw error{ "Failed to create a compute shader module.", res };
+    }
+    auto pipeline_info = VkComputePipelineCreateInfo{ };
+    pipeline_info.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    pipeline_info.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    pipeline_info.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    pipeline_info.stage.module = shader_module;
+    pipeline_info.stage.pName = entry_point.data();
+    pipeline_info.stage.pSpecializationInfo = specialization;
+    pipeline_info.layout = m_layout;
+    DECLARE_DEVICE_PFN(ddt, vkCreateComputePipelines);
+    const auto res = vkCreateComputePipelines(m_parent->handle(), cache, 1, &pipeline_info, nullptr, &m_handle);
+    vkDestroyShaderModule(m_parent->handle(), shader_module, nullptr);
+    if (res != VK_SUCCESS)
+    {
+      vkDestroyPipelineLayout(m_parent->handle(), m_layout, nullptr);
+      throw error{ "Failed to create a compute pipeline.", res };
+    }
+  }
+
+  compute_pipeline_impl::~compute_pipeline_impl() noexcept {
+    auto& deletions = m_parent->deletions();
+    deletions.destroy_pipeline(m_handle);
+    deletions.destroy_pipeline_layout(m_layout);
+  }
+
+  compute_pipeline_impl::handle_type compute_pipeline_impl::handle() const {
+    return m_handle;
+  }
+
+  const compute_pipeline_impl::parent_type& compute_pipeline_impl::parent() const {
+    MEGATECH_PRECONDITION(m_parent != nullptr);
+    return *m_parent;
+  }
+
+  VkPipelineLayout compute_pipeline_impl::layout() const {
+    return m_layout;
+  }
+
+  std::uint32_t compute_pipeline_impl::push_constant_size() const {
+    return m_push_constant_size;
+  }
+
+  const kernel_specialization& compute_pipeline_impl::specialization() const {
+    return m_specialization;
+  }
+
+}
@@ -0,0 +1,212 @@
+/**
+ * @file deletion_queue.cpp
+ * @brief Timeline-Deferred Resource Destruction
+ * @author Alexander Rothman <[gnomesort@megate.ch](mailto:gnomesort@megate.ch)>
+ * @copyright AGPL-3.0-or-later
+ * @date 2025
+ */
+#include "megatech/vulkan/internal/base/deletion_queue.hpp"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include <megatech/assertions.hpp>
+
+#include "megatech/vulkan/error.hpp"
+
+#include "megatech/vulkan/internal/base/device_impl.hpp"
+
+#define DECLARE_DEVICE_PFN_NO_THROW(dt, cmd) MEGATECH_VULKAN_INTERNAL_BASE_DECLARE_DEVICE_PFN_NO_THROW(dt, cmd)
+
+namespace megatech::vulkan::internal::base {
+
+  deletion_queue::deletion_queue(const parent_type& parent) : m_parent{ &parent } { }
+
+  deletion_queue::~deletion_queue() noexcept {
+    flush();
+  }
+
+  const deletion_queue::parent_type& deletion_queue::parent() const {
+    MEGATECH_PRECONDITION(m_parent != nullptr);
+    return *m_parent;
+  }
+
+  void deletion_queue::wait_for(const std::uint64_t timeline_value) const noexcept {
+    try
+    {
+      m_parent->wait_for_timeline_value(timeline_value == current_value ? m_parent->current_timeline_value() :
+                                                                          timeline_value);
+    }
+    catch (...)
+    {
+      // The device is lost, so nothing can still be using the object.
+    }
+  }
+
+  void deletion_queue::enqueue(deleter_type deleter, const std::uint64_t timeline_value) {
+    MEGATECH_PRECONDITION(m_parent != nullptr);
+    if (!deleter)
+    {
+      throw error{ "The deleter cannot be empty." };
+    }
+    const auto key = timeline_value == current_value ? m_parent->current_timeline_value() : timeline_value;
+    auto lock = std::unique_lock<std::mutex>{ m_mutex };
+    // Keys almost always arrive in order, so searching from the back is effectively constant time.
+    auto position = m_entries.end();
+    while (position != m_entries.begin() && std::prev(position)->timeline_value > key)
+    {
+      --position;
+    }
+    m_entries.emplace(position, key, std::move(deleter));
+  }
+
+  void deletion_queue::destroy_buffer(buffer_allocation& buffer, const std::uint64_t timeline_value) noexcept {
+    if (buffer.buffer == VK_NULL_HANDLE && buffer.allocation.memory == VK_NULL_HANDLE)
+    {
+      return;
+    }
+    defer([parent = m_parent, buffer = buffer]() mutable { parent->destroy_buffer(buffer); }, timeline_value);
+    buffer = buffer_allocation{ };
+  }
+
+  void deletion_queue::destroy_buffer(const VkBuffer buffer, const std::uint64_t timeline_value) noexcept {
+    if (buffer == VK_NULL_HANDLE)
+    {
+      return;
+    }
+    defer([parent = m_parent, buffer]() {
+      DECLARE_DEVICE_PFN_NO_THROW(parent->dispatch_table(), vkDestroyBuffer);
+      vkDestroyBuffer(parent->handle(), buffer, nullptr);
+    }, timeline_value);
+  }
+
+  void deletion_queue::destroy_image(image_allocation& image, const std::uint64_t timeline_value) noexcept {
+    if (image.image == VK_NULL_HANDLE && image.allocation.memory == VK_NULL_HANDLE)
+    {
+      return;
+    }
+    defer([parent = m_parent, image = image]() mutable { parent->destroy_image(image); }, timeline_value);
+    image = image_allocation{ };
+  }
+
+  void deletion_queue::destroy_image(const VkImage image, const std::uint64_t timeline_value) noexcept {
+    if (image == VK_NULL_HANDLE)
+    {
+      return;
+    }
+    defer([parent = m_parent, image]() {
+      DECLARE_DEVICE_PFN_NO_THROW(parent->dispatch_table(), vkDestroyImage);
+      vkDestroyImage(parent->handle(), image, nullptr);
+    }, timeline_value);
+  }
+
+  void deletion_queue::free_memory(memory_allocation& allocation, const std::uint64_t timeline_value) noexcept {
+    if (allocation.memory == VK_NULL_HANDLE)
+    {
+      return;
+    }
+    defer([parent = m_parent, allocation = allocation]() mutable { parent->free_memory(allocation); },
+            timeline_value);
+    allocation = memory_allocation{ };
+  }
+
+  void deletion_queue::destroy_image_view(const VkImageView view, const std::uint64_t timeline_value) noexcept {
+    if (view == VK_NULL_HANDLE)
+    {
+      return;
+    }
+    defer([parent = m_parent, view]() {
+      DECLARE_DEVICE_PFN_NO_THROW(parent->dispatch_table(), vkDestroyImageView);
+      vkDestroyImageView(parent->handle(), view, nullptr);
+    }, timeline_value);
+  }
+
+  void deletion_queue::destroy_pipeline(const VkPipeline pipeline, const std::uint64_t timeline_value) noexcept {
+    if (pipeline == VK_NULL_HANDLE)
+    {
+      return;
+    }
+    defer([parent = m_parent, pipeline]() {
+      DECLARE_DEVICE_PFN_NO_THROW(parent->dispatch_table(), vkDestroyPipeline);
+      vkDestroyPipeline(parent->handle(), pipeline, nullptr);
+    }, timeline_value);
+  }
+
+  void deletion_queue::destroy_pipeline_layout(const VkPipelineLayout layout,
+                                               const std::uint64_t timeline_value) noexcept {
+    if (layout == VK_NULL_HANDLE)
+    {
+      return;
+    }
+    defer([parent = m_parent, layout]() {
+      DECLARE_DEVICE_PFN_NO_THROW(parent->dispatch_table(), vkDestroyPipelineLayout);
+      vkDestroyPipelineLayout(parent->handle(), layout, nullptr);
+    }, timeline_value);
+  }
+
+  void deletion_queue::destroy_descriptor_pool(const VkDescriptorPool pool,
+                                               const std::uint64_t timeline_value) noexcept {
+    if (pool == VK_NULL_HANDLE)
+    {
+      return;
+    }
+    defer([parent = m_parent, pool]() {
+      DECLARE_DEVICE_PFN_NO_THROW(parent->dispatch_table(), vkDestroyDescriptorPool);
+      vkDestroyDescriptorPool(parent->handle(), pool, nullptr);
+    }, timeline_value);
+  }
+
+  void deletion_queue::destroy_command_pool(const VkCommandPool pool, const std::uint64_t timeline_value) noexcept {
+    if (pool == VK_NULL_HANDLE)
+    {
+      return;
+    }
+    defer([parent = m_parent, pool]() {
+      DECLARE_DEVICE_PFN_NO_THROW(parent->dispatch_table(), vkDestroyCommandPool);
+      vkDestroyCommandPool(parent->handle(), pool, nullptr);
+    }, timeline_value);
+  }
+
+  std::size_t deletion_queue::collect() {
+    MEGATECH_PRECONDITION(m_parent != nullptr);
+    auto ready = std::vector<deleter_type>{ };
+    {
+      auto lock = std::unique_lock<std::mutex>{ m_mutex };
+      if (m_entries.empty())
+      {
+        return 0;
+      }
+      const auto completed = m_parent->completed_timeline_value();
+      while (!m_entries.empty() && m_entries.front().timeline_value <= completed)
+      {
+        ready.emplace_back(std::move(m_entries.front().deleter));
+        m_entries.pop_front();
+      }
+    }
+    for (const auto& deleter : ready)
+    {
+      deleter();
+    }
+    return ready.size();
+  }
+
+  std::size_t deletion_queue::flush() noexcept {
+    auto ready = std::deque<entry>{ };
+    {
+      auto lock = std::unique_lock<std::mutex>{ m_mutex };
+      std::swap(ready, m_entries);
+    }
+    for (const auto& current : ready)
+    {
+      current.deleter();
+    }
+    return ready.size();
+  }
+
+  std::size_t deletion_queue::size() const {
+    auto lock = std::unique_lock<std::mutex>{ m_mutex };
+    return m_entries.size();
+  }
+
+}
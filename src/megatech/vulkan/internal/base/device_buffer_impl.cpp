@@ -0,0 +1,77 @@
+/**
+ * @file device_buffer_impl.cpp
+ * @brief Device Buffer Implementation
+ * @author Alexander Rothman <[gnomesort@megate.ch](mailto:gnomesort@megate.ch)>
+ * @copyright AGPL-3.0-or-later
+ * @date 2025
+ */
+#include "megatech/vulkan/internal/base/device_buffer_impl.hpp"
+
+#include <megatech/assertions.hpp>
+
+#include "megatech/vulkan/error.hpp"
+
+#define DECLARE_DEVICE_PFN(dt, cmd) MEGATECH_VULKAN_INTERNAL_BASE_DECLARE_DEVICE_PFN(dt, cmd)
+
+namespace megatech::vulkan::internal::base {
+
+  device_buffer_impl::device_buffer_impl(const std::shared_ptr<const parent_type>& parent, const VkDeviceSize size,
+                                         const bool host_visible) :
+  m_parent{ parent } {
+    if (!m_parent)
+    {
+      throw error{ "The parent device cannot be null." };
+    }
+    if (!size)
+    {
+      throw error{ "The size of a device buffer must be greater than 0." };
+    }
+    constexpr auto usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT |
+                           VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    if (host_visible)
+    {
+      m_buffer = m_parent->create_buffer(size, usage, memory_usage::readback);
+    }
+    else
+    {
+      m_buffer = m_parent->create_buffer(size, usage, memory_usage::gpu_only);
+    }
+    auto address_info = VkBufferDeviceAddressInfo{ };
+    address_info.sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO;
+    address_info.buffer = m_buffer.buffer;
+    try
+    {
+      DECLARE_DEVICE_PFN(m_parent->dispatch_table(), vkGetBufferDeviceAddress);
+      m_device_address = vkGetBufferDeviceAddress(m_parent->handle(), &address_info);
+    }
+    catch (...)
+    {
+      m_parent->destroy_buffer(m_buffer);
+      throw;
+    }
+    MEGATECH_POSTCONDITION(m_buffer.buffer != VK_NULL_HANDLE);
+    MEGATECH_POSTCONDITION(!host_visible || m_buffer.allocation.mapped != nullptr);
+  }
+
+  device_buffer_impl::~device_buffer_impl() noexcept {
+    m_parent->deletions().destroy_buffer(m_buffer);
+  }
+
+  device_buffer_impl::handle_type device_buffer_impl::handle() const {
+    return m_buffer.buffer;
+  }
+
+  const device_buffer_impl::parent_type& device_buffer_impl::parent() const {
+    MEGATECH_PRECONDITION(m_parent != nullptr);
+    return *m_parent;
+  }
+
+  const buffer_allocation& device_buffer_impl::allocation() const {
+    return m_buffer;
+  }
+
+  VkDeviceAddress device_buffer_impl::device_address() const {
+    return m_device_address;
+  }
+
+}
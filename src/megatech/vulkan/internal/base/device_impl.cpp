@@ -7,6 +7,8 @@
  */
 #include "megatech/vulkan/internal/base/device_impl.hpp"
 
+#include <algorithm>
+#include <limits>
 #include <vector>
 
 #include <megatech/assertions.hpp>
@@ -16,69 +18,335 @@
 #include "megatech/vulkan/internal/base/loader_impl.hpp"
 #include "megatech/vulkan/internal/base/instance_impl.hpp"
 #include "megatech/vulkan/internal/base/physical_device_description_impl.hpp"
+#include "megatech/vulkan/internal/base/compute_pipeline_cache.hpp"
 
 #define DECLARE_INSTANCE_PFN(dt, cmd) MEGATECH_VULKAN_INTERNAL_BASE_DECLARE_INSTANCE_PFN(dt, cmd)
+#define DECLARE_INSTANCE_PFN_NO_THROW(dt, cmd) MEGATECH_VULKAN_INTERNAL_BASE_DECLARE_INSTANCE_PFN_NO_THROW(dt, cmd)
 #define DECLARE_DEVICE_PFN(dt, cmd) MEGATECH_VULKAN_INTERNAL_BASE_DECLARE_DEVICE_PFN(dt, cmd)
 #define DECLARE_DEVICE_PFN_NO_THROW(dt, cmd) MEGATECH_VULKAN_INTERNAL_BASE_DECLARE_DEVICE_PFN_NO_THROW(dt, cmd)
 #define VK_CHECK(exp) MEGATECH_VULKAN_INTERNAL_BASE_VK_CHECK(exp)
 
 namespace megatech::vulkan::internal::base {
 
+  void device_impl::query_memory_budget() const {
+    MEGATECH_PRECONDITION(m_parent != nullptr);
+    const auto& memory_properties = m_parent->memory_properties();
+    m_memory_budget = VkPhysicalDeviceMemoryBudgetPropertiesEXT{ };
+    m_memory_budget.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT;
+    if (has_memory_budget())
+    {
+      auto memory_properties2 = VkPhysicalDeviceMemoryProperties2{ };
+      memory_properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2;
+      memory_properties2.pNext = &m_memory_budget;
+      DECLARE_INSTANCE_PFN(m_parent->parent().dispatch_table(), vkGetPhysicalDeviceMemoryProperties2);
+      vkGetPhysicalDeviceMemoryProperties2(m_parent->handle(), &memory_properties2);
+      m_memory_budget.pNext = nullptr;
+    }
+    else
+    {
+      // Without VK_EXT_memory_budget there is no way to know what other processes are doing with the heap. 80% of the
+      // heap is a common rule of thumb for the portion that a single process can safely occupy.
+      for (auto i = std::uint32_t{ 0 }; i < memory_properties.memoryHeapCount; ++i)
+      {
+        m_memory_budget.heapBudget[i] = (memory_properties.memoryHeaps[i].size / 5) * 4;
+        m_memory_budget.heapUsage[i] = m_allocated_bytes[i].load();
+      }
+    }
+    m_memory_budget_timestamp = std::chrono::steady_clock::now();
+    MEGATECH_POSTCONDITION(m_memory_budget.pNext == nullptr);
+  }
+
+  device_impl::queue_state& device_impl::state(const queue_type type) const {
+    return m_queues[m_queue_slots[static_cast<std::size_t>(type)]];
+  }
+
+  VkResult device_impl::try_allocate_memory(const VkMemoryAllocateInfo& allocate_info, VkDeviceMemory& memory) const {
+    DECLARE_DEVICE_PFN(*m_ddt, vkAllocateMemory);
+    return vkAllocateMemory(m_ddt->device(), &allocate_info, nullptr, &memory);
+  }
+
   device_impl::device_impl(const std::shared_ptr<const parent_type>& parent) :
-  m_parent{ parent } {
-    if (!parent)
+  device_impl{ std::vector<std::shared_ptr<const parent_type>>{ parent } } { }
+
+  device_impl::device_impl(const std::vector<std::shared_ptr<const parent_type>>& group) :
+  m_parent{ group.empty() ? nullptr : group.front() },
+  m_physical_devices{ group } {
+    if (!m_parent)
     {
       throw error{ "The parent physical_device_description cannot be null." };
     }
+    if (m_physical_devices.size() > 32)
+    {
+      throw error{ "A device cannot drive more than 32 physical devices." };
+    }
+    auto physical_device_handles = std::vector<VkPhysicalDevice>{ };
+    for (const auto& physical_device : m_physical_devices)
+    {
+      if (!physical_device)
+      {
+        throw error{ "The physical_device_descriptions in a group cannot be null." };
+      }
+      if (&physical_device->parent() != &m_parent->parent())
+      {
+        throw error{ "The physical_device_descriptions in a group must belong to the same instance." };
+      }
+      physical_device_handles.emplace_back(physical_device->handle());
+    }
     auto device_info = VkDeviceCreateInfo{ };
     device_info.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+    m_enabled_extensions = m_parent->required_extensions();
+    if (m_parent->available_extensions().contains("VK_EXT_memory_budget"))
+    {
+      m_enabled_extensions.insert("VK_EXT_memory_budget");
+    }
+    // Sync file export only needs device extensions and handle type support, so it's enabled wherever it's available.
+    const auto& idt = m_parent->parent().dispatch_table();
+    if (m_parent->available_extensions().contains("VK_KHR_external_fence_fd"))
+    {
+      auto external_info = VkPhysicalDeviceExternalFenceInfo{ };
+      external_info.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTERNAL_FENCE_INFO;
+      external_info.handleType = VK_EXTERNAL_FENCE_HANDLE_TYPE_SYNC_FD_BIT;
+      auto external_properties = VkExternalFenceProperties{ };
+      external_properties.sType = VK_STRUCTURE_TYPE_EXTERNAL_FENCE_PROPERTIES;
+      DECLARE_INSTANCE_PFN(idt, vkGetPhysicalDeviceExternalFenceProperties);
+      vkGetPhysicalDeviceExternalFenceProperties(m_parent->handle(), &external_info, &external_properties);
+      m_fence_sync_fd = external_properties.externalFenceFeatures & VK_EXTERNAL_FENCE_FEATURE_EXPORTABLE_BIT;
+      if (m_fence_sync_fd)
+      {
+        m_enabled_extensions.insert("VK_KHR_external_fence_fd");
+      }
+    }
+    if (m_parent->available_extensions().contains("VK_KHR_external_semaphore_fd"))
+    {
+      auto external_info = VkPhysicalDeviceExternalSemaphoreInfo{ };
+      external_info.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTERNAL_SEMAPHORE_INFO;
+      external_info.handleType = VK_EXTERNAL_SEMAPHORE_HANDLE_TYPE_SYNC_FD_BIT;
+      auto external_properties = VkExternalSemaphoreProperties{ };
+      external_properties.sType = VK_STRUCTURE_TYPE_EXTERNAL_SEMAPHORE_PROPERTIES;
+      DECLARE_INSTANCE_PFN(idt, vkGetPhysicalDeviceExternalSemaphoreProperties);
+      vkGetPhysicalDeviceExternalSemaphoreProperties(m_parent->handle(), &external_info, &external_properties);
+      m_semaphore_sync_fd = external_properties.externalSemaphoreFeatures &
+                            VK_EXTERNAL_SEMAPHORE_FEATURE_EXPORTABLE_BIT;
+      if (m_semaphore_sync_fd)
+      {
+        m_enabled_extensions.insert("VK_KHR_external_semaphore_fd");
+      }
+    }
+    device_info.pNext = &m_parent->required_features();
+    // Optional extensions are enabled, along with their features, wherever the physical device supports them. They
+    // follow the extensions that they depend on. Extensions that the physical device description already requires are
+    // skipped, since their features belong to its own chain. vkCreateDevice doesn't write to the chain, so linking it
+    // to the required features is safe.
+    const auto link = [](auto& features, auto& head) {
+      features.pNext = const_cast<void*>(head.pNext);
+      head.pNext = &features;
+    };
+    const auto is_candidate = [&](const char *const extension) {
+      return m_parent->available_extensions().contains(extension) &&
+             !m_parent->required_extensions().contains(extension);
+    };
+    auto memory_priority = VkPhysicalDeviceMemoryPriorityFeaturesEXT{ };
+    memory_priority.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PRIORITY_FEATURES_EXT;
+    auto pageable_memory = VkPhysicalDevicePageableDeviceLocalMemoryFeaturesEXT{ };
+    pageable_memory.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PAGEABLE_DEVICE_LOCAL_MEMORY_FEATURES_EXT;
+    auto maintenance5 = VkPhysicalDeviceMaintenance5FeaturesKHR{ };
+    maintenance5.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MAINTENANCE_5_FEATURES_KHR;
+    auto maintenance6 = VkPhysicalDeviceMaintenance6FeaturesKHR{ };
+    maintenance6.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MAINTENANCE_6_FEATURES_KHR;
+    auto descriptor_buffer = VkPhysicalDeviceDescriptorBufferFeaturesEXT{ };
+    descriptor_buffer.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_FEATURES_EXT;
+    auto pipeline_binary = VkPhysicalDevicePipelineBinaryFeaturesKHR{ };
+    pipeline_binary.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PIPELINE_BINARY_FEATURES_KHR;
+    {
+      auto query = VkPhysicalDeviceFeatures2{ };
+      query.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+      if (is_candidate("VK_EXT_memory_priority"))
+      {
+        link(memory_priority, query);
+      }
+      if (is_candidate("VK_EXT_pageable_device_local_memory"))
+      {
+        link(pageable_memory, query);
+      }
+      if (is_candidate("VK_KHR_maintenance5"))
+      {
+        link(maintenance5, query);
+      }
+      if (is_candidate("VK_KHR_maintenance6"))
+      {
+        link(maintenance6, query);
+      }
+      if (is_candidate("VK_EXT_descriptor_buffer"))
+      {
+        link(descriptor_buffer, query);
+      }
+      if (is_candidate("VK_KHR_pipeline_binary"))
+      {
+        link(pipeline_binary, query);
+      }
+      DECLARE_INSTANCE_PFN(idt, vkGetPhysicalDeviceFeatures2);
+      vkGetPhysicalDeviceFeatures2(m_parent->handle(), &query);
+    }
+    const auto enable = [&](const optional_extension extension, const char *const name, const bool is_supported,
+                            auto& features) {
+      if (is_supported)
+      {
+        m_enabled_extensions.insert(name);
+        m_optional_extensions |= 1u << static_cast<std::uint32_t>(extension);
+        link(features, device_info);
+      }
+    };
+    enable(optional_extension::memory_priority, "VK_EXT_memory_priority", memory_priority.memoryPriority,
+           memory_priority);
+    enable(optional_extension::pageable_device_local_memory, "VK_EXT_pageable_device_local_memory",
+           pageable_memory.pageableDeviceLocalMemory && m_enabled_extensions.contains("VK_EXT_memory_priority"),
+           pageable_memory);
+    enable(optional_extension::maintenance5, "VK_KHR_maintenance5", maintenance5.maintenance5, maintenance5);
+    enable(optional_extension::maintenance6, "VK_KHR_maintenance6", maintenance6.maintenance6, maintenance6);
+    // Capture and replay support costs performance on some drivers, so only the core feature is enabled.
+    descriptor_buffer.descriptorBufferCaptureReplay = VK_FALSE;
+    enable(optional_extension::descriptor_buffer, "VK_EXT_descriptor_buffer", descriptor_buffer.descriptorBuffer,
+           descriptor_buffer);
+    enable(optional_extension::pipeline_binary, "VK_KHR_pipeline_binary",
+           pipeline_binary.pipelineBinaries && m_enabled_extensions.contains("VK_KHR_maintenance5"), pipeline_binary);
     auto enabled_extensions = std::vector<const char*>{ };
-    for (const auto& extension : m_parent->required_extensions())
+    for (const auto& extension : m_enabled_extensions)
     {
       enabled_extensions.emplace_back(extension.data());
     }
     device_info.enabledExtensionCount = enabled_extensions.size();
     device_info.ppEnabledExtensionNames = enabled_extensions.data();
-    device_info.pNext = &m_parent->required_features();
+    auto group_info = VkDeviceGroupDeviceCreateInfo{ };
+    group_info.sType = VK_STRUCTURE_TYPE_DEVICE_GROUP_DEVICE_CREATE_INFO;
+    group_info.physicalDeviceCount = physical_device_handles.size();
+    group_info.pPhysicalDevices = physical_device_handles.data();
+    if (physical_device_handles.size() > 1)
+    {
+      group_info.pNext = device_info.pNext;
+      device_info.pNext = &group_info;
+    }
+    // Queues that don't exist (or that share a family with an earlier queue) alias the earlier queue.
+    const auto families = std::array<std::int64_t, 4>{ m_parent->primary_queue_family_index(),
+                                                       m_parent->async_compute_queue_family_index(),
+                                                       m_parent->async_transfer_queue_family_index(),
+                                                       m_parent->sparse_binding_queue_family_index() };
+    for (auto i = std::size_t{ 0 }; i < families.size(); ++i)
+    {
+      m_queue_slots[i] = i;
+      for (auto j = std::size_t{ 0 }; j < i && m_queue_slots[i] == i; ++j)
+      {
+        if (families[i] == -1 || families[i] == families[j])
+        {
+          m_queue_slots[i] = j;
+        }
+      }
+    }
+    m_sparse_binding = m_parent->required_features().features.sparseBinding &&
+                       families[static_cast<std::size_t>(queue_type::sparse_binding)] != -1;
     const auto priority = 1.0f;
-    auto queue_infos = std::vector<VkDeviceQueueCreateInfo>(3);
-    for (auto& queue_info : queue_infos)
-    {
-      queue_info.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
-      queue_info.pQueuePriorities = &priority;
-      queue_info.queueCount = 1;
-    }
-    queue_infos[0].queueFamilyIndex = m_parent->primary_queue_family_index();
-    queue_infos[1].queueFamilyIndex = m_parent->async_compute_queue_family_index();
-    queue_infos[2].queueFamilyIndex = m_parent->async_transfer_queue_family_index();
-    device_info.queueCreateInfoCount = 1 + (m_parent->async_compute_queue_family_index() != -1) +
-                                       (m_parent->async_transfer_queue_family_index() != -1);
+    auto queue_infos = std::vector<VkDeviceQueueCreateInfo>{ };
+    for (auto i = std::size_t{ 0 }; i < families.size(); ++i)
+    {
+      if (m_queue_slots[i] == i)
+      {
+        auto& queue_info = queue_infos.emplace_back();
+        queue_info.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+        queue_info.queueFamilyIndex = families[i];
+        queue_info.queueCount = 1;
+        queue_info.pQueuePriorities = &priority;
+      }
+    }
+    device_info.queueCreateInfoCount = queue_infos.size();
     device_info.pQueueCreateInfos = queue_infos.data();
     DECLARE_INSTANCE_PFN(m_parent->parent().dispatch_table(), vkCreateDevice);
     auto device = VkDevice{ };
     VK_CHECK(vkCreateDevice(m_parent->handle(), &device_info, nullptr,&device));
-    m_ddt.reset(new dispatch::device::table{ m_parent->parent().parent().dispatch_table(),
-                                             m_parent->parent().dispatch_table(), device });
-    DECLARE_DEVICE_PFN(*m_ddt, vkGetDeviceQueue);
-    vkGetDeviceQueue(m_ddt->device(), m_parent->primary_queue_family_index(), 0, &m_primary_queue);
-    if (m_parent->async_compute_queue_family_index() != -1)
+    try
+    {
+      m_ddt.reset(new dispatch::device::table{ m_parent->parent().parent().dispatch_table(),
+                                               m_parent->parent().dispatch_table(), device });
+    }
+    catch (...)
     {
-      vkGetDeviceQueue(m_ddt->device(), m_parent->async_compute_queue_family_index(), 0, &m_async_compute_queue);
+      // Without a dispatch table, vkDestroyDevice has to be resolved by hand.
+      DECLARE_INSTANCE_PFN_NO_THROW(m_parent->parent().dispatch_table(), vkGetDeviceProcAddr);
+      auto destroy_device = PFN_vkDestroyDevice{ };
+      if (vkGetDeviceProcAddr)
+      {
+        destroy_device = reinterpret_cast<PFN_vkDestroyDevice>(vkGetDeviceProcAddr(device, "vkDestroyDevice"));
+      }
+      if (destroy_device)
+      {
+        destroy_device(device, nullptr);
+      }
+      throw;
     }
-    if (m_parent->async_transfer_queue_family_index() != -1)
+    // Destructors don't run when constructors throw, so everything created from here on is released by hand.
+    try
     {
-      vkGetDeviceQueue(m_ddt->device(), m_parent->async_transfer_queue_family_index(), 0, &m_async_transfer_queue);
+      DECLARE_DEVICE_PFN(*m_ddt, vkGetDeviceQueue);
+      DECLARE_DEVICE_PFN(*m_ddt, vkCreateSemaphore);
+      auto timeline_info = VkSemaphoreTypeCreateInfo{ };
+      timeline_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+      timeline_info.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+      auto semaphore_info = VkSemaphoreCreateInfo{ };
+      semaphore_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+      semaphore_info.pNext = &timeline_info;
+      for (auto i = std::size_t{ 0 }; i < families.size(); ++i)
+      {
+        if (m_queue_slots[i] == i)
+        {
+          m_queues[i].family_index = families[i];
+          vkGetDeviceQueue(m_ddt->device(), m_queues[i].family_index, 0, &m_queues[i].queue);
+          VK_CHECK(vkCreateSemaphore(m_ddt->device(), &semaphore_info, nullptr, &m_queues[i].timeline));
+        }
+      }
+      query_memory_budget();
+      m_residency.reset(new residency_manager{ *this });
+      m_deletions.reset(new deletion_queue{ *this });
+      m_fences.reset(new fence_pool{ *this });
+      m_semaphores.reset(new semaphore_pool{ *this });
+      m_events.reset(new event_pool{ *this });
+      m_pipelines.reset(new compute_pipeline_cache{ *this });
+    }
+    catch (...)
+    {
+      destroy();
+      throw;
     }
     MEGATECH_POSTCONDITION(m_parent != nullptr);
-    MEGATECH_POSTCONDITION(m_parent == parent);
+    MEGATECH_POSTCONDITION(m_parent == group.front());
     MEGATECH_POSTCONDITION(m_ddt != nullptr);
     MEGATECH_POSTCONDITION(m_ddt->device() == device);
-    MEGATECH_POSTCONDITION(m_primary_queue != VK_NULL_HANDLE);
+    MEGATECH_POSTCONDITION(m_queues[0].queue != VK_NULL_HANDLE);
+    MEGATECH_POSTCONDITION(m_queues[0].timeline != VK_NULL_HANDLE);
+    MEGATECH_POSTCONDITION(m_residency != nullptr);
+    MEGATECH_POSTCONDITION(m_deletions != nullptr);
+    MEGATECH_POSTCONDITION(m_fences != nullptr);
+    MEGATECH_POSTCONDITION(m_semaphores != nullptr);
+    MEGATECH_POSTCONDITION(m_events != nullptr);
+    MEGATECH_POSTCONDITION(m_pipelines != nullptr);
   }
 
   device_impl::~device_impl() noexcept {
+    destroy();
+  }
+
+  void device_impl::destroy() noexcept {
     DECLARE_DEVICE_PFN_NO_THROW(*m_ddt, vkDeviceWaitIdle);
     vkDeviceWaitIdle(m_ddt->device());
+    m_pipelines.reset();
+    // Deferred destructions may release pooled objects, so the pools are destroyed after the deletion_queue.
+    m_deletions.reset();
+    m_events.reset();
+    m_semaphores.reset();
+    m_fences.reset();
+    m_residency.reset();
+    DECLARE_DEVICE_PFN_NO_THROW(*m_ddt, vkDestroySemaphore);
+    for (auto& queue : m_queues)
+    {
+      vkDestroySemaphore(m_ddt->device(), queue.timeline, nullptr);
+    }
     DECLARE_DEVICE_PFN_NO_THROW(*m_ddt, vkDestroyDevice);
     vkDestroyDevice(m_ddt->device(), nullptr);
   }
@@ -98,9 +366,564 @@ namespace megatech::vulkan::internal::base {
     return *m_parent;
   }
 
+  std::uint32_t device_impl::physical_device_count() const {
+    return m_physical_devices.size();
+  }
+
+  std::uint32_t device_impl::device_mask() const {
+    return static_cast<std::uint32_t>((std::uint64_t{ 1 } << m_physical_devices.size()) - 1);
+  }
+
   const std::unordered_set<std::string>& device_impl::enabled_extensions() const {
-    MEGATECH_PRECONDITION(m_parent != nullptr);
-    return m_parent->required_extensions();
+    return m_enabled_extensions;
+  }
+
+  const format_feature_flags& device_impl::format_features(const VkFormat format) const {
+    return m_parent->format_features(format, m_enabled_extensions);
+  }
+
+  bool device_impl::has_format_features(const VkFormat format, const VkImageTiling tiling,
+                                        const VkFormatFeatureFlags2 features) const {
+    MEGATECH_PRECONDITION(tiling == VK_IMAGE_TILING_LINEAR || tiling == VK_IMAGE_TILING_OPTIMAL);
+    const auto& supported = format_features(format);
+    const auto flags = tiling == VK_IMAGE_TILING_LINEAR ? supported.linear_tiling : supported.optimal_tiling;
+    return (flags & features) == features;
+  }
+
+  bool device_impl::has_buffer_format_features(const VkFormat format, const VkFormatFeatureFlags2 features) const {
+    return (format_features(format).buffer & features) == features;
+  }
+
+  bool device_impl::has_memory_budget() const {
+    return m_enabled_extensions.contains("VK_EXT_memory_budget");
+  }
+
+  bool device_impl::has_optional_extension(const optional_extension extension) const {
+    return m_optional_extensions & (1u << static_cast<std::uint32_t>(extension));
+  }
+
+  bool device_impl::can_export_fence_sync_fd() const {
+    return m_fence_sync_fd;
+  }
+
+  bool device_impl::can_export_semaphore_sync_fd() const {
+    return m_semaphore_sync_fd;
+  }
+
+  int device_impl::export_sync_fd(const VkFence fence) const {
+    if (!m_fence_sync_fd)
+    {
+      throw error{ "The device can't export fences as sync files." };
+    }
+    auto fd_info = VkFenceGetFdInfoKHR{ };
+    fd_info.sType = VK_STRUCTURE_TYPE_FENCE_GET_FD_INFO_KHR;
+    fd_info.fence = fence;
+    fd_info.handleType = VK_EXTERNAL_FENCE_HANDLE_TYPE_SYNC_FD_BIT;
+    auto result = int{ -1 };
+    DECLARE_DEVICE_PFN(*m_ddt, vkGetFenceFdKHR);
+    VK_CHECK(vkGetFenceFdKHR(m_ddt->device(), &fd_info, &result));
+    return result;
+  }
+
+  int device_impl::export_sync_fd(const VkSemaphore semaphore) const {
+    if (!m_semaphore_sync_fd)
+    {
+      throw error{ "The device can't export semaphores as sync files." };
+    }
+    auto fd_info = VkSemaphoreGetFdInfoKHR{ };
+    fd_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_GET_FD_INFO_KHR;
+    fd_info.semaphore = semaphore;
+    fd_info.handleType = VK_EXTERNAL_SEMAPHORE_HANDLE_TYPE_SYNC_FD_BIT;
+    auto result = int{ -1 };
+    DECLARE_DEVICE_PFN(*m_ddt, vkGetSemaphoreFdKHR);
+    VK_CHECK(vkGetSemaphoreFdKHR(m_ddt->device(), &fd_info, &result));
+    return result;
+  }
+
+  int device_impl::export_sync_fd(const std::uint64_t value) const {
+    if (!m_fence_sync_fd)
+    {
+      throw error{ "The device can't export fences as sync files." };
+    }
+    if (value <= completed_timeline_value())
+    {
+      return -1;
+    }
+    auto waits = std::vector<VkSemaphoreSubmitInfo>{ };
+    for (const auto& target : timeline_targets(value))
+    {
+      auto& wait = waits.emplace_back();
+      wait.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
+      wait.semaphore = target.first;
+      wait.value = target.second;
+      wait.stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+    }
+    const auto fence = m_fences->acquire();
+    auto submitted = std::uint64_t{ };
+    try
+    {
+      submitted = submit(queue_type::primary, { }, waits, { }, fence);
+      const auto result = export_sync_fd(fence);
+      m_fences->release(fence, submitted);
+      return result;
+    }
+    catch (...)
+    {
+      // A fence that was submitted can't be reused until its submission completes.
+      m_fences->release(fence, submitted);
+      throw;
+    }
+  }
+
+  VkPhysicalDeviceMemoryBudgetPropertiesEXT device_impl::memory_budget() const {
+    auto lock = std::unique_lock<std::mutex>{ m_memory_budget_mutex };
+    if (std::chrono::steady_clock::now() - m_memory_budget_timestamp >= m_memory_budget_refresh_interval)
+    {
+      query_memory_budget();
+    }
+    return m_memory_budget;
+  }
+
+  VkPhysicalDeviceMemoryBudgetPropertiesEXT device_impl::refresh_memory_budget() const {
+    auto lock = std::unique_lock<std::mutex>{ m_memory_budget_mutex };
+    query_memory_budget();
+    return m_memory_budget;
+  }
+
+  void device_impl::set_memory_budget_refresh_interval(const std::chrono::nanoseconds interval) {
+    if (interval.count() < 0)
+    {
+      throw error{ "The memory budget refresh interval cannot be negative." };
+    }
+    auto lock = std::unique_lock<std::mutex>{ m_memory_budget_mutex };
+    m_memory_budget_refresh_interval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(interval);
+  }
+
+  VkQueue device_impl::queue(const queue_type type) const {
+    return state(type).queue;
+  }
+
+  std::uint32_t device_impl::queue_family_index(const queue_type type) const {
+    return state(type).family_index;
+  }
+
+  VkSemaphore device_impl::timeline_semaphore(const queue_type type) const {
+    return state(type).timeline;
+  }
+
+  std::uint64_t device_impl::submit(const queue_type type,
+                                    const std::span<const VkCommandBufferSubmitInfo> command_buffers,
+                                    const std::span<const VkSemaphoreSubmitInfo> waits,
+                                    const std::span<const VkSemaphoreSubmitInfo> signals, const VkFence fence) const {
+    const auto mask = device_mask();
+    for (const auto& command_buffer : command_buffers)
+    {
+      if (command_buffer.deviceMask & ~mask)
+      {
+        throw error{ "A command buffer's device mask selects a physical device that the device doesn't drive." };
+      }
+    }
+    for (const auto& infos : std::array{ waits, signals })
+    {
+      if (std::ranges::any_of(infos, [&](const auto& info){ return info.deviceIndex >= physical_device_count(); }))
+      {
+        throw error{ "A semaphore's device index selects a physical device that the device doesn't drive." };
+      }
+    }
+    auto& queue = state(type);
+    auto signal_infos = std::vector<VkSemaphoreSubmitInfo>(signals.begin(), signals.end());
+    auto& timeline_signal = signal_infos.emplace_back();
+    timeline_signal.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
+    timeline_signal.semaphore = queue.timeline;
+    timeline_signal.stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+    auto submit_info = VkSubmitInfo2{ };
+    submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2;
+    submit_info.waitSemaphoreInfoCount = waits.size();
+    submit_info.pWaitSemaphoreInfos = waits.data();
+    submit_info.commandBufferInfoCount = command_buffers.size();
+    submit_info.pCommandBufferInfos = command_buffers.data();
+    submit_info.signalSemaphoreInfoCount = signal_infos.size();
+    submit_info.pSignalSemaphoreInfos = signal_infos.data();
+    DECLARE_DEVICE_PFN(*m_ddt, vkQueueSubmit2);
+    // Values are assigned while the queue is locked so that each queue's timeline only ever increases and so that
+    // completed_timeline_value() never observes a value without its submission.
+    auto lock = std::unique_lock<std::mutex>{ queue.mutex };
+    timeline_signal.value = m_timeline_value.fetch_add(1) + 1;
+    VK_CHECK(vkQueueSubmit2(queue.queue, 1, &submit_info, fence));
+    queue.last_submitted = timeline_signal.value;
+    lock.unlock();
+    try
+    {
+      m_deletions->collect();
+    }
+    catch (...)
+    {
+      // The submission succeeded. Anything that couldn't be collected now is collected after a later submission.
+    }
+    return timeline_signal.value;
+  }
+
+  bool device_impl::has_sparse_binding() const {
+    return m_sparse_binding;
+  }
+
+  std::uint64_t device_impl::bind_sparse(const std::span<const VkSparseBufferMemoryBindInfo> buffers,
+                                         const std::span<const VkSparseImageOpaqueMemoryBindInfo> opaque_images,
+                                         const std::span<const VkSparseImageMemoryBindInfo> images,
+                                         const std::uint64_t wait_value) const {
+    if (!m_sparse_binding)
+    {
+      throw error{ "The device doesn't support sparse binding." };
+    }
+    // Sparse binding predates VkSubmitInfo2, so the timeline values are passed through VkTimelineSemaphoreSubmitInfo.
+    auto wait_semaphores = std::vector<VkSemaphore>{ };
+    auto wait_values = std::vector<std::uint64_t>{ };
+    if (wait_value)
+    {
+      for (const auto& target : timeline_targets(wait_value))
+      {
+        wait_semaphores.emplace_back(target.first);
+        wait_values.emplace_back(target.second);
+      }
+    }
+    auto& queue = state(queue_type::sparse_binding);
+    auto signal_value = std::uint64_t{ };
+    auto timeline_info = VkTimelineSemaphoreSubmitInfo{ };
+    timeline_info.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+    timeline_info.waitSemaphoreValueCount = wait_values.size();
+    timeline_info.pWaitSemaphoreValues = wait_values.data();
+    timeline_info.signalSemaphoreValueCount = 1;
+    timeline_info.pSignalSemaphoreValues = &signal_value;
+    auto bind_info = VkBindSparseInfo{ };
+    bind_info.sType = VK_STRUCTURE_TYPE_BIND_SPARSE_INFO;
+    bind_info.pNext = &timeline_info;
+    bind_info.waitSemaphoreCount = wait_semaphores.size();
+    bind_info.pWaitSemaphores = wait_semaphores.data();
+    bind_info.bufferBindCount = buffers.size();
+    bind_info.pBufferBinds = buffers.data();
+    bind_info.imageOpaqueBindCount = opaque_images.size();
+    bind_info.pImageOpaqueBinds = opaque_images.data();
+    bind_info.imageBindCount = images.size();
+    bind_info.pImageBinds = images.data();
+    bind_info.signalSemaphoreCount = 1;
+    bind_info.pSignalSemaphores = &queue.timeline;
+    DECLARE_DEVICE_PFN(*m_ddt, vkQueueBindSparse);
+    auto lock = std::unique_lock<std::mutex>{ queue.mutex };
+    signal_value = m_timeline_value.fetch_add(1) + 1;
+    VK_CHECK(vkQueueBindSparse(queue.queue, 1, &bind_info, VK_NULL_HANDLE));
+    queue.last_submitted = signal_value;
+    lock.unlock();
+    try
+    {
+      m_deletions->collect();
+    }
+    catch (...)
+    {
+      // The operation succeeded. Anything that couldn't be collected now is collected after a later submission.
+    }
+    return signal_value;
+  }
+
+  std::uint64_t device_impl::current_timeline_value() const {
+    return m_timeline_value.load();
+  }
+
+  std::uint64_t device_impl::completed_timeline_value() const {
+    auto result = m_timeline_value.load();
+    DECLARE_DEVICE_PFN(*m_ddt, vkGetSemaphoreCounterValue);
+    for (auto& queue : m_queues)
+    {
+      if (queue.timeline == VK_NULL_HANDLE)
+      {
+        continue;
+      }
+      auto lock = std::unique_lock<std::mutex>{ queue.mutex };
+      auto completed = std::uint64_t{ };
+      VK_CHECK(vkGetSemaphoreCounterValue(m_ddt->device(), queue.timeline, &completed));
+      if (completed < queue.last_submitted)
+      {
+        result = std::min(result, completed);
+      }
+    }
+    MEGATECH_POSTCONDITION(result <= current_timeline_value());
+    return result;
+  }
+
+  std::vector<std::pair<VkSemaphore, std::uint64_t>> device_impl::timeline_targets(const std::uint64_t value) const {
+    if (value > current_timeline_value())
+    {
+      throw error{ "The requested timeline value hasn't been submitted." };
+    }
+    auto result = std::vector<std::pair<VkSemaphore, std::uint64_t>>{ };
+    for (auto& queue : m_queues)
+    {
+      if (queue.timeline == VK_NULL_HANDLE)
+      {
+        continue;
+      }
+      auto lock = std::unique_lock<std::mutex>{ queue.mutex };
+      result.emplace_back(queue.timeline, std::min(value, queue.last_submitted));
+    }
+    return result;
+  }
+
+  bool device_impl::wait_for_timeline_value(const std::uint64_t value, const std::chrono::nanoseconds timeout) const {
+    auto semaphores = std::vector<VkSemaphore>{ };
+    auto values = std::vector<std::uint64_t>{ };
+    for (const auto& target : timeline_targets(value))
+    {
+      semaphores.emplace_back(target.first);
+      values.emplace_back(target.second);
+    }
+    auto wait_info = VkSemaphoreWaitInfo{ };
+    wait_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+    wait_info.semaphoreCount = semaphores.size();
+    wait_info.pSemaphores = semaphores.data();
+    wait_info.pValues = values.data();
+    auto ns = std::numeric_limits<std::uint64_t>::max();
+    if (timeout != std::chrono::nanoseconds::max())
+    {
+      ns = std::max(timeout.count(), std::chrono::nanoseconds::rep{ 0 });
+    }
+    DECLARE_DEVICE_PFN(*m_ddt, vkWaitSemaphores);
+    const auto result = vkWaitSemaphores(m_ddt->device(), &wait_info, ns);
+    if (result != VK_SUCCESS && result != VK_TIMEOUT)
+    {
+      throw error{ "Failed to wait for the device timeline.", result };
+    }
+    return result == VK_SUCCESS;
+  }
+
+  memory_allocation device_impl::allocate_selected_memory(const VkMemoryRequirements& requirements,
+                                                          const std::function<std::int64_t(std::uint32_t)>& select,
+                                                          const void* next) const {
+    MEGATECH_PRECONDITION(m_residency != nullptr);
+    const auto& memory_properties = m_parent->memory_properties();
+    auto type_bits = requirements.memoryTypeBits;
+    auto index = select(type_bits);
+    if (index == -1)
+    {
+      throw error{ "No memory type satisfies the allocation's requirements." };
+    }
+    auto allocate_info = VkMemoryAllocateInfo{ };
+    allocate_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocate_info.pNext = next;
+    allocate_info.allocationSize = requirements.size;
+    auto result = VK_ERROR_OUT_OF_DEVICE_MEMORY;
+    auto memory = VkDeviceMemory{ };
+    for (; index != -1; index = select(type_bits))
+    {
+      const auto heap_index = memory_properties.memoryTypes[index].heapIndex;
+      if (const auto excess = m_residency->overcommitment(heap_index, requirements.size); excess)
+      {
+        m_residency->make_room(heap_index, excess);
+      }
+      allocate_info.memoryTypeIndex = index;
+      result = try_allocate_memory(allocate_info, memory);
+      while (result == VK_ERROR_OUT_OF_DEVICE_MEMORY && m_residency->make_room(heap_index, requirements.size))
+      {
+        result = try_allocate_memory(allocate_info, memory);
+      }
+      if (result != VK_ERROR_OUT_OF_DEVICE_MEMORY)
+      {
+        break;
+      }
+      // The heap is exhausted even after eviction. Fall back to any other heap that satisfies the requirements (e.g.,
+      // host-visible memory when device-local memory was only preferred).
+      for (auto i = std::uint32_t{ 0 }; i < memory_properties.memoryTypeCount; ++i)
+      {
+        type_bits &= ~(std::uint32_t{ memory_properties.memoryTypes[i].heapIndex == heap_index } << i);
+      }
+    }
+    if (result != VK_SUCCESS)
+    {
+      throw error{ "Failed to allocate device memory.", result };
+    }
+    auto allocation = memory_allocation{ };
+    allocation.memory = memory;
+    allocation.size = requirements.size;
+    allocation.memory_type_index = index;
+    allocation.heap_index = memory_properties.memoryTypes[index].heapIndex;
+    allocation.flags = memory_properties.memoryTypes[index].propertyFlags;
+    allocation.mapped = nullptr;
+    m_allocated_bytes[allocation.heap_index] += allocation.size;
+    if (allocation.flags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+    {
+      DECLARE_DEVICE_PFN(*m_ddt, vkMapMemory);
+      if (const auto res = vkMapMemory(m_ddt->device(), memory, 0, VK_WHOLE_SIZE, 0, &allocation.mapped);
+          res != VK_SUCCESS)
+      {
+        free_memory(allocation);
+        throw error{ "Failed to map host-visible device memory.", res };
+      }
+    }
+    MEGATECH_POSTCONDITION(allocation.memory != VK_NULL_HANDLE);
+    return allocation;
+  }
+
+  memory_allocation device_impl::allocate_memory(const VkMemoryRequirements& requirements,
+                                                 const VkMemoryPropertyFlags required,
+                                                 const VkMemoryPropertyFlags preferred, const void* next) const {
+    return allocate_selected_memory(requirements, [&](const std::uint32_t type_bits) {
+      return m_parent->memory_type_index(type_bits, required, preferred);
+    }, next);
+  }
+
+  memory_allocation device_impl::allocate_memory(const VkMemoryRequirements& requirements, const memory_usage usage,
+                                                 const void* next) const {
+    return allocate_selected_memory(requirements, [&](const std::uint32_t type_bits) {
+      return m_parent->memory_type_index(type_bits, usage);
+    }, next);
+  }
+
+  void device_impl::free_memory(memory_allocation& allocation) const noexcept {
+    if (allocation.memory == VK_NULL_HANDLE)
+    {
+      return;
+    }
+    DECLARE_DEVICE_PFN_NO_THROW(*m_ddt, vkFreeMemory);
+    vkFreeMemory(m_ddt->device(), allocation.memory, nullptr);
+    m_allocated_bytes[allocation.heap_index] -= allocation.size;
+    allocation.memory = VK_NULL_HANDLE;
+    allocation.mapped = nullptr;
+  }
+
+  buffer_allocation device_impl::create_selected_buffer(const VkDeviceSize size, const VkBufferUsageFlags usage,
+                                                       const std::function<std::int64_t(std::uint32_t)>& select) const {
+    auto buffer_info = VkBufferCreateInfo{ };
+    buffer_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    buffer_info.size = size;
+    buffer_info.usage = usage;
+    buffer_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    auto result = buffer_allocation{ };
+    result.size = size;
+    DECLARE_DEVICE_PFN(*m_ddt, vkCreateBuffer);
+    VK_CHECK(vkCreateBuffer(m_ddt->device(), &buffer_info, nullptr, &result.buffer));
+    try
+    {
+      auto requirements = VkMemoryRequirements{ };
+      DECLARE_DEVICE_PFN(*m_ddt, vkGetBufferMemoryRequirements);
+      vkGetBufferMemoryRequirements(m_ddt->device(), result.buffer, &requirements);
+      // Buffers that can be addressed from shaders need memory allocated with the device address flag.
+      auto flags_info = VkMemoryAllocateFlagsInfo{ };
+      flags_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_FLAGS_INFO;
+      flags_info.flags = VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT;
+      const auto addressable = (usage & VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT) != 0;
+      result.allocation = allocate_selected_memory(requirements, select, addressable ? &flags_info : nullptr);
+      DECLARE_DEVICE_PFN(*m_ddt, vkBindBufferMemory);
+      VK_CHECK(vkBindBufferMemory(m_ddt->device(), result.buffer, result.allocation.memory, 0));
+    }
+    catch (...)
+    {
+      destroy_buffer(result);
+      throw;
+    }
+    MEGATECH_POSTCONDITION(result.buffer != VK_NULL_HANDLE);
+    return result;
+  }
+
+  buffer_allocation device_impl::create_buffer(const VkDeviceSize size, const VkBufferUsageFlags usage,
+                                              const VkMemoryPropertyFlags required,
+                                              const VkMemoryPropertyFlags preferred) const {
+    return create_selected_buffer(size, usage, [&](const std::uint32_t type_bits) {
+      return m_parent->memory_type_index(type_bits, required, preferred);
+    });
+  }
+
+  buffer_allocation device_impl::create_buffer(const VkDeviceSize size, const VkBufferUsageFlags usage,
+                                              const memory_usage memory) const {
+    return create_selected_buffer(size, usage, [&](const std::uint32_t type_bits) {
+      return m_parent->memory_type_index(type_bits, memory);
+    });
+  }
+
+  void device_impl::destroy_buffer(buffer_allocation& buffer) const noexcept {
+    DECLARE_DEVICE_PFN_NO_THROW(*m_ddt, vkDestroyBuffer);
+    vkDestroyBuffer(m_ddt->device(), buffer.buffer, nullptr);
+    buffer.buffer = VK_NULL_HANDLE;
+    free_memory(buffer.allocation);
+  }
+
+  image_allocation device_impl::create_selected_image(const VkImageCreateInfo& image_info,
+                                                     const std::function<std::int64_t(std::uint32_t)>& select) const {
+    auto result = image_allocation{ };
+    DECLARE_DEVICE_PFN(*m_ddt, vkCreateImage);
+    VK_CHECK(vkCreateImage(m_ddt->device(), &image_info, nullptr, &result.image));
+    try
+    {
+      auto requirements = VkMemoryRequirements{ };
+      DECLARE_DEVICE_PFN(*m_ddt, vkGetImageMemoryRequirements);
+      vkGetImageMemoryRequirements(m_ddt->device(), result.image, &requirements);
+      result.allocation = allocate_selected_memory(requirements, select, nullptr);
+      DECLARE_DEVICE_PFN(*m_ddt, vkBindImageMemory);
+      VK_CHECK(vkBindImageMemory(m_ddt->device(), result.image, result.allocation.memory, 0));
+    }
+    catch (...)
+    {
+      destroy_image(result);
+      throw;
+    }
+    MEGATECH_POSTCONDITION(result.image != VK_NULL_HANDLE);
+    return result;
+  }
+
+  image_allocation device_impl::create_image(const VkImageCreateInfo& image_info,
+                                             const VkMemoryPropertyFlags required,
+                                             const VkMemoryPropertyFlags preferred) const {
+    return create_selected_image(image_info, [&](const std::uint32_t type_bits) {
+      return m_parent->memory_type_index(type_bits, required, preferred);
+    });
+  }
+
+  image_allocation device_impl::create_image(const VkImageCreateInfo& image_info, const memory_usage memory) const {
+    return create_selected_image(image_info, [&](const std::uint32_t type_bits) {
+      return m_parent->memory_type_index(type_bits, memory);
+    });
+  }
+
+  void device_impl::destroy_image(image_allocation& image) const noexcept {
+    DECLARE_DEVICE_PFN_NO_THROW(*m_ddt, vkDestroyImage);
+    vkDestroyImage(m_ddt->device(), image.image, nullptr);
+    image.image = VK_NULL_HANDLE;
+    free_memory(image.allocation);
+  }
+
+  VkDeviceSize device_impl::allocated_bytes(const std::uint32_t heap_index) const {
+    if (heap_index >= m_allocated_bytes.size())
+    {
+      return 0;
+    }
+    return m_allocated_bytes[heap_index].load();
+  }
+
+  residency_manager& device_impl::residency() const {
+    MEGATECH_PRECONDITION(m_residency != nullptr);
+    return *m_residency;
+  }
+
+  deletion_queue& device_impl::deletions() const {
+    MEGATECH_PRECONDITION(m_deletions != nullptr);
+    return *m_deletions;
+  }
+
+  fence_pool& device_impl::fences() const {
+    MEGATECH_PRECONDITION(m_fences != nullptr);
+    return *m_fences;
+  }
+
+  semaphore_pool& device_impl::semaphores() const {
+    MEGATECH_PRECONDITION(m_semaphores != nullptr);
+    return *m_semaphores;
+  }
+
+  event_pool& device_impl::events() const {
+    MEGATECH_PRECONDITION(m_events != nullptr);
+    return *m_events;
+  }
+
+  compute_pipeline_cache& device_impl::pipelines() const {
+    MEGATECH_PRECONDITION(m_pipelines != nullptr);
+    return *m_pipelines;
   }
 
 }
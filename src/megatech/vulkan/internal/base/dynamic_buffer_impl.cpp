@@ -0,0 +1,173 @@
+/**
+ * @file dynamic_buffer_impl.cpp
+ * @brief Dynamic Buffer Implementation
+ * @author Alexander Rothman <[gnomesort@megate.ch](mailto:gnomesort@megate.ch)>
+ * @copyright AGPL-3.0-or-later
+ * @date 2025
+ */
+#include "megatech/vulkan/internal/base/dynamic_buffer_impl.hpp"
+
+#include <megatech/assertions.hpp>
+
+#include "megatech/vulkan/error.hpp"
+
+#include "megatech/vulkan/internal/base/physical_device_description_impl.hpp"
+#include "megatech/vulkan/internal/base/deletion_queue.hpp"
+
+#define DECLARE_DEVICE_PFN(dt, cmd) MEGATECH_VULKAN_INTERNAL_BASE_DECLARE_DEVICE_PFN(dt, cmd)
+
+namespace megatech::vulkan::internal::base {
+
+  dynamic_buffer_impl::dynamic_buffer_impl(const std::shared_ptr<const parent_type>& parent, const VkDeviceSize size) :
+  m_parent{ parent } {
+    if (!m_parent)
+    {
+      throw error{ "The parent device cannot be null." };
+    }
+    if (!size)
+    {
+      throw error{ "The size of a dynamic buffer must be greater than 0." };
+    }
+    constexpr auto usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT |
+                           VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    constexpr auto direct_flags = VkMemoryPropertyFlags{ VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT |
+                                                         VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                                                         VK_MEMORY_PROPERTY_HOST_COHERENT_BIT };
+    if (m_parent->parent().host_visible_device_local_heap_index() != -1)
+    {
+      try
+      {
+        m_buffer = m_parent->create_buffer(size, usage, direct_flags, 0);
+      }
+      catch (const error&)
+      {
+        // Without resizable BAR, the heap is usually only 256 MiB. Once it's full, writes are staged instead.
+      }
+    }
+    if (m_buffer.buffer == VK_NULL_HANDLE)
+    {
+      m_buffer = m_parent->create_buffer(size, usage, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 0);
+      try
+      {
+        m_staging = m_parent->create_buffer(size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                                            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                                            0);
+        m_commands.reset(new command_buffer_pool{ m_parent, queue_type::async_compute });
+      }
+      catch (...)
+      {
+        m_parent->destroy_buffer(m_staging);
+        m_parent->destroy_buffer(m_buffer);
+        throw;
+      }
+    }
+    auto address_info = VkBufferDeviceAddressInfo{ };
+    address_info.sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO;
+    address_info.buffer = m_buffer.buffer;
+    try
+    {
+      DECLARE_DEVICE_PFN(m_parent->dispatch_table(), vkGetBufferDeviceAddress);
+      m_device_address = vkGetBufferDeviceAddress(m_parent->handle(), &address_info);
+    }
+    catch (...)
+    {
+      m_commands.reset();
+      m_parent->destroy_buffer(m_staging);
+      m_parent->destroy_buffer(m_buffer);
+      throw;
+    }
+    MEGATECH_POSTCONDITION(m_buffer.buffer != VK_NULL_HANDLE);
+    MEGATECH_POSTCONDITION(data().data() != nullptr);
+  }
+
+  dynamic_buffer_impl::~dynamic_buffer_impl() noexcept {
+    m_parent->deletions().destroy_buffer(m_buffer);
+    if (m_staging.buffer != VK_NULL_HANDLE)
+    {
+      m_parent->deletions().destroy_buffer(m_staging);
+    }
+  }
+
+  dynamic_buffer_impl::handle_type dynamic_buffer_impl::handle() const {
+    return m_buffer.buffer;
+  }
+
+  const dynamic_buffer_impl::parent_type& dynamic_buffer_impl::parent() const {
+    MEGATECH_PRECONDITION(m_parent != nullptr);
+    return *m_parent;
+  }
+
+  std::shared_ptr<const dynamic_buffer_impl::parent_type> dynamic_buffer_impl::share_parent() const {
+    MEGATECH_PRECONDITION(m_parent != nullptr);
+    return m_parent;
+  }
+
+  const buffer_allocation& dynamic_buffer_impl::allocation() const {
+    return m_buffer;
+  }
+
+  const buffer_allocation& dynamic_buffer_impl::staging() const {
+    return m_staging;
+  }
+
+  VkDeviceAddress dynamic_buffer_impl::device_address() const {
+    return m_device_address;
+  }
+
+  bool dynamic_buffer_impl::is_direct() const {
+    return m_staging.buffer == VK_NULL_HANDLE;
+  }
+
+  std::span<std::byte> dynamic_buffer_impl::data() const {
+    const auto& mapped = is_direct() ? m_buffer : m_staging;
+    return { static_cast<std::byte*>(mapped.allocation.mapped), mapped.size };
+  }
+
+  std::uint64_t dynamic_buffer_impl::flush(const VkDeviceSize offset, const VkDeviceSize size) {
+    if (offset > m_buffer.size || size > m_buffer.size - offset)
+    {
+      throw error{ "The flushed range exceeds the dynamic buffer." };
+    }
+    if (is_direct() || !size)
+    {
+      return 0;
+    }
+    MEGATECH_PRECONDITION(m_commands != nullptr);
+    const auto& ddt = m_parent->dispatch_table();
+    DECLARE_DEVICE_PFN(ddt, vkCmdCopyBuffer);
+    DECLARE_DEVICE_PFN(ddt, vkCmdPipelineBarrier2);
+    auto lock = std::unique_lock<std::mutex>{ m_mutex };
+    const auto command_buffer = m_commands->acquire();
+    try
+    {
+      // Barriers also order commands in earlier and later submissions to the same queue. The copy waits for earlier
+      // commands that might still read the buffer, and later dispatches see the copy without waiting on the host.
+      auto barrier = VkMemoryBarrier2{ };
+      barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2;
+      barrier.srcStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+      barrier.dstStageMask = VK_PIPELINE_STAGE_2_COPY_BIT;
+      auto dependency_info = VkDependencyInfo{ };
+      dependency_info.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+      dependency_info.memoryBarrierCount = 1;
+      dependency_info.pMemoryBarriers = &barrier;
+      vkCmdPipelineBarrier2(command_buffer, &dependency_info);
+      auto region = VkBufferCopy{ };
+      region.srcOffset = offset;
+      region.dstOffset = offset;
+      region.size = size;
+      vkCmdCopyBuffer(command_buffer, m_staging.buffer, m_buffer.buffer, 1, &region);
+      barrier.srcStageMask = VK_PIPELINE_STAGE_2_COPY_BIT;
+      barrier.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+      barrier.dstStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+      barrier.dstAccessMask = VK_ACCESS_2_MEMORY_READ_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT;
+      vkCmdPipelineBarrier2(command_buffer, &dependency_info);
+    }
+    catch (...)
+    {
+      m_commands->release(command_buffer, 0);
+      throw;
+    }
+    return m_commands->submit(command_buffer);
+  }
+
+}
@@ -0,0 +1,646 @@
+/**
+ * @file file_streamer_impl.cpp
+ * @brief File Streamer Implementation
+ * @author Alexander Rothman <[gnomesort@megate.ch](mailto:gnomesort@megate.ch)>
+ * @copyright AGPL-3.0-or-later
+ * @date 2025
+ */
+#include "megatech/vulkan/internal/base/file_streamer_impl.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+
+#include <megatech/assertions.hpp>
+
+#include "config.hpp"
+
+#ifdef CONFIG_SYSTEM_LINUX
+  #include <cerrno>
+  #include <cstring>
+
+  #include <fcntl.h>
+  #include <linux/io_uring.h>
+  #include <sys/mman.h>
+  #include <sys/syscall.h>
+  #include <unistd.h>
+#endif
+
+#include "megatech/vulkan/error.hpp"
+
+#include "megatech/vulkan/internal/base/device_buffer_impl.hpp"
+#include "megatech/vulkan/internal/base/deletion_queue.hpp"
+
+#define DECLARE_DEVICE_PFN(dt, cmd) MEGATECH_VULKAN_INTERNAL_BASE_DECLARE_DEVICE_PFN(dt, cmd)
+#define VK_CHECK(exp) MEGATECH_VULKAN_INTERNAL_BASE_VK_CHECK(exp)
+
+namespace megatech::vulkan::internal::base {
+
+#ifdef CONFIG_SYSTEM_LINUX
+  namespace {
+
+    // io_uring is used through its system calls directly so that the library doesn't depend on liburing.
+    int setup_ring(const std::uint32_t entries, io_uring_params& params) {
+      return static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+    }
+
+    int enter_ring(const int fd, const std::uint32_t to_submit, const std::uint32_t min_complete) {
+      const auto flags = min_complete ? IORING_ENTER_GETEVENTS : 0U;
+      return static_cast<int>(syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, nullptr, 0));
+    }
+
+    template <typename Type>
+    Type* ring_field(void* ring, const std::uint32_t offset) {
+      return reinterpret_cast<Type*>(static_cast<std::byte*>(ring) + offset);
+    }
+
+  }
+
+  struct file_streamer_impl::io_ring final {
+    int fd{ -1 };
+    void* sq{ MAP_FAILED };
+    std::size_t sq_size{ };
+    void* cq{ MAP_FAILED };
+    std::size_t cq_size{ };
+    io_uring_sqe* sqes{ static_cast<io_uring_sqe*>(MAP_FAILED) };
+    std::size_t sqes_size{ };
+    std::uint32_t* sq_head{ };
+    std::uint32_t* sq_tail{ };
+    std::uint32_t sq_mask{ };
+    std::uint32_t sq_entries{ };
+    std::uint32_t* sq_array{ };
+    std::uint32_t* cq_head{ };
+    std::uint32_t* cq_tail{ };
+    std::uint32_t cq_mask{ };
+    io_uring_cqe* cqes{ };
+
+    // The ring is left with an fd of -1 if io_uring is unavailable.
+    explicit io_ring(const std::uint32_t entries) {
+      auto params = io_uring_params{ };
+      fd = setup_ring(entries, params);
+      if (fd < 0)
+      {
+        fd = -1;
+        return;
+      }
+      sq_size = params.sq_off.array + params.sq_entries * sizeof(std::uint32_t);
+      cq_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+      // Newer kernels map both rings with a single mmap().
+      if (params.features & IORING_FEAT_SINGLE_MMAP)
+      {
+        sq_size = std::max(sq_size, cq_size);
+      }
+      sq = mmap(nullptr, sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+      if (params.features & IORING_FEAT_SINGLE_MMAP)
+      {
+        cq = sq;
+      }
+      else if (sq != MAP_FAILED)
+      {
+        cq = mmap(nullptr, cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+      }
+      sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+      if (sq != MAP_FAILED && cq != MAP_FAILED)
+      {
+        sqes = static_cast<io_uring_sqe*>(mmap(nullptr, sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                               fd, IORING_OFF_SQES));
+      }
+      if (sqes == MAP_FAILED)
+      {
+        release();
+        return;
+      }
+      sq_head = ring_field<std::uint32_t>(sq, params.sq_off.head);
+      sq_tail = ring_field<std::uint32_t>(sq, params.sq_off.tail);
+      sq_mask = *ring_field<std::uint32_t>(sq, params.sq_off.ring_mask);
+      sq_entries = params.sq_entries;
+      sq_array = ring_field<std::uint32_t>(sq, params.sq_off.array);
+      cq_head = ring_field<std::uint32_t>(cq, params.cq_off.head);
+      cq_tail = ring_field<std::uint32_t>(cq, params.cq_off.tail);
+      cq_mask = *ring_field<std::uint32_t>(cq, params.cq_off.ring_mask);
+      cqes = ring_field<io_uring_cqe>(cq, params.cq_off.cqes);
+    }
+
+    io_ring(const io_ring& other) = delete;
+    io_ring(io_ring&& other) = delete;
+
+    ~io_ring() noexcept {
+      release();
+    }
+
+    io_ring& operator=(const io_ring& rhs) = delete;
+    io_ring& operator=(io_ring&& rhs) = delete;
+
+    void release() noexcept {
+      if (sqes != MAP_FAILED)
+      {
+        munmap(sqes, sqes_size);
+        sqes = static_cast<io_uring_sqe*>(MAP_FAILED);
+      }
+      if (cq != MAP_FAILED && cq != sq)
+      {
+        munmap(cq, cq_size);
+      }
+      cq = MAP_FAILED;
+      if (sq != MAP_FAILED)
+      {
+        munmap(sq, sq_size);
+        sq = MAP_FAILED;
+      }
+      if (fd != -1)
+      {
+        close(fd);
+        fd = -1;
+      }
+    }
+
+    // Returns a null pointer if the submission queue is full.
+    io_uring_sqe* next_sqe() {
+      const auto head = std::atomic_ref<std::uint32_t>{ *sq_head }.load(std::memory_order_acquire);
+      const auto tail = *sq_tail;
+      if (tail - head >= sq_entries)
+      {
+        return nullptr;
+      }
+      auto* result = &sqes[tail & sq_mask];
+      *result = io_uring_sqe{ };
+      return result;
+    }
+
+    void push_sqe(const io_uring_sqe* sqe) {
+      const auto tail = *sq_tail;
+      sq_array[tail & sq_mask] = static_cast<std::uint32_t>(sqe - sqes);
+      std::atomic_ref<std::uint32_t>{ *sq_tail }.store(tail + 1, std::memory_order_release);
+    }
+
+    // Returns the number of submissions that the kernel consumed.
+    std::uint32_t enter(const std::uint32_t to_submit, const std::uint32_t min_complete) {
+      auto result = int{ };
+      do
+      {
+        result = enter_ring(fd, to_submit, min_complete);
+      }
+      while (result < 0 && errno == EINTR);
+      // EBUSY means the completion queue is full. The caller drains it and submits the remainder later.
+      if (result < 0 && errno != EBUSY && errno != EAGAIN)
+      {
+        throw error{ std::string{ "Failed to enter the io_uring: " } + std::strerror(errno) };
+      }
+      return std::max(result, 0);
+    }
+  };
+#else
+  struct file_streamer_impl::io_ring final { };
+#endif
+
+  void file_streamer_impl::destroy() noexcept {
+#ifdef CONFIG_SYSTEM_LINUX
+    // The kernel writes into the staging buffer, so it must outlive every read.
+    try
+    {
+      while (m_ring && m_in_flight)
+      {
+        reap(true);
+      }
+    }
+    catch (...)
+    {
+      // The ring's destruction cancels whatever remains.
+    }
+    m_ring.reset();
+    for (const auto& [path, fd] : m_files)
+    {
+      close(fd);
+    }
+    m_files.clear();
+#endif
+    m_chunks.clear();
+    m_acquire.reset();
+    m_transfer.reset();
+    if (m_staging.buffer != VK_NULL_HANDLE)
+    {
+      m_parent->deletions().destroy_buffer(m_staging);
+    }
+  }
+
+  int file_streamer_impl::open_file(const std::filesystem::path& path) {
+#ifdef CONFIG_SYSTEM_LINUX
+    const auto key = path.string();
+    if (const auto found = m_files.find(key); found != m_files.end())
+    {
+      return found->second;
+    }
+    const auto fd = open(key.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
+    {
+      throw error{ "Failed to open \"" + key + "\": " + std::strerror(errno) };
+    }
+    m_files.emplace(key, fd);
+    return fd;
+#else
+    static_cast<void>(path);
+    return -1;
+#endif
+  }
+
+  bool file_streamer_impl::reserve(const VkDeviceSize size, VkDeviceSize& offset) {
+    MEGATECH_PRECONDITION(size > 0 && size <= m_staging.size);
+    if (m_chunks.empty())
+    {
+      offset = 0;
+      m_head = size;
+      return true;
+    }
+    // The ring is full when its head has caught up with the oldest chunk.
+    const auto tail = m_chunks.front().staging_offset;
+    if (m_head > tail)
+    {
+      if (m_staging.size - m_head >= size)
+      {
+        offset = m_head;
+        m_head += size;
+        return true;
+      }
+      if (tail >= size)
+      {
+        offset = 0;
+        m_head = size;
+        return true;
+      }
+      return false;
+    }
+    if (m_head < tail && tail - m_head >= size)
+    {
+      offset = m_head;
+      m_head += size;
+      return true;
+    }
+    return false;
+  }
+
+  void file_streamer_impl::reclaim() {
+    const auto completed = m_parent->completed_timeline_value();
+    while (!m_chunks.empty())
+    {
+      const auto& front = m_chunks.front();
+      if (!front.is_read || (!front.is_failed && (!front.timeline_value || front.timeline_value > completed)))
+      {
+        break;
+      }
+      m_chunks.pop_front();
+    }
+  }
+
+  void file_streamer_impl::issue(chunk& current) {
+#ifdef CONFIG_SYSTEM_LINUX
+    auto* const destination = static_cast<std::byte*>(m_staging.allocation.mapped) + current.staging_offset +
+                              current.completed;
+    const auto remaining = current.size - current.completed;
+    const auto offset = current.file_offset + current.completed;
+    if (!m_ring)
+    {
+      auto result = ssize_t{ };
+      do
+      {
+        result = pread(current.fd, destination, remaining, static_cast<off_t>(offset));
+      }
+      while (result < 0 && errno == EINTR);
+      ++m_in_flight;
+      complete(current.id, result < 0 ? -errno : result);
+      return;
+    }
+    auto* sqe = m_ring->next_sqe();
+    while (!sqe)
+    {
+      m_unsubmitted -= m_ring->enter(m_unsubmitted, 0);
+      sqe = m_ring->next_sqe();
+    }
+    sqe->opcode = IORING_OP_READ;
+    sqe->fd = current.fd;
+    sqe->off = offset;
+    sqe->addr = reinterpret_cast<std::uintptr_t>(destination);
+    sqe->len = static_cast<std::uint32_t>(remaining);
+    sqe->user_data = current.id;
+    m_ring->push_sqe(sqe);
+    ++m_in_flight;
+    ++m_unsubmitted;
+#else
+    static_cast<void>(current);
+#endif
+  }
+
+  void file_streamer_impl::complete(const std::uint64_t id, const std::int64_t result) {
+    MEGATECH_PRECONDITION(!m_chunks.empty() && id >= m_chunks.front().id);
+    auto& current = m_chunks[id - m_chunks.front().id];
+    --m_in_flight;
+    if (result <= 0)
+    {
+#ifdef CONFIG_SYSTEM_LINUX
+      const auto reason = result < 0 ? std::string{ std::strerror(static_cast<int>(-result)) } :
+                                       std::string{ "unexpected end of file" };
+#else
+      const auto reason = std::string{ "read failed" };
+#endif
+      m_failures.emplace_back("Failed to read " + std::to_string(current.size) + " bytes at offset " +
+                              std::to_string(current.file_offset) + ": " + reason + ".");
+      current.is_read = true;
+      current.is_failed = true;
+      return;
+    }
+    current.completed += static_cast<VkDeviceSize>(result);
+    if (current.completed < current.size)
+    {
+      // Short reads are continued where they left off.
+      issue(current);
+      return;
+    }
+    current.is_read = true;
+  }
+
+  void file_streamer_impl::reap(const bool wait) {
+#ifdef CONFIG_SYSTEM_LINUX
+    if (!m_ring)
+    {
+      return;
+    }
+    if (m_unsubmitted || (wait && m_in_flight))
+    {
+      m_unsubmitted -= m_ring->enter(m_unsubmitted, wait && m_in_flight ? 1 : 0);
+    }
+    auto head = *m_ring->cq_head;
+    while (head != std::atomic_ref<std::uint32_t>{ *m_ring->cq_tail }.load(std::memory_order_acquire))
+    {
+      const auto& cqe = m_ring->cqes[head & m_ring->cq_mask];
+      const auto id = cqe.user_data;
+      const auto result = cqe.res;
+      ++head;
+      std::atomic_ref<std::uint32_t>{ *m_ring->cq_head }.store(head, std::memory_order_release);
+      complete(id, result);
+    }
+    // Continuations of short reads are queued by complete().
+    if (m_unsubmitted)
+    {
+      m_unsubmitted -= m_ring->enter(m_unsubmitted, 0);
+    }
+#else
+    static_cast<void>(wait);
+#endif
+  }
+
+  std::uint64_t file_streamer_impl::submit_locked() {
+    reap(false);
+    if (!m_failures.empty())
+    {
+      const auto message = m_failures.front();
+      m_failures.clear();
+      throw error{ message };
+    }
+    auto ready = std::vector<chunk*>{ };
+    for (auto& current : m_chunks)
+    {
+      if (current.is_read && !current.is_failed && !current.timeline_value)
+      {
+        ready.emplace_back(&current);
+      }
+    }
+    if (ready.empty())
+    {
+      return 0;
+    }
+    const auto source_family = m_parent->queue_family_index(queue_type::async_transfer);
+    const auto destination_family = m_parent->queue_family_index(queue_type::async_compute);
+    const auto is_transfer = source_family != destination_family;
+    const auto& ddt = m_parent->dispatch_table();
+    DECLARE_DEVICE_PFN(ddt, vkCmdPipelineBarrier2);
+    DECLARE_DEVICE_PFN(ddt, vkCmdCopyBuffer);
+    auto barriers = std::vector<VkBufferMemoryBarrier2>{ };
+    if (is_transfer)
+    {
+      for (const auto* current : ready)
+      {
+        auto& barrier = barriers.emplace_back();
+        barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2;
+        barrier.srcStageMask = VK_PIPELINE_STAGE_2_COPY_BIT;
+        barrier.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+        barrier.srcQueueFamilyIndex = source_family;
+        barrier.dstQueueFamilyIndex = destination_family;
+        barrier.buffer = current->destination->allocation().buffer;
+        barrier.offset = current->destination_offset;
+        barrier.size = current->size;
+      }
+    }
+    auto command_buffer = m_transfer->acquire();
+    try
+    {
+      for (const auto* current : ready)
+      {
+        auto region = VkBufferCopy{ };
+        region.srcOffset = current->staging_offset;
+        region.dstOffset = current->destination_offset;
+        region.size = current->size;
+        vkCmdCopyBuffer(command_buffer, m_staging.buffer, current->destination->allocation().buffer, 1, &region);
+      }
+      auto dependency_info = VkDependencyInfo{ };
+      dependency_info.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+      auto barrier = VkMemoryBarrier2{ };
+      if (is_transfer)
+      {
+        // Release ownership. The destination stages are ignored, since the acquire completes the transfer.
+        dependency_info.bufferMemoryBarrierCount = barriers.size();
+        dependency_info.pBufferMemoryBarriers = barriers.data();
+      }
+      else
+      {
+        barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2;
+        barrier.srcStageMask = VK_PIPELINE_STAGE_2_COPY_BIT;
+        barrier.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+        barrier.dstStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+        barrier.dstAccessMask = VK_ACCESS_2_MEMORY_READ_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT;
+        dependency_info.memoryBarrierCount = 1;
+        dependency_info.pMemoryBarriers = &barrier;
+      }
+      vkCmdPipelineBarrier2(command_buffer, &dependency_info);
+    }
+    catch (...)
+    {
+      m_transfer->release(command_buffer, 0);
+      throw;
+    }
+    auto timeline_value = m_transfer->submit(command_buffer);
+    for (auto* current : ready)
+    {
+      current->timeline_value = timeline_value;
+    }
+    m_last_value = timeline_value;
+    if (is_transfer)
+    {
+      command_buffer = m_acquire->acquire();
+      try
+      {
+        for (auto& barrier : barriers)
+        {
+          barrier.srcStageMask = VK_PIPELINE_STAGE_2_NONE;
+          barrier.srcAccessMask = VK_ACCESS_2_NONE;
+          barrier.dstStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+          barrier.dstAccessMask = VK_ACCESS_2_MEMORY_READ_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT;
+        }
+        auto dependency_info = VkDependencyInfo{ };
+        dependency_info.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+        dependency_info.bufferMemoryBarrierCount = barriers.size();
+        dependency_info.pBufferMemoryBarriers = barriers.data();
+        vkCmdPipelineBarrier2(command_buffer, &dependency_info);
+      }
+      catch (...)
+      {
+        m_acquire->release(command_buffer, 0);
+        throw;
+      }
+      auto wait_info = VkSemaphoreSubmitInfo{ };
+      wait_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
+      wait_info.semaphore = m_parent->timeline_semaphore(queue_type::async_transfer);
+      wait_info.value = timeline_value;
+      wait_info.stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+      timeline_value = m_acquire->submit(command_buffer, { &wait_info, 1 });
+      m_last_value = timeline_value;
+    }
+    return timeline_value;
+  }
+
+  file_streamer_impl::file_streamer_impl(const std::shared_ptr<const parent_type>& parent,
+                                         const VkDeviceSize staging_capacity, const std::uint32_t queue_depth) :
+  m_parent{ parent },
+  m_chunk_size{ std::max(staging_capacity / 4, VkDeviceSize{ 1 }) },
+  m_queue_depth{ queue_depth } {
+#ifdef CONFIG_SYSTEM_LINUX
+    if (!m_parent)
+    {
+      throw error{ "The parent device cannot be null." };
+    }
+    if (staging_capacity < 4 || !m_queue_depth)
+    {
+      throw error{ "A file streamer needs at least 4 bytes of staging memory and a queue depth of at least 1." };
+    }
+    m_staging = m_parent->create_buffer(staging_capacity, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, memory_usage::upload);
+    try
+    {
+      m_transfer.reset(new command_buffer_pool{ m_parent, queue_type::async_transfer });
+      m_acquire.reset(new command_buffer_pool{ m_parent, queue_type::async_compute });
+      m_ring.reset(new io_ring{ m_queue_depth });
+      if (m_ring->fd == -1)
+      {
+        m_ring.reset();
+      }
+    }
+    catch (...)
+    {
+      destroy();
+      throw;
+    }
+    MEGATECH_POSTCONDITION(m_staging.buffer != VK_NULL_HANDLE);
+    MEGATECH_POSTCONDITION(m_staging.allocation.mapped != nullptr);
+#else
+    throw error{ "File streaming is only supported on Linux." };
+#endif
+  }
+
+  file_streamer_impl::~file_streamer_impl() noexcept {
+    destroy();
+  }
+
+  const file_streamer_impl::parent_type& file_streamer_impl::parent() const {
+    MEGATECH_PRECONDITION(m_parent != nullptr);
+    return *m_parent;
+  }
+
+  std::shared_ptr<const file_streamer_impl::parent_type> file_streamer_impl::share_parent() const {
+    MEGATECH_PRECONDITION(m_parent != nullptr);
+    return m_parent;
+  }
+
+  VkDeviceSize file_streamer_impl::staging_capacity() const {
+    return m_staging.size;
+  }
+
+  bool file_streamer_impl::uses_io_uring() const {
+    return m_ring != nullptr;
+  }
+
+  std::size_t file_streamer_impl::pending() const {
+    auto lock = std::unique_lock<std::mutex>{ m_mutex };
+    return static_cast<std::size_t>(std::ranges::count_if(m_chunks, [](const auto& current) {
+      return !current.is_failed && !current.timeline_value;
+    }));
+  }
+
+  void file_streamer_impl::read(const std::filesystem::path& path, const std::uint64_t file_offset,
+                                const VkDeviceSize size, const std::shared_ptr<const device_buffer_impl>& destination,
+                                const VkDeviceSize destination_offset) {
+    if (!destination)
+    {
+      throw error{ "The destination buffer cannot be null." };
+    }
+    const auto destination_size = destination->allocation().size;
+    if (destination_offset > destination_size || size > destination_size - destination_offset)
+    {
+      throw error{ "The read exceeds the destination buffer." };
+    }
+    if (!size)
+    {
+      return;
+    }
+    auto lock = std::unique_lock<std::mutex>{ m_mutex };
+    const auto fd = open_file(path);
+    for (auto done = VkDeviceSize{ 0 }; done < size;)
+    {
+      const auto chunk_size = std::min(m_chunk_size, size - done);
+      auto staging_offset = VkDeviceSize{ };
+      reap(false);
+      reclaim();
+      while (m_in_flight >= m_queue_depth || !reserve(chunk_size, staging_offset))
+      {
+        // Make room by finishing the oldest chunk: wait for its read, copy it, and wait for the copy.
+        const auto& front = m_chunks.front();
+        if (!front.is_read)
+        {
+          reap(true);
+        }
+        else if (!front.is_failed)
+        {
+          if (!front.timeline_value)
+          {
+            submit_locked();
+          }
+          m_parent->wait_for_timeline_value(front.timeline_value);
+        }
+        reclaim();
+      }
+      auto& current = m_chunks.emplace_back();
+      current.id = m_next_id++;
+      current.fd = fd;
+      current.file_offset = file_offset + done;
+      current.destination = destination;
+      current.destination_offset = destination_offset + done;
+      current.staging_offset = staging_offset;
+      current.size = chunk_size;
+      issue(current);
+      done += chunk_size;
+    }
+    reap(false);
+  }
+
+  std::uint64_t file_streamer_impl::submit() {
+    auto lock = std::unique_lock<std::mutex>{ m_mutex };
+    return submit_locked();
+  }
+
+  std::uint64_t file_streamer_impl::flush() {
+    auto lock = std::unique_lock<std::mutex>{ m_mutex };
+    while (m_in_flight)
+    {
+      reap(true);
+    }
+    const auto result = submit_locked();
+    return result ? result : m_last_value;
+  }
+
+}
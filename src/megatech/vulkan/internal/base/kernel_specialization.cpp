@@ -0,0 +1,102 @@
+/**
+ * @file kernel_specialization.cpp
+ * @brief Device-Derived Compute Kernel Specialization
+ * @author Alexander Rothman <[gnomesort@megate.ch](mailto:gnomesort@megate.ch)>
+ * @copyright AGPL-3.0-or-later
+ * @date 2025
+ */
+#include "megatech/vulkan/internal/base/kernel_specialization.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <limits>
+
+#include <megatech/assertions.hpp>
+
+#include "megatech/vulkan/error.hpp"
+
+#include "megatech/vulkan/internal/base/physical_device_description_impl.hpp"
+
+namespace megatech::vulkan::internal::base {
+
+  kernel_specialization::kernel_specialization(const physical_device_description_impl& physical_device,
+                                               const kernel_constants& constants) {
+    if (!constants.shared_bytes_per_element)
+    {
+      throw error{ "The shared memory size of a tile element must be greater than 0." };
+    }
+    const auto& limits = physical_device.properties_1_0().limits;
+    m_subgroup_size = std::max(physical_device.properties_1_1().subgroupSize, 1u);
+    // Workgroups are kept to whole subgroups so that no subgroup runs partially empty.
+    const auto limit = std::min({ max_workgroup_size, limits.maxComputeWorkGroupInvocations,
+                                  limits.maxComputeWorkGroupSize[0] });
+    m_workgroup_size = std::max(limit - (limit % m_subgroup_size), std::min(m_subgroup_size, limit));
+    // Half of the shared memory is used so that at least two workgroups can be resident on each compute unit.
+    const auto tile_elements = (limits.maxComputeSharedMemorySize / 2) / constants.shared_bytes_per_element;
+    m_tile_size = std::max(std::bit_floor(tile_elements), 1u);
+    add_constant(constants.workgroup_size_id, m_workgroup_size);
+    add_constant(constants.subgroup_size_id, m_subgroup_size);
+    add_constant(constants.tile_size_id, m_tile_size);
+    MEGATECH_POSTCONDITION(m_entries.size() == m_data.size());
+    MEGATECH_POSTCONDITION(m_workgroup_size > 0);
+  }
+
+  void kernel_specialization::add_constant(const std::int64_t id, const std::uint32_t value) {
+    if (id == -1)
+    {
+      return;
+    }
+    if (id < 0 || id > std::numeric_limits<std::uint32_t>::max())
+    {
+      throw error{ "Specialization constant IDs must be 32-bit unsigned integers." };
+    }
+    const auto constant_id = static_cast<std::uint32_t>(id);
+    const auto duplicate = std::ranges::any_of(m_entries, [&](const VkSpecializationMapEntry& entry) {
+      return entry.constantID == constant_id;
+    });
+    if (duplicate)
+    {
+      throw error{ "Specialization constant IDs must be distinct." };
+    }
+    auto& entry = m_entries.emplace_back();
+    entry.constantID = constant_id;
+    entry.offset = static_cast<std::uint32_t>(m_data.size() * sizeof(std::uint32_t));
+    entry.size = sizeof(std::uint32_t);
+    m_data.emplace_back(value);
+  }
+
+  VkSpecializationInfo kernel_specialization::info() const {
+    auto res = VkSpecializationInfo{ };
+    res.mapEntryCount = static_cast<std::uint32_t>(m_entries.size());
+    res.pMapEntries = m_entries.data();
+    res.dataSize = m_data.size() * sizeof(std::uint32_t);
+    res.pData = m_data.data();
+    return res;
+  }
+
+  std::string kernel_specialization::key() const {
+    auto res = std::string{ };
+    for (auto i = std::size_t{ 0 }; i < m_entries.size(); ++i)
+    {
+      res += std::to_string(m_entries[i].constantID) + "=" + std::to_string(m_data[i]) + ";";
+    }
+    return res;
+  }
+
+  bool kernel_specialization::empty() const {
+    return m_entries.empty();
+  }
+
+  std::uint32_t kernel_specialization::workgroup_size() const {
+    return m_workgroup_size;
+  }
+
+  std::uint32_t kernel_specialization::subgroup_size() const {
+    return m_subgroup_size;
+  }
+
+  std::uint32_t kernel_specialization::tile_size() const {
+    return m_tile_size;
+  }
+
+}
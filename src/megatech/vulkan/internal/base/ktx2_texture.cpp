@@ -0,0 +1,504 @@
+/**
+ * @file ktx2_texture.cpp
+ * @brief Progressively Streamed KTX2 Textures
+ * @author Alexander Rothman <[gnomesort@megate.ch](mailto:gnomesort@megate.ch)>
+ * @copyright AGPL-3.0-or-later
+ * @date 2025
+ */
+#include "megatech/vulkan/internal/base/ktx2_texture.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <numeric>
+
+#include <megatech/assertions.hpp>
+
+#include "config.hpp"
+
+#ifdef CONFIG_SYSTEM_LINUX
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+#ifdef CONFIG_HAVE_ZSTD
+  #include <zstd.h>
+#endif
+
+#include "megatech/vulkan/error.hpp"
+
+#include "megatech/vulkan/internal/base/deletion_queue.hpp"
+
+#define DECLARE_DEVICE_PFN(dt, cmd) MEGATECH_VULKAN_INTERNAL_BASE_DECLARE_DEVICE_PFN(dt, cmd)
+#define VK_CHECK(exp) MEGATECH_VULKAN_INTERNAL_BASE_VK_CHECK(exp)
+
+namespace megatech::vulkan::internal::base {
+
+  namespace {
+
+    constexpr auto identifier = std::array<unsigned char, 12>{ 0xab, 'K', 'T', 'X', ' ', '2', '0', 0xbb, '\r', '\n',
+                                                               0x1a, '\n' };
+    constexpr auto header_size = std::size_t{ 80 };
+    constexpr auto level_index_entry_size = std::size_t{ 24 };
+    constexpr auto supercompression_none = std::uint32_t{ 0 };
+    constexpr auto supercompression_zstd = std::uint32_t{ 2 };
+
+    // KTX2 is always little-endian.
+    template <typename Type>
+    Type read_field(const std::span<const std::byte> file, const std::size_t offset) {
+      if (offset > file.size() || sizeof(Type) > file.size() - offset)
+      {
+        throw error{ "The KTX2 file is truncated." };
+      }
+      auto result = Type{ };
+      std::memcpy(&result, file.data() + offset, sizeof(Type));
+      return result;
+    }
+
+    std::uint32_t divide_up(const std::uint32_t numerator, const std::uint32_t denominator) {
+      return (numerator + denominator - 1) / denominator;
+    }
+
+    VkDeviceSize align_up(const VkDeviceSize value, const VkDeviceSize alignment) {
+      return (value + alignment - 1) / alignment * alignment;
+    }
+
+    std::vector<std::byte> decode_zstd(const std::span<const std::byte> source, const VkDeviceSize size) {
+#ifdef CONFIG_HAVE_ZSTD
+      auto result = std::vector<std::byte>(size);
+      const auto decoded = ZSTD_decompress(result.data(), result.size(), source.data(), source.size());
+      if (ZSTD_isError(decoded) || decoded != result.size())
+      {
+        throw error{ "Failed to decode a Zstandard-supercompressed mip level." };
+      }
+      return result;
+#else
+      static_cast<void>(source);
+      static_cast<void>(size);
+      throw error{ "Zstandard supercompression isn't supported by this build." };
+#endif
+    }
+
+  }
+
+  void ktx2_texture::destroy() noexcept {
+    // Decoding jobs read from the mapping, so they have to finish before it's unmapped.
+    for (auto& current : m_levels)
+    {
+      if (current.decoding.valid())
+      {
+        current.decoding.wait();
+      }
+    }
+    m_commands.reset();
+    if (m_image.image != VK_NULL_HANDLE)
+    {
+      m_parent->deletions().destroy_image(m_image);
+    }
+    unmap();
+  }
+
+  std::span<const std::byte> ktx2_texture::map(const std::filesystem::path& path) {
+#ifdef CONFIG_SYSTEM_LINUX
+    const auto fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
+    {
+      throw error{ "Failed to open \"" + path.string() + "\"." };
+    }
+    struct stat status{ };
+    if (fstat(fd, &status) == -1 || status.st_size <= 0)
+    {
+      close(fd);
+      throw error{ "Failed to read \"" + path.string() + "\"." };
+    }
+    m_mapping_size = static_cast<std::size_t>(status.st_size);
+    m_mapping = mmap(nullptr, m_mapping_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // The mapping keeps the file alive on its own.
+    close(fd);
+    if (m_mapping == MAP_FAILED)
+    {
+      m_mapping = nullptr;
+      throw error{ "Failed to map \"" + path.string() + "\"." };
+    }
+    return { static_cast<const std::byte*>(m_mapping), m_mapping_size };
+#else
+    auto file = std::ifstream{ path, std::ios::binary | std::ios::ate };
+    if (!file)
+    {
+      throw error{ "Failed to open \"" + path.string() + "\"." };
+    }
+    m_contents.resize(static_cast<std::size_t>(file.tellg()));
+    file.seekg(0);
+    if (!file.read(reinterpret_cast<char*>(m_contents.data()), static_cast<std::streamsize>(m_contents.size())))
+    {
+      throw error{ "Failed to read \"" + path.string() + "\"." };
+    }
+    return m_contents;
+#endif
+  }
+
+  void ktx2_texture::unmap() noexcept {
+#ifdef CONFIG_SYSTEM_LINUX
+    if (m_mapping)
+    {
+      munmap(m_mapping, m_mapping_size);
+      m_mapping = nullptr;
+    }
+#endif
+    m_contents = { };
+    for (auto& current : m_levels)
+    {
+      current.source = { };
+    }
+  }
+
+  void ktx2_texture::parse(const std::span<const std::byte> file) {
+    if (file.size() < header_size || std::memcmp(file.data(), identifier.data(), identifier.size()))
+    {
+      throw error{ "The file isn't a KTX2 file." };
+    }
+    const auto format = read_field<std::uint32_t>(file, 12);
+    const auto width = read_field<std::uint32_t>(file, 20);
+    const auto height = read_field<std::uint32_t>(file, 24);
+    const auto depth = read_field<std::uint32_t>(file, 28);
+    const auto layers = std::max(read_field<std::uint32_t>(file, 32), 1U);
+    m_faces = read_field<std::uint32_t>(file, 36);
+    const auto level_count = std::max(read_field<std::uint32_t>(file, 40), 1U);
+    m_supercompression = read_field<std::uint32_t>(file, 44);
+    const auto dfd_offset = read_field<std::uint32_t>(file, 48);
+    if (format == VK_FORMAT_UNDEFINED)
+    {
+      throw error{ "Basis Universal KTX2 files aren't supported." };
+    }
+    if (m_supercompression != supercompression_none && m_supercompression != supercompression_zstd)
+    {
+      throw error{ "The KTX2 file uses an unsupported supercompression scheme." };
+    }
+    if (!width || (m_faces != 1 && m_faces != 6) || level_count > 32)
+    {
+      throw error{ "The KTX2 file's header is invalid." };
+    }
+    // The texel block dimensions are stored, minus 1, in the basic data format descriptor block.
+    m_block_extent.width = std::to_integer<std::uint32_t>(read_field<std::byte>(file, dfd_offset + 16)) + 1;
+    m_block_extent.height = std::to_integer<std::uint32_t>(read_field<std::byte>(file, dfd_offset + 17)) + 1;
+    m_block_extent.depth = std::to_integer<std::uint32_t>(read_field<std::byte>(file, dfd_offset + 18)) + 1;
+    m_image_info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    if (m_faces == 6)
+    {
+      m_image_info.flags = VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT;
+    }
+    m_image_info.imageType = depth ? VK_IMAGE_TYPE_3D : height ? VK_IMAGE_TYPE_2D : VK_IMAGE_TYPE_1D;
+    m_image_info.format = static_cast<VkFormat>(format);
+    m_image_info.extent = { width, std::max(height, 1U), std::max(depth, 1U) };
+    m_image_info.mipLevels = level_count;
+    m_image_info.arrayLayers = layers * m_faces;
+    m_image_info.samples = VK_SAMPLE_COUNT_1_BIT;
+    m_image_info.tiling = VK_IMAGE_TILING_OPTIMAL;
+    m_image_info.usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+    m_image_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    m_image_info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    m_levels.resize(level_count);
+    for (auto i = std::uint32_t{ 0 }; i < level_count; ++i)
+    {
+      auto& current = m_levels[i];
+      const auto entry = header_size + i * level_index_entry_size;
+      const auto offset = read_field<std::uint64_t>(file, entry);
+      const auto length = read_field<std::uint64_t>(file, entry + 8);
+      const auto uncompressed_length = read_field<std::uint64_t>(file, entry + 16);
+      if (offset > file.size() || length > file.size() - offset)
+      {
+        throw error{ "The KTX2 file is truncated." };
+      }
+      current.source = file.subspan(offset, length);
+      current.size = m_supercompression == supercompression_none ? length : uncompressed_length;
+      current.extent = { std::max(width >> i, 1U), std::max(m_image_info.extent.height >> i, 1U),
+                         std::max(m_image_info.extent.depth >> i, 1U) };
+      // Each level stores every layer, then every face, then every slice of blocks as a sequence of block rows.
+      const auto row_blocks = divide_up(current.extent.width, m_block_extent.width);
+      const auto slices = divide_up(current.extent.depth, m_block_extent.depth);
+      current.rows_per_image = divide_up(current.extent.height, m_block_extent.height);
+      current.rows = m_image_info.arrayLayers * slices * current.rows_per_image;
+      if (!current.size || current.size % current.rows || current.size / current.rows % row_blocks)
+      {
+        throw error{ "The KTX2 file's level " + std::to_string(i) + " has an invalid size." };
+      }
+      current.row_size = current.size / current.rows;
+      if (!i)
+      {
+        // Buffer offsets must be multiples of both the texel block size and 4.
+        m_copy_alignment = std::lcm(current.row_size / row_blocks, VkDeviceSize{ 4 });
+      }
+    }
+  }
+
+  void ktx2_texture::decode(const std::uint32_t index) {
+    auto& current = m_levels[index];
+    if (m_supercompression == supercompression_none || !m_workers || current.decoding.valid() ||
+        !current.decoded.empty())
+    {
+      return;
+    }
+    current.decoding = m_workers->enqueue([source = current.source, size = current.size]() {
+      return decode_zstd(source, size);
+    });
+  }
+
+  std::span<const std::byte> ktx2_texture::level_data(const std::uint32_t index, const bool wait) {
+    auto& current = m_levels[index];
+    if (m_supercompression == supercompression_none)
+    {
+      return current.source;
+    }
+    if (current.decoded.empty())
+    {
+      if (!m_workers)
+      {
+        current.decoded = decode_zstd(current.source, current.size);
+        return current.decoded;
+      }
+      decode(index);
+      if (!wait && current.decoding.wait_for(std::chrono::seconds{ 0 }) != std::future_status::ready)
+      {
+        return { };
+      }
+      current.decoded = current.decoding.get();
+    }
+    return current.decoded;
+  }
+
+  std::uint64_t ktx2_texture::upload(const bool is_initial) {
+    auto pieces = std::vector<piece>{ };
+    auto sources = std::vector<std::span<const std::byte>>{ };
+    auto offsets = std::vector<VkDeviceSize>{ };
+    auto staging_size = VkDeviceSize{ 0 };
+    auto budget = m_frame_budget;
+    auto index = m_remaining_levels;
+    auto uploaded = index ? m_levels[index - 1].uploaded_rows : 0;
+    while (index && budget)
+    {
+      const auto& current = m_levels[index - 1];
+      // The initial upload only takes whole levels, and it always takes at least one.
+      if (is_initial && !pieces.empty() && current.size > budget)
+      {
+        break;
+      }
+      // Decoding runs one level ahead of the upload.
+      if (index > 1)
+      {
+        decode(index - 2);
+      }
+      const auto data = level_data(index - 1, is_initial);
+      if (data.empty())
+      {
+        break;
+      }
+      auto rows = current.rows - uploaded;
+      if (!is_initial)
+      {
+        rows = std::min<VkDeviceSize>(rows, budget / current.row_size);
+        if (!rows && pieces.empty())
+        {
+          rows = 1;
+        }
+      }
+      if (!rows)
+      {
+        break;
+      }
+      pieces.emplace_back(piece{ index - 1, uploaded, static_cast<std::uint32_t>(rows) });
+      sources.emplace_back(data.subspan(uploaded * current.row_size, rows * current.row_size));
+      offsets.emplace_back(align_up(staging_size, m_copy_alignment));
+      staging_size = offsets.back() + sources.back().size();
+      budget -= std::min<VkDeviceSize>(budget, sources.back().size());
+      uploaded += rows;
+      if (uploaded < current.rows)
+      {
+        break;
+      }
+      --index;
+      uploaded = 0;
+    }
+    if (pieces.empty())
+    {
+      return 0;
+    }
+    auto staging = m_parent->create_buffer(staging_size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, memory_usage::upload);
+    auto timeline_value = std::uint64_t{ };
+    try
+    {
+      auto regions = std::vector<VkBufferImageCopy>{ };
+      for (auto i = std::size_t{ 0 }; i < pieces.size(); ++i)
+      {
+        std::memcpy(static_cast<std::byte*>(staging.allocation.mapped) + offsets[i], sources[i].data(),
+                    sources[i].size());
+        const auto& current = m_levels[pieces[i].level];
+        const auto slices = divide_up(current.extent.depth, m_block_extent.depth);
+        const auto end = pieces[i].first_row + pieces[i].rows;
+        for (auto row = pieces[i].first_row; row < end;)
+        {
+          // A piece is split wherever it crosses from one slice, face, or layer into the next.
+          const auto image = row / current.rows_per_image;
+          const auto first = row % current.rows_per_image;
+          const auto count = std::min(current.rows_per_image - first, end - row);
+          const auto slice = image % slices;
+          auto& region = regions.emplace_back();
+          region.bufferOffset = offsets[i] + (row - pieces[i].first_row) * current.row_size;
+          region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+          region.imageSubresource.mipLevel = pieces[i].level;
+          region.imageSubresource.baseArrayLayer = image / slices;
+          region.imageSubresource.layerCount = 1;
+          region.imageOffset.y = static_cast<std::int32_t>(first * m_block_extent.height);
+          region.imageOffset.z = static_cast<std::int32_t>(slice * m_block_extent.depth);
+          region.imageExtent.width = current.extent.width;
+          region.imageExtent.height = std::min(count * m_block_extent.height,
+                                               current.extent.height - first * m_block_extent.height);
+          region.imageExtent.depth = std::min(m_block_extent.depth,
+                                              current.extent.depth - slice * m_block_extent.depth);
+          row += count;
+        }
+      }
+      const auto& ddt = m_parent->dispatch_table();
+      DECLARE_DEVICE_PFN(ddt, vkCmdPipelineBarrier2);
+      DECLARE_DEVICE_PFN(ddt, vkCmdCopyBufferToImage);
+      const auto command_buffer = m_commands->acquire();
+      try
+      {
+        // The initial upload moves every level out of the undefined layout, so that any level can be sampled later.
+        auto barrier = VkImageMemoryBarrier2{ };
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2;
+        barrier.srcStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+        barrier.dstStageMask = VK_PIPELINE_STAGE_2_COPY_BIT;
+        barrier.dstAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+        barrier.oldLayout = is_initial ? VK_IMAGE_LAYOUT_UNDEFINED : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = m_image.image;
+        barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        barrier.subresourceRange.baseMipLevel = is_initial ? 0 : pieces.back().level;
+        barrier.subresourceRange.levelCount = is_initial ? VK_REMAINING_MIP_LEVELS :
+                                                           pieces.front().level - pieces.back().level + 1;
+        barrier.subresourceRange.layerCount = VK_REMAINING_ARRAY_LAYERS;
+        auto dependency_info = VkDependencyInfo{ };
+        dependency_info.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+        dependency_info.imageMemoryBarrierCount = 1;
+        dependency_info.pImageMemoryBarriers = &barrier;
+        vkCmdPipelineBarrier2(command_buffer, &dependency_info);
+        vkCmdCopyBufferToImage(command_buffer, staging.buffer, m_image.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                               regions.size(), regions.data());
+        barrier.srcStageMask = VK_PIPELINE_STAGE_2_COPY_BIT;
+        barrier.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+        barrier.dstStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+        barrier.dstAccessMask = VK_ACCESS_2_SHADER_READ_BIT;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        vkCmdPipelineBarrier2(command_buffer, &dependency_info);
+      }
+      catch (...)
+      {
+        m_commands->release(command_buffer, 0);
+        throw;
+      }
+      timeline_value = m_commands->submit(command_buffer);
+    }
+    catch (...)
+    {
+      m_parent->destroy_buffer(staging);
+      throw;
+    }
+    m_parent->deletions().destroy_buffer(staging, timeline_value);
+    for (const auto& current : pieces)
+    {
+      auto& uploaded_level = m_levels[current.level];
+      uploaded_level.uploaded_rows += current.rows;
+      if (uploaded_level.uploaded_rows == uploaded_level.rows)
+      {
+        uploaded_level.timeline_value = timeline_value;
+        uploaded_level.decoded = { };
+        --m_remaining_levels;
+      }
+    }
+    if (!m_remaining_levels)
+    {
+      unmap();
+    }
+    return timeline_value;
+  }
+
+  ktx2_texture::ktx2_texture(const std::shared_ptr<const parent_type>& parent, const std::filesystem::path& path,
+                             const VkDeviceSize frame_budget, const std::shared_ptr<worker_pool>& workers) :
+  m_parent{ parent },
+  m_workers{ workers },
+  m_frame_budget{ frame_budget } {
+    if (!m_parent)
+    {
+      throw error{ "The parent device cannot be null." };
+    }
+    if (!m_frame_budget)
+    {
+      throw error{ "A KTX2 texture's frame budget must be greater than 0." };
+    }
+    try
+    {
+      parse(map(path));
+      m_image = m_parent->create_image(m_image_info, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 0);
+      m_commands.reset(new command_buffer_pool{ m_parent, queue_type::primary });
+      m_remaining_levels = m_levels.size();
+      upload(true);
+    }
+    catch (...)
+    {
+      destroy();
+      throw;
+    }
+    MEGATECH_POSTCONDITION(m_image.image != VK_NULL_HANDLE);
+    MEGATECH_POSTCONDITION(m_remaining_levels < m_levels.size());
+  }
+
+  ktx2_texture::~ktx2_texture() noexcept {
+    destroy();
+  }
+
+  ktx2_texture::handle_type ktx2_texture::handle() const {
+    return m_image.image;
+  }
+
+  const ktx2_texture::parent_type& ktx2_texture::parent() const {
+    MEGATECH_PRECONDITION(m_parent != nullptr);
+    return *m_parent;
+  }
+
+  const VkImageCreateInfo& ktx2_texture::image_info() const {
+    return m_image_info;
+  }
+
+  VkDeviceSize ktx2_texture::frame_budget() const {
+    return m_frame_budget;
+  }
+
+  std::uint32_t ktx2_texture::resident_level() const {
+    auto lock = std::unique_lock<std::mutex>{ m_mutex };
+    const auto completed = m_parent->completed_timeline_value();
+    auto result = static_cast<std::uint32_t>(m_levels.size());
+    while (result && m_levels[result - 1].timeline_value && m_levels[result - 1].timeline_value <= completed)
+    {
+      --result;
+    }
+    return result;
+  }
+
+  bool ktx2_texture::is_complete() const {
+    auto lock = std::unique_lock<std::mutex>{ m_mutex };
+    return !m_remaining_levels;
+  }
+
+  std::uint64_t ktx2_texture::stream() {
+    auto lock = std::unique_lock<std::mutex>{ m_mutex };
+    return upload(false);
+  }
+
+}
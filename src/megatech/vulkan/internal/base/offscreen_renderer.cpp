@@ -0,0 +1,371 @@
+/**
+ * @file offscreen_renderer.cpp
+ * @brief Headless Rendering and Readback
+ * @author Alexander Rothman <[gnomesort@megate.ch](mailto:gnomesort@megate.ch)>
+ * @copyright AGPL-3.0-or-later
+ * @date 2025
+ */
+#include "megatech/vulkan/internal/base/offscreen_renderer.hpp"
+
+#include <utility>
+
+#include <megatech/assertions.hpp>
+
+#include "megatech/vulkan/error.hpp"
+
+#define DECLARE_DEVICE_PFN(dt, cmd) MEGATECH_VULKAN_INTERNAL_BASE_DECLARE_DEVICE_PFN(dt, cmd)
+#define DECLARE_DEVICE_PFN_NO_THROW(dt, cmd) MEGATECH_VULKAN_INTERNAL_BASE_DECLARE_DEVICE_PFN_NO_THROW(dt, cmd)
+#define VK_CHECK(exp) MEGATECH_VULKAN_INTERNAL_BASE_VK_CHECK(exp)
+
+namespace {
+
+  VkDeviceSize texel_size(const VkFormat format) {
+    switch (format)
+    {
+    case VK_FORMAT_R8_UNORM:
+    case VK_FORMAT_R8_UINT:
+      return 1;
+    case VK_FORMAT_R8G8_UNORM:
+    case VK_FORMAT_R16_SFLOAT:
+    case VK_FORMAT_R16_UINT:
+      return 2;
+    case VK_FORMAT_R8G8B8A8_UNORM:
+    case VK_FORMAT_R8G8B8A8_SRGB:
+    case VK_FORMAT_R8G8B8A8_UINT:
+    case VK_FORMAT_B8G8R8A8_UNORM:
+    case VK_FORMAT_B8G8R8A8_SRGB:
+    case VK_FORMAT_A2B10G10R10_UNORM_PACK32:
+    case VK_FORMAT_R16G16_SFLOAT:
+    case VK_FORMAT_R32_SFLOAT:
+    case VK_FORMAT_R32_UINT:
+      return 4;
+    case VK_FORMAT_R16G16B16A16_SFLOAT:
+    case VK_FORMAT_R16G16B16A16_UNORM:
+    case VK_FORMAT_R32G32_SFLOAT:
+      return 8;
+    case VK_FORMAT_R32G32B32A32_SFLOAT:
+    case VK_FORMAT_R32G32B32A32_UINT:
+      return 16;
+    default:
+      throw megatech::vulkan::error{ "The offscreen color format isn't supported for readback." };
+    }
+  }
+
+  VkImageAspectFlags depth_aspect(const VkFormat format) {
+    switch (format)
+    {
+    case VK_FORMAT_D16_UNORM:
+    case VK_FORMAT_X8_D24_UNORM_PACK32:
+    case VK_FORMAT_D32_SFLOAT:
+      return VK_IMAGE_ASPECT_DEPTH_BIT;
+    case VK_FORMAT_D16_UNORM_S8_UINT:
+    case VK_FORMAT_D24_UNORM_S8_UINT:
+    case VK_FORMAT_D32_SFLOAT_S8_UINT:
+      return VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT;
+    default:
+      throw megatech::vulkan::error{ "The offscreen depth format isn't a depth format." };
+    }
+  }
+
+}
+
+namespace megatech::vulkan::internal::base {
+
+  offscreen_readback::offscreen_readback(const std::shared_ptr<buffer_pool>& pool, const buffer_allocation& buffer,
+                                         const VkDeviceSize size, const std::uint64_t timeline_value,
+                                         const VkExtent2D extent, const VkFormat format) :
+  m_pool{ pool },
+  m_buffer{ buffer },
+  m_size{ size },
+  m_timeline_value{ timeline_value },
+  m_extent{ extent },
+  m_format{ format } {
+    MEGATECH_PRECONDITION(m_pool != nullptr);
+    MEGATECH_PRECONDITION(m_buffer.allocation.mapped != nullptr);
+    MEGATECH_PRECONDITION(m_size <= m_buffer.size);
+  }
+
+  offscreen_readback::offscreen_readback(offscreen_readback&& other) noexcept :
+  m_pool{ std::exchange(other.m_pool, nullptr) },
+  m_buffer{ other.m_buffer },
+  m_size{ other.m_size },
+  m_timeline_value{ other.m_timeline_value },
+  m_extent{ other.m_extent },
+  m_format{ other.m_format },
+  m_invalidated{ other.m_invalidated } { }
+
+  offscreen_readback::~offscreen_readback() noexcept {
+    if (m_pool)
+    {
+      try
+      {
+        m_pool->release(m_buffer, m_timeline_value);
+      }
+      catch (...)
+      {
+        // Releasing only fails if the pool can't grow. The pool doesn't own the buffer until it's released, so it's
+        // destroyed here once the device is finished with it.
+        m_pool->parent().deletions().destroy_buffer(m_buffer, m_timeline_value);
+      }
+    }
+  }
+
+  offscreen_readback& offscreen_readback::operator=(offscreen_readback&& rhs) noexcept {
+    if (this != &rhs)
+    {
+      this->~offscreen_readback();
+      m_pool = std::exchange(rhs.m_pool, nullptr);
+      m_buffer = rhs.m_buffer;
+      m_size = rhs.m_size;
+      m_timeline_value = rhs.m_timeline_value;
+      m_extent = rhs.m_extent;
+      m_format = rhs.m_format;
+      m_invalidated = rhs.m_invalidated;
+    }
+    return *this;
+  }
+
+  std::uint64_t offscreen_readback::timeline_value() const {
+    return m_timeline_value;
+  }
+
+  VkExtent2D offscreen_readback::extent() const {
+    return m_extent;
+  }
+
+  VkFormat offscreen_readback::format() const {
+    return m_format;
+  }
+
+  bool offscreen_readback::is_ready() const {
+    MEGATECH_PRECONDITION(m_pool != nullptr);
+    return m_pool->parent().completed_timeline_value() >= m_timeline_value;
+  }
+
+  bool offscreen_readback::wait(const std::chrono::nanoseconds timeout) const {
+    MEGATECH_PRECONDITION(m_pool != nullptr);
+    return is_ready() || m_pool->parent().wait_for_timeline_value(m_timeline_value, timeout);
+  }
+
+  std::span<const std::byte> offscreen_readback::data() {
+    MEGATECH_PRECONDITION(m_pool != nullptr);
+    wait();
+    if (!m_invalidated && !(m_buffer.allocation.flags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT))
+    {
+      const auto& device = m_pool->parent();
+      auto range = VkMappedMemoryRange{ };
+      range.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+      range.memory = m_buffer.allocation.memory;
+      range.size = VK_WHOLE_SIZE;
+      DECLARE_DEVICE_PFN(device.dispatch_table(), vkInvalidateMappedMemoryRanges);
+      VK_CHECK(vkInvalidateMappedMemoryRanges(device.handle(), 1, &range));
+    }
+    m_invalidated = true;
+    return { static_cast<const std::byte*>(m_buffer.allocation.mapped), m_size };
+  }
+
+  void offscreen_renderer::destroy() noexcept {
+    DECLARE_DEVICE_PFN_NO_THROW(m_parent->dispatch_table(), vkDestroyImageView);
+    vkDestroyImageView(m_parent->handle(), m_depth_view, nullptr);
+    vkDestroyImageView(m_parent->handle(), m_color_view, nullptr);
+    m_parent->destroy_image(m_depth_image);
+    m_parent->destroy_image(m_color_image);
+  }
+
+  offscreen_renderer::offscreen_renderer(const std::shared_ptr<const parent_type>& parent, const VkExtent2D extent,
+                                         const VkFormat color_format, const VkFormat depth_format) :
+  m_parent{ parent },
+  m_extent{ extent },
+  m_color_format{ color_format },
+  m_depth_format{ depth_format } {
+    if (!m_parent)
+    {
+      throw error{ "The parent device cannot be null." };
+    }
+    if (!m_extent.width || !m_extent.height)
+    {
+      throw error{ "The offscreen render target must have a non-zero extent." };
+    }
+    m_readback_size = texel_size(m_color_format) * m_extent.width * m_extent.height;
+    const auto depth_aspect_flags = m_depth_format != VK_FORMAT_UNDEFINED ? depth_aspect(m_depth_format) : 0;
+    auto image_info = VkImageCreateInfo{ };
+    image_info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    image_info.imageType = VK_IMAGE_TYPE_2D;
+    image_info.format = m_color_format;
+    image_info.extent = { m_extent.width, m_extent.height, 1 };
+    image_info.mipLevels = 1;
+    image_info.arrayLayers = 1;
+    image_info.samples = VK_SAMPLE_COUNT_1_BIT;
+    image_info.tiling = VK_IMAGE_TILING_OPTIMAL;
+    image_info.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT |
+                       VK_IMAGE_USAGE_SAMPLED_BIT;
+    image_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    image_info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    auto view_info = VkImageViewCreateInfo{ };
+    view_info.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    view_info.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    view_info.subresourceRange.levelCount = 1;
+    view_info.subresourceRange.layerCount = 1;
+    DECLARE_DEVICE_PFN(m_parent->dispatch_table(), vkCreateImageView);
+    try
+    {
+      m_color_image = m_parent->create_image(image_info, 0, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+      view_info.image = m_color_image.image;
+      view_info.format = m_color_format;
+      view_info.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+      VK_CHECK(vkCreateImageView(m_parent->handle(), &view_info, nullptr, &m_color_view));
+      if (m_depth_format != VK_FORMAT_UNDEFINED)
+      {
+        image_info.format = m_depth_format;
+        image_info.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+        m_depth_image = m_parent->create_image(image_info, 0, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        view_info.image = m_depth_image.image;
+        view_info.format = m_depth_format;
+        view_info.subresourceRange.aspectMask = depth_aspect_flags;
+        VK_CHECK(vkCreateImageView(m_parent->handle(), &view_info, nullptr, &m_depth_view));
+      }
+      m_states.reset(new resource_state_tracker{ *m_parent });
+      view_info.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+      m_states->track_image(m_color_image.image, view_info.subresourceRange);
+      if (m_depth_image.image != VK_NULL_HANDLE)
+      {
+        view_info.subresourceRange.aspectMask = depth_aspect_flags;
+        m_states->track_image(m_depth_image.image, view_info.subresourceRange);
+      }
+      m_commands.reset(new command_buffer_pool{ m_parent, queue_type::primary });
+      // Readback buffers are read by the CPU, so cached memory is strongly preferred over write-combined memory.
+      m_readbacks.reset(new buffer_pool{ m_parent, VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                         VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, VK_MEMORY_PROPERTY_HOST_CACHED_BIT });
+    }
+    catch (...)
+    {
+      destroy();
+      throw;
+    }
+    MEGATECH_POSTCONDITION(m_color_image.image != VK_NULL_HANDLE);
+    MEGATECH_POSTCONDITION(m_color_view != VK_NULL_HANDLE);
+  }
+
+  offscreen_renderer::~offscreen_renderer() noexcept {
+    auto& deletions = m_parent->deletions();
+    deletions.destroy_image_view(m_depth_view, m_last_submitted);
+    deletions.destroy_image_view(m_color_view, m_last_submitted);
+    deletions.destroy_image(m_depth_image, m_last_submitted);
+    deletions.destroy_image(m_color_image, m_last_submitted);
+  }
+
+  const offscreen_renderer::parent_type& offscreen_renderer::parent() const {
+    MEGATECH_PRECONDITION(m_parent != nullptr);
+    return *m_parent;
+  }
+
+  VkExtent2D offscreen_renderer::extent() const {
+    return m_extent;
+  }
+
+  VkFormat offscreen_renderer::color_format() const {
+    return m_color_format;
+  }
+
+  VkFormat offscreen_renderer::depth_format() const {
+    return m_depth_format;
+  }
+
+  offscreen_readback offscreen_renderer::render(const VkClearColorValue& clear_color, const record_function& record) {
+    const auto& ddt = m_parent->dispatch_table();
+    DECLARE_DEVICE_PFN(ddt, vkCmdBeginRendering);
+    DECLARE_DEVICE_PFN(ddt, vkCmdEndRendering);
+    DECLARE_DEVICE_PFN(ddt, vkCmdSetViewport);
+    DECLARE_DEVICE_PFN(ddt, vkCmdSetScissor);
+    DECLARE_DEVICE_PFN(ddt, vkCmdCopyImageToBuffer);
+    // The render target is shared by every render, so renders are recorded one at a time. Execution still overlaps
+    // because nothing here waits on the device.
+    auto lock = std::unique_lock<std::mutex>{ m_mutex };
+    const auto readback = m_readbacks->acquire(m_readback_size);
+    const auto command_buffer = m_commands->acquire();
+    try
+    {
+      // Previous contents are discarded, so the only hazards are the previous render's copy and depth writes.
+      m_states->use_image(m_color_image.image, VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT,
+                          VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, true);
+      if (m_depth_image.image != VK_NULL_HANDLE)
+      {
+        m_states->use_image(m_depth_image.image, VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT |
+                                                 VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT,
+                            VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT |
+                            VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+                            VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, true);
+      }
+      m_states->flush(command_buffer);
+      auto color_attachment = VkRenderingAttachmentInfo{ };
+      color_attachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
+      color_attachment.imageView = m_color_view;
+      color_attachment.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+      color_attachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+      color_attachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+      color_attachment.clearValue.color = clear_color;
+      auto depth_attachment = VkRenderingAttachmentInfo{ };
+      depth_attachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
+      depth_attachment.imageView = m_depth_view;
+      depth_attachment.imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+      depth_attachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+      depth_attachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+      depth_attachment.clearValue.depthStencil.depth = 1.0f;
+      auto rendering_info = VkRenderingInfo{ };
+      rendering_info.sType = VK_STRUCTURE_TYPE_RENDERING_INFO;
+      rendering_info.renderArea.extent = m_extent;
+      rendering_info.layerCount = 1;
+      rendering_info.colorAttachmentCount = 1;
+      rendering_info.pColorAttachments = &color_attachment;
+      rendering_info.pDepthAttachment = m_depth_view != VK_NULL_HANDLE ? &depth_attachment : nullptr;
+      vkCmdBeginRendering(command_buffer, &rendering_info);
+      auto viewport = VkViewport{ };
+      viewport.width = m_extent.width;
+      viewport.height = m_extent.height;
+      viewport.maxDepth = 1.0f;
+      vkCmdSetViewport(command_buffer, 0, 1, &viewport);
+      vkCmdSetScissor(command_buffer, 0, 1, &rendering_info.renderArea);
+      if (record)
+      {
+        record(command_buffer);
+      }
+      vkCmdEndRendering(command_buffer);
+      m_states->use_image(m_color_image.image, VK_PIPELINE_STAGE_2_COPY_BIT, VK_ACCESS_2_TRANSFER_READ_BIT,
+                          VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+      m_states->track_buffer(readback.buffer);
+      m_states->use_buffer(readback.buffer, VK_PIPELINE_STAGE_2_COPY_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT);
+      m_states->flush(command_buffer);
+      auto region = VkBufferImageCopy{ };
+      region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+      region.imageSubresource.layerCount = 1;
+      region.imageExtent = { m_extent.width, m_extent.height, 1 };
+      vkCmdCopyImageToBuffer(command_buffer, m_color_image.image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                             readback.buffer, 1, &region);
+      m_states->use_buffer(readback.buffer, VK_PIPELINE_STAGE_2_HOST_BIT, VK_ACCESS_2_HOST_READ_BIT);
+      m_states->flush(command_buffer);
+      m_states->untrack_buffer(readback.buffer);
+    }
+    catch (...)
+    {
+      // Every render discards the render target, so dropping the pending uses can't leave a stale layout behind.
+      m_states->resolve();
+      m_states->untrack_buffer(readback.buffer);
+      m_commands->release(command_buffer, 0);
+      m_readbacks->release(readback, 0);
+      throw;
+    }
+    auto timeline_value = std::uint64_t{ };
+    try
+    {
+      timeline_value = m_commands->submit(command_buffer);
+    }
+    catch (...)
+    {
+      m_readbacks->release(readback, 0);
+      throw;
+    }
+    m_last_submitted = timeline_value;
+    return offscreen_readback{ m_readbacks, readback, m_readback_size, timeline_value, m_extent, m_color_format };
+  }
+
+}
@@ -9,8 +9,12 @@
 
 #include <cstring>
 
+#include <array>
 #include <bit>
 #include <algorithm>
+#include <future>
+#include <limits>
+#include <thread>
 #include <type_traits>
 
 #include <megatech/assertions.hpp>
@@ -23,104 +27,99 @@
 #define DECLARE_INSTANCE_PFN(dt, cmd) MEGATECH_VULKAN_INTERNAL_BASE_DECLARE_INSTANCE_PFN(dt, cmd)
 #define VK_CHECK(exp) MEGATECH_VULKAN_INTERNAL_BASE_VK_CHECK(exp)
 
-// Allegedly, Microsoft ignores [[no_unique_address]], even in C++20 mode. The MSVC specific attribute shouldn't be
-// ignored.
-#ifdef CONFIG_COMPILER_MSVC
-  #define NO_UNIQUE_ADDRESS_ATTR [[msvc::no_unique_address]]
-#else
-  #define NO_UNIQUE_ADDRESS_ATTR [[no_unique_address]]
-#endif
-
-// All of this stuff is so that I can safely compare and merge Vulkan features in a way that isn't disastrously
-// unmaintainable. It is, merely, sort of unmaintainable.
 namespace {
 
-  template <typename Type>
-  concept vk_extended_feature_type = requires (Type&& t) {
-    alignof(Type) >= sizeof(VkBool32);
-    { t.sType } -> std::convertible_to<VkStructureType>;
-    { t.pNext } -> std::convertible_to<void*>;
-  };
-
-  template <std::size_t Padding>
-  struct padding final {
-    char pad[Padding];
+  struct format_range final {
+    std::uint32_t first;
+    std::uint32_t count;
+    const char* extension;
   };
 
-  struct empty final { };
-
-  template <vk_extended_feature_type Type>
-  struct padded_feature final {
-    VkBool32 value;
-
-    // This is required to ensure that pad is 0 when sizeof(void*) <= 4.
-    NO_UNIQUE_ADDRESS_ATTR
-    std::conditional_t<(alignof(Type) > sizeof(VkBool32)), padding<alignof(Type) - sizeof(VkBool32)>, empty> pad;
+  constexpr format_range make_format_range(const VkFormat first, const VkFormat last,
+                                           const char *const extension = nullptr) {
+    return { static_cast<std::uint32_t>(first), static_cast<std::uint32_t>(last) - first + 1, extension };
+  }
+
+  // The format table is a concatenation of these ranges. The first range is every Vulkan 1.0 format. The next is the
+  // Vulkan 1.1 YCbCr formats. The next three are the Vulkan 1.3 formats. The rest belong to extensions, and they're
+  // only queried when the extension is available. VK_NV_optical_flow's format is left out because it's only valid for
+  // optical flow images, which have their own format query.
+  constexpr auto format_ranges = std::array{
+    make_format_range(VK_FORMAT_UNDEFINED, VK_FORMAT_ASTC_12x12_SRGB_BLOCK),
+    make_format_range(VK_FORMAT_G8B8G8R8_422_UNORM, VK_FORMAT_G16_B16_R16_3PLANE_444_UNORM),
+    make_format_range(VK_FORMAT_ASTC_4x4_SFLOAT_BLOCK, VK_FORMAT_ASTC_12x12_SFLOAT_BLOCK),
+    make_format_range(VK_FORMAT_G8_B8R8_2PLANE_444_UNORM, VK_FORMAT_G16_B16R16_2PLANE_444_UNORM),
+    make_format_range(VK_FORMAT_A4R4G4B4_UNORM_PACK16, VK_FORMAT_A4B4G4R4_UNORM_PACK16),
+    make_format_range(VK_FORMAT_PVRTC1_2BPP_UNORM_BLOCK_IMG, VK_FORMAT_PVRTC2_4BPP_SRGB_BLOCK_IMG,
+                      "VK_IMG_format_pvrtc"),
+    make_format_range(VK_FORMAT_A1B5G5R5_UNORM_PACK16_KHR, VK_FORMAT_A8_UNORM_KHR, "VK_KHR_maintenance5")
   };
 
-  template <vk_extended_feature_type Type>
-  constexpr std::size_t feature_count() {
-    return (sizeof(Type) - (alignof(Type) << 1)) / sizeof(padded_feature<Type>);
+  constexpr std::size_t format_table_size() {
+    auto result = std::size_t{ 0 };
+    for (const auto& range : format_ranges)
+    {
+      result += range.count;
+    }
+    return result;
   }
 
-  template <vk_extended_feature_type Type>
-  struct extended_feature_array final {
-    VkStructureType sType;
-    void* pNext;
-    padded_feature<Type> elements[feature_count<Type>()];
-  };
-
-  struct basic_feature_array final {
-    VkBool32 elements[sizeof(VkPhysicalDeviceFeatures) / sizeof(VkBool32)];
-  };
-
-  // featurecmp works by converting VkPhysicalDevice*Features* into an array-esque type and then doing the
-  // comparison iteratively. If a feature is enabled in required but not enabled in actual the test fails.
-  template <vk_extended_feature_type Feature>
-  bool featurecmp(const Feature& actual, const Feature& required) {
-    const auto a_arr = std::bit_cast<extended_feature_array<Feature>>(actual);
-    const auto r_arr = std::bit_cast<extended_feature_array<Feature>>(required);
-    for (auto i = std::size_t{ 0 }; i < feature_count<Feature>(); ++i)
+  const format_range* find_format_range(const VkFormat format) {
+    const auto value = static_cast<std::uint32_t>(format);
+    for (const auto& range : format_ranges)
     {
-      if (r_arr.elements[i].value && !a_arr.elements[i].value)
+      if (value >= range.first && value - range.first < range.count)
       {
-        return false;
+        return &range;
       }
     }
-    return true;
+    return nullptr;
   }
 
-  bool featurecmp(const VkPhysicalDeviceFeatures& actual, const VkPhysicalDeviceFeatures& required) {
-    const auto a_arr = std::bit_cast<basic_feature_array>(actual);
-    const auto r_arr = std::bit_cast<basic_feature_array>(required);
-    for (auto i = std::size_t{ 0 }; i < (sizeof(VkPhysicalDeviceFeatures) / sizeof(VkBool32)); ++i)
+  std::int64_t format_table_index(const VkFormat format) {
+    const auto value = static_cast<std::uint32_t>(format);
+    auto base = std::int64_t{ 0 };
+    for (const auto& range : format_ranges)
     {
-      if (r_arr.elements[i] && !a_arr.elements[i])
+      if (value >= range.first && value - range.first < range.count)
       {
-        return false;
+        return base + (value - range.first);
       }
+      base += range.count;
     }
-    return true;
+    return -1;
   }
 
-  // This is similar to featurecmp. Instead of comparing though we merge two sets of features iteratively.
-  template <vk_extended_feature_type Feature>
-  Feature featuremerge(const Feature& a, const Feature& b) {
-    auto a_arr = std::bit_cast<extended_feature_array<Feature>>(a);
-    const auto b_arr = std::bit_cast<extended_feature_array<Feature>>(b);
-    for (auto i = std::size_t{ 0 }; i < feature_count<Feature>(); ++i) {
-      a_arr.elements[i].value = a_arr.elements[i].value || b_arr.elements[i].value;
-    }
-    return std::bit_cast<Feature>(a_arr);
-  }
+  struct memory_usage_ranking final {
+    VkMemoryPropertyFlags required;
+    VkMemoryPropertyFlags preferred;
+    VkMemoryPropertyFlags avoided;
+  };
+
+  // These are indexed by memory_usage.
+  constexpr auto memory_usage_rankings = std::array{
+    memory_usage_ranking{ 0, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT },
+    memory_usage_ranking{ VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, 0,
+                          VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_CACHED_BIT },
+    memory_usage_ranking{ VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                          VK_MEMORY_PROPERTY_HOST_CACHED_BIT, 0 },
+    memory_usage_ranking{ VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                          VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, VK_MEMORY_PROPERTY_HOST_CACHED_BIT }
+  };
 
-  VkPhysicalDeviceFeatures featuremerge(const VkPhysicalDeviceFeatures& a, const VkPhysicalDeviceFeatures& b) {
-    auto a_arr = std::bit_cast<basic_feature_array>(a);
-    const auto b_arr = std::bit_cast<basic_feature_array>(b);
-    for (auto i = std::size_t{ 0 }; i < (sizeof(VkPhysicalDeviceFeatures) / sizeof(VkBool32)); ++i) {
-      a_arr.elements[i] = a_arr.elements[i] || b_arr.elements[i];
+  constexpr auto ineligible_memory_score = std::numeric_limits<int>::min();
+
+  int memory_score(const VkMemoryPropertyFlags flags, const megatech::vulkan::internal::base::memory_usage usage) {
+    constexpr auto excluded = VkMemoryPropertyFlags{ VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT |
+                                                     VK_MEMORY_PROPERTY_PROTECTED_BIT |
+                                                     VK_MEMORY_PROPERTY_DEVICE_COHERENT_BIT_AMD |
+                                                     VK_MEMORY_PROPERTY_DEVICE_UNCACHED_BIT_AMD };
+    const auto& ranking = memory_usage_rankings[static_cast<std::size_t>(usage)];
+    if ((flags & excluded) || (flags & ranking.required) != ranking.required)
+    {
+      return ineligible_memory_score;
     }
-    return std::bit_cast<VkPhysicalDeviceFeatures>(a_arr);
+    return std::popcount(flags & ranking.preferred) - std::popcount(flags & ranking.avoided);
   }
 
 }
@@ -169,7 +168,7 @@ namespace megatech::vulkan::internal::base {
   }
 
   void physical_device_description_impl::append_extended_feature_chain(void *const next) {
-    m_dynamic_rendering_local_read_features.pNext = next;
+    m_required_dynamic_rendering_local_read_features.pNext = next;
   }
 
   bool physical_device_description_impl::has_extended_features() const {
@@ -188,24 +187,16 @@ namespace megatech::vulkan::internal::base {
     {
       throw error{ "The physical device handle cannot be null." };
     }
-    auto properties2 = VkPhysicalDeviceProperties2{ };
-    properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
     m_properties_1_1.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_1_PROPERTIES;
-    properties2.pNext = &m_properties_1_1;
-    m_properties_1_2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_PROPERTIES;
     m_properties_1_1.pNext = &m_properties_1_2;
-    m_properties_1_3.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_PROPERTIES;
+    m_properties_1_2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_PROPERTIES;
     m_properties_1_2.pNext = &m_properties_1_3;
+    m_properties_1_3.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_PROPERTIES;
     m_properties_1_3.pNext = nullptr;
-    DECLARE_INSTANCE_PFN(m_parent->dispatch_table(), vkGetPhysicalDeviceProperties2);
-    vkGetPhysicalDeviceProperties2(m_handle, &properties2);
+    m_properties_1_0 = query_properties(&m_properties_1_1);
     m_properties_1_3.pNext = nullptr;
     m_properties_1_2.pNext = nullptr;
     m_properties_1_1.pNext = nullptr;
-    m_properties_1_0 = properties2.properties;
-    auto features2 = VkPhysicalDeviceFeatures2{ };
-    features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
-    features2.pNext = &m_features_1_1;
     m_features_1_1.pNext = &m_features_1_2;
     m_features_1_1.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_1_FEATURES;
     m_features_1_2.pNext = &m_features_1_3;
@@ -215,25 +206,96 @@ namespace megatech::vulkan::internal::base {
     m_dynamic_rendering_local_read_features.pNext = nullptr;
     m_dynamic_rendering_local_read_features.sType =
       VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_LOCAL_READ_FEATURES_KHR;
-    DECLARE_INSTANCE_PFN(m_parent->dispatch_table(), vkGetPhysicalDeviceFeatures2);
-    vkGetPhysicalDeviceFeatures2(m_handle, &features2);
+    m_features_1_0 = query_features(&m_features_1_1);
     m_features_1_3.pNext = nullptr;
     m_features_1_2.pNext = nullptr;
     m_features_1_1.pNext = nullptr;
-    m_features_1_0 = features2.features;
     m_required_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
     m_required_features.pNext = &m_required_features_1_1;
+    // Sparse residency is optional. It's enabled wherever it's available so that sparse resources can be created
+    // without the caller knowing about it in advance.
+    m_required_features.features.sparseBinding = m_features_1_0.sparseBinding;
+    m_required_features.features.sparseResidencyBuffer = m_features_1_0.sparseResidencyBuffer;
+    m_required_features.features.sparseResidencyImage2D = m_features_1_0.sparseResidencyImage2D;
     m_required_features_1_1.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_1_FEATURES;
     m_required_features_1_1.pNext = &m_required_features_1_2;
     m_required_features_1_2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
     m_required_features_1_2.pNext = &m_required_features_1_3;
+    m_required_features_1_2.timelineSemaphore = VK_TRUE;
+    m_required_features_1_2.bufferDeviceAddress = VK_TRUE;
     m_required_features_1_3.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES;
     m_required_features_1_3.pNext = &m_required_dynamic_rendering_local_read_features;
     m_required_features_1_3.dynamicRendering = VK_TRUE;
+    m_required_features_1_3.synchronization2 = VK_TRUE;
     m_required_dynamic_rendering_local_read_features.sType =
       VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_LOCAL_READ_FEATURES_KHR;
     m_required_dynamic_rendering_local_read_features.pNext = nullptr;
     m_required_dynamic_rendering_local_read_features.dynamicRenderingLocalRead = true;
+    DECLARE_INSTANCE_PFN(m_parent->dispatch_table(), vkGetPhysicalDeviceMemoryProperties);
+    vkGetPhysicalDeviceMemoryProperties(m_handle, &m_memory_properties);
+    {
+      // Types with the same flags and heap are interchangeable, so they're ranked as a single class. Each class is
+      // ordered by its first type, which preserves the driver's ordering when breaking ties.
+      auto classes = std::array<std::uint8_t, VK_MAX_MEMORY_TYPES>{ };
+      for (auto i = std::uint32_t{ 0 }; i < m_memory_properties.memoryTypeCount; ++i)
+      {
+        const auto& type = m_memory_properties.memoryTypes[i];
+        auto j = std::uint32_t{ 0 };
+        for (; j < i; ++j)
+        {
+          const auto& other = m_memory_properties.memoryTypes[j];
+          if (other.propertyFlags == type.propertyFlags && other.heapIndex == type.heapIndex)
+          {
+            break;
+          }
+        }
+        classes[i] = j == i ? m_memory_class_count++ : classes[j];
+        if (classes[i] < m_memory_class_types.size())
+        {
+          m_memory_class_types[classes[i]] |= 1u << i;
+        }
+      }
+      if (m_memory_class_count <= m_memory_class_types.size())
+      {
+        for (auto byte = std::size_t{ 0 }; byte < m_memory_class_masks.size(); ++byte)
+        {
+          for (auto value = std::uint32_t{ 0 }; value < m_memory_class_masks[byte].size(); ++value)
+          {
+            for (auto bit = std::uint32_t{ 0 }; bit < 8; ++bit)
+            {
+              const auto i = byte * 8 + bit;
+              if ((value & (1u << bit)) && i < m_memory_properties.memoryTypeCount)
+              {
+                m_memory_class_masks[byte][value] |= 1u << classes[i];
+              }
+            }
+          }
+        }
+        for (auto usage = std::size_t{ 0 }; usage < m_memory_usage_classes.size(); ++usage)
+        {
+          m_memory_usage_classes[usage].fill(-1);
+          for (auto mask = std::uint32_t{ 1 }; mask < (1u << m_memory_class_count); ++mask)
+          {
+            auto best_score = ineligible_memory_score;
+            for (auto c = std::uint32_t{ 0 }; c < m_memory_class_count; ++c)
+            {
+              if (!(mask & (1u << c)))
+              {
+                continue;
+              }
+              const auto first = std::countr_zero(m_memory_class_types[c]);
+              const auto score = memory_score(m_memory_properties.memoryTypes[first].propertyFlags,
+                                              static_cast<memory_usage>(usage));
+              if (score > best_score)
+              {
+                best_score = score;
+                m_memory_usage_classes[usage][mask] = c;
+              }
+            }
+          }
+        }
+      }
+    }
     DECLARE_INSTANCE_PFN(m_parent->dispatch_table(), vkEnumerateDeviceExtensionProperties);
     {
       auto sz = std::uint32_t{ 0 };
@@ -255,6 +317,51 @@ namespace megatech::vulkan::internal::base {
         }
       }
     }
+    DECLARE_INSTANCE_PFN(m_parent->dispatch_table(), vkGetPhysicalDeviceFormatProperties2);
+    {
+      m_format_features.resize(format_table_size());
+      auto formats = std::vector<std::pair<VkFormat, std::size_t>>{ };
+      auto base = std::size_t{ 0 };
+      for (const auto& range : format_ranges)
+      {
+        if (!range.extension || m_available_extensions.contains(range.extension))
+        {
+          for (auto i = std::uint32_t{ 0 }; i < range.count; ++i)
+          {
+            formats.emplace_back(static_cast<VkFormat>(range.first + i), base + i);
+          }
+        }
+        base += range.count;
+      }
+      // Physical device queries don't require external synchronization, so the table is split across a few threads.
+      // Each thread writes to a disjoint part of it.
+      const auto query = [&](const std::size_t first, const std::size_t last) {
+        for (auto i = first; i < last; ++i)
+        {
+          auto properties3 = VkFormatProperties3{ };
+          properties3.sType = VK_STRUCTURE_TYPE_FORMAT_PROPERTIES_3;
+          auto properties2 = VkFormatProperties2{ };
+          properties2.sType = VK_STRUCTURE_TYPE_FORMAT_PROPERTIES_2;
+          properties2.pNext = &properties3;
+          vkGetPhysicalDeviceFormatProperties2(m_handle, formats[i].first, &properties2);
+          m_format_features[formats[i].second] = { properties3.linearTilingFeatures,
+                                                   properties3.optimalTilingFeatures, properties3.bufferFeatures };
+        }
+      };
+      const auto thread_count = std::size_t{ std::clamp(std::thread::hardware_concurrency(), 1U, 4U) };
+      const auto per_thread = (formats.size() + thread_count - 1) / thread_count;
+      auto workers = std::vector<std::future<void>>{ };
+      for (auto first = per_thread; first < formats.size(); first += per_thread)
+      {
+        const auto last = std::min(first + per_thread, formats.size());
+        workers.emplace_back(std::async(std::launch::async, query, first, last));
+      }
+      query(0, std::min(per_thread, formats.size()));
+      for (auto& worker : workers)
+      {
+        worker.get();
+      }
+    }
     DECLARE_INSTANCE_PFN(m_parent->dispatch_table(), vkGetPhysicalDeviceQueueFamilyProperties);
     {
       auto sz = std::uint32_t{ 0 };
@@ -330,6 +437,8 @@ namespace megatech::vulkan::internal::base {
     MEGATECH_POSTCONDITION(m_primary_queue_family < static_cast<std::int64_t>(m_queue_family_properties.size()));
     MEGATECH_POSTCONDITION(m_async_compute_queue_family < static_cast<std::int64_t>(m_queue_family_properties.size()));
     MEGATECH_POSTCONDITION(m_async_transfer_queue_family < static_cast<std::int64_t>(m_queue_family_properties.size()));
+    MEGATECH_POSTCONDITION(m_memory_properties.memoryHeapCount <= VK_MAX_MEMORY_HEAPS);
+    MEGATECH_POSTCONDITION(m_memory_properties.memoryTypeCount <= VK_MAX_MEMORY_TYPES);
     MEGATECH_POSTCONDITION(m_required_extensions.contains("VK_KHR_dynamic_rendering_local_read"));
     MEGATECH_POSTCONDITION(m_required_features.pNext == &m_required_features_1_1);
     MEGATECH_POSTCONDITION(m_required_features.sType == VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2);
@@ -337,10 +446,12 @@ namespace megatech::vulkan::internal::base {
     MEGATECH_POSTCONDITION(m_required_features_1_1.sType == VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_1_FEATURES);
     MEGATECH_POSTCONDITION(m_required_features_1_2.pNext == &m_required_features_1_3);
     MEGATECH_POSTCONDITION(m_required_features_1_2.sType == VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES);
+    MEGATECH_POSTCONDITION(m_required_features_1_2.timelineSemaphore == VK_TRUE);
+    MEGATECH_POSTCONDITION(m_required_features_1_2.bufferDeviceAddress == VK_TRUE);
     MEGATECH_POSTCONDITION(m_required_features_1_3.pNext == &m_required_dynamic_rendering_local_read_features);
     MEGATECH_POSTCONDITION(m_required_features_1_3.sType == VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES);
     MEGATECH_POSTCONDITION(m_required_features_1_3.dynamicRendering == VK_TRUE);
-    MEGATECH_POSTCONDITION(m_required_dynamic_rendering_local_read_features.pNext == nullptr);
+    MEGATECH_POSTCONDITION(m_required_features_1_3.synchronization2 == VK_TRUE);
     MEGATECH_POSTCONDITION(m_required_dynamic_rendering_local_read_features.sType ==
                            VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_LOCAL_READ_FEATURES_KHR);
     MEGATECH_POSTCONDITION(m_required_dynamic_rendering_local_read_features.dynamicRenderingLocalRead == VK_TRUE);
@@ -388,6 +499,163 @@ namespace megatech::vulkan::internal::base {
     return m_features_1_3;
   }
 
+  std::size_t physical_device_description_impl::allocate_property_slot() {
+    static auto next_slot = std::atomic<std::size_t>{ 0 };
+    return next_slot.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  const void* physical_device_description_impl::cache_properties(const std::size_t slot,
+                                                                 const std::shared_ptr<void>& storage) const {
+    if (slot >= m_cached_properties.size())
+    {
+      throw error{ "Too many different property structures have been requested." };
+    }
+    auto lock = std::lock_guard{ m_cached_properties_mutex };
+    // Another thread may have finished the same query while this one was waiting.
+    if (const auto* cached = m_cached_properties[slot].load(std::memory_order_relaxed); cached)
+    {
+      return cached;
+    }
+    query_properties(storage.get());
+    m_cached_property_storage[slot] = storage;
+    m_cached_properties[slot].store(storage.get(), std::memory_order_release);
+    MEGATECH_POSTCONDITION(m_cached_property_storage[slot] != nullptr);
+    return storage.get();
+  }
+
+  VkPhysicalDeviceFeatures physical_device_description_impl::query_features(void *const next) const {
+    auto features2 = VkPhysicalDeviceFeatures2{ };
+    features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    features2.pNext = next;
+    DECLARE_INSTANCE_PFN(m_parent->dispatch_table(), vkGetPhysicalDeviceFeatures2);
+    vkGetPhysicalDeviceFeatures2(m_handle, &features2);
+    return features2.features;
+  }
+
+  VkPhysicalDeviceProperties physical_device_description_impl::query_properties(void *const next) const {
+    auto properties2 = VkPhysicalDeviceProperties2{ };
+    properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+    properties2.pNext = next;
+    DECLARE_INSTANCE_PFN(m_parent->dispatch_table(), vkGetPhysicalDeviceProperties2);
+    vkGetPhysicalDeviceProperties2(m_handle, &properties2);
+    return properties2.properties;
+  }
+
+  const VkPhysicalDeviceMemoryProperties& physical_device_description_impl::memory_properties() const {
+    return m_memory_properties;
+  }
+
+  std::int64_t physical_device_description_impl::memory_type_index(const std::uint32_t type_bits,
+                                                                   const VkMemoryPropertyFlags required,
+                                                                   const VkMemoryPropertyFlags preferred) const {
+    auto result = std::int64_t{ -1 };
+    auto best_score = -1;
+    for (auto i = std::uint32_t{ 0 }; i < m_memory_properties.memoryTypeCount; ++i)
+    {
+      const auto flags = m_memory_properties.memoryTypes[i].propertyFlags;
+      if (!(type_bits & (1u << i)) || (flags & required) != required)
+      {
+        continue;
+      }
+      const auto score = std::popcount(flags & preferred);
+      if (score > best_score)
+      {
+        best_score = score;
+        result = i;
+      }
+    }
+    MEGATECH_POSTCONDITION(result < static_cast<std::int64_t>(m_memory_properties.memoryTypeCount));
+    return result;
+  }
+
+  std::int64_t physical_device_description_impl::memory_type_index(const std::uint32_t type_bits,
+                                                                   const memory_usage usage) const {
+    MEGATECH_PRECONDITION(static_cast<std::size_t>(usage) < m_memory_usage_classes.size());
+    if (m_memory_class_count > m_memory_class_types.size())
+    {
+      auto result = std::int64_t{ -1 };
+      auto best_score = ineligible_memory_score;
+      for (auto i = std::uint32_t{ 0 }; i < m_memory_properties.memoryTypeCount; ++i)
+      {
+        const auto score = memory_score(m_memory_properties.memoryTypes[i].propertyFlags, usage);
+        if ((type_bits & (1u << i)) && score > best_score)
+        {
+          best_score = score;
+          result = i;
+        }
+      }
+      return result;
+    }
+    const auto mask = m_memory_class_masks[0][type_bits & 0xff] | m_memory_class_masks[1][(type_bits >> 8) & 0xff] |
+                      m_memory_class_masks[2][(type_bits >> 16) & 0xff] | m_memory_class_masks[3][type_bits >> 24];
+    const auto selected = m_memory_usage_classes[static_cast<std::size_t>(usage)][mask];
+    if (selected == -1)
+    {
+      return -1;
+    }
+    const auto result = std::int64_t{ std::countr_zero(type_bits & m_memory_class_types[selected]) };
+    MEGATECH_POSTCONDITION(result < static_cast<std::int64_t>(m_memory_properties.memoryTypeCount));
+    return result;
+  }
+
+  std::int64_t physical_device_description_impl::host_visible_device_local_heap_index() const {
+    constexpr auto flags = VkMemoryPropertyFlags{ VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT |
+                                                  VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                                                  VK_MEMORY_PROPERTY_HOST_COHERENT_BIT };
+    auto result = std::int64_t{ -1 };
+    for (auto i = std::uint32_t{ 0 }; i < m_memory_properties.memoryTypeCount; ++i)
+    {
+      const auto& type = m_memory_properties.memoryTypes[i];
+      if ((type.propertyFlags & flags) != flags)
+      {
+        continue;
+      }
+      if (result == -1 || m_memory_properties.memoryHeaps[type.heapIndex].size >
+                          m_memory_properties.memoryHeaps[result].size)
+      {
+        result = type.heapIndex;
+      }
+    }
+    MEGATECH_POSTCONDITION(result < static_cast<std::int64_t>(m_memory_properties.memoryHeapCount));
+    return result;
+  }
+
+  const format_feature_flags& physical_device_description_impl::format_features(const VkFormat format) const {
+    static constexpr auto unsupported = format_feature_flags{ };
+    const auto index = format_table_index(format);
+    if (index == -1)
+    {
+      return unsupported;
+    }
+    MEGATECH_PRECONDITION(static_cast<std::size_t>(index) < m_format_features.size());
+    return m_format_features[index];
+  }
+
+  const format_feature_flags&
+  physical_device_description_impl::format_features(const VkFormat format,
+                                                    const std::unordered_set<std::string>& enabled_extensions) const {
+    static constexpr auto unsupported = format_feature_flags{ };
+    const auto range = find_format_range(format);
+    if (range && range->extension && !enabled_extensions.contains(range->extension))
+    {
+      return unsupported;
+    }
+    return format_features(format);
+  }
+
+  bool physical_device_description_impl::has_format_features(const VkFormat format, const VkImageTiling tiling,
+                                                             const VkFormatFeatureFlags2 features) const {
+    MEGATECH_PRECONDITION(tiling == VK_IMAGE_TILING_LINEAR || tiling == VK_IMAGE_TILING_OPTIMAL);
+    const auto& supported = format_features(format);
+    const auto flags = tiling == VK_IMAGE_TILING_LINEAR ? supported.linear_tiling : supported.optimal_tiling;
+    return (flags & features) == features;
+  }
+
+  bool physical_device_description_impl::has_buffer_format_features(const VkFormat format,
+                                                                    const VkFormatFeatureFlags2 features) const {
+    return (format_features(format).buffer & features) == features;
+  }
+
   const std::unordered_set<std::string>& physical_device_description_impl::available_extensions() const {
     return m_available_extensions;
   }
@@ -411,6 +679,28 @@ namespace megatech::vulkan::internal::base {
     return m_async_transfer_queue_family;
   }
 
+  int64_t physical_device_description_impl::sparse_binding_queue_family_index() const {
+    const auto supports_sparse_binding = [this](const std::int64_t family) {
+      return family != -1 && (m_queue_family_properties[family].queueFlags & VK_QUEUE_SPARSE_BINDING_BIT);
+    };
+    for (const auto family : std::array{ m_async_transfer_queue_family, m_async_compute_queue_family,
+                                         m_primary_queue_family })
+    {
+      if (supports_sparse_binding(family))
+      {
+        return family;
+      }
+    }
+    for (auto i = std::int64_t{ 0 }; i < static_cast<std::int64_t>(m_queue_family_properties.size()); ++i)
+    {
+      if (supports_sparse_binding(i))
+      {
+        return i;
+      }
+    }
+    return -1;
+  }
+
   const VkQueueFamilyProperties& physical_device_description_impl::primary_queue_family_properties() const {
     MEGATECH_PRECONDITION(m_primary_queue_family < static_cast<std::int64_t>(m_queue_family_properties.size()));
     if (m_primary_queue_family == -1)
@@ -471,7 +761,6 @@ namespace megatech::vulkan::internal::base {
     MEGATECH_PRECONDITION(m_required_features_1_3.pNext == &m_required_dynamic_rendering_local_read_features);
     MEGATECH_PRECONDITION(m_required_features_1_3.sType == VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES);
     MEGATECH_PRECONDITION(m_required_features_1_3.dynamicRendering == VK_TRUE);
-    MEGATECH_PRECONDITION(m_required_dynamic_rendering_local_read_features.pNext == nullptr);
     MEGATECH_PRECONDITION(m_required_dynamic_rendering_local_read_features.sType ==
                           VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_LOCAL_READ_FEATURES_KHR);
     MEGATECH_PRECONDITION(m_required_dynamic_rendering_local_read_features.dynamicRenderingLocalRead == VK_TRUE);
@@ -0,0 +1,696 @@
+/**
+ * @file render_graph.cpp
+ * @brief Frame Graph With Transient Resource Aliasing
+ * @author Alexander Rothman <[gnomesort@megate.ch](mailto:gnomesort@megate.ch)>
+ * @copyright AGPL-3.0-or-later
+ * @date 2025
+ */
+#include "megatech/vulkan/internal/base/render_graph.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <set>
+#include <utility>
+
+#include <megatech/assertions.hpp>
+
+#include "megatech/vulkan/error.hpp"
+
+#define DECLARE_DEVICE_PFN(dt, cmd) MEGATECH_VULKAN_INTERNAL_BASE_DECLARE_DEVICE_PFN(dt, cmd)
+#define DECLARE_DEVICE_PFN_NO_THROW(dt, cmd) MEGATECH_VULKAN_INTERNAL_BASE_DECLARE_DEVICE_PFN_NO_THROW(dt, cmd)
+#define VK_CHECK(exp) MEGATECH_VULKAN_INTERNAL_BASE_VK_CHECK(exp)
+
+namespace {
+
+  using megatech::vulkan::internal::base::queue_type;
+
+  constexpr VkImageUsageFlags attachment_usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT |
+                                                 VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT |
+                                                 VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT;
+
+  constexpr std::array<queue_type, 2> graph_queues{ queue_type::primary, queue_type::async_compute };
+
+  std::uint32_t queue_index(const queue_type type) {
+    return type == queue_type::async_compute;
+  }
+
+  VkImageViewType view_type(const VkImageCreateInfo& image_info) {
+    switch (image_info.imageType)
+    {
+    case VK_IMAGE_TYPE_1D:
+      return image_info.arrayLayers > 1 ? VK_IMAGE_VIEW_TYPE_1D_ARRAY : VK_IMAGE_VIEW_TYPE_1D;
+    case VK_IMAGE_TYPE_3D:
+      return VK_IMAGE_VIEW_TYPE_3D;
+    default:
+      return image_info.arrayLayers > 1 ? VK_IMAGE_VIEW_TYPE_2D_ARRAY : VK_IMAGE_VIEW_TYPE_2D;
+    }
+  }
+
+}
+
+namespace megatech::vulkan::internal::base {
+
+  void render_graph::destroy() noexcept {
+    const auto device = m_parent->handle();
+    const auto& ddt = m_parent->dispatch_table();
+    DECLARE_DEVICE_PFN_NO_THROW(ddt, vkDestroyImageView);
+    DECLARE_DEVICE_PFN_NO_THROW(ddt, vkDestroyImage);
+    DECLARE_DEVICE_PFN_NO_THROW(ddt, vkDestroyBuffer);
+    for (auto& current : m_resources)
+    {
+      if (current.imported)
+      {
+        continue;
+      }
+      vkDestroyImageView(device, current.view, nullptr);
+      vkDestroyImage(device, current.image, nullptr);
+      vkDestroyBuffer(device, current.buffer, nullptr);
+      current.view = VK_NULL_HANDLE;
+      current.image = VK_NULL_HANDLE;
+      current.buffer = VK_NULL_HANDLE;
+    }
+    for (auto& block : m_blocks)
+    {
+      m_parent->free_memory(block.allocation);
+    }
+    m_blocks.clear();
+  }
+
+  void render_graph::check_mutable() const {
+    if (m_compiled)
+    {
+      throw error{ "The render graph can't be modified after it's compiled." };
+    }
+  }
+
+  void render_graph::declare(const pass_id pass, const resource_id resource, const VkPipelineStageFlags2 stages,
+                             const VkAccessFlags2 accesses, const VkImageLayout layout, const bool write) {
+    check_mutable();
+    if (pass >= m_passes.size() || resource >= m_resources.size())
+    {
+      throw error{ "The pass or resource doesn't belong to the render graph." };
+    }
+    if (m_resources[resource].is_image && layout == VK_IMAGE_LAYOUT_UNDEFINED)
+    {
+      throw error{ "Passes must declare the layout of every image that they access." };
+    }
+    m_passes[pass].accesses.emplace_back(resource, stages, accesses, layout, write);
+  }
+
+  void render_graph::cull() {
+    // Passes are kept if they have side effects or write imported resources. Everything that they read is kept
+    // recursively.
+    auto alive = std::vector<bool>(m_passes.size());
+    auto pending = std::vector<pass_id>{ };
+    for (auto i = pass_id{ 0 }; i < m_passes.size(); ++i)
+    {
+      const auto& current = m_passes[i];
+      if (current.side_effects || std::ranges::any_of(current.accesses, [&](const auto& use) {
+        return use.write && m_resources[use.resource].imported;
+      }))
+      {
+        alive[i] = true;
+        pending.emplace_back(i);
+      }
+    }
+    while (!pending.empty())
+    {
+      const auto reader = pending.back();
+      pending.pop_back();
+      for (const auto& use : m_passes[reader].accesses)
+      {
+        if (use.write)
+        {
+          continue;
+        }
+        auto written = m_resources[use.resource].imported;
+        for (auto writer = pass_id{ 0 }; writer < reader; ++writer)
+        {
+          const auto writes = std::ranges::any_of(m_passes[writer].accesses, [&](const auto& other) {
+            return other.write && other.resource == use.resource;
+          });
+          written = written || writes;
+          if (writes && !alive[writer])
+          {
+            alive[writer] = true;
+            pending.emplace_back(writer);
+          }
+        }
+        if (!written)
+        {
+          throw error{ "The pass \"" + m_passes[reader].name + "\" reads a transient resource before it's written." };
+        }
+      }
+    }
+    for (auto i = pass_id{ 0 }; i < m_passes.size(); ++i)
+    {
+      m_passes[i].culled = !alive[i];
+    }
+  }
+
+  void render_graph::schedule() {
+    const auto async_compute = m_parent->queue_family_index(queue_type::async_compute) !=
+                               m_parent->queue_family_index(queue_type::primary);
+    for (auto& current : m_passes)
+    {
+      current.queue = current.type == render_pass_type::compute && async_compute ? queue_type::async_compute :
+                                                                                   queue_type::primary;
+    }
+    // Passes depend on the last writer of everything that they access and on every reader of everything that they
+    // write.
+    auto edges = std::vector<std::vector<pass_id>>(m_passes.size());
+    auto in_degree = std::vector<std::uint32_t>(m_passes.size());
+    auto last_writer = std::vector<std::uint32_t>(m_resources.size(), invalid_index);
+    auto readers = std::vector<std::vector<pass_id>>(m_resources.size());
+    const auto add_edge = [&](const std::uint32_t from, const pass_id to) {
+      if (from != invalid_index && from != to)
+      {
+        edges[from].emplace_back(to);
+        ++in_degree[to];
+      }
+    };
+    for (auto i = pass_id{ 0 }; i < m_passes.size(); ++i)
+    {
+      if (m_passes[i].culled)
+      {
+        continue;
+      }
+      for (const auto& use : m_passes[i].accesses)
+      {
+        if (!use.write)
+        {
+          add_edge(last_writer[use.resource], i);
+          readers[use.resource].emplace_back(i);
+        }
+      }
+      for (const auto& use : m_passes[i].accesses)
+      {
+        if (use.write)
+        {
+          add_edge(last_writer[use.resource], i);
+          for (const auto reader : readers[use.resource])
+          {
+            add_edge(reader, i);
+          }
+          readers[use.resource].clear();
+          last_writer[use.resource] = i;
+        }
+      }
+    }
+    // Among the passes that are ready, asynchronous passes go first so that their queue starts working as early as
+    // possible. Otherwise, declaration order is preserved.
+    const auto priority = [&](const pass_id id) {
+      return std::pair{ m_passes[id].queue != queue_type::async_compute, id };
+    };
+    auto ready = std::set<std::pair<bool, pass_id>>{ };
+    for (auto i = pass_id{ 0 }; i < m_passes.size(); ++i)
+    {
+      if (!m_passes[i].culled && !in_degree[i])
+      {
+        ready.emplace(priority(i));
+      }
+    }
+    m_order.clear();
+    while (!ready.empty())
+    {
+      const auto next = ready.begin()->second;
+      ready.erase(ready.begin());
+      m_order.emplace_back(next);
+      for (const auto dependent : edges[next])
+      {
+        if (!--in_degree[dependent])
+        {
+          ready.emplace(priority(dependent));
+        }
+      }
+    }
+  }
+
+  void render_graph::create_resources() {
+    for (auto position = std::uint32_t{ 0 }; position < m_order.size(); ++position)
+    {
+      const auto& current = m_passes[m_order[position]];
+      for (const auto& use : current.accesses)
+      {
+        auto& used = m_resources[use.resource];
+        used.first_use = std::min(used.first_use, position);
+        used.last_use = position;
+        used.queue_mask |= 1U << queue_index(current.queue);
+      }
+    }
+    const auto device = m_parent->handle();
+    const auto& ddt = m_parent->dispatch_table();
+    DECLARE_DEVICE_PFN(ddt, vkCreateImage);
+    DECLARE_DEVICE_PFN(ddt, vkCreateBuffer);
+    DECLARE_DEVICE_PFN(ddt, vkGetImageMemoryRequirements);
+    DECLARE_DEVICE_PFN(ddt, vkGetBufferMemoryRequirements);
+    const auto families = std::array<std::uint32_t, 2>{ m_parent->queue_family_index(queue_type::primary),
+                                                         m_parent->queue_family_index(queue_type::async_compute) };
+    for (auto& current : m_resources)
+    {
+      // Resources used by both queues are shared concurrently so that passes never need ownership transfers.
+      const auto concurrent = std::popcount(current.queue_mask) > 1 && families[0] != families[1];
+      if (current.imported && concurrent && !current.concurrent)
+      {
+        throw error{ "Imported resources used by both queues must be created with concurrent sharing." };
+      }
+      if (current.imported || current.first_use == invalid_index)
+      {
+        continue;
+      }
+      if (current.is_image)
+      {
+        auto image_info = current.image_info;
+        current.lazy = !(image_info.usage & ~attachment_usage);
+        if (current.lazy)
+        {
+          image_info.usage |= VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+        }
+        image_info.sharingMode = concurrent ? VK_SHARING_MODE_CONCURRENT : VK_SHARING_MODE_EXCLUSIVE;
+        image_info.queueFamilyIndexCount = concurrent ? families.size() : 0;
+        image_info.pQueueFamilyIndices = concurrent ? families.data() : nullptr;
+        VK_CHECK(vkCreateImage(device, &image_info, nullptr, &current.image));
+        vkGetImageMemoryRequirements(device, current.image, &current.requirements);
+      }
+      else
+      {
+        auto buffer_info = VkBufferCreateInfo{ };
+        buffer_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        buffer_info.size = current.size;
+        buffer_info.usage = current.buffer_usage;
+        buffer_info.sharingMode = concurrent ? VK_SHARING_MODE_CONCURRENT : VK_SHARING_MODE_EXCLUSIVE;
+        buffer_info.queueFamilyIndexCount = concurrent ? families.size() : 0;
+        buffer_info.pQueueFamilyIndices = concurrent ? families.data() : nullptr;
+        VK_CHECK(vkCreateBuffer(device, &buffer_info, nullptr, &current.buffer));
+        vkGetBufferMemoryRequirements(device, current.buffer, &current.requirements);
+      }
+    }
+  }
+
+  void render_graph::alias_resources() {
+    auto candidates = std::vector<resource_id>{ };
+    for (auto i = resource_id{ 0 }; i < m_resources.size(); ++i)
+    {
+      if (!m_resources[i].imported && m_resources[i].first_use != invalid_index)
+      {
+        candidates.emplace_back(i);
+      }
+    }
+    // Placing the largest resources first keeps each block close to the size of its largest occupant.
+    std::ranges::stable_sort(candidates, [&](const auto lhs, const auto rhs) {
+      return m_resources[lhs].requirements.size > m_resources[rhs].requirements.size;
+    });
+    for (const auto id : candidates)
+    {
+      auto& current = m_resources[id];
+      // Resources used by more than one queue would need cross-queue ordering with every other occupant, so they're
+      // never aliased.
+      const auto queue = std::popcount(current.queue_mask) == 1 ? std::countr_zero(current.queue_mask) :
+                                                                  invalid_index;
+      const auto block = std::ranges::find_if(m_blocks, [&](const auto& candidate) {
+        return queue != invalid_index && candidate.queue == queue && candidate.is_image == current.is_image &&
+               candidate.lazy == current.lazy &&
+               (candidate.requirements.memoryTypeBits & current.requirements.memoryTypeBits) &&
+               std::ranges::none_of(candidate.occupants, [&](const auto occupant) {
+                 const auto& other = m_resources[occupant];
+                 return current.first_use <= other.last_use && other.first_use <= current.last_use;
+               });
+      });
+      if (block == m_blocks.end())
+      {
+        auto& created = m_blocks.emplace_back();
+        created.requirements = current.requirements;
+        created.is_image = current.is_image;
+        created.lazy = current.lazy;
+        created.queue = queue;
+        created.occupants.emplace_back(id);
+        current.block = m_blocks.size() - 1;
+        continue;
+      }
+      block->requirements.size = std::max(block->requirements.size, current.requirements.size);
+      block->requirements.alignment = std::max(block->requirements.alignment, current.requirements.alignment);
+      block->requirements.memoryTypeBits &= current.requirements.memoryTypeBits;
+      block->occupants.emplace_back(id);
+      current.block = block - m_blocks.begin();
+    }
+    const auto device = m_parent->handle();
+    const auto& ddt = m_parent->dispatch_table();
+    DECLARE_DEVICE_PFN(ddt, vkBindImageMemory);
+    DECLARE_DEVICE_PFN(ddt, vkBindBufferMemory);
+    DECLARE_DEVICE_PFN(ddt, vkCreateImageView);
+    auto allocate_flags = VkMemoryAllocateFlagsInfo{ };
+    allocate_flags.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_FLAGS_INFO;
+    allocate_flags.flags = VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT;
+    for (auto& block : m_blocks)
+    {
+      const auto device_address = !block.is_image && std::ranges::any_of(block.occupants, [&](const auto occupant) {
+        return (m_resources[occupant].buffer_usage & VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT) != 0;
+      });
+      const auto preferred = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT |
+                             (block.lazy ? VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT : 0);
+      block.allocation = m_parent->allocate_memory(block.requirements, 0, preferred,
+                                                   device_address ? &allocate_flags : nullptr);
+      for (const auto occupant : block.occupants)
+      {
+        auto& current = m_resources[occupant];
+        if (current.is_image)
+        {
+          VK_CHECK(vkBindImageMemory(device, current.image, block.allocation.memory, 0));
+          auto view_info = VkImageViewCreateInfo{ };
+          view_info.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+          view_info.image = current.image;
+          view_info.viewType = view_type(current.image_info);
+          view_info.format = current.image_info.format;
+          view_info.subresourceRange = current.range;
+          VK_CHECK(vkCreateImageView(device, &view_info, nullptr, &current.view));
+        }
+        else
+        {
+          VK_CHECK(vkBindBufferMemory(device, current.buffer, block.allocation.memory, 0));
+        }
+      }
+    }
+  }
+
+  void render_graph::prepare(const std::uint32_t queue, const access& use, std::array<std::uint64_t, 2>& waits,
+                             std::array<VkPipelineStageFlags2, 2>& wait_stages) {
+    auto& current = m_resources[use.resource];
+    // Work from the other queue is ordered by its timeline semaphore, which also makes its writes visible.
+    auto waited_stages = VkPipelineStageFlags2{ VK_PIPELINE_STAGE_2_NONE };
+    if (current.last_queue != invalid_index && current.last_queue != queue && current.last_value)
+    {
+      waits[current.last_queue] = std::max(waits[current.last_queue], current.last_value);
+      wait_stages[current.last_queue] |= use.stages;
+      waited_stages = use.stages;
+    }
+    auto& states = *m_states[queue];
+    if (current.tracked_queue != queue)
+    {
+      auto layout = current.initial_layout;
+      if (current.tracked_queue != invalid_index)
+      {
+        auto& previous = *m_states[current.tracked_queue];
+        if (current.is_image)
+        {
+          layout = previous.image_layout(current.image);
+          previous.untrack_image(current.image);
+        }
+        else
+        {
+          previous.untrack_buffer(current.buffer);
+        }
+      }
+      // The first barrier on the new queue (e.g., a layout transition) must begin within the semaphore wait's scope.
+      // Otherwise, it wouldn't be ordered after the other queue's work.
+      if (current.is_image)
+      {
+        states.track_image(current.image, current.range, layout, VK_QUEUE_FAMILY_IGNORED, waited_stages);
+      }
+      else
+      {
+        states.track_buffer(current.buffer, VK_QUEUE_FAMILY_IGNORED, waited_stages);
+      }
+      current.tracked_queue = queue;
+    }
+    const auto first = !current.imported && current.last_execution != m_executions;
+    if (first)
+    {
+      auto& block = m_blocks[current.block];
+      if (block.last_occupant != invalid_index && block.last_occupant != use.resource)
+      {
+        const auto& aliased = m_resources[block.last_occupant];
+        if (current.is_image)
+        {
+          states.alias_image(current.image, aliased.image);
+        }
+        else
+        {
+          states.alias_buffer(current.buffer, aliased.buffer);
+        }
+      }
+      block.last_occupant = use.resource;
+    }
+    if (current.is_image)
+    {
+      states.use_image(current.image, use.stages, use.accesses, use.layout, first);
+    }
+    else
+    {
+      states.use_buffer(current.buffer, use.stages, use.accesses);
+    }
+  }
+
+  render_graph::render_graph(const std::shared_ptr<const parent_type>& parent) : m_parent{ parent } {
+    if (!m_parent)
+    {
+      throw error{ "The parent device cannot be null." };
+    }
+  }
+
+  render_graph::~render_graph() noexcept {
+    auto& deletions = m_parent->deletions();
+    for (auto& current : m_resources)
+    {
+      if (!current.imported)
+      {
+        deletions.destroy_image_view(current.view, m_last_submitted);
+        deletions.destroy_image(current.image, m_last_submitted);
+        deletions.destroy_buffer(current.buffer, m_last_submitted);
+      }
+    }
+    for (auto& block : m_blocks)
+    {
+      deletions.free_memory(block.allocation, m_last_submitted);
+    }
+  }
+
+  const render_graph::parent_type& render_graph::parent() const {
+    MEGATECH_PRECONDITION(m_parent != nullptr);
+    return *m_parent;
+  }
+
+  render_graph::resource_id render_graph::create_image(const VkImageCreateInfo& image_info,
+                                                       const VkImageAspectFlags aspect) {
+    check_mutable();
+    if (image_info.initialLayout != VK_IMAGE_LAYOUT_UNDEFINED)
+    {
+      throw error{ "Transient images must have an undefined initial layout." };
+    }
+    auto& created = m_resources.emplace_back();
+    created.is_image = true;
+    created.image_info = image_info;
+    created.image_info.pNext = nullptr;
+    created.range = { aspect, 0, image_info.mipLevels, 0, image_info.arrayLayers };
+    created.initial_layout = VK_IMAGE_LAYOUT_UNDEFINED;
+    return m_resources.size() - 1;
+  }
+
+  render_graph::resource_id render_graph::create_buffer(const VkDeviceSize size, const VkBufferUsageFlags usage) {
+    check_mutable();
+    if (!size)
+    {
+      throw error{ "Transient buffers must have a non-zero size." };
+    }
+    auto& created = m_resources.emplace_back();
+    created.size = size;
+    created.buffer_usage = usage;
+    return m_resources.size() - 1;
+  }
+
+  render_graph::resource_id render_graph::import_image(const VkImage image, const VkImageSubresourceRange& range,
+                                                       const VkImageLayout layout, const bool concurrent) {
+    check_mutable();
+    if (image == VK_NULL_HANDLE)
+    {
+      throw error{ "The imported image cannot be null." };
+    }
+    auto& imported = m_resources.emplace_back();
+    imported.imported = true;
+    imported.is_image = true;
+    imported.image = image;
+    imported.range = range;
+    imported.initial_layout = layout;
+    imported.concurrent = concurrent;
+    return m_resources.size() - 1;
+  }
+
+  render_graph::resource_id render_graph::import_buffer(const VkBuffer buffer, const bool concurrent) {
+    check_mutable();
+    if (buffer == VK_NULL_HANDLE)
+    {
+      throw error{ "The imported buffer cannot be null." };
+    }
+    auto& imported = m_resources.emplace_back();
+    imported.imported = true;
+    imported.buffer = buffer;
+    imported.concurrent = concurrent;
+    return m_resources.size() - 1;
+  }
+
+  render_graph::pass_id render_graph::add_pass(const std::string& name, const render_pass_type type,
+                                               const record_function& record, const bool side_effects) {
+    check_mutable();
+    auto& created = m_passes.emplace_back();
+    created.name = name;
+    created.type = type;
+    created.record = record;
+    created.side_effects = side_effects;
+    return m_passes.size() - 1;
+  }
+
+  void render_graph::read(const pass_id pass, const resource_id resource, const VkPipelineStageFlags2 stages,
+                          const VkAccessFlags2 accesses, const VkImageLayout layout) {
+    declare(pass, resource, stages, accesses, layout, false);
+  }
+
+  void render_graph::write(const pass_id pass, const resource_id resource, const VkPipelineStageFlags2 stages,
+                           const VkAccessFlags2 accesses, const VkImageLayout layout) {
+    declare(pass, resource, stages, accesses, layout, true);
+  }
+
+  void render_graph::compile() {
+    if (m_compiled)
+    {
+      return;
+    }
+    try
+    {
+      cull();
+      schedule();
+      create_resources();
+      alias_resources();
+      for (const auto id : m_order)
+      {
+        const auto index = queue_index(m_passes[id].queue);
+        if (!m_commands[index])
+        {
+          m_states[index].reset(new resource_state_tracker{ *m_parent });
+          m_commands[index].reset(new command_buffer_pool{ m_parent, graph_queues[index] });
+        }
+      }
+    }
+    catch (...)
+    {
+      destroy();
+      m_order.clear();
+      for (auto& current : m_resources)
+      {
+        current.first_use = invalid_index;
+        current.queue_mask = 0;
+      }
+      throw;
+    }
+    m_compiled = true;
+  }
+
+  std::uint64_t render_graph::execute() {
+    compile();
+    ++m_executions;
+    auto begin = std::size_t{ 0 };
+    while (begin < m_order.size())
+    {
+      // Consecutive passes on the same queue share a command buffer and a submission.
+      const auto queue = queue_index(m_passes[m_order[begin]].queue);
+      auto end = begin;
+      while (end < m_order.size() && queue_index(m_passes[m_order[end]].queue) == queue)
+      {
+        ++end;
+      }
+      auto& commands = *m_commands[queue];
+      auto waits = std::array<std::uint64_t, 2>{ };
+      auto wait_stages = std::array<VkPipelineStageFlags2, 2>{ };
+      const auto command_buffer = commands.acquire();
+      try
+      {
+        for (auto i = begin; i < end; ++i)
+        {
+          const auto& current = m_passes[m_order[i]];
+          for (const auto& use : current.accesses)
+          {
+            prepare(queue, use, waits, wait_stages);
+          }
+          for (const auto& use : current.accesses)
+          {
+            m_resources[use.resource].last_execution = m_executions;
+          }
+          m_states[queue]->flush(command_buffer);
+          if (current.record)
+          {
+            current.record(command_buffer, *this);
+          }
+        }
+      }
+      catch (...)
+      {
+        commands.release(command_buffer, 0);
+        throw;
+      }
+      auto wait_infos = std::vector<VkSemaphoreSubmitInfo>{ };
+      for (auto i = std::size_t{ 0 }; i < waits.size(); ++i)
+      {
+        if (waits[i])
+        {
+          auto& wait_info = wait_infos.emplace_back();
+          wait_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
+          wait_info.semaphore = m_parent->timeline_semaphore(graph_queues[i]);
+          wait_info.value = waits[i];
+          wait_info.stageMask = wait_stages[i];
+        }
+      }
+      const auto timeline_value = commands.submit(command_buffer, wait_infos);
+      for (auto i = begin; i < end; ++i)
+      {
+        for (const auto& use : m_passes[m_order[i]].accesses)
+        {
+          m_resources[use.resource].last_queue = queue;
+          m_resources[use.resource].last_value = timeline_value;
+        }
+      }
+      m_last_submitted = timeline_value;
+      begin = end;
+    }
+    return m_last_submitted;
+  }
+
+  VkImage render_graph::image(const resource_id resource) const {
+    return resource < m_resources.size() ? m_resources[resource].image : VK_NULL_HANDLE;
+  }
+
+  VkImageView render_graph::image_view(const resource_id resource) const {
+    return resource < m_resources.size() ? m_resources[resource].view : VK_NULL_HANDLE;
+  }
+
+  VkBuffer render_graph::buffer(const resource_id resource) const {
+    return resource < m_resources.size() ? m_resources[resource].buffer : VK_NULL_HANDLE;
+  }
+
+  const std::vector<render_graph::pass_id>& render_graph::order() const {
+    return m_order;
+  }
+
+  bool render_graph::is_culled(const pass_id pass) const {
+    return m_compiled && pass < m_passes.size() && m_passes[pass].culled;
+  }
+
+  queue_type render_graph::pass_queue(const pass_id pass) const {
+    if (pass >= m_passes.size())
+    {
+      throw error{ "The pass doesn't belong to the render graph." };
+    }
+    return m_passes[pass].queue;
+  }
+
+  std::size_t render_graph::memory_block_count() const {
+    return m_blocks.size();
+  }
+
+  VkDeviceSize render_graph::transient_memory_size() const {
+    auto result = VkDeviceSize{ 0 };
+    for (const auto& block : m_blocks)
+    {
+      result += block.requirements.size;
+    }
+    return result;
+  }
+
+}
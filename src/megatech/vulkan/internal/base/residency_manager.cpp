@@ -0,0 +1,187 @@
+/**
+ * @file residency_manager.cpp
+ * @brief Budget-Driven Device Memory Residency
+ * @author Alexander Rothman <[gnomesort@megate.ch](mailto:gnomesort@megate.ch)>
+ * @copyright AGPL-3.0-or-later
+ * @date 2025
+ */
+#include "megatech/vulkan/internal/base/residency_manager.hpp"
+
+#include <cmath>
+
+#include <megatech/assertions.hpp>
+
+#include "megatech/vulkan/error.hpp"
+
+#include "megatech/vulkan/internal/base/device_impl.hpp"
+#include "megatech/vulkan/internal/base/physical_device_description_impl.hpp"
+
+namespace megatech::vulkan::internal::base {
+
+  residency_manager::residency_manager(const parent_type& parent) :
+  m_parent{ &parent },
+  m_lru(parent.parent().memory_properties().memoryHeapCount) {
+    MEGATECH_POSTCONDITION(m_parent != nullptr);
+  }
+
+  const residency_manager::parent_type& residency_manager::parent() const {
+    MEGATECH_PRECONDITION(m_parent != nullptr);
+    return *m_parent;
+  }
+
+  residency_manager::id_type residency_manager::track(const std::uint32_t heap_index, const VkDeviceSize size,
+                                                      const std::uint64_t last_use, callback_type callback) {
+    if (heap_index >= m_lru.size())
+    {
+      throw error{ "The heap index is out of range." };
+    }
+    if (!callback)
+    {
+      throw error{ "The residency callback cannot be empty." };
+    }
+    auto lock = std::unique_lock<std::mutex>{ m_mutex };
+    const auto id = m_next_id++;
+    m_entries.emplace(id, entry{ heap_index, size, last_use, std::move(callback) });
+    m_lru[heap_index].emplace(last_use, id);
+    return id;
+  }
+
+  void residency_manager::touch(const id_type id, const std::uint64_t last_use) {
+    auto lock = std::unique_lock<std::mutex>{ m_mutex };
+    auto itr = m_entries.find(id);
+    if (itr == m_entries.end() || itr->second.last_use >= last_use)
+    {
+      return;
+    }
+    auto& lru = m_lru[itr->second.heap_index];
+    lru.erase({ itr->second.last_use, id });
+    itr->second.last_use = last_use;
+    lru.emplace(last_use, id);
+  }
+
+  void residency_manager::untrack(const id_type id) noexcept {
+    auto lock = std::unique_lock<std::mutex>{ m_mutex };
+    auto itr = m_entries.find(id);
+    if (itr == m_entries.end())
+    {
+      // The resource may be mid-eviction. Cancelling keeps make_room() from tracking it again if the callback fails,
+      // and waiting keeps the callback from outliving its owner.
+      m_evicting.erase(id);
+      m_callback_finished.wait(lock, [&]() { return !m_running.contains(id); });
+      return;
+    }
+    m_lru[itr->second.heap_index].erase({ itr->second.last_use, id });
+    m_entries.erase(itr);
+  }
+
+  VkDeviceSize residency_manager::tracked_bytes(const std::uint32_t heap_index) const {
+    auto lock = std::unique_lock<std::mutex>{ m_mutex };
+    auto result = VkDeviceSize{ 0 };
+    for (const auto& [id, tracked] : m_entries)
+    {
+      result += (tracked.heap_index == heap_index) * tracked.size;
+    }
+    return result;
+  }
+
+  double residency_manager::pressure_threshold() const {
+    auto lock = std::unique_lock<std::mutex>{ m_mutex };
+    return m_pressure_threshold;
+  }
+
+  void residency_manager::set_pressure_threshold(const double threshold) {
+    if (!(threshold > 0.0) || std::isinf(threshold))
+    {
+      throw error{ "The residency pressure threshold must be a finite value greater than 0." };
+    }
+    auto lock = std::unique_lock<std::mutex>{ m_mutex };
+    m_pressure_threshold = threshold;
+  }
+
+  VkDeviceSize residency_manager::overcommitment(const std::uint32_t heap_index, const VkDeviceSize bytes) const {
+    MEGATECH_PRECONDITION(m_parent != nullptr);
+    if (heap_index >= m_lru.size())
+    {
+      return 0;
+    }
+    const auto budget = m_parent->memory_budget();
+    const auto limit = static_cast<VkDeviceSize>(static_cast<double>(budget.heapBudget[heap_index]) *
+                                                 pressure_threshold());
+    const auto projected = budget.heapUsage[heap_index] + bytes;
+    return (projected > limit) * (projected - limit);
+  }
+
+  VkDeviceSize residency_manager::make_room(const std::uint32_t heap_index, const VkDeviceSize bytes) {
+    MEGATECH_PRECONDITION(m_parent != nullptr);
+    if (heap_index >= m_lru.size())
+    {
+      return 0;
+    }
+    // Resources are only safe to release once the device has finished every submission that used them.
+    const auto completed = m_parent->completed_timeline_value();
+    auto released = VkDeviceSize{ 0 };
+    auto failed = std::vector<std::pair<id_type, entry>>{ };
+    while (released < bytes)
+    {
+      auto id = id_type{ };
+      auto victim = entry{ };
+      {
+        auto lock = std::unique_lock<std::mutex>{ m_mutex };
+        auto& lru = m_lru[heap_index];
+        if (lru.empty() || lru.begin()->first > completed)
+        {
+          break;
+        }
+        id = lru.begin()->second;
+        lru.erase(lru.begin());
+        auto itr = m_entries.find(id);
+        victim = std::move(itr->second);
+        m_entries.erase(itr);
+        m_evicting.emplace(id);
+        m_running.emplace(id);
+      }
+      const auto freed = victim.callback();
+      {
+        auto lock = std::unique_lock<std::mutex>{ m_mutex };
+        m_running.erase(id);
+        if (freed)
+        {
+          m_evicting.erase(id);
+        }
+      }
+      m_callback_finished.notify_all();
+      if (!freed)
+      {
+        failed.emplace_back(id, std::move(victim));
+      }
+      released += freed;
+    }
+    if (!failed.empty())
+    {
+      // Failed resources are only tracked again once the loop is over. Otherwise, they would be selected again.
+      auto lock = std::unique_lock<std::mutex>{ m_mutex };
+      for (auto& [id, victim] : failed)
+      {
+        if (m_evicting.erase(id))
+        {
+          m_lru[victim.heap_index].emplace(victim.last_use, id);
+          m_entries.emplace(id, std::move(victim));
+        }
+      }
+    }
+    return released;
+  }
+
+  VkDeviceSize residency_manager::trim() {
+    auto released = VkDeviceSize{ 0 };
+    for (auto i = std::uint32_t{ 0 }; i < m_lru.size(); ++i)
+    {
+      if (const auto excess = overcommitment(i, 0); excess)
+      {
+        released += make_room(i, excess);
+      }
+    }
+    return released;
+  }
+
+}
@@ -0,0 +1,336 @@
+/**
+ * @file resource_state_tracker.cpp
+ * @brief Automatic Resource State Tracking
+ * @author Alexander Rothman <[gnomesort@megate.ch](mailto:gnomesort@megate.ch)>
+ * @copyright AGPL-3.0-or-later
+ * @date 2025
+ */
+#include "megatech/vulkan/internal/base/resource_state_tracker.hpp"
+
+#include <megatech/assertions.hpp>
+
+#include "megatech/vulkan/error.hpp"
+
+#include "megatech/vulkan/internal/base/device_impl.hpp"
+
+#define DECLARE_DEVICE_PFN(dt, cmd) MEGATECH_VULKAN_INTERNAL_BASE_DECLARE_DEVICE_PFN(dt, cmd)
+
+namespace {
+
+  constexpr VkAccessFlags2 write_access_mask = VK_ACCESS_2_SHADER_WRITE_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT |
+                                               VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT |
+                                               VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT |
+                                               VK_ACCESS_2_TRANSFER_WRITE_BIT | VK_ACCESS_2_HOST_WRITE_BIT |
+                                               VK_ACCESS_2_MEMORY_WRITE_BIT;
+
+  bool is_ownership_transfer(const std::uint32_t current, const std::uint32_t next) {
+    return current != VK_QUEUE_FAMILY_IGNORED && next != VK_QUEUE_FAMILY_IGNORED && current != next;
+  }
+
+}
+
+namespace megatech::vulkan::internal::base {
+
+  void resource_state_tracker::merge(std::optional<pending_use>& pending, const pending_use& use) {
+    if (!pending)
+    {
+      pending = use;
+      return;
+    }
+    if (pending->layout != use.layout)
+    {
+      throw error{ "An image can't be used with two different layouts in the same batch." };
+    }
+    if (is_ownership_transfer(pending->queue_family_index, use.queue_family_index))
+    {
+      throw error{ "A resource can't be used by two different queue families in the same batch." };
+    }
+    pending->stages |= use.stages;
+    pending->accesses |= use.accesses;
+    pending->discard = pending->discard && use.discard;
+    if (use.queue_family_index != VK_QUEUE_FAMILY_IGNORED)
+    {
+      pending->queue_family_index = use.queue_family_index;
+    }
+  }
+
+  bool resource_state_tracker::transition(access_state& state, const pending_use& use, const bool force,
+                                          VkPipelineStageFlags2& src_stages, VkAccessFlags2& src_accesses,
+                                          VkPipelineStageFlags2& dst_stages, VkAccessFlags2& dst_accesses) {
+    const auto writes = use.accesses & write_access_mask;
+    dst_stages = use.stages;
+    dst_accesses = use.accesses;
+    if (force)
+    {
+      // Layout transitions and ownership transfers are writes that wait for every earlier access. Their results are
+      // visible to exactly the stages and accesses that requested them.
+      src_stages = state.write_stages | state.read_stages;
+      src_accesses = use.discard ? VK_ACCESS_2_NONE : state.write_accesses;
+      state.write_stages = use.stages;
+      state.write_accesses = writes;
+      state.read_stages = (use.accesses & ~writes) ? use.stages : VK_PIPELINE_STAGE_2_NONE;
+      state.visible_stages = use.stages;
+      state.visible_accesses = use.accesses;
+      return true;
+    }
+    if (writes)
+    {
+      // Write-after-write needs a memory dependency unless an earlier barrier already made the last write available.
+      // Write-after-read only needs an execution dependency.
+      src_stages = state.write_stages | state.read_stages;
+      src_accesses = state.visible_accesses ? VK_ACCESS_2_NONE : state.write_accesses;
+      state.write_stages = use.stages;
+      state.write_accesses = writes;
+      state.read_stages = VK_PIPELINE_STAGE_2_NONE;
+      state.visible_stages = VK_PIPELINE_STAGE_2_NONE;
+      state.visible_accesses = VK_ACCESS_2_NONE;
+      return src_stages != VK_PIPELINE_STAGE_2_NONE;
+    }
+    state.read_stages |= use.stages;
+    // Reads only wait for the last write, and only if it hasn't already been made visible to them.
+    if (!state.write_stages ||
+        (!(use.stages & ~state.visible_stages) && !(use.accesses & ~state.visible_accesses)))
+    {
+      src_stages = VK_PIPELINE_STAGE_2_NONE;
+      src_accesses = VK_ACCESS_2_NONE;
+      return false;
+    }
+    src_stages = state.write_stages;
+    src_accesses = state.write_accesses;
+    // Widening the destination to everything that's already visible keeps the visible set an exact product of stages
+    // and accesses.
+    state.visible_stages |= use.stages;
+    state.visible_accesses |= use.accesses;
+    dst_stages = state.visible_stages;
+    dst_accesses = state.visible_accesses;
+    return true;
+  }
+
+  resource_state_tracker::resource_state_tracker(const parent_type& parent) : m_parent{ &parent } { }
+
+  const resource_state_tracker::parent_type& resource_state_tracker::parent() const {
+    MEGATECH_PRECONDITION(m_parent != nullptr);
+    return *m_parent;
+  }
+
+  void resource_state_tracker::track_buffer(const VkBuffer buffer, const std::uint32_t queue_family_index,
+                                            const VkPipelineStageFlags2 prior_stages) {
+    auto state = buffer_state{ };
+    state.access.queue_family_index = queue_family_index;
+    // Externally synchronized work is already visible, so it only has to be treated like an earlier read.
+    state.access.read_stages = prior_stages;
+    if (buffer == VK_NULL_HANDLE || !m_buffers.emplace(buffer, state).second)
+    {
+      throw error{ "The buffer is null or is already tracked." };
+    }
+  }
+
+  void resource_state_tracker::track_image(const VkImage image, const VkImageSubresourceRange& range,
+                                           const VkImageLayout layout, const std::uint32_t queue_family_index,
+                                           const VkPipelineStageFlags2 prior_stages) {
+    auto state = image_state{ };
+    state.access.queue_family_index = queue_family_index;
+    state.access.read_stages = prior_stages;
+    state.layout = layout;
+    state.range = range;
+    if (image == VK_NULL_HANDLE || !m_images.emplace(image, state).second)
+    {
+      throw error{ "The image is null or is already tracked." };
+    }
+  }
+
+  void resource_state_tracker::untrack_buffer(const VkBuffer buffer) {
+    if (m_buffers.erase(buffer))
+    {
+      std::erase(m_pending_buffers, buffer);
+    }
+  }
+
+  void resource_state_tracker::untrack_image(const VkImage image) {
+    if (m_images.erase(image))
+    {
+      std::erase(m_pending_images, image);
+    }
+  }
+
+  void resource_state_tracker::alias_buffer(const VkBuffer buffer, const VkBuffer aliased) {
+    const auto state = m_buffers.find(buffer);
+    const auto aliased_state = m_buffers.find(aliased);
+    if (state == m_buffers.end() || aliased_state == m_buffers.end())
+    {
+      throw error{ "Both buffers must be tracked." };
+    }
+    const auto queue_family_index = state->second.access.queue_family_index;
+    state->second.access = aliased_state->second.access;
+    state->second.access.queue_family_index = queue_family_index;
+  }
+
+  void resource_state_tracker::alias_image(const VkImage image, const VkImage aliased) {
+    const auto state = m_images.find(image);
+    const auto aliased_state = m_images.find(aliased);
+    if (state == m_images.end() || aliased_state == m_images.end())
+    {
+      throw error{ "Both images must be tracked." };
+    }
+    const auto queue_family_index = state->second.access.queue_family_index;
+    state->second.access = aliased_state->second.access;
+    state->second.access.queue_family_index = queue_family_index;
+  }
+
+  void resource_state_tracker::use_buffer(const VkBuffer buffer, const VkPipelineStageFlags2 stages,
+                                          const VkAccessFlags2 accesses, const std::uint32_t queue_family_index) {
+    const auto state = m_buffers.find(buffer);
+    if (state == m_buffers.end())
+    {
+      throw error{ "The buffer isn't tracked." };
+    }
+    if (!state->second.pending)
+    {
+      m_pending_buffers.emplace_back(buffer);
+    }
+    merge(state->second.pending, { stages, accesses, VK_IMAGE_LAYOUT_UNDEFINED, false, queue_family_index });
+  }
+
+  void resource_state_tracker::use_image(const VkImage image, const VkPipelineStageFlags2 stages,
+                                         const VkAccessFlags2 accesses, const VkImageLayout layout,
+                                         const bool discard, const std::uint32_t queue_family_index) {
+    const auto state = m_images.find(image);
+    if (state == m_images.end())
+    {
+      throw error{ "The image isn't tracked." };
+    }
+    if (!state->second.pending)
+    {
+      m_pending_images.emplace_back(image);
+    }
+    merge(state->second.pending, { stages, accesses, layout, discard, queue_family_index });
+  }
+
+  VkImageLayout resource_state_tracker::image_layout(const VkImage image) const {
+    const auto state = m_images.find(image);
+    if (state == m_images.end())
+    {
+      throw error{ "The image isn't tracked." };
+    }
+    return state->second.pending ? state->second.pending->layout : state->second.layout;
+  }
+
+  bool resource_state_tracker::has_pending_uses() const {
+    return !m_pending_buffers.empty() || !m_pending_images.empty();
+  }
+
+  VkDependencyInfo resource_state_tracker::resolve() {
+    m_memory_barrier = VkMemoryBarrier2{ };
+    m_memory_barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2;
+    m_buffer_barriers.clear();
+    m_image_barriers.clear();
+    auto src_stages = VkPipelineStageFlags2{ };
+    auto src_accesses = VkAccessFlags2{ };
+    auto dst_stages = VkPipelineStageFlags2{ };
+    auto dst_accesses = VkAccessFlags2{ };
+    const auto merge_global = [&]() {
+      m_memory_barrier.srcStageMask |= src_stages;
+      m_memory_barrier.srcAccessMask |= src_accesses;
+      m_memory_barrier.dstStageMask |= dst_stages;
+      m_memory_barrier.dstAccessMask |= dst_accesses;
+    };
+    for (const auto buffer : m_pending_buffers)
+    {
+      auto& state = m_buffers.at(buffer);
+      const auto use = *state.pending;
+      state.pending.reset();
+      const auto previous_family = state.access.queue_family_index;
+      const auto transfer = is_ownership_transfer(previous_family, use.queue_family_index);
+      if (!transition(state.access, use, transfer, src_stages, src_accesses, dst_stages, dst_accesses))
+      {
+        continue;
+      }
+      if (transfer)
+      {
+        auto& barrier = m_buffer_barriers.emplace_back();
+        barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2;
+        barrier.srcStageMask = src_stages;
+        barrier.srcAccessMask = src_accesses;
+        barrier.dstStageMask = dst_stages;
+        barrier.dstAccessMask = dst_accesses;
+        barrier.srcQueueFamilyIndex = previous_family;
+        barrier.dstQueueFamilyIndex = use.queue_family_index;
+        barrier.buffer = buffer;
+        barrier.size = VK_WHOLE_SIZE;
+        state.access.queue_family_index = use.queue_family_index;
+      }
+      else
+      {
+        merge_global();
+      }
+    }
+    for (const auto image : m_pending_images)
+    {
+      auto& state = m_images.at(image);
+      const auto use = *state.pending;
+      state.pending.reset();
+      const auto previous_family = state.access.queue_family_index;
+      // Discarded contents don't need to change hands, but the new queue family still becomes the owner.
+      const auto transfer = !use.discard && is_ownership_transfer(previous_family, use.queue_family_index);
+      const auto force = use.discard || transfer || use.layout != state.layout;
+      if (use.queue_family_index != VK_QUEUE_FAMILY_IGNORED && previous_family != VK_QUEUE_FAMILY_IGNORED)
+      {
+        state.access.queue_family_index = use.queue_family_index;
+      }
+      if (!transition(state.access, use, force, src_stages, src_accesses, dst_stages, dst_accesses))
+      {
+        continue;
+      }
+      if (force)
+      {
+        auto& barrier = m_image_barriers.emplace_back();
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2;
+        barrier.srcStageMask = src_stages;
+        barrier.srcAccessMask = src_accesses;
+        barrier.dstStageMask = dst_stages;
+        barrier.dstAccessMask = dst_accesses;
+        barrier.oldLayout = use.discard ? VK_IMAGE_LAYOUT_UNDEFINED : state.layout;
+        barrier.newLayout = use.layout;
+        barrier.srcQueueFamilyIndex = transfer ? previous_family : VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = transfer ? use.queue_family_index : VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = image;
+        barrier.subresourceRange = state.range;
+        state.layout = use.layout;
+      }
+      else
+      {
+        merge_global();
+      }
+    }
+    m_pending_buffers.clear();
+    m_pending_images.clear();
+    auto dependency_info = VkDependencyInfo{ };
+    dependency_info.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+    dependency_info.memoryBarrierCount = m_memory_barrier.srcStageMask != VK_PIPELINE_STAGE_2_NONE;
+    dependency_info.pMemoryBarriers = &m_memory_barrier;
+    dependency_info.bufferMemoryBarrierCount = m_buffer_barriers.size();
+    dependency_info.pBufferMemoryBarriers = m_buffer_barriers.data();
+    dependency_info.imageMemoryBarrierCount = m_image_barriers.size();
+    dependency_info.pImageMemoryBarriers = m_image_barriers.data();
+    return dependency_info;
+  }
+
+  bool resource_state_tracker::flush(const VkCommandBuffer command_buffer) {
+    MEGATECH_PRECONDITION(m_parent != nullptr);
+    const auto dependency_info = resolve();
+    if (!dependency_info.memoryBarrierCount && !dependency_info.bufferMemoryBarrierCount &&
+        !dependency_info.imageMemoryBarrierCount)
+    {
+      return false;
+    }
+    DECLARE_DEVICE_PFN(m_parent->dispatch_table(), vkCmdPipelineBarrier2);
+    vkCmdPipelineBarrier2(command_buffer, &dependency_info);
+    ++m_barriers_recorded;
+    return true;
+  }
+
+  std::uint64_t resource_state_tracker::barriers_recorded() const {
+    return m_barriers_recorded;
+  }
+
+}
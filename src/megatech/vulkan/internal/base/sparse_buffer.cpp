@@ -0,0 +1,201 @@
+/**
+ * @file sparse_buffer.cpp
+ * @brief Sparse-Resident Buffers
+ * @author Alexander Rothman <[gnomesort@megate.ch](mailto:gnomesort@megate.ch)>
+ * @copyright AGPL-3.0-or-later
+ * @date 2025
+ */
+#include "megatech/vulkan/internal/base/sparse_buffer.hpp"
+
+#include <algorithm>
+
+#include <megatech/assertions.hpp>
+
+#include "megatech/vulkan/error.hpp"
+
+#include "megatech/vulkan/internal/base/physical_device_description_impl.hpp"
+#include "megatech/vulkan/internal/base/deletion_queue.hpp"
+
+#define DECLARE_DEVICE_PFN(dt, cmd) MEGATECH_VULKAN_INTERNAL_BASE_DECLARE_DEVICE_PFN(dt, cmd)
+#define VK_CHECK(exp) MEGATECH_VULKAN_INTERNAL_BASE_VK_CHECK(exp)
+
+namespace megatech::vulkan::internal::base {
+
+  void sparse_buffer::mark_dirty(const std::size_t page) {
+    if (!m_is_dirty[page])
+    {
+      m_is_dirty[page] = true;
+      m_dirty.emplace_back(page);
+    }
+  }
+
+  sparse_buffer::sparse_buffer(const std::shared_ptr<const parent_type>& parent, const VkDeviceSize size,
+                               const VkBufferUsageFlags usage, const std::uint32_t resident_pages) :
+  m_parent{ parent },
+  m_size{ size } {
+    if (!m_parent)
+    {
+      throw error{ "The parent device cannot be null." };
+    }
+    if (!m_size || !resident_pages)
+    {
+      throw error{ "A sparse buffer must have a size and at least 1 resident page." };
+    }
+    if (!m_parent->has_sparse_binding() || !m_parent->parent().required_features().features.sparseResidencyBuffer)
+    {
+      throw error{ "The device doesn't support sparse-resident buffers." };
+    }
+    auto buffer_info = VkBufferCreateInfo{ };
+    buffer_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    buffer_info.flags = VK_BUFFER_CREATE_SPARSE_BINDING_BIT | VK_BUFFER_CREATE_SPARSE_RESIDENCY_BIT;
+    buffer_info.size = m_size;
+    buffer_info.usage = usage;
+    buffer_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    DECLARE_DEVICE_PFN(m_parent->dispatch_table(), vkCreateBuffer);
+    VK_CHECK(vkCreateBuffer(m_parent->handle(), &buffer_info, nullptr, &m_buffer));
+    auto requirements = VkMemoryRequirements{ };
+    try
+    {
+      DECLARE_DEVICE_PFN(m_parent->dispatch_table(), vkGetBufferMemoryRequirements);
+      vkGetBufferMemoryRequirements(m_parent->handle(), m_buffer, &requirements);
+      auto flags = VkMemoryAllocateFlags{ 0 };
+      if (usage & VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT)
+      {
+        flags |= VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT;
+      }
+      m_pages.reset(new sparse_page_pool{ m_parent, requirements, resident_pages, 16, flags });
+    }
+    catch (...)
+    {
+      m_parent->deletions().destroy_buffer(m_buffer);
+      throw;
+    }
+    // The memory requirements are padded to a whole number of pages, so every bind covers a whole page.
+    const auto pages = requirements.size / requirements.alignment;
+    m_page_table.resize(pages);
+    m_is_dirty.resize(pages);
+    MEGATECH_POSTCONDITION(m_buffer != VK_NULL_HANDLE);
+    MEGATECH_POSTCONDITION(m_pages != nullptr);
+  }
+
+  sparse_buffer::~sparse_buffer() noexcept {
+    // The buffer is destroyed first so that its pages are never freed while they're still bound.
+    m_parent->deletions().destroy_buffer(m_buffer);
+    m_pages.reset();
+  }
+
+  sparse_buffer::handle_type sparse_buffer::handle() const {
+    return m_buffer;
+  }
+
+  const sparse_buffer::parent_type& sparse_buffer::parent() const {
+    MEGATECH_PRECONDITION(m_parent != nullptr);
+    return *m_parent;
+  }
+
+  VkDeviceSize sparse_buffer::size() const {
+    return m_size;
+  }
+
+  VkDeviceSize sparse_buffer::page_size() const {
+    MEGATECH_PRECONDITION(m_pages != nullptr);
+    return m_pages->page_size();
+  }
+
+  std::size_t sparse_buffer::page_count() const {
+    return m_page_table.size();
+  }
+
+  bool sparse_buffer::is_resident(const std::size_t page) const {
+    MEGATECH_PRECONDITION(page < page_count());
+    return m_page_table[page].has_value();
+  }
+
+  std::uint32_t sparse_buffer::resident_pages() const {
+    MEGATECH_PRECONDITION(m_pages != nullptr);
+    return m_pages->capacity() - m_pages->available();
+  }
+
+  void sparse_buffer::commit(const VkDeviceSize offset, const VkDeviceSize size) {
+    if (offset > m_size || size > m_size - offset)
+    {
+      throw error{ "The committed range exceeds the sparse buffer." };
+    }
+    if (!size)
+    {
+      return;
+    }
+    const auto first = offset / page_size();
+    const auto last = (offset + size - 1) / page_size();
+    const auto missing = std::count_if(m_page_table.begin() + first, m_page_table.begin() + last + 1,
+                                       [](const auto& page) { return !page.has_value(); });
+    if (static_cast<std::uint32_t>(missing) > m_pages->available())
+    {
+      throw error{ "The sparse buffer doesn't have enough free pages to commit the range." };
+    }
+    for (auto i = first; i <= last; ++i)
+    {
+      if (!m_page_table[i])
+      {
+        m_page_table[i] = m_pages->acquire();
+        mark_dirty(i);
+      }
+    }
+  }
+
+  void sparse_buffer::evict(const VkDeviceSize offset, const VkDeviceSize size) {
+    if (offset > m_size || size > m_size - offset)
+    {
+      throw error{ "The evicted range exceeds the sparse buffer." };
+    }
+    if (!size)
+    {
+      return;
+    }
+    const auto first = offset / page_size();
+    const auto last = (offset + size - 1) / page_size();
+    for (auto i = first; i <= last; ++i)
+    {
+      if (m_page_table[i])
+      {
+        m_pages->release(*m_page_table[i]);
+        m_page_table[i].reset();
+        mark_dirty(i);
+      }
+    }
+  }
+
+  std::uint64_t sparse_buffer::flush(const std::uint64_t wait_value) {
+    if (m_dirty.empty())
+    {
+      return 0;
+    }
+    // Each page appears once in the batch with its final state, so a page that was evicted and committed again (or
+    // a memory page that moved from one buffer page to another) never produces conflicting binds.
+    std::ranges::sort(m_dirty);
+    auto binds = std::vector<VkSparseMemoryBind>{ };
+    for (const auto page : m_dirty)
+    {
+      auto& bind = binds.emplace_back();
+      bind.resourceOffset = page * page_size();
+      bind.size = page_size();
+      if (m_page_table[page])
+      {
+        bind.memory = m_page_table[page]->memory;
+        bind.memoryOffset = m_page_table[page]->offset;
+      }
+    }
+    auto bind_info = VkSparseBufferMemoryBindInfo{ };
+    bind_info.buffer = m_buffer;
+    bind_info.bindCount = binds.size();
+    bind_info.pBinds = binds.data();
+    const auto result = m_parent->bind_sparse({ &bind_info, 1 }, { }, { }, wait_value);
+    for (const auto page : m_dirty)
+    {
+      m_is_dirty[page] = false;
+    }
+    m_dirty.clear();
+    return result;
+  }
+
+}
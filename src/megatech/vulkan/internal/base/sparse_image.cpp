@@ -0,0 +1,495 @@
+/**
+ * @file sparse_image.cpp
+ * @brief Sparse-Resident Images with Tile Streaming
+ * @author Alexander Rothman <[gnomesort@megate.ch](mailto:gnomesort@megate.ch)>
+ * @copyright AGPL-3.0-or-later
+ * @date 2025
+ */
+#include "megatech/vulkan/internal/base/sparse_image.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <iterator>
+#include <utility>
+
+#include <megatech/assertions.hpp>
+
+#include "megatech/vulkan/error.hpp"
+
+#include "megatech/vulkan/internal/base/physical_device_description_impl.hpp"
+#include "megatech/vulkan/internal/base/deletion_queue.hpp"
+
+#define DECLARE_DEVICE_PFN(dt, cmd) MEGATECH_VULKAN_INTERNAL_BASE_DECLARE_DEVICE_PFN(dt, cmd)
+#define VK_CHECK(exp) MEGATECH_VULKAN_INTERNAL_BASE_VK_CHECK(exp)
+
+namespace megatech::vulkan::internal::base {
+
+  std::size_t sparse_tile_hash::operator()(const sparse_tile& tile) const noexcept {
+    auto result = std::size_t{ tile.mip_level };
+    for (const auto value : std::array{ tile.array_layer, tile.x, tile.y })
+    {
+      result = result * 0x100000001b3 ^ value;
+    }
+    return result;
+  }
+
+  void sparse_image::destroy() noexcept {
+    m_commands.reset();
+    m_staging.reset();
+    // The image is destroyed first so that its memory is never freed while it's still bound.
+    m_parent->deletions().destroy_image(m_image);
+    m_image = VK_NULL_HANDLE;
+    m_pages.reset();
+    for (auto& allocation : m_mip_tail)
+    {
+      m_parent->deletions().free_memory(allocation);
+    }
+    m_mip_tail.clear();
+  }
+
+  void sparse_image::validate(const sparse_tile& tile) const {
+    if (tile.mip_level >= m_image_info.mipLevels || tile.array_layer >= m_image_info.arrayLayers)
+    {
+      throw error{ "The tile's subresource is outside of the sparse image." };
+    }
+    const auto count = tile_count(tile.mip_level);
+    if (tile.x >= count.width || tile.y >= count.height)
+    {
+      throw error{ "The tile is outside of its mip level." };
+    }
+  }
+
+  bool sparse_image::is_mip_tail(const sparse_tile& tile) const {
+    return tile.mip_level >= m_mip_tail_first_level;
+  }
+
+  VkExtent3D sparse_image::tile_extent(const sparse_tile& tile) const {
+    const auto width = std::max(m_image_info.extent.width >> tile.mip_level, 1U);
+    const auto height = std::max(m_image_info.extent.height >> tile.mip_level, 1U);
+    return { std::min(m_granularity.width, width - tile.x * m_granularity.width),
+             std::min(m_granularity.height, height - tile.y * m_granularity.height), 1 };
+  }
+
+  sparse_image::sparse_image(const std::shared_ptr<const parent_type>& parent, const VkImageCreateInfo& image_info,
+                             const std::uint32_t resident_tiles, tile_loader loader) :
+  m_parent{ parent },
+  m_image_info{ image_info },
+  m_loader{ std::move(loader) } {
+    if (!m_parent)
+    {
+      throw error{ "The parent device cannot be null." };
+    }
+    if (!resident_tiles || !m_loader)
+    {
+      throw error{ "A sparse image must have a tile budget and a tile loader." };
+    }
+    if (!m_parent->has_sparse_binding() || !m_parent->parent().required_features().features.sparseResidencyImage2D)
+    {
+      throw error{ "The device doesn't support sparse-resident images." };
+    }
+    if (m_image_info.imageType != VK_IMAGE_TYPE_2D || m_image_info.extent.depth != 1 ||
+        m_image_info.samples != VK_SAMPLE_COUNT_1_BIT || m_image_info.tiling != VK_IMAGE_TILING_OPTIMAL ||
+        !m_image_info.mipLevels || !m_image_info.arrayLayers)
+    {
+      throw error{ "Sparse images must be single-sampled, optimally tiled 2D images." };
+    }
+    m_image_info.flags |= VK_IMAGE_CREATE_SPARSE_BINDING_BIT | VK_IMAGE_CREATE_SPARSE_RESIDENCY_BIT;
+    m_image_info.usage |= VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+    m_image_info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    const auto& ddt = m_parent->dispatch_table();
+    DECLARE_DEVICE_PFN(ddt, vkCreateImage);
+    VK_CHECK(vkCreateImage(m_parent->handle(), &m_image_info, nullptr, &m_image));
+    m_image_info.pNext = nullptr;
+    try
+    {
+      auto requirements = VkMemoryRequirements{ };
+      DECLARE_DEVICE_PFN(ddt, vkGetImageMemoryRequirements);
+      vkGetImageMemoryRequirements(m_parent->handle(), m_image, &requirements);
+      auto count = std::uint32_t{ 0 };
+      DECLARE_DEVICE_PFN(ddt, vkGetImageSparseMemoryRequirements);
+      vkGetImageSparseMemoryRequirements(m_parent->handle(), m_image, &count, nullptr);
+      auto sparse_requirements = std::vector<VkSparseImageMemoryRequirements>(count);
+      vkGetImageSparseMemoryRequirements(m_parent->handle(), m_image, &count, sparse_requirements.data());
+      const auto color = std::ranges::find_if(sparse_requirements, [](const auto& current) {
+        return (current.formatProperties.aspectMask & VK_IMAGE_ASPECT_COLOR_BIT) != 0;
+      });
+      if (color == sparse_requirements.end())
+      {
+        throw error{ "The sparse image's format doesn't support sparse residency." };
+      }
+      m_granularity = color->formatProperties.imageGranularity;
+      m_mip_tail_first_level = std::min(color->imageMipTailFirstLod, m_image_info.mipLevels);
+      // Mip tails can only be bound opaquely, and metadata must be bound for the image to be usable at all. Both are
+      // bound once and stay resident for the lifetime of the image.
+      auto binds = std::vector<VkSparseMemoryBind>{ };
+      for (const auto& current : sparse_requirements)
+      {
+        const auto is_metadata = (current.formatProperties.aspectMask & VK_IMAGE_ASPECT_METADATA_BIT) != 0;
+        if ((current.imageMipTailFirstLod >= m_image_info.mipLevels && !is_metadata) || !current.imageMipTailSize)
+        {
+          continue;
+        }
+        const auto is_single = (current.formatProperties.flags & VK_SPARSE_IMAGE_FORMAT_SINGLE_MIPTAIL_BIT) != 0;
+        const auto tails = is_single ? 1 : m_image_info.arrayLayers;
+        auto tail_requirements = requirements;
+        tail_requirements.size = current.imageMipTailSize * tails;
+        m_mip_tail.emplace_back(m_parent->allocate_memory(tail_requirements, 0, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT));
+        for (auto i = std::uint32_t{ 0 }; i < tails; ++i)
+        {
+          auto& bind = binds.emplace_back();
+          bind.resourceOffset = current.imageMipTailOffset + i * current.imageMipTailStride;
+          bind.size = current.imageMipTailSize;
+          bind.memory = m_mip_tail.back().memory;
+          bind.memoryOffset = i * current.imageMipTailSize;
+          bind.flags = is_metadata ? VK_SPARSE_MEMORY_BIND_METADATA_BIT : 0;
+        }
+      }
+      if (!binds.empty())
+      {
+        auto bind_info = VkSparseImageOpaqueMemoryBindInfo{ };
+        bind_info.image = m_image;
+        bind_info.bindCount = binds.size();
+        bind_info.pBinds = binds.data();
+        m_bind_value = m_parent->bind_sparse({ }, { &bind_info, 1 }, { });
+      }
+      m_pages.reset(new sparse_page_pool{ m_parent, requirements, resident_tiles, std::min(resident_tiles, 16U) });
+      m_commands.reset(new command_buffer_pool{ m_parent, queue_type::primary });
+      m_staging.reset(new buffer_pool{ m_parent, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                                       VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, 0 });
+      for (auto level = m_mip_tail_first_level; level < m_image_info.mipLevels; ++level)
+      {
+        const auto tiles = tile_count(level);
+        for (auto layer = std::uint32_t{ 0 }; layer < m_image_info.arrayLayers; ++layer)
+        {
+          for (auto y = std::uint32_t{ 0 }; y < tiles.height; ++y)
+          {
+            for (auto x = std::uint32_t{ 0 }; x < tiles.width; ++x)
+            {
+              m_mip_tail_loads.emplace_back(sparse_tile{ level, layer, x, y });
+            }
+          }
+        }
+      }
+    }
+    catch (...)
+    {
+      destroy();
+      throw;
+    }
+    MEGATECH_POSTCONDITION(m_image != VK_NULL_HANDLE);
+    MEGATECH_POSTCONDITION(m_pages != nullptr);
+    MEGATECH_POSTCONDITION(m_commands != nullptr);
+    MEGATECH_POSTCONDITION(m_staging != nullptr);
+  }
+
+  sparse_image::~sparse_image() noexcept {
+    destroy();
+  }
+
+  sparse_image::handle_type sparse_image::handle() const {
+    return m_image;
+  }
+
+  const sparse_image::parent_type& sparse_image::parent() const {
+    MEGATECH_PRECONDITION(m_parent != nullptr);
+    return *m_parent;
+  }
+
+  const VkExtent3D& sparse_image::tile_granularity() const {
+    return m_granularity;
+  }
+
+  VkDeviceSize sparse_image::tile_size() const {
+    MEGATECH_PRECONDITION(m_pages != nullptr);
+    return m_pages->page_size();
+  }
+
+  std::uint32_t sparse_image::mip_tail_first_level() const {
+    return m_mip_tail_first_level;
+  }
+
+  VkExtent2D sparse_image::tile_count(const std::uint32_t mip_level) const {
+    MEGATECH_PRECONDITION(mip_level < m_image_info.mipLevels);
+    const auto width = std::max(m_image_info.extent.width >> mip_level, 1U);
+    const auto height = std::max(m_image_info.extent.height >> mip_level, 1U);
+    return { (width + m_granularity.width - 1) / m_granularity.width,
+             (height + m_granularity.height - 1) / m_granularity.height };
+  }
+
+  std::uint32_t sparse_image::tile_budget() const {
+    MEGATECH_PRECONDITION(m_pages != nullptr);
+    return m_pages->capacity();
+  }
+
+  std::uint32_t sparse_image::resident_tiles() const {
+    auto lock = std::unique_lock<std::mutex>{ m_mutex };
+    return m_resident.size();
+  }
+
+  bool sparse_image::is_resident(const sparse_tile& tile) const {
+    validate(tile);
+    if (is_mip_tail(tile))
+    {
+      return true;
+    }
+    auto lock = std::unique_lock<std::mutex>{ m_mutex };
+    return m_resident.contains(tile);
+  }
+
+  void sparse_image::request(const sparse_tile& tile) {
+    validate(tile);
+    if (is_mip_tail(tile))
+    {
+      return;
+    }
+    auto lock = std::unique_lock<std::mutex>{ m_mutex };
+    if (const auto resident = m_resident.find(tile); resident != m_resident.end())
+    {
+      m_lru.splice(m_lru.end(), m_lru, resident->second.lru);
+      return;
+    }
+    m_requested.insert(tile);
+  }
+
+  void sparse_image::touch(const sparse_tile& tile, const std::uint64_t timeline_value) {
+    validate(tile);
+    auto lock = std::unique_lock<std::mutex>{ m_mutex };
+    if (const auto resident = m_resident.find(tile); resident != m_resident.end())
+    {
+      resident->second.last_use = std::max(resident->second.last_use, timeline_value);
+    }
+  }
+
+  std::uint64_t sparse_image::commit(const std::uint64_t wait_value) {
+    MEGATECH_PRECONDITION(m_pages != nullptr);
+    MEGATECH_PRECONDITION(m_commands != nullptr);
+    MEGATECH_PRECONDITION(m_staging != nullptr);
+    auto lock = std::unique_lock<std::mutex>{ m_mutex };
+    // Coarse levels are streamed first, so that a tile that doesn't fit in this batch at least has a lower
+    // resolution fallback.
+    auto requested = std::vector<sparse_tile>(m_requested.begin(), m_requested.end());
+    std::ranges::sort(requested, [](const auto& a, const auto& b) { return a.mip_level > b.mip_level; });
+    auto pages = std::vector<sparse_page>{ };
+    auto acquired = std::vector<sparse_page>{ };
+    auto evicted = std::vector<sparse_tile>{ };
+    // Tiles that the device may still be sampling are skipped rather than waited for. Their requests are kept for a
+    // later commit() instead.
+    const auto completed = m_parent->completed_timeline_value();
+    auto victim = m_lru.begin();
+    const auto find_victim = [&]() {
+      while (victim != m_lru.end() && m_resident.at(*victim).last_use > completed)
+      {
+        ++victim;
+      }
+    };
+    auto can_allocate = true;
+    for (auto i = std::size_t{ 0 }; i < requested.size() && pages.size() == i; ++i)
+    {
+      if (can_allocate && m_pages->available())
+      {
+        try
+        {
+          acquired.emplace_back(m_pages->acquire());
+          pages.emplace_back(acquired.back());
+          continue;
+        }
+        catch (const error&)
+        {
+          // The heap is full. Pages that are already allocated are recycled instead.
+          can_allocate = false;
+        }
+      }
+      find_victim();
+      if (victim != m_lru.end())
+      {
+        evicted.emplace_back(*victim);
+        pages.emplace_back(m_resident.at(*victim).page);
+        ++victim;
+      }
+    }
+    requested.resize(pages.size());
+    auto loads = m_mip_tail_loads;
+    loads.insert(loads.end(), requested.begin(), requested.end());
+    if (loads.empty())
+    {
+      return 0;
+    }
+    const auto release_acquired = [&]() {
+      for (const auto& page : acquired)
+      {
+        m_pages->release(page);
+      }
+    };
+    auto staging = buffer_allocation{ };
+    try
+    {
+      // Batches are rounded up to a power of two tiles so that recycled staging buffers fit later batches.
+      staging = m_staging->acquire(std::bit_ceil(loads.size()) * tile_size());
+      auto* const data = static_cast<std::byte*>(staging.allocation.mapped);
+      for (auto i = std::size_t{ 0 }; i < loads.size(); ++i)
+      {
+        m_loader(loads[i], { data + i * tile_size(), tile_size() });
+      }
+      auto binds = std::vector<VkSparseImageMemoryBind>{ };
+      const auto add_bind = [&](const sparse_tile& tile, const VkDeviceMemory memory, const VkDeviceSize offset) {
+        auto& bind = binds.emplace_back();
+        bind.subresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        bind.subresource.mipLevel = tile.mip_level;
+        bind.subresource.arrayLayer = tile.array_layer;
+        bind.offset.x = static_cast<std::int32_t>(tile.x * m_granularity.width);
+        bind.offset.y = static_cast<std::int32_t>(tile.y * m_granularity.height);
+        bind.extent = tile_extent(tile);
+        bind.memory = memory;
+        bind.memoryOffset = offset;
+      };
+      for (const auto& tile : evicted)
+      {
+        add_bind(tile, VK_NULL_HANDLE, 0);
+      }
+      for (auto i = std::size_t{ 0 }; i < requested.size(); ++i)
+      {
+        add_bind(requested[i], pages[i].memory, pages[i].offset);
+      }
+      if (!binds.empty())
+      {
+        auto bind_info = VkSparseImageMemoryBindInfo{ };
+        bind_info.image = m_image;
+        bind_info.bindCount = binds.size();
+        bind_info.pBinds = binds.data();
+        m_bind_value = m_parent->bind_sparse({ }, { }, { &bind_info, 1 }, wait_value);
+      }
+    }
+    catch (...)
+    {
+      release_acquired();
+      if (staging.buffer != VK_NULL_HANDLE)
+      {
+        m_staging->release(staging, 0);
+      }
+      throw;
+    }
+    // The bindings have been submitted, so the page table has to reflect them even if the upload fails.
+    for (const auto& tile : evicted)
+    {
+      m_lru.erase(m_resident.at(tile).lru);
+      m_resident.erase(tile);
+    }
+    for (auto i = std::size_t{ 0 }; i < requested.size(); ++i)
+    {
+      m_lru.emplace_back(requested[i]);
+      m_resident.emplace(requested[i], resident_tile{ pages[i], std::prev(m_lru.end()), m_bind_value });
+      m_requested.erase(requested[i]);
+    }
+    m_mip_tail_loads.clear();
+    const auto& ddt = m_parent->dispatch_table();
+    auto timeline_value = std::uint64_t{ };
+    try
+    {
+      DECLARE_DEVICE_PFN(ddt, vkCmdPipelineBarrier2);
+      DECLARE_DEVICE_PFN(ddt, vkCmdCopyBufferToImage);
+      const auto command_buffer = m_commands->acquire();
+      try
+      {
+        const auto shader_stages = VK_PIPELINE_STAGE_2_PRE_RASTERIZATION_SHADERS_BIT |
+                                   VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+        // Only the subresources that receive tiles are transitioned, so the rest of the image can be sampled while
+        // the copy runs. Layout transitions preserve contents everywhere except on the first upload, when the whole
+        // image leaves the undefined layout.
+        auto barriers = std::vector<VkImageMemoryBarrier2>{ };
+        const auto add_barrier = [&](const std::uint32_t mip_level, const std::uint32_t level_count,
+                                     const std::uint32_t array_layer, const std::uint32_t layer_count) {
+          auto& barrier = barriers.emplace_back();
+          barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2;
+          barrier.srcStageMask = m_initialized ? shader_stages : VK_PIPELINE_STAGE_2_NONE;
+          barrier.dstStageMask = VK_PIPELINE_STAGE_2_COPY_BIT;
+          barrier.dstAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+          barrier.oldLayout = m_initialized ? VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_UNDEFINED;
+          barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+          barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+          barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+          barrier.image = m_image;
+          barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+          barrier.subresourceRange.baseMipLevel = mip_level;
+          barrier.subresourceRange.levelCount = level_count;
+          barrier.subresourceRange.baseArrayLayer = array_layer;
+          barrier.subresourceRange.layerCount = layer_count;
+        };
+        if (!m_initialized)
+        {
+          add_barrier(0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS);
+        }
+        else
+        {
+          for (const auto& tile : loads)
+          {
+            const auto same_subresource = [&](const VkImageMemoryBarrier2& barrier) {
+              return barrier.subresourceRange.baseMipLevel == tile.mip_level &&
+                     barrier.subresourceRange.baseArrayLayer == tile.array_layer;
+            };
+            if (std::ranges::none_of(barriers, same_subresource))
+            {
+              add_barrier(tile.mip_level, 1, tile.array_layer, 1);
+            }
+          }
+        }
+        auto dependency_info = VkDependencyInfo{ };
+        dependency_info.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+        dependency_info.imageMemoryBarrierCount = barriers.size();
+        dependency_info.pImageMemoryBarriers = barriers.data();
+        vkCmdPipelineBarrier2(command_buffer, &dependency_info);
+        auto regions = std::vector<VkBufferImageCopy>(loads.size());
+        for (auto i = std::size_t{ 0 }; i < loads.size(); ++i)
+        {
+          regions[i].bufferOffset = i * tile_size();
+          regions[i].bufferRowLength = m_granularity.width;
+          regions[i].bufferImageHeight = m_granularity.height;
+          regions[i].imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+          regions[i].imageSubresource.mipLevel = loads[i].mip_level;
+          regions[i].imageSubresource.baseArrayLayer = loads[i].array_layer;
+          regions[i].imageSubresource.layerCount = 1;
+          regions[i].imageOffset.x = static_cast<std::int32_t>(loads[i].x * m_granularity.width);
+          regions[i].imageOffset.y = static_cast<std::int32_t>(loads[i].y * m_granularity.height);
+          regions[i].imageExtent = tile_extent(loads[i]);
+        }
+        vkCmdCopyBufferToImage(command_buffer, staging.buffer, m_image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                               regions.size(), regions.data());
+        for (auto& barrier : barriers)
+        {
+          barrier.srcStageMask = VK_PIPELINE_STAGE_2_COPY_BIT;
+          barrier.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+          barrier.dstStageMask = shader_stages;
+          barrier.dstAccessMask = VK_ACCESS_2_SHADER_SAMPLED_READ_BIT;
+          barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+          barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        }
+        vkCmdPipelineBarrier2(command_buffer, &dependency_info);
+      }
+      catch (...)
+      {
+        m_commands->release(command_buffer, 0);
+        throw;
+      }
+      // Sparse binding isn't implicitly ordered with other queue operations, even on the same queue.
+      auto wait_info = VkSemaphoreSubmitInfo{ };
+      wait_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
+      wait_info.semaphore = m_parent->timeline_semaphore(queue_type::sparse_binding);
+      wait_info.value = m_bind_value;
+      wait_info.stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+      timeline_value = m_commands->submit(command_buffer, { &wait_info, m_bind_value ? 1U : 0U });
+    }
+    catch (...)
+    {
+      m_staging->release(staging, 0);
+      throw;
+    }
+    m_initialized = true;
+    m_staging->release(staging, timeline_value);
+    for (const auto& tile : requested)
+    {
+      m_resident.at(tile).last_use = timeline_value;
+    }
+    return timeline_value;
+  }
+
+}
@@ -0,0 +1,163 @@
+/**
+ * @file sparse_page_pool.cpp
+ * @brief Pooled Memory Pages for Sparse Resources
+ * @author Alexander Rothman <[gnomesort@megate.ch](mailto:gnomesort@megate.ch)>
+ * @copyright AGPL-3.0-or-later
+ * @date 2025
+ */
+#include "megatech/vulkan/internal/base/sparse_page_pool.hpp"
+
+#include <algorithm>
+
+#include <megatech/assertions.hpp>
+
+#include "megatech/vulkan/error.hpp"
+
+#include "megatech/vulkan/internal/base/deletion_queue.hpp"
+
+namespace megatech::vulkan::internal::base {
+
+  sparse_page_pool::sparse_page_pool(const std::shared_ptr<const parent_type>& parent,
+                                     const VkMemoryRequirements& requirements, const std::uint32_t capacity,
+                                     const std::uint32_t pages_per_block,
+                                     const VkMemoryAllocateFlags allocate_flags) :
+  m_parent{ parent },
+  m_requirements{ requirements },
+  m_pages_per_block{ pages_per_block },
+  m_capacity{ capacity },
+  m_allocate_flags{ allocate_flags } {
+    if (!m_parent)
+    {
+      throw error{ "The parent device cannot be null." };
+    }
+    if (!m_capacity || !m_pages_per_block || !m_requirements.alignment)
+    {
+      throw error{ "A sparse page pool must have a capacity, a block size, and a page size." };
+    }
+  }
+
+  sparse_page_pool::~sparse_page_pool() noexcept {
+    // Untracking waits for any eviction in progress, so every block must be untracked before the blocks are freed.
+    auto ids = std::vector<residency_manager::id_type>{ };
+    {
+      auto lock = std::unique_lock<std::mutex>{ m_mutex };
+      for (const auto& block : m_blocks)
+      {
+        ids.emplace_back(block.residency_id);
+      }
+    }
+    for (const auto id : ids)
+    {
+      m_parent->residency().untrack(id);
+    }
+    for (auto& block : m_blocks)
+    {
+      m_parent->deletions().free_memory(block.memory);
+    }
+  }
+
+  sparse_page_pool::block& sparse_page_pool::find_block(const VkDeviceMemory memory) {
+    const auto found = std::ranges::find_if(m_blocks, [&](const block& b) { return b.memory.memory == memory; });
+    MEGATECH_PRECONDITION(found != m_blocks.end());
+    return *found;
+  }
+
+  VkDeviceSize sparse_page_pool::evict_block(const VkDeviceMemory memory) {
+    auto evicted = memory_allocation{ };
+    {
+      auto lock = std::unique_lock<std::mutex>{ m_mutex };
+      const auto found = std::ranges::find_if(m_blocks, [&](const block& b) { return b.memory.memory == memory; });
+      if (found == m_blocks.end() || found->free_pages < found->pages)
+      {
+        return 0;
+      }
+      std::erase_if(m_free, [&](const sparse_page& page) { return page.memory == memory; });
+      m_allocated_pages -= found->pages;
+      evicted = found->memory;
+      m_blocks.erase(found);
+    }
+    // The residency_manager only evicts blocks whose last use has completed, so the memory can be freed immediately.
+    const auto size = evicted.size;
+    m_parent->free_memory(evicted);
+    return size;
+  }
+
+  const sparse_page_pool::parent_type& sparse_page_pool::parent() const {
+    MEGATECH_PRECONDITION(m_parent != nullptr);
+    return *m_parent;
+  }
+
+  VkDeviceSize sparse_page_pool::page_size() const {
+    return m_requirements.alignment;
+  }
+
+  std::uint32_t sparse_page_pool::capacity() const {
+    return m_capacity;
+  }
+
+  std::uint32_t sparse_page_pool::available() const {
+    auto lock = std::unique_lock<std::mutex>{ m_mutex };
+    return m_free.size() + (m_capacity - std::min(m_allocated_pages, m_capacity));
+  }
+
+  sparse_page sparse_page_pool::acquire() {
+    auto lock = std::unique_lock<std::mutex>{ m_mutex };
+    if (m_free.empty())
+    {
+      if (m_allocated_pages >= m_capacity)
+      {
+        throw error{ "The sparse page pool is at capacity." };
+      }
+      const auto pages = std::min(m_pages_per_block, m_capacity - m_allocated_pages);
+      // The pages are reserved before unlocking so that concurrent acquisitions can't exceed the capacity.
+      m_allocated_pages += pages;
+      lock.unlock();
+      auto requirements = m_requirements;
+      requirements.size = pages * page_size();
+      auto flags_info = VkMemoryAllocateFlagsInfo{ };
+      flags_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_FLAGS_INFO;
+      flags_info.flags = m_allocate_flags;
+      auto memory = memory_allocation{ };
+      auto id = residency_manager::id_type{ };
+      try
+      {
+        memory = m_parent->allocate_memory(requirements, 0, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                                           m_allocate_flags ? &flags_info : nullptr);
+        const auto handle = memory.memory;
+        id = m_parent->residency().track(memory.heap_index, memory.size, m_parent->current_timeline_value(),
+                                         [this, handle]() { return evict_block(handle); });
+      }
+      catch (...)
+      {
+        m_parent->free_memory(memory);
+        lock.lock();
+        m_allocated_pages -= pages;
+        throw;
+      }
+      lock.lock();
+      m_blocks.emplace_back(block{ memory, id, pages, pages });
+      // Pages are handed out from the front of a block first.
+      for (auto i = pages; i > 0; --i)
+      {
+        m_free.emplace_back(sparse_page{ memory.memory, (i - 1) * page_size() });
+      }
+    }
+    const auto result = m_free.back();
+    m_free.pop_back();
+    auto& owner = find_block(result.memory);
+    --owner.free_pages;
+    m_parent->residency().touch(owner.residency_id, m_parent->current_timeline_value());
+    MEGATECH_POSTCONDITION(result.memory != VK_NULL_HANDLE);
+    return result;
+  }
+
+  void sparse_page_pool::release(const sparse_page& page) {
+    MEGATECH_PRECONDITION(page.memory != VK_NULL_HANDLE);
+    auto lock = std::unique_lock<std::mutex>{ m_mutex };
+    auto& owner = find_block(page.memory);
+    ++owner.free_pages;
+    m_parent->residency().touch(owner.residency_id, m_parent->current_timeline_value());
+    m_free.emplace_back(page);
+  }
+
+}
@@ -0,0 +1,158 @@
+/**
+ * @file split_barrier.cpp
+ * @brief Event-Based Split Barriers
+ * @author Alexander Rothman <[gnomesort@megate.ch](mailto:gnomesort@megate.ch)>
+ * @copyright AGPL-3.0-or-later
+ * @date 2025
+ */
+#include "megatech/vulkan/internal/base/split_barrier.hpp"
+
+#include <megatech/assertions.hpp>
+
+#include "megatech/vulkan/error.hpp"
+
+#include "megatech/vulkan/internal/base/device_impl.hpp"
+#include "megatech/vulkan/internal/base/sync_object_pool.hpp"
+
+#define DECLARE_DEVICE_PFN(dt, cmd) MEGATECH_VULKAN_INTERNAL_BASE_DECLARE_DEVICE_PFN(dt, cmd)
+
+namespace megatech::vulkan::internal::base {
+
+  VkDependencyInfo split_barrier::dependency_info() const {
+    auto result = VkDependencyInfo{ };
+    result.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+    result.memoryBarrierCount = m_memory_barriers.size();
+    result.pMemoryBarriers = m_memory_barriers.data();
+    result.bufferMemoryBarrierCount = m_buffer_barriers.size();
+    result.pBufferMemoryBarriers = m_buffer_barriers.data();
+    result.imageMemoryBarrierCount = m_image_barriers.size();
+    result.pImageMemoryBarriers = m_image_barriers.data();
+    return result;
+  }
+
+  split_barrier::split_barrier(const parent_type& parent) : m_parent{ &parent }, m_event{ parent.events().acquire() } {
+    MEGATECH_POSTCONDITION(m_event != VK_NULL_HANDLE);
+  }
+
+  split_barrier::~split_barrier() noexcept {
+    if (m_event == VK_NULL_HANDLE)
+    {
+      return;
+    }
+    // Only the owner knows which submission last used a signaled event. Guessing could return the event to the pool
+    // while the device still uses it, so signaled events that weren't retired are leaked instead.
+    MEGATECH_PRECONDITION(!m_signaled);
+    if (m_signaled)
+    {
+      return;
+    }
+    try
+    {
+      retire(0);
+    }
+    catch (...)
+    {
+      // The event can't be returned to the pool, so it's leaked.
+    }
+  }
+
+  const split_barrier::parent_type& split_barrier::parent() const {
+    MEGATECH_PRECONDITION(m_parent != nullptr);
+    return *m_parent;
+  }
+
+  VkEvent split_barrier::event() const {
+    return m_event;
+  }
+
+  void split_barrier::add(const VkDependencyInfo& dependency) {
+    for (auto i = std::uint32_t{ 0 }; i < dependency.memoryBarrierCount; ++i)
+    {
+      add(dependency.pMemoryBarriers[i]);
+    }
+    for (auto i = std::uint32_t{ 0 }; i < dependency.bufferMemoryBarrierCount; ++i)
+    {
+      add(dependency.pBufferMemoryBarriers[i]);
+    }
+    for (auto i = std::uint32_t{ 0 }; i < dependency.imageMemoryBarrierCount; ++i)
+    {
+      add(dependency.pImageMemoryBarriers[i]);
+    }
+  }
+
+  void split_barrier::add(const VkMemoryBarrier2& barrier) {
+    if (m_signaled)
+    {
+      throw error{ "Barriers can't be added after the split barrier is signaled." };
+    }
+    auto& added = m_memory_barriers.emplace_back(barrier);
+    added.pNext = nullptr;
+  }
+
+  void split_barrier::add(const VkBufferMemoryBarrier2& barrier) {
+    if (m_signaled)
+    {
+      throw error{ "Barriers can't be added after the split barrier is signaled." };
+    }
+    auto& added = m_buffer_barriers.emplace_back(barrier);
+    added.pNext = nullptr;
+    added.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    added.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  }
+
+  void split_barrier::add(const VkImageMemoryBarrier2& barrier) {
+    if (m_signaled)
+    {
+      throw error{ "Barriers can't be added after the split barrier is signaled." };
+    }
+    auto& added = m_image_barriers.emplace_back(barrier);
+    added.pNext = nullptr;
+    added.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    added.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  }
+
+  bool split_barrier::empty() const {
+    return m_memory_barriers.empty() && m_buffer_barriers.empty() && m_image_barriers.empty();
+  }
+
+  void split_barrier::signal(const VkCommandBuffer command_buffer) {
+    MEGATECH_PRECONDITION(m_parent != nullptr);
+    if (m_event == VK_NULL_HANDLE || m_signaled)
+    {
+      throw error{ "The split barrier was already signaled or retired." };
+    }
+    if (!empty())
+    {
+      const auto dependency = dependency_info();
+      DECLARE_DEVICE_PFN(m_parent->dispatch_table(), vkCmdSetEvent2);
+      vkCmdSetEvent2(command_buffer, m_event, &dependency);
+    }
+    m_signaled = true;
+  }
+
+  void split_barrier::wait(const VkCommandBuffer command_buffer) {
+    MEGATECH_PRECONDITION(m_parent != nullptr);
+    if (m_event == VK_NULL_HANDLE || !m_signaled || m_waited)
+    {
+      throw error{ "The split barrier must be signaled and not yet waited on or retired." };
+    }
+    if (!empty())
+    {
+      const auto dependency = dependency_info();
+      DECLARE_DEVICE_PFN(m_parent->dispatch_table(), vkCmdWaitEvents2);
+      vkCmdWaitEvents2(command_buffer, 1, &m_event, &dependency);
+    }
+    m_waited = true;
+  }
+
+  void split_barrier::retire(const std::uint64_t timeline_value) {
+    MEGATECH_PRECONDITION(m_parent != nullptr);
+    if (m_event == VK_NULL_HANDLE)
+    {
+      return;
+    }
+    m_parent->events().release(m_event, timeline_value);
+    m_event = VK_NULL_HANDLE;
+  }
+
+}
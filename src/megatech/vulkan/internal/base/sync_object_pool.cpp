@@ -0,0 +1,335 @@
+/**
+ * @file sync_object_pool.cpp
+ * @brief Recycled Fences, Binary Semaphores, and Events
+ * @author Alexander Rothman <[gnomesort@megate.ch](mailto:gnomesort@megate.ch)>
+ * @copyright AGPL-3.0-or-later
+ * @date 2025
+ */
+#include "megatech/vulkan/internal/base/sync_object_pool.hpp"
+
+#include <algorithm>
+
+#include <megatech/assertions.hpp>
+
+#include "megatech/vulkan/error.hpp"
+
+#include "megatech/vulkan/internal/base/device_impl.hpp"
+
+#define DECLARE_DEVICE_PFN(dt, cmd) MEGATECH_VULKAN_INTERNAL_BASE_DECLARE_DEVICE_PFN(dt, cmd)
+#define DECLARE_DEVICE_PFN_NO_THROW(dt, cmd) MEGATECH_VULKAN_INTERNAL_BASE_DECLARE_DEVICE_PFN_NO_THROW(dt, cmd)
+#define VK_CHECK(exp) MEGATECH_VULKAN_INTERNAL_BASE_VK_CHECK(exp)
+
+namespace megatech::vulkan::internal::base {
+
+  namespace {
+
+    std::atomic<std::uint64_t> next_pool_id{ 1 };
+
+  }
+
+  fence_traits::handle_type fence_traits::create(const device_impl& device) {
+    auto export_info = VkExportFenceCreateInfo{ };
+    export_info.sType = VK_STRUCTURE_TYPE_EXPORT_FENCE_CREATE_INFO;
+    export_info.handleTypes = VK_EXTERNAL_FENCE_HANDLE_TYPE_SYNC_FD_BIT;
+    auto fence_info = VkFenceCreateInfo{ };
+    fence_info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+    if (device.can_export_fence_sync_fd())
+    {
+      fence_info.pNext = &export_info;
+    }
+    auto result = handle_type{ };
+    DECLARE_DEVICE_PFN(device.dispatch_table(), vkCreateFence);
+    VK_CHECK(vkCreateFence(device.handle(), &fence_info, nullptr, &result));
+    return result;
+  }
+
+  void fence_traits::reset(const device_impl& device, const std::span<const handle_type> handles) {
+    if (handles.empty())
+    {
+      return;
+    }
+    DECLARE_DEVICE_PFN(device.dispatch_table(), vkResetFences);
+    VK_CHECK(vkResetFences(device.handle(), static_cast<std::uint32_t>(handles.size()), handles.data()));
+  }
+
+  void fence_traits::destroy(const device_impl& device, const handle_type handle) noexcept {
+    DECLARE_DEVICE_PFN_NO_THROW(device.dispatch_table(), vkDestroyFence);
+    vkDestroyFence(device.handle(), handle, nullptr);
+  }
+
+  semaphore_traits::handle_type semaphore_traits::create(const device_impl& device) {
+    auto export_info = VkExportSemaphoreCreateInfo{ };
+    export_info.sType = VK_STRUCTURE_TYPE_EXPORT_SEMAPHORE_CREATE_INFO;
+    export_info.handleTypes = VK_EXTERNAL_SEMAPHORE_HANDLE_TYPE_SYNC_FD_BIT;
+    auto semaphore_info = VkSemaphoreCreateInfo{ };
+    semaphore_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    if (device.can_export_semaphore_sync_fd())
+    {
+      semaphore_info.pNext = &export_info;
+    }
+    auto result = handle_type{ };
+    DECLARE_DEVICE_PFN(device.dispatch_table(), vkCreateSemaphore);
+    VK_CHECK(vkCreateSemaphore(device.handle(), &semaphore_info, nullptr, &result));
+    return result;
+  }
+
+  void semaphore_traits::reset(const device_impl&, const std::span<const handle_type>) { }
+
+  void semaphore_traits::destroy(const device_impl& device, const handle_type handle) noexcept {
+    DECLARE_DEVICE_PFN_NO_THROW(device.dispatch_table(), vkDestroySemaphore);
+    vkDestroySemaphore(device.handle(), handle, nullptr);
+  }
+
+  event_traits::handle_type event_traits::create(const device_impl& device) {
+    auto event_info = VkEventCreateInfo{ };
+    event_info.sType = VK_STRUCTURE_TYPE_EVENT_CREATE_INFO;
+    auto result = handle_type{ };
+    DECLARE_DEVICE_PFN(device.dispatch_table(), vkCreateEvent);
+    VK_CHECK(vkCreateEvent(device.handle(), &event_info, nullptr, &result));
+    return result;
+  }
+
+  void event_traits::reset(const device_impl& device, const std::span<const handle_type> handles) {
+    // There's no bulk reset for events, but batching still keeps the calls out of the release path.
+    DECLARE_DEVICE_PFN(device.dispatch_table(), vkResetEvent);
+    for (const auto event : handles)
+    {
+      VK_CHECK(vkResetEvent(device.handle(), event));
+    }
+  }
+
+  void event_traits::destroy(const device_impl& device, const handle_type handle) noexcept {
+    DECLARE_DEVICE_PFN_NO_THROW(device.dispatch_table(), vkDestroyEvent);
+    vkDestroyEvent(device.handle(), handle, nullptr);
+  }
+
+  template <typename Traits>
+  sync_object_pool<Traits>::sync_object_pool(const parent_type& parent) :
+  m_parent{ &parent },
+  m_id{ next_pool_id.fetch_add(1, std::memory_order_relaxed) } { }
+
+  template <typename Traits>
+  sync_object_pool<Traits>::~sync_object_pool() noexcept {
+    const auto destroy_all = [this](const std::vector<handle_type>& handles) {
+      for (const auto handle : handles)
+      {
+        Traits::destroy(*m_parent, handle);
+      }
+    };
+    // Detach every cache before touching the shared lists. A thread that's exiting either returns its cache first or
+    // finds it detached.
+    auto caches = std::vector<std::shared_ptr<local_cache>>{ };
+    {
+      auto lock = std::unique_lock<std::mutex>{ m_mutex };
+      caches.swap(m_caches);
+    }
+    for (const auto& cache : caches)
+    {
+      auto lock = std::unique_lock<std::mutex>{ cache->mutex };
+      cache->pool = nullptr;
+      destroy_all(cache->ready);
+      destroy_all(cache->dirty);
+      cache->ready.clear();
+      cache->dirty.clear();
+    }
+    destroy_all(m_free);
+    destroy_all(m_dirty);
+    for (const auto& pending : m_pending)
+    {
+      Traits::destroy(*m_parent, pending.second);
+    }
+  }
+
+  template <typename Traits>
+  const typename sync_object_pool<Traits>::parent_type& sync_object_pool<Traits>::parent() const {
+    MEGATECH_PRECONDITION(m_parent != nullptr);
+    return *m_parent;
+  }
+
+  template <typename Traits>
+  typename sync_object_pool<Traits>::local_cache& sync_object_pool<Traits>::local() {
+    // Each thread owns its caches. When the thread exits, the owner hands every cache whose pool is still alive back
+    // to that pool.
+    struct cache_owner final {
+      std::vector<std::pair<std::uint64_t, std::shared_ptr<local_cache>>> caches{ };
+
+      ~cache_owner() noexcept {
+        for (const auto& [id, cache] : caches)
+        {
+          auto lock = std::unique_lock<std::mutex>{ cache->mutex };
+          if (cache->pool)
+          {
+            cache->pool->reclaim(*cache);
+          }
+        }
+      }
+    };
+    // Pool IDs are never reused, so an entry can only match the pool that created it, and that pool is alive for the
+    // duration of the call.
+    thread_local auto owner = cache_owner{ };
+    for (const auto& [id, cache] : owner.caches)
+    {
+      if (id == m_id)
+      {
+        return *cache;
+      }
+    }
+    std::erase_if(owner.caches, [](const auto& entry) {
+      auto lock = std::unique_lock<std::mutex>{ entry.second->mutex };
+      return entry.second->pool == nullptr;
+    });
+    auto cache = std::make_shared<local_cache>();
+    cache->pool = this;
+    cache->ready.reserve(cache_capacity);
+    cache->dirty.reserve(cache_capacity);
+    owner.caches.emplace_back(m_id, cache);
+    {
+      auto lock = std::unique_lock<std::mutex>{ m_mutex };
+      m_caches.emplace_back(cache);
+    }
+    return *cache;
+  }
+
+  template <typename Traits>
+  void sync_object_pool<Traits>::reclaim(local_cache& cache) noexcept {
+    // The caller holds the cache's lock, so the pool can't finish destroying itself until this returns.
+    auto lock = std::unique_lock<std::mutex>{ m_mutex };
+    auto& reclaimed = Traits::needs_reset ? m_dirty : m_free;
+    try
+    {
+      // Once both lists have room, inserting the handles can't throw.
+      m_free.reserve(m_free.size() + cache.ready.size() + (Traits::needs_reset ? 0 : cache.dirty.size()));
+      reclaimed.reserve(reclaimed.size() + cache.dirty.size());
+      m_free.insert(m_free.end(), cache.ready.begin(), cache.ready.end());
+      reclaimed.insert(reclaimed.end(), cache.dirty.begin(), cache.dirty.end());
+    }
+    catch (...)
+    {
+      // Nothing can be reported from a thread that's exiting, so destroy the handles rather than leaking them.
+      for (const auto& list : { &cache.ready, &cache.dirty })
+      {
+        for (const auto handle : *list)
+        {
+          Traits::destroy(*m_parent, handle);
+        }
+        m_size.fetch_sub(list->size(), std::memory_order_relaxed);
+      }
+    }
+    std::erase_if(m_caches, [&](const auto& entry) { return entry.get() == &cache; });
+    cache.pool = nullptr;
+    cache.ready.clear();
+    cache.dirty.clear();
+  }
+
+  template <typename Traits>
+  void sync_object_pool<Traits>::refill(local_cache& cache) {
+    if constexpr (Traits::needs_reset)
+    {
+      if (!cache.dirty.empty())
+      {
+        Traits::reset(*m_parent, cache.dirty);
+        cache.ready.insert(cache.ready.end(), cache.dirty.begin(), cache.dirty.end());
+        cache.dirty.clear();
+        return;
+      }
+    }
+    constexpr auto batch_size = cache_capacity / 2;
+    {
+      auto lock = std::unique_lock<std::mutex>{ m_mutex };
+      auto& reclaimed = Traits::needs_reset ? m_dirty : m_free;
+      if (m_free.size() < batch_size && !m_pending.empty())
+      {
+        const auto completed = m_parent->completed_timeline_value();
+        const auto itr = std::ranges::partition(m_pending, [&](const auto& p){ return p.first > completed; }).begin();
+        for (auto cur = itr; cur != m_pending.end(); ++cur)
+        {
+          reclaimed.emplace_back(cur->second);
+        }
+        m_pending.erase(itr, m_pending.end());
+      }
+      if constexpr (Traits::needs_reset)
+      {
+        if (m_free.size() < batch_size && !m_dirty.empty())
+        {
+          Traits::reset(*m_parent, m_dirty);
+          m_free.insert(m_free.end(), m_dirty.begin(), m_dirty.end());
+          m_dirty.clear();
+        }
+      }
+      const auto count = std::min(batch_size, m_free.size());
+      cache.ready.insert(cache.ready.end(), m_free.end() - count, m_free.end());
+      m_free.erase(m_free.end() - count, m_free.end());
+    }
+    if (cache.ready.empty())
+    {
+      cache.ready.emplace_back(Traits::create(*m_parent));
+      m_size.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  template <typename Traits>
+  void sync_object_pool<Traits>::spill(std::vector<handle_type>& list, std::vector<handle_type>& destination) {
+    const auto count = list.size() / 2;
+    {
+      auto lock = std::unique_lock<std::mutex>{ m_mutex };
+      destination.insert(destination.end(), list.end() - count, list.end());
+    }
+    list.erase(list.end() - count, list.end());
+  }
+
+  template <typename Traits>
+  typename sync_object_pool<Traits>::handle_type sync_object_pool<Traits>::acquire() {
+    MEGATECH_PRECONDITION(m_parent != nullptr);
+    auto& cache = local();
+    if (cache.ready.empty())
+    {
+      refill(cache);
+    }
+    const auto result = cache.ready.back();
+    cache.ready.pop_back();
+    MEGATECH_POSTCONDITION(result != VK_NULL_HANDLE);
+    return result;
+  }
+
+  template <typename Traits>
+  void sync_object_pool<Traits>::release(const handle_type handle, const std::uint64_t timeline_value) {
+    MEGATECH_PRECONDITION(m_parent != nullptr);
+    if (handle == VK_NULL_HANDLE)
+    {
+      return;
+    }
+    if (timeline_value)
+    {
+      auto lock = std::unique_lock<std::mutex>{ m_mutex };
+      m_pending.emplace_back(timeline_value, handle);
+      return;
+    }
+    auto& cache = local();
+    if constexpr (Traits::needs_reset)
+    {
+      if (cache.dirty.size() == cache_capacity)
+      {
+        spill(cache.dirty, m_dirty);
+      }
+      cache.dirty.emplace_back(handle);
+    }
+    else
+    {
+      if (cache.ready.size() == cache_capacity)
+      {
+        spill(cache.ready, m_free);
+      }
+      cache.ready.emplace_back(handle);
+    }
+  }
+
+  template <typename Traits>
+  std::size_t sync_object_pool<Traits>::size() const {
+    return m_size.load(std::memory_order_relaxed);
+  }
+
+  template class sync_object_pool<fence_traits>;
+  template class sync_object_pool<semaphore_traits>;
+  template class sync_object_pool<event_traits>;
+
+}
@@ -0,0 +1,137 @@
+/**
+ * @file transient_allocator_impl.cpp
+ * @brief Transient Allocator Implementation
+ * @author Alexander Rothman <[gnomesort@megate.ch](mailto:gnomesort@megate.ch)>
+ * @copyright AGPL-3.0-or-later
+ * @date 2025
+ */
+#include "megatech/vulkan/internal/base/transient_allocator_impl.hpp"
+
+#include <bit>
+
+#include <megatech/assertions.hpp>
+
+#include "megatech/vulkan/error.hpp"
+
+#include "megatech/vulkan/internal/base/deletion_queue.hpp"
+
+#define DECLARE_DEVICE_PFN(dt, cmd) MEGATECH_VULKAN_INTERNAL_BASE_DECLARE_DEVICE_PFN(dt, cmd)
+
+namespace megatech::vulkan::internal::base {
+
+  void transient_allocator_impl::destroy() noexcept {
+    for (auto& current : m_frames)
+    {
+      if (current.buffer.buffer != VK_NULL_HANDLE)
+      {
+        m_parent->deletions().destroy_buffer(current.buffer);
+      }
+    }
+  }
+
+  transient_allocator_impl::transient_allocator_impl(const std::shared_ptr<const parent_type>& parent,
+                                                     const VkDeviceSize capacity,
+                                                     const std::uint32_t frames_in_flight) :
+  m_parent{ parent },
+  m_capacity{ capacity } {
+    if (!m_parent)
+    {
+      throw error{ "The parent device cannot be null." };
+    }
+    if (!m_capacity || !frames_in_flight)
+    {
+      throw error{ "A transient allocator must have a capacity and at least 1 frame in flight." };
+    }
+    constexpr auto usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT |
+                           VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+    m_frames.resize(frames_in_flight);
+    try
+    {
+      DECLARE_DEVICE_PFN(m_parent->dispatch_table(), vkGetBufferDeviceAddress);
+      for (auto& current : m_frames)
+      {
+        // Host-visible device-local memory is preferred, but transient data is small enough that reading it from
+        // host memory is acceptable when the device can't expose its own.
+        current.buffer = m_parent->create_buffer(m_capacity, usage, memory_usage::dynamic);
+        auto address_info = VkBufferDeviceAddressInfo{ };
+        address_info.sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO;
+        address_info.buffer = current.buffer.buffer;
+        current.device_address = vkGetBufferDeviceAddress(m_parent->handle(), &address_info);
+        if (current.device_address % granularity)
+        {
+          throw error{ "The transient allocator's buffer isn't sufficiently aligned." };
+        }
+      }
+    }
+    catch (...)
+    {
+      destroy();
+      throw;
+    }
+    MEGATECH_POSTCONDITION(m_frames.size() == frames_in_flight);
+  }
+
+  transient_allocator_impl::~transient_allocator_impl() noexcept {
+    destroy();
+  }
+
+  const transient_allocator_impl::parent_type& transient_allocator_impl::parent() const {
+    MEGATECH_PRECONDITION(m_parent != nullptr);
+    return *m_parent;
+  }
+
+  VkDeviceSize transient_allocator_impl::capacity() const {
+    return m_capacity;
+  }
+
+  std::uint32_t transient_allocator_impl::frames_in_flight() const {
+    return m_frames.size();
+  }
+
+  VkDeviceSize transient_allocator_impl::used() const {
+    return m_offset.load(std::memory_order_relaxed);
+  }
+
+  transient_block transient_allocator_impl::allocate(const VkDeviceSize size, const VkDeviceSize alignment) {
+    if (!size || !std::has_single_bit(alignment))
+    {
+      throw error{ "Transient allocations must have a size and a power of 2 alignment." };
+    }
+    const auto rounded = (size + granularity - 1) & ~(granularity - 1);
+    if (rounded > m_capacity)
+    {
+      throw error{ "The transient allocation is larger than a frame's capacity." };
+    }
+    // The offset is only advanced if the allocation fits, so a failed allocation doesn't use up the frame for smaller
+    // ones. Uncontended allocations succeed on their first exchange.
+    const auto& current = m_frames[m_current];
+    auto reserved = m_offset.load(std::memory_order_relaxed);
+    auto offset = VkDeviceSize{ };
+    do
+    {
+      offset = ((current.device_address + reserved + alignment - 1) & ~(alignment - 1)) - current.device_address;
+      if (offset > m_capacity - rounded)
+      {
+        throw error{ "The transient allocator's frame is out of memory." };
+      }
+    }
+    while (!m_offset.compare_exchange_weak(reserved, offset + rounded, std::memory_order_relaxed));
+    const auto address = current.device_address + offset;
+    MEGATECH_POSTCONDITION(offset + size <= m_capacity);
+    return { static_cast<std::byte*>(current.buffer.allocation.mapped) + offset, address, current.buffer.buffer,
+             offset };
+  }
+
+  void transient_allocator_impl::advance(const std::uint64_t timeline_value) {
+    MEGATECH_PRECONDITION(m_parent != nullptr);
+    m_frames[m_current].timeline_value = timeline_value;
+    const auto next = (m_current + 1) % m_frames.size();
+    if (m_frames[next].timeline_value > m_parent->completed_timeline_value())
+    {
+      m_parent->wait_for_timeline_value(m_frames[next].timeline_value);
+    }
+    m_current = next;
+    m_offset.store(0, std::memory_order_relaxed);
+  }
+
+}
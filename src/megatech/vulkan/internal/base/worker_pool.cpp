@@ -0,0 +1,83 @@
+/**
+ * @file worker_pool.cpp
+ * @brief Host Worker Threads
+ * @author Alexander Rothman <[gnomesort@megate.ch](mailto:gnomesort@megate.ch)>
+ * @copyright AGPL-3.0-or-later
+ * @date 2025
+ */
+#include "megatech/vulkan/internal/base/worker_pool.hpp"
+
+#include <algorithm>
+
+#include <megatech/assertions.hpp>
+
+namespace megatech::vulkan::internal::base {
+
+  void worker_pool::run() {
+    auto lock = std::unique_lock<std::mutex>{ m_mutex };
+    while (true)
+    {
+      m_condition.wait(lock, [&]() { return !m_jobs.empty() || m_is_stopping; });
+      if (m_jobs.empty())
+      {
+        return;
+      }
+      auto job = std::move(m_jobs.front());
+      m_jobs.pop_front();
+      lock.unlock();
+      job();
+      lock.lock();
+    }
+  }
+
+  void worker_pool::push(std::function<void()>&& job) {
+    {
+      auto lock = std::unique_lock<std::mutex>{ m_mutex };
+      m_jobs.emplace_back(std::move(job));
+    }
+    m_condition.notify_one();
+  }
+
+  worker_pool::worker_pool(const std::uint32_t size) {
+    const auto count = size ? size : std::max(std::thread::hardware_concurrency(), 1U);
+    m_workers.reserve(count);
+    try
+    {
+      for (auto i = std::uint32_t{ 0 }; i < count; ++i)
+      {
+        m_workers.emplace_back(&worker_pool::run, this);
+      }
+    }
+    catch (...)
+    {
+      {
+        auto lock = std::unique_lock<std::mutex>{ m_mutex };
+        m_is_stopping = true;
+      }
+      m_condition.notify_all();
+      for (auto& worker : m_workers)
+      {
+        worker.join();
+      }
+      throw;
+    }
+    MEGATECH_POSTCONDITION(m_workers.size() == count);
+  }
+
+  worker_pool::~worker_pool() noexcept {
+    {
+      auto lock = std::unique_lock<std::mutex>{ m_mutex };
+      m_is_stopping = true;
+    }
+    m_condition.notify_all();
+    for (auto& worker : m_workers)
+    {
+      worker.join();
+    }
+  }
+
+  std::uint32_t worker_pool::size() const {
+    return m_workers.size();
+  }
+
+}
@@ -0,0 +1,67 @@
+/**
+ * @file memory.cpp
+ * @brief Vulkan Device Memory Descriptions
+ * @author Alexander Rothman <[gnomesort@megate.ch](mailto:gnomesort@megate.ch)>
+ * @copyright AGPL-3.0-or-later
+ * @date 2025
+ */
+#include "megatech/vulkan/memory.hpp"
+
+#include <megatech/assertions.hpp>
+
+#include "megatech/vulkan/error.hpp"
+
+namespace megatech::vulkan {
+
+  memory_heap_description::memory_heap_description(const std::uint64_t size, const bitmask flags) :
+  m_size{ size },
+  m_flags{ flags } {
+    if ((m_flags & ~(memory_heap_flags::device_local_bit | memory_heap_flags::multi_instance_bit)) != bitmask{ 0 })
+    {
+      throw error{ "The heap flags bitmask contains invalid bits." };
+    }
+  }
+
+  std::uint64_t memory_heap_description::size() const {
+    return m_size;
+  }
+
+  bitmask memory_heap_description::flags() const {
+    return m_flags;
+  }
+
+  bool memory_heap_description::is_device_local() const {
+    return (m_flags & memory_heap_flags::device_local_bit) != bitmask{ 0 };
+  }
+
+  memory_heap_budget::memory_heap_budget(const std::uint64_t size, const std::uint64_t budget,
+                                         const std::uint64_t usage) :
+  m_size{ size },
+  m_budget{ budget },
+  m_usage{ usage } { }
+
+  std::uint64_t memory_heap_budget::size() const {
+    return m_size;
+  }
+
+  std::uint64_t memory_heap_budget::budget() const {
+    return m_budget;
+  }
+
+  std::uint64_t memory_heap_budget::usage() const {
+    return m_usage;
+  }
+
+  std::uint64_t memory_heap_budget::available() const {
+    return (m_usage < m_budget) * (m_budget - m_usage);
+  }
+
+  double memory_heap_budget::pressure() const {
+    if (m_budget == 0)
+    {
+      return m_usage > 0 ? 1.0 : 0.0;
+    }
+    return static_cast<double>(m_usage) / static_cast<double>(m_budget);
+  }
+
+}
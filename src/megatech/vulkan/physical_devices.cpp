@@ -14,6 +14,7 @@
 
 #include <megatech/assertions.hpp>
 
+#include "megatech/vulkan/error.hpp"
 #include "megatech/vulkan/instance.hpp"
 #include "megatech/vulkan/version.hpp"
 
@@ -78,6 +79,78 @@ namespace megatech::vulkan {
     return async_transfer_support::none;
   }
 
+  bool physical_device_description::supports_memory_budget() const {
+    MEGATECH_PRECONDITION(m_impl != nullptr);
+    return m_impl->available_extensions().contains("VK_EXT_memory_budget");
+  }
+
+  std::vector<memory_heap_description> physical_device_description::memory_heaps() const {
+    MEGATECH_PRECONDITION(m_impl != nullptr);
+    const auto& memory_properties = m_impl->memory_properties();
+    auto result = std::vector<memory_heap_description>{ };
+    result.reserve(memory_properties.memoryHeapCount);
+    // Vendor extensions can define additional heap flags. Those are dropped since they have no public meaning.
+    constexpr auto known_flags = memory_heap_flags::device_local_bit | memory_heap_flags::multi_instance_bit;
+    for (auto i = std::uint32_t{ 0 }; i < memory_properties.memoryHeapCount; ++i)
+    {
+      const auto flags = bitmask{ memory_properties.memoryHeaps[i].flags } & known_flags;
+      result.emplace_back(memory_properties.memoryHeaps[i].size, flags);
+    }
+    MEGATECH_POSTCONDITION(result.size() == memory_properties.memoryHeapCount);
+    return result;
+  }
+
+  std::uint64_t physical_device_description::host_visible_device_local_memory() const {
+    MEGATECH_PRECONDITION(m_impl != nullptr);
+    const auto heap_index = m_impl->host_visible_device_local_heap_index();
+    if (heap_index == -1)
+    {
+      return 0;
+    }
+    return m_impl->memory_properties().memoryHeaps[heap_index].size;
+  }
+
+  physical_device_group::physical_device_group(std::vector<physical_device_description>&& physical_devices,
+                                               const bool subset_allocation) :
+  m_physical_devices{ std::move(physical_devices) },
+  m_subset_allocation{ subset_allocation } {
+    if (m_physical_devices.empty() || m_physical_devices.size() > 32)
+    {
+      throw error{ "A physical device group must contain between 1 and 32 physical devices." };
+    }
+  }
+
+  const physical_device_description& physical_device_group::operator[](const std::size_t index) const {
+    MEGATECH_PRECONDITION(index < m_physical_devices.size());
+    return m_physical_devices[index];
+  }
+
+  const physical_device_description& physical_device_group::front() const {
+    MEGATECH_PRECONDITION(!m_physical_devices.empty());
+    return m_physical_devices.front();
+  }
+
+  physical_device_group::const_iterator physical_device_group::begin() const {
+    return m_physical_devices.begin();
+  }
+
+  physical_device_group::const_iterator physical_device_group::end() const {
+    return m_physical_devices.end();
+  }
+
+  std::size_t physical_device_group::size() const {
+    return m_physical_devices.size();
+  }
+
+  std::uint32_t physical_device_group::device_mask() const {
+    MEGATECH_PRECONDITION(!m_physical_devices.empty() && m_physical_devices.size() <= 32);
+    return static_cast<std::uint32_t>((std::uint64_t{ 1 } << m_physical_devices.size()) - 1);
+  }
+
+  bool physical_device_group::supports_subset_allocation() const {
+    return m_subset_allocation;
+  }
+
   physical_device_list::physical_device_list(std::vector<physical_device_description>&& filtered_list) :
   m_physical_devices{ std::move(filtered_list) } {
     MEGATECH_POSTCONDITION(static_cast<std::size_t>(std::ranges::count_if(m_physical_devices,
@@ -102,6 +175,37 @@ namespace megatech::vulkan {
       }
     }
     m_physical_devices.shrink_to_fit();
+    DECLARE_INSTANCE_PFN(parent->dispatch_table(), vkEnumeratePhysicalDeviceGroups);
+    VK_CHECK(vkEnumeratePhysicalDeviceGroups(parent->handle(), &sz, nullptr));
+    auto group_properties = std::vector<VkPhysicalDeviceGroupProperties>(sz);
+    for (auto& properties : group_properties)
+    {
+      properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GROUP_PROPERTIES;
+    }
+    VK_CHECK(vkEnumeratePhysicalDeviceGroups(parent->handle(), &sz, group_properties.data()));
+    m_groups.reserve(sz);
+    for (auto i = std::uint32_t{ 0 }; i < sz; ++i)
+    {
+      // Groups are only useful if every member is usable, so they have to be built from the filtered descriptions.
+      auto members = std::vector<physical_device_description>{ };
+      for (auto j = std::uint32_t{ 0 }; j < group_properties[i].physicalDeviceCount; ++j)
+      {
+        const auto handle = group_properties[i].physicalDevices[j];
+        const auto found = std::ranges::find_if(m_physical_devices, [&](const auto& p){
+          return p.implementation().handle() == handle;
+        });
+        if (found == m_physical_devices.end())
+        {
+          members.clear();
+          break;
+        }
+        members.emplace_back(*found);
+      }
+      if (!members.empty())
+      {
+        m_groups.emplace_back(std::move(members), group_properties[i].subsetAllocation);
+      }
+    }
     MEGATECH_POSTCONDITION(static_cast<std::size_t>(std::ranges::count_if(m_physical_devices,
                           [](const auto& p){ return p.implementation().is_valid(); })) == m_physical_devices.size());
   }
@@ -185,4 +289,8 @@ namespace megatech::vulkan {
     return m_physical_devices.size();
   }
 
+  const std::vector<physical_device_group>& physical_device_list::groups() const {
+    return m_groups;
+  }
+
 }
@@ -0,0 +1,83 @@
+/**
+ * @file transient_allocator.cpp
+ * @brief Per-Frame Transient Allocation
+ * @author Alexander Rothman <[gnomesort@megate.ch](mailto:gnomesort@megate.ch)>
+ * @copyright AGPL-3.0-or-later
+ * @date 2025
+ */
+#include "megatech/vulkan/transient_allocator.hpp"
+
+#include <megatech/assertions.hpp>
+
+#include "megatech/vulkan/device.hpp"
+
+#include "megatech/vulkan/internal/base/device_impl.hpp"
+#include "megatech/vulkan/internal/base/transient_allocator_impl.hpp"
+
+namespace megatech::vulkan {
+
+  transient_allocation::transient_allocation(const std::span<std::byte> data, const std::uint64_t device_address) :
+  m_data{ data },
+  m_device_address{ device_address } { }
+
+  std::span<std::byte> transient_allocation::data() const {
+    return m_data;
+  }
+
+  std::uint64_t transient_allocation::device_address() const {
+    return m_device_address;
+  }
+
+  transient_allocator::transient_allocator(const device& parent, const std::uint64_t frame_capacity,
+                                           const std::uint32_t frames_in_flight) :
+  m_impl{ new implementation_type{ parent.share_implementation(), frame_capacity, frames_in_flight } } {
+    MEGATECH_POSTCONDITION(m_impl != nullptr);
+  }
+
+  const transient_allocator::implementation_type& transient_allocator::implementation() const {
+    MEGATECH_PRECONDITION(m_impl != nullptr);
+    return *m_impl;
+  }
+
+  transient_allocator::implementation_type& transient_allocator::implementation() {
+    MEGATECH_PRECONDITION(m_impl != nullptr);
+    return *m_impl;
+  }
+
+  std::shared_ptr<const transient_allocator::implementation_type> transient_allocator::share_implementation() const {
+    MEGATECH_PRECONDITION(m_impl != nullptr);
+    return m_impl;
+  }
+
+  std::uint64_t transient_allocator::frame_capacity() const {
+    MEGATECH_PRECONDITION(m_impl != nullptr);
+    return m_impl->capacity();
+  }
+
+  std::uint32_t transient_allocator::frames_in_flight() const {
+    MEGATECH_PRECONDITION(m_impl != nullptr);
+    return m_impl->frames_in_flight();
+  }
+
+  std::uint64_t transient_allocator::used() const {
+    MEGATECH_PRECONDITION(m_impl != nullptr);
+    return m_impl->used();
+  }
+
+  transient_allocation transient_allocator::allocate(const std::uint64_t size, const std::uint64_t alignment) {
+    MEGATECH_PRECONDITION(m_impl != nullptr);
+    const auto block = m_impl->allocate(size, alignment);
+    return transient_allocation{ { block.data, size }, block.device_address };
+  }
+
+  void transient_allocator::next_frame() {
+    MEGATECH_PRECONDITION(m_impl != nullptr);
+    m_impl->advance(m_impl->parent().current_timeline_value());
+  }
+
+  void transient_allocator::next_frame(const compute_completion& last_use) {
+    MEGATECH_PRECONDITION(m_impl != nullptr);
+    m_impl->advance(last_use.timeline_value());
+  }
+
+}
@@ -0,0 +1,40 @@
+#ifndef MEGATECH_VULKAN_TESTS_LIBVULKAN_FIXTURES_HPP
+#define MEGATECH_VULKAN_TESTS_LIBVULKAN_FIXTURES_HPP
+
+#include <cinttypes>
+
+#include <array>
+
+#include <megatech/vulkan.hpp>
+#include <megatech/vulkan/adaptors/libvulkan.hpp>
+
+// Provides a loader, an instance, and the instance's physical devices to a test case.
+class instance_fixture {
+protected:
+  megatech::vulkan::adaptors::libvulkan::loader ldr{ };
+  megatech::vulkan::instance inst{ ldr, { "test_device", megatech::vulkan::version{ 0, 1, 0, 0 } } };
+  megatech::vulkan::physical_device_list physical_devices{ inst };
+};
+
+// Additionally provides a device created from the first physical device.
+class device_fixture : public instance_fixture {
+protected:
+  megatech::vulkan::device dev{ physical_devices.front() };
+};
+
+// An empty GLCompute entry point named "main" with a 1x1x1 workgroup.
+inline constexpr auto empty_kernel = std::array<std::uint32_t, 35>{
+  0x07230203, 0x00010000, 0x00000000, 0x00000005, 0x00000000,
+  0x00020011, 0x00000001,
+  0x0003000e, 0x00000000, 0x00000001,
+  0x0005000f, 0x00000005, 0x00000001, 0x6e69616d, 0x00000000,
+  0x00060010, 0x00000001, 0x00000011, 0x00000001, 0x00000001, 0x00000001,
+  0x00020013, 0x00000002,
+  0x00030021, 0x00000003, 0x00000002,
+  0x00050036, 0x00000002, 0x00000001, 0x00000000, 0x00000003,
+  0x000200f8, 0x00000004,
+  0x000100fd,
+  0x00010038
+};
+
+#endif
@@ -0,0 +1,102 @@
+#include <array>
+#include <chrono>
+#include <future>
+#include <span>
+#include <vector>
+
+#include <catch2/catch_all.hpp>
+
+#include <megatech/vulkan.hpp>
+#include <megatech/vulkan/internal/base/device_impl.hpp>
+#include <megatech/vulkan/internal/base/compute_pipeline_cache.hpp>
+#include <megatech/vulkan/internal/base/compute_batcher_impl.hpp>
+#include <megatech/vulkan/internal/base/physical_device_description_impl.hpp>
+
+#include "fixtures.hpp"
+
+using megatech::vulkan::device;
+using megatech::vulkan::device_buffer;
+using megatech::vulkan::compute_kernel;
+using megatech::vulkan::kernel_constants;
+using megatech::vulkan::compute_context;
+using megatech::vulkan::compute_batcher;
+
+TEST_CASE_METHOD(device_fixture, "Devices should dispatch compute kernels.", "[compute][adaptor-libvulkan]") {
+  REQUIRE_THROWS(compute_kernel{ dev, empty_kernel, 3 });
+  auto kernel = compute_kernel{ dev, empty_kernel, 0 };
+  auto buffer = device_buffer{ dev, 256, true };
+  REQUIRE(buffer.size() == 256);
+  REQUIRE(buffer.data().size() == 256);
+  REQUIRE(buffer.device_address() != 0);
+  auto context = compute_context{ dev };
+  const auto first = context.dispatch(kernel, std::span<const std::byte>{ }, 1);
+  const auto second = context.dispatch(kernel, std::span<const std::byte>{ }, 4, 4);
+  REQUIRE(second.timeline_value() > first.timeline_value());
+  REQUIRE(second.wait());
+  REQUIRE(first.is_ready());
+  REQUIRE_THROWS(context.dispatch(kernel, std::array<std::uint32_t, 1>{ }, 1));
+}
+
+TEST_CASE_METHOD(device_fixture, "Compute kernels should be specialized for and cached by their device.",
+                 "[compute][adaptor-libvulkan]") {
+  const auto& limits = dev.implementation().parent().properties_1_0().limits;
+  auto constants = kernel_constants{ };
+  constants.workgroup_size_id = 0;
+  constants.subgroup_size_id = 1;
+  constants.tile_size_id = 2;
+  REQUIRE(compute_kernel{ dev, empty_kernel, 0 }.workgroup_size() == 0);
+  auto invalid = constants;
+  invalid.tile_size_id = 0;
+  REQUIRE_THROWS(compute_kernel{ dev, empty_kernel, 0, invalid });
+  invalid = constants;
+  invalid.shared_bytes_per_element = 0;
+  REQUIRE_THROWS(compute_kernel{ dev, empty_kernel, 0, invalid });
+  auto kernel = compute_kernel{ dev, empty_kernel, 0, constants };
+  REQUIRE(kernel.subgroup_size() > 0);
+  REQUIRE(kernel.workgroup_size() > 0);
+  REQUIRE(kernel.workgroup_size() <= limits.maxComputeWorkGroupInvocations);
+  REQUIRE(kernel.workgroup_size() <= limits.maxComputeWorkGroupSize[0]);
+  if (kernel.subgroup_size() <= kernel.workgroup_size())
+  {
+    REQUIRE(kernel.workgroup_size() % kernel.subgroup_size() == 0);
+  }
+  REQUIRE(kernel.tile_size() * constants.shared_bytes_per_element <= limits.maxComputeSharedMemorySize);
+  {
+    const auto same = compute_kernel{ dev, empty_kernel, 0, constants };
+    REQUIRE(&same.implementation() == &kernel.implementation());
+    const auto other = compute_kernel{ dev, empty_kernel, 4, constants };
+    REQUIRE(&other.implementation() != &kernel.implementation());
+    REQUIRE(dev.implementation().pipelines().size() == 2);
+  }
+  REQUIRE(dev.implementation().pipelines().size() == 1);
+  auto context = compute_context{ dev };
+  REQUIRE(context.dispatch(kernel, std::span<const std::byte>{ }, 1).wait());
+}
+
+TEST_CASE_METHOD(device_fixture, "Compute batchers should coalesce small dispatches.", "[compute][adaptor-libvulkan]") {
+  auto kernel = compute_kernel{ dev, empty_kernel, 0 };
+  auto buffer = device_buffer{ dev, 256, true };
+  const auto address = std::array<std::uint64_t, 1>{ buffer.device_address() };
+  REQUIRE_THROWS(compute_batcher{ dev, std::chrono::milliseconds{ 1 }, 0 });
+  auto batcher = compute_batcher{ dev, std::chrono::seconds{ 10 }, 4 };
+  auto futures = std::vector<std::future<void>>{ };
+  futures.emplace_back(batcher.enqueue(kernel, std::span<const std::byte>{ }, { }, { }, 1));
+  futures.emplace_back(batcher.enqueue(kernel, std::span<const std::byte>{ }, { }, address, 1));
+  futures.emplace_back(batcher.enqueue(kernel, std::span<const std::byte>{ }, address, { }, 1));
+  futures.emplace_back(batcher.enqueue(kernel, std::span<const std::byte>{ }, address, { }, 1));
+  for (auto& future : futures)
+  {
+    REQUIRE_NOTHROW(future.get());
+  }
+  REQUIRE(batcher.implementation().batches_submitted() == 1);
+  REQUIRE(batcher.implementation().barriers_recorded() == 1);
+  auto flushed = batcher.enqueue(kernel, std::span<const std::byte>{ }, { }, { }, 2, 2);
+  batcher.flush();
+  REQUIRE_NOTHROW(flushed.get());
+  REQUIRE(batcher.implementation().batches_submitted() == 2);
+  REQUIRE_THROWS(batcher.enqueue(kernel, std::array<std::uint32_t, 1>{ }, { }, { }, 1));
+}
+
+int main(int argc, char** argv) {
+  return Catch::Session{ }.run(argc, argv);
+}
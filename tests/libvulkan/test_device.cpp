@@ -1,9 +1,16 @@
+#include <array>
+#include <chrono>
 #include <iostream>
+#include <string>
 
 #include <catch2/catch_all.hpp>
 
 #include <megatech/vulkan.hpp>
 #include <megatech/vulkan/adaptors/libvulkan.hpp>
+#include <megatech/vulkan/internal/base/device_impl.hpp>
+#include <megatech/vulkan/internal/base/physical_device_description_impl.hpp>
+
+#include "fixtures.hpp"
 
 using megatech::vulkan::bitmask;
 using megatech::vulkan::version;
@@ -40,6 +47,94 @@ TEST_CASE("Devices should be initializable.", "[device][adaptor-libvulkan]") {
   REQUIRE(validation_error_count == 0);
 }
 
+TEST_CASE_METHOD(instance_fixture, "Devices should report a memory budget for every memory heap.",
+                 "[device][adaptor-libvulkan]") {
+  const auto heaps = physical_devices.front().memory_heaps();
+  REQUIRE(!heaps.empty());
+  auto dev = device{ physical_devices.front() };
+  const auto budget = dev.memory_budget();
+  REQUIRE(budget.size() == heaps.size());
+  for (auto i = std::size_t{ 0 }; i < heaps.size(); ++i)
+  {
+    REQUIRE(budget[i].size() == heaps[i].size());
+    REQUIRE(budget[i].budget() > 0);
+  }
+  dev.set_memory_budget_refresh_interval(std::chrono::nanoseconds{ 0 });
+  REQUIRE(dev.refresh_memory_budget().size() == heaps.size());
+}
+
+TEST_CASE_METHOD(device_fixture, "Devices should only report format features for enabled extensions.",
+                 "[device][adaptor-libvulkan]") {
+  const auto& impl = dev.implementation();
+  const auto& physical_impl = physical_devices.front().implementation();
+  REQUIRE(impl.format_features(VK_FORMAT_R8G8B8A8_UNORM).optimal_tiling ==
+          physical_impl.format_features(VK_FORMAT_R8G8B8A8_UNORM).optimal_tiling);
+  REQUIRE(impl.has_buffer_format_features(VK_FORMAT_R32_SFLOAT, VK_FORMAT_FEATURE_2_VERTEX_BUFFER_BIT));
+  // VK_KHR_maintenance5 is only enabled when it's available, so its formats follow whichever way that went.
+  const auto& a8 = impl.format_features(VK_FORMAT_A8_UNORM_KHR);
+  if (impl.enabled_extensions().contains("VK_KHR_maintenance5"))
+  {
+    REQUIRE(a8.optimal_tiling == physical_impl.format_features(VK_FORMAT_A8_UNORM_KHR).optimal_tiling);
+  }
+  else
+  {
+    REQUIRE(a8.linear_tiling == 0);
+    REQUIRE(a8.optimal_tiling == 0);
+    REQUIRE(a8.buffer == 0);
+    REQUIRE(!impl.has_format_features(VK_FORMAT_A8_UNORM_KHR, VK_IMAGE_TILING_OPTIMAL,
+                                      VK_FORMAT_FEATURE_2_SAMPLED_IMAGE_BIT));
+  }
+}
+
+TEST_CASE_METHOD(device_fixture, "Devices should enable optional extensions wherever they're available.",
+                 "[device][adaptor-libvulkan]") {
+  using megatech::vulkan::internal::base::optional_extension;
+  const auto& impl = dev.implementation();
+  const auto& available = physical_devices.front().implementation().available_extensions();
+  const auto extensions = std::array<std::pair<optional_extension, std::string>, 6>{ {
+    { optional_extension::memory_priority, "VK_EXT_memory_priority" },
+    { optional_extension::pageable_device_local_memory, "VK_EXT_pageable_device_local_memory" },
+    { optional_extension::maintenance5, "VK_KHR_maintenance5" },
+    { optional_extension::maintenance6, "VK_KHR_maintenance6" },
+    { optional_extension::descriptor_buffer, "VK_EXT_descriptor_buffer" },
+    { optional_extension::pipeline_binary, "VK_KHR_pipeline_binary" }
+  } };
+  for (const auto& [extension, name] : extensions)
+  {
+    if (impl.has_optional_extension(extension))
+    {
+      REQUIRE(available.contains(name));
+      REQUIRE(impl.enabled_extensions().contains(name));
+    }
+  }
+  if (impl.has_optional_extension(optional_extension::pageable_device_local_memory))
+  {
+    REQUIRE(impl.has_optional_extension(optional_extension::memory_priority));
+  }
+  if (impl.has_optional_extension(optional_extension::pipeline_binary))
+  {
+    REQUIRE(impl.has_optional_extension(optional_extension::maintenance5));
+  }
+}
+
+TEST_CASE_METHOD(instance_fixture, "Devices should be constructible from physical device groups.",
+                 "[device][adaptor-libvulkan]") {
+  REQUIRE(!physical_devices.groups().empty());
+  auto grouped = std::size_t{ 0 };
+  for (const auto& group : physical_devices.groups())
+  {
+    REQUIRE(group.size() > 0);
+    REQUIRE(group.device_mask() == (std::uint32_t{ 1 } << group.size()) - 1);
+    grouped += group.size();
+  }
+  REQUIRE(grouped <= physical_devices.size());
+  const auto& group = physical_devices.groups().front();
+  auto dev = device{ group };
+  REQUIRE(dev.physical_device_count() == group.size());
+  REQUIRE(dev.device_mask() == group.device_mask());
+  REQUIRE(device{ physical_devices.front() }.device_mask() == 1);
+}
+
 int main(int argc, char** argv) {
   return Catch::Session{ }.run(argc, argv);
 }
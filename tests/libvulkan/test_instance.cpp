@@ -160,6 +160,119 @@ TEST_CASE("Physical Devices should never return a queue family index greater tha
   }
 }
 
+TEST_CASE("Physical devices should report format features without querying the driver.",
+          "[instance][adaptor-libvulkan]") {
+  auto ldr = loader{ };
+  auto inst = instance{ ldr, { "test_instance", version{ 0, 1, 0, 0 } } };
+  auto physical_devices = physical_device_list{ inst };
+  for (const auto& device : physical_devices)
+  {
+    const auto& impl = device.implementation();
+    // R8G8B8A8_UNORM is required to support sampling, blitting, and storage with optimal tiling.
+    const auto required = VK_FORMAT_FEATURE_2_SAMPLED_IMAGE_BIT | VK_FORMAT_FEATURE_2_BLIT_SRC_BIT |
+                          VK_FORMAT_FEATURE_2_BLIT_DST_BIT | VK_FORMAT_FEATURE_2_STORAGE_IMAGE_BIT;
+    REQUIRE((impl.format_features(VK_FORMAT_R8G8B8A8_UNORM).optimal_tiling & required) == required);
+    REQUIRE(impl.has_format_features(VK_FORMAT_R8G8B8A8_UNORM, VK_IMAGE_TILING_OPTIMAL, required));
+    REQUIRE(impl.has_buffer_format_features(VK_FORMAT_R32_SFLOAT, VK_FORMAT_FEATURE_2_VERTEX_BUFFER_BIT));
+    const auto& unknown = impl.format_features(static_cast<VkFormat>(0x7ffffffe));
+    REQUIRE(unknown.linear_tiling == 0);
+    REQUIRE(unknown.optimal_tiling == 0);
+    REQUIRE(unknown.buffer == 0);
+    // Extension formats are unsupported unless the extension is in the set that's passed in.
+    const auto& pvrtc = impl.format_features(VK_FORMAT_PVRTC1_4BPP_UNORM_BLOCK_IMG, { });
+    REQUIRE(pvrtc.linear_tiling == 0);
+    REQUIRE(pvrtc.optimal_tiling == 0);
+    REQUIRE(pvrtc.buffer == 0);
+    REQUIRE(impl.format_features(VK_FORMAT_R8G8B8A8_UNORM, { }).optimal_tiling ==
+            impl.format_features(VK_FORMAT_R8G8B8A8_UNORM).optimal_tiling);
+  }
+}
+
+TEST_CASE("Physical devices should resolve memory types by usage.", "[instance][adaptor-libvulkan]") {
+  using megatech::vulkan::internal::base::memory_usage;
+  auto ldr = loader{ };
+  auto inst = instance{ ldr, { "test_instance", version{ 0, 1, 0, 0 } } };
+  auto physical_devices = physical_device_list{ inst };
+  for (const auto& device : physical_devices)
+  {
+    const auto& impl = device.implementation();
+    const auto& memory_properties = impl.memory_properties();
+    constexpr auto host_flags = VkMemoryPropertyFlags{ VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                                                       VK_MEMORY_PROPERTY_HOST_COHERENT_BIT };
+    for (const auto usage : { memory_usage::gpu_only, memory_usage::upload, memory_usage::readback,
+                              memory_usage::dynamic })
+    {
+      const auto index = impl.memory_type_index(~std::uint32_t{ 0 }, usage);
+      REQUIRE(index != -1);
+      REQUIRE(index < static_cast<std::int64_t>(memory_properties.memoryTypeCount));
+      if (usage != memory_usage::gpu_only)
+      {
+        REQUIRE((memory_properties.memoryTypes[index].propertyFlags & host_flags) == host_flags);
+      }
+      // Restricting the acceptable types to a single type must select that type or nothing.
+      for (auto i = std::uint32_t{ 0 }; i < memory_properties.memoryTypeCount; ++i)
+      {
+        const auto single = impl.memory_type_index(1u << i, usage);
+        REQUIRE((single == -1 || single == i));
+      }
+      REQUIRE(impl.memory_type_index(0, usage) == -1);
+    }
+  }
+}
+
+TEST_CASE("Physical devices should query arbitrary feature and property chains.", "[instance][adaptor-libvulkan]") {
+  using megatech::vulkan::internal::base::structure_chain;
+  using megatech::vulkan::internal::base::make_structure;
+  auto ldr = loader{ };
+  auto inst = instance{ ldr, { "test_instance", version{ 0, 1, 0, 0 } } };
+  auto physical_devices = physical_device_list{ inst };
+  for (const auto& device : physical_devices)
+  {
+    const auto& impl = device.implementation();
+    auto features = structure_chain{
+      make_structure<VkPhysicalDeviceVulkan12Features>(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES),
+      make_structure<VkPhysicalDeviceVulkan13Features>(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES)
+    };
+    impl.query_features(features);
+    REQUIRE(features.get<VkPhysicalDeviceVulkan12Features>().pNext == nullptr);
+    REQUIRE(features.get<VkPhysicalDeviceVulkan12Features>().timelineSemaphore ==
+            impl.features_1_2().timelineSemaphore);
+    REQUIRE(features.get<VkPhysicalDeviceVulkan13Features>().synchronization2 == impl.features_1_3().synchronization2);
+    auto required = structure_chain{
+      make_structure<VkPhysicalDeviceVulkan12Features>(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES),
+      make_structure<VkPhysicalDeviceVulkan13Features>(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES)
+    };
+    REQUIRE(impl.has_features(required));
+    required.get<VkPhysicalDeviceVulkan12Features>().timelineSemaphore = VK_TRUE;
+    REQUIRE(impl.has_features(required) == static_cast<bool>(impl.features_1_2().timelineSemaphore));
+    auto properties = structure_chain{
+      make_structure<VkPhysicalDeviceVulkan11Properties>(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_1_PROPERTIES)
+    };
+    REQUIRE(impl.query_properties(properties).apiVersion == impl.properties_1_0().apiVersion);
+    REQUIRE(properties.get<VkPhysicalDeviceVulkan11Properties>().subgroupSize == impl.properties_1_1().subgroupSize);
+  }
+}
+
+TEST_CASE("Physical devices should cache extended properties on first use.", "[instance][adaptor-libvulkan]") {
+  auto ldr = loader{ };
+  auto inst = instance{ ldr, { "test_instance", version{ 0, 1, 0, 0 } } };
+  auto physical_devices = physical_device_list{ inst };
+  for (const auto& device : physical_devices)
+  {
+    const auto& impl = device.implementation();
+    const auto& driver = impl.properties<VkPhysicalDeviceDriverProperties>();
+    REQUIRE(driver.sType == VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DRIVER_PROPERTIES);
+    REQUIRE(driver.pNext == nullptr);
+    REQUIRE(driver.driverID == impl.properties_1_2().driverID);
+    REQUIRE(&impl.properties<VkPhysicalDeviceDriverProperties>() == &driver);
+    const auto& subgroups = impl.properties<VkPhysicalDeviceSubgroupSizeControlProperties>();
+    REQUIRE(subgroups.minSubgroupSize <= impl.properties_1_1().subgroupSize);
+    REQUIRE(subgroups.maxSubgroupSize >= impl.properties_1_1().subgroupSize);
+    // The public description forwards to the same cache.
+    REQUIRE(&device.properties<VkPhysicalDeviceDriverProperties>() == &driver);
+  }
+}
+
 int main(int argc, char** argv) {
   return Catch::Session{ }.run(argc, argv);
 }
@@ -0,0 +1,130 @@
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch_all.hpp>
+
+#include <megatech/vulkan.hpp>
+#include <megatech/vulkan/internal/base/device_impl.hpp>
+
+#include "fixtures.hpp"
+
+using megatech::vulkan::dynamic_buffer;
+using megatech::vulkan::transient_allocator;
+
+TEST_CASE_METHOD(device_fixture, "Devices should evict idle resources under memory pressure.",
+                 "[memory][adaptor-libvulkan]") {
+  using megatech::vulkan::internal::base::queue_type;
+  auto& impl = dev.implementation();
+  REQUIRE(impl.current_timeline_value() == 0);
+  const auto value = impl.submit(queue_type::primary, { });
+  REQUIRE(value == impl.current_timeline_value());
+  REQUIRE(impl.wait_for_timeline_value(value));
+  REQUIRE(impl.completed_timeline_value() == value);
+  auto evictions = std::size_t{ 0 };
+  auto& residency = impl.residency();
+  residency.track(0, 1024, value, [&]() {
+    ++evictions;
+    return VkDeviceSize{ 1024 };
+  });
+  // Resources that are still in use by the device must not be evicted.
+  const auto pending = residency.track(0, 1024, value + 1, [&]() {
+    ++evictions;
+    return VkDeviceSize{ 1024 };
+  });
+  REQUIRE(residency.tracked_bytes(0) == 2048);
+  REQUIRE(residency.make_room(0, 4096) == 1024);
+  REQUIRE(evictions == 1);
+  residency.untrack(pending);
+  REQUIRE(residency.tracked_bytes(0) == 0);
+  REQUIRE_THROWS(dev.set_residency_threshold(0.0));
+  dev.set_residency_threshold(0.5);
+  REQUIRE(dev.residency_threshold() == 0.5);
+}
+
+TEST_CASE_METHOD(device_fixture, "Deletion queues should defer destruction until the GPU is finished.",
+                 "[memory][adaptor-libvulkan]") {
+  auto& impl = dev.implementation();
+  auto& deletions = impl.deletions();
+  deletions.collect();
+  const auto initial = deletions.size();
+  auto buffer = impl.create_buffer(256, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, 0, 0);
+  auto ran = false;
+  deletions.enqueue([&ran]() { ran = true; }, impl.current_timeline_value() + 1);
+  deletions.destroy_buffer(buffer);
+  REQUIRE(buffer.buffer == VK_NULL_HANDLE);
+  REQUIRE(deletions.size() == initial + 2);
+  deletions.collect();
+  REQUIRE_FALSE(ran);
+  deletions.flush();
+  REQUIRE(ran);
+  REQUIRE(deletions.size() == 0);
+}
+
+TEST_CASE_METHOD(device_fixture, "Dynamic buffers should be writable by the host with or without staging.",
+                 "[memory][adaptor-libvulkan]") {
+  REQUIRE_THROWS(dynamic_buffer{ dev, 0 });
+  auto buffer = dynamic_buffer{ dev, 256 };
+  REQUIRE(buffer.size() == 256);
+  REQUIRE(buffer.data().size() == 256);
+  REQUIRE(buffer.device_address() != 0);
+  if (!physical_devices.front().host_visible_device_local_memory())
+  {
+    REQUIRE_FALSE(buffer.is_direct());
+  }
+  std::ranges::fill(buffer.data(), std::byte{ 0x2a });
+  const auto completion = buffer.flush();
+  REQUIRE(completion.wait(std::chrono::seconds{ 10 }));
+  REQUIRE(buffer.flush(128, 0).is_ready());
+  REQUIRE_THROWS(buffer.flush(128, 256));
+}
+
+TEST_CASE_METHOD(device_fixture, "Transient allocators should bump allocate and recycle frames.",
+                 "[memory][adaptor-libvulkan]") {
+  REQUIRE_THROWS(transient_allocator{ dev, 1024, 0 });
+  auto allocator = transient_allocator{ dev, 1024 };
+  REQUIRE(allocator.frames_in_flight() == 2);
+  const auto first = allocator.allocate(4);
+  const auto second = allocator.allocate(64, 256);
+  REQUIRE(first.data().size() == 4);
+  REQUIRE(second.device_address() % 256 == 0);
+  REQUIRE(second.device_address() > first.device_address());
+  REQUIRE(second.data().data() - first.data().data() ==
+          static_cast<std::ptrdiff_t>(second.device_address() - first.device_address()));
+  REQUIRE_THROWS(allocator.allocate(0));
+  REQUIRE_THROWS(allocator.allocate(16, 3));
+  const auto used = allocator.used();
+  auto workers = std::vector<std::thread>{ };
+  for (auto i = 0; i < 4; ++i)
+  {
+    workers.emplace_back([&allocator]() {
+      for (auto j = 0; j < 8; ++j)
+      {
+        allocator.allocate(1);
+      }
+    });
+  }
+  for (auto& worker : workers)
+  {
+    worker.join();
+  }
+  REQUIRE(allocator.used() == used + 32 * 16);
+  REQUIRE_THROWS(allocator.allocate(2048));
+  // Allocations that don't fit leave the frame's remaining space for smaller ones.
+  const auto full = allocator.used();
+  REQUIRE_THROWS(allocator.allocate(1024));
+  REQUIRE(allocator.used() == full);
+  REQUIRE_NOTHROW(allocator.allocate(16));
+  REQUIRE(allocator.used() == full + 16);
+  allocator.next_frame();
+  REQUIRE(allocator.used() == 0);
+  const auto third = allocator.allocate(4);
+  REQUIRE(third.device_address() != first.device_address());
+  allocator.next_frame();
+  REQUIRE(allocator.allocate(4).device_address() == first.device_address());
+}
+
+int main(int argc, char** argv) {
+  return Catch::Session{ }.run(argc, argv);
+}
@@ -0,0 +1,107 @@
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <catch2/catch_all.hpp>
+
+#include <megatech/vulkan.hpp>
+#include <megatech/vulkan/internal/base/device_impl.hpp>
+#include <megatech/vulkan/internal/base/offscreen_renderer.hpp>
+#include <megatech/vulkan/internal/base/render_graph.hpp>
+
+#include "fixtures.hpp"
+
+TEST_CASE_METHOD(device_fixture, "Devices should render offscreen and read the results back.",
+                 "[render][adaptor-libvulkan]") {
+  using megatech::vulkan::internal::base::offscreen_renderer;
+  auto renderer = offscreen_renderer{ dev.share_implementation(), { 16, 16 }, VK_FORMAT_R8G8B8A8_UNORM,
+                                      VK_FORMAT_D32_SFLOAT };
+  auto first = renderer.render({ .float32 = { 1.0f, 0.0f, 0.0f, 1.0f } }, { });
+  auto second = renderer.render({ .float32 = { 0.0f, 0.0f, 1.0f, 1.0f } }, [](VkCommandBuffer) { });
+  REQUIRE(second.timeline_value() > first.timeline_value());
+  const auto red = first.data();
+  REQUIRE(red.size() == 16 * 16 * 4);
+  REQUIRE(std::to_integer<int>(red[0]) == 255);
+  REQUIRE(std::to_integer<int>(red[2]) == 0);
+  REQUIRE(second.wait());
+  REQUIRE(second.is_ready());
+  const auto blue = second.data();
+  REQUIRE(std::to_integer<int>(blue[blue.size() - 4]) == 0);
+  REQUIRE(std::to_integer<int>(blue[blue.size() - 2]) == 255);
+}
+
+TEST_CASE_METHOD(device_fixture, "Render graphs should cull passes and alias transient resources.",
+                 "[render][adaptor-libvulkan]") {
+  using megatech::vulkan::internal::base::render_graph;
+  using megatech::vulkan::internal::base::render_pass_type;
+  auto& impl = dev.implementation();
+  constexpr auto usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+  auto output = impl.create_buffer(256, usage, 0, 0);
+  {
+    auto graph = render_graph{ dev.share_implementation() };
+    auto executed = std::vector<std::string>{ };
+    const auto record = [&](const std::string& name) {
+      return [&executed, name](const VkCommandBuffer, const render_graph&) { executed.emplace_back(name); };
+    };
+    const auto first = graph.create_buffer(1024, usage);
+    const auto second = graph.create_buffer(1024, usage);
+    const auto unused = graph.create_buffer(1024, usage);
+    const auto imported = graph.import_buffer(output.buffer);
+    constexpr auto stage = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+    constexpr auto read = VK_ACCESS_2_SHADER_STORAGE_READ_BIT;
+    constexpr auto write = VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT;
+    const auto produce_first = graph.add_pass("produce first", render_pass_type::graphics, record("produce first"));
+    graph.write(produce_first, first, stage, write);
+    const auto consume_first = graph.add_pass("consume first", render_pass_type::graphics, record("consume first"));
+    graph.read(consume_first, first, stage, read);
+    graph.write(consume_first, imported, stage, write);
+    const auto produce_second = graph.add_pass("produce second", render_pass_type::graphics,
+                                               record("produce second"));
+    graph.write(produce_second, second, stage, write);
+    const auto consume_second = graph.add_pass("consume second", render_pass_type::graphics,
+                                               record("consume second"));
+    graph.read(consume_second, second, stage, read);
+    graph.write(consume_second, imported, stage, write);
+    const auto dead = graph.add_pass("dead", render_pass_type::compute, record("dead"));
+    graph.write(dead, unused, stage, write);
+    graph.compile();
+    REQUIRE_THROWS(graph.add_pass("late", render_pass_type::graphics, record("late")));
+    REQUIRE(graph.is_culled(dead));
+    REQUIRE_FALSE(graph.is_culled(produce_first));
+    REQUIRE(graph.order().size() == 4);
+    REQUIRE(graph.buffer(unused) == VK_NULL_HANDLE);
+    REQUIRE(graph.buffer(first) != VK_NULL_HANDLE);
+    REQUIRE(graph.memory_block_count() == 1);
+    REQUIRE(graph.pass_queue(consume_first) == megatech::vulkan::internal::base::queue_type::primary);
+    for (auto i = 0; i < 2; ++i)
+    {
+      REQUIRE(impl.wait_for_timeline_value(graph.execute()));
+    }
+    REQUIRE(executed.size() == 8);
+    REQUIRE(std::ranges::find(executed, "dead") == executed.end());
+  }
+  {
+    // The graph doesn't transfer ownership, so exclusive imports can't be shared between queue families.
+    auto graph = render_graph{ dev.share_implementation() };
+    const auto imported = graph.import_buffer(output.buffer);
+    constexpr auto stage = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+    const auto producer = graph.add_pass("producer", render_pass_type::compute, [](const auto, const auto&) { });
+    graph.write(producer, imported, stage, VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT);
+    const auto consumer = graph.add_pass("consumer", render_pass_type::graphics, [](const auto, const auto&) { });
+    graph.write(consumer, imported, stage, VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT);
+    using megatech::vulkan::internal::base::queue_type;
+    if (impl.queue_family_index(queue_type::async_compute) != impl.queue_family_index(queue_type::primary))
+    {
+      REQUIRE_THROWS(graph.compile());
+    }
+    else
+    {
+      REQUIRE(impl.wait_for_timeline_value(graph.execute()));
+    }
+  }
+  impl.destroy_buffer(output);
+}
+
+int main(int argc, char** argv) {
+  return Catch::Session{ }.run(argc, argv);
+}
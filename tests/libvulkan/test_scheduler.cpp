@@ -0,0 +1,74 @@
+#include <chrono>
+#include <exception>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch_all.hpp>
+
+#include <megatech/vulkan.hpp>
+#include <megatech/vulkan/internal/base/device_impl.hpp>
+
+#include "fixtures.hpp"
+
+using megatech::vulkan::device;
+using megatech::vulkan::device_scheduler;
+
+TEST_CASE_METHOD(instance_fixture, "Device schedulers should distribute jobs across every listed device.",
+                 "[scheduler][adaptor-libvulkan]") {
+  using megatech::vulkan::internal::base::queue_type;
+  auto scheduler = device_scheduler{ physical_devices };
+  REQUIRE(scheduler.size() == physical_devices.size());
+  REQUIRE_THROWS(scheduler.set_smoothing_factor(0.0));
+  for (auto i = std::size_t{ 0 }; i < 4 * scheduler.size(); ++i)
+  {
+    const auto index = scheduler.schedule(0, [](device& dev) {
+      return dev.implementation().submit(queue_type::primary, { });
+    });
+    REQUIRE(index < scheduler.size());
+  }
+  // Jobs run without the scheduler locked, so they can inspect it.
+  auto depth = std::size_t{ 0 };
+  const auto index = scheduler.schedule(1, [&](device& dev) {
+    depth = scheduler.queue_depth(0);
+    return dev.implementation().submit(queue_type::primary, { });
+  });
+  REQUIRE(index < scheduler.size());
+  REQUIRE(depth <= 4 * scheduler.size() + 1);
+  REQUIRE_THROWS(scheduler.schedule(1, [](device&) -> std::uint64_t { throw std::exception{ }; }));
+  scheduler.wait_idle();
+  for (auto i = std::size_t{ 0 }; i < scheduler.size(); ++i)
+  {
+    REQUIRE(scheduler.queue_depth(i) == 0);
+  }
+}
+
+TEST_CASE_METHOD(instance_fixture, "Device schedulers should prefer less loaded devices.",
+                 "[scheduler][adaptor-libvulkan]") {
+  using megatech::vulkan::internal::base::queue_type;
+  // Opening the same physical device twice gives the scheduler two identical devices to choose between.
+  const auto twins = std::vector{ physical_devices.front(), physical_devices.front() };
+  auto scheduler = device_scheduler{ twins };
+  REQUIRE(scheduler.size() == 2);
+  // A job counts against its device while its callable runs, so a job scheduled from inside another job should be
+  // sent to the idle device.
+  auto inner = scheduler.size();
+  const auto outer = scheduler.schedule(0, [&](device& dev) {
+    inner = scheduler.schedule(0, [](device& dev) { return dev.implementation().submit(queue_type::primary, { }); });
+    return dev.implementation().submit(queue_type::primary, { });
+  });
+  REQUIRE(outer == 0);
+  REQUIRE(inner == 1);
+  scheduler.wait_idle();
+  // Durations are measured until the device signals completion, not until the scheduler is polled.
+  const auto delay = std::chrono::milliseconds{ 250 };
+  scheduler.schedule(1, [](device& dev) { return dev.implementation().submit(queue_type::primary, { }); });
+  std::this_thread::sleep_for(delay);
+  scheduler.poll();
+  REQUIRE(scheduler.queue_depth(0) == 0);
+  REQUIRE(scheduler.estimated_duration(0, 1) > std::chrono::nanoseconds{ 0 });
+  REQUIRE(scheduler.estimated_duration(0, 1) < delay);
+}
+
+int main(int argc, char** argv) {
+  return Catch::Session{ }.run(argc, argv);
+}
@@ -0,0 +1,139 @@
+#include <algorithm>
+#include <span>
+#include <vector>
+
+#include <catch2/catch_all.hpp>
+
+#include <megatech/vulkan.hpp>
+#include <megatech/vulkan/internal/base/device_impl.hpp>
+#include <megatech/vulkan/internal/base/sparse_buffer.hpp>
+#include <megatech/vulkan/internal/base/sparse_image.hpp>
+#include <megatech/vulkan/internal/base/physical_device_description_impl.hpp>
+
+#include "fixtures.hpp"
+
+TEST_CASE_METHOD(device_fixture, "Sparse resources should page tiles in on request.", "[sparse][adaptor-libvulkan]") {
+  using megatech::vulkan::internal::base::queue_type;
+  using megatech::vulkan::internal::base::sparse_buffer;
+  using megatech::vulkan::internal::base::sparse_image;
+  using megatech::vulkan::internal::base::sparse_tile;
+  auto& impl = dev.implementation();
+  if (!impl.has_sparse_binding())
+  {
+    REQUIRE(impl.parent().sparse_binding_queue_family_index() == -1);
+    REQUIRE_THROWS(impl.bind_sparse({ }, { }, { }));
+    return;
+  }
+  const auto family = impl.queue_family_index(queue_type::sparse_binding);
+  REQUIRE(impl.parent().queue_family_properties()[family].queueFlags & VK_QUEUE_SPARSE_BINDING_BIT);
+  const auto& features = impl.parent().required_features().features;
+  if (features.sparseResidencyBuffer)
+  {
+    auto buffer = sparse_buffer{ dev.share_implementation(), 1 << 20, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, 2 };
+    REQUIRE(buffer.flush() == 0);
+    buffer.commit(0, 1);
+    REQUIRE(buffer.is_resident(0));
+    REQUIRE(buffer.resident_pages() == 1);
+    REQUIRE_THROWS(buffer.commit(0, buffer.size()));
+    buffer.evict(0, 1);
+    buffer.commit(buffer.size() - 1, 1);
+    REQUIRE_FALSE(buffer.is_resident(0));
+    auto timeline_value = buffer.flush();
+    REQUIRE(timeline_value > 0);
+    REQUIRE(impl.wait_for_timeline_value(timeline_value));
+    // Page memory is evictable. Once every page of a block has been evicted and the device is finished with it, the
+    // block is freed under memory pressure, and committing allocates it again.
+    auto& residency = impl.residency();
+    const auto heap_count = impl.parent().memory_properties().memoryHeapCount;
+    const auto tracked_bytes = [&]() {
+      auto result = VkDeviceSize{ 0 };
+      for (auto i = std::uint32_t{ 0 }; i < heap_count; ++i)
+      {
+        result += residency.tracked_bytes(i);
+      }
+      return result;
+    };
+    const auto tracked = tracked_bytes();
+    REQUIRE(tracked >= 2 * buffer.page_size());
+    buffer.evict(buffer.size() - 1, 1);
+    REQUIRE(buffer.resident_pages() == 0);
+    timeline_value = buffer.flush();
+    REQUIRE(impl.wait_for_timeline_value(timeline_value));
+    auto released = VkDeviceSize{ 0 };
+    for (auto i = std::uint32_t{ 0 }; i < heap_count; ++i)
+    {
+      released += residency.make_room(i, 1);
+    }
+    REQUIRE(released == tracked);
+    REQUIRE(tracked_bytes() == 0);
+    buffer.commit(0, 1);
+    REQUIRE(buffer.is_resident(0));
+    REQUIRE(tracked_bytes() == tracked);
+    REQUIRE(impl.wait_for_timeline_value(buffer.flush()));
+  }
+  if (!features.sparseResidencyImage2D)
+  {
+    return;
+  }
+  auto image_info = VkImageCreateInfo{ };
+  image_info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+  image_info.imageType = VK_IMAGE_TYPE_2D;
+  image_info.format = VK_FORMAT_R8G8B8A8_UNORM;
+  image_info.extent = { 1024, 1024, 1 };
+  image_info.mipLevels = 11;
+  image_info.arrayLayers = 1;
+  image_info.samples = VK_SAMPLE_COUNT_1_BIT;
+  image_info.tiling = VK_IMAGE_TILING_OPTIMAL;
+  image_info.usage = VK_IMAGE_USAGE_SAMPLED_BIT;
+  auto loaded = std::vector<sparse_tile>{ };
+  auto tile_size = std::size_t{ 0 };
+  auto image = sparse_image{ dev.share_implementation(), image_info, 2,
+                             [&](const sparse_tile& tile, std::span<std::byte> data) {
+                               tile_size = data.size();
+                               loaded.emplace_back(tile);
+                             } };
+  REQUIRE(image.mip_tail_first_level() > 0);
+  REQUIRE_THROWS(image.request(sparse_tile{ 0, 1, 0, 0 }));
+  REQUIRE_THROWS(image.request(sparse_tile{ 0, 0, image.tile_count(0).width, 0 }));
+  if (image.mip_tail_first_level() < image_info.mipLevels)
+  {
+    REQUIRE(image.is_resident(sparse_tile{ image.mip_tail_first_level(), 0, 0, 0 }));
+  }
+  const auto first = sparse_tile{ 0, 0, 0, 0 };
+  const auto second = sparse_tile{ 0, 0, 1, 0 };
+  const auto third = sparse_tile{ 0, 0, 0, 1 };
+  image.request(first);
+  image.request(second);
+  REQUIRE_FALSE(image.is_resident(first));
+  auto timeline_value = image.commit(0);
+  REQUIRE(timeline_value > 0);
+  REQUIRE(tile_size == image.tile_size());
+  REQUIRE(std::ranges::find(loaded, first) != loaded.end());
+  REQUIRE(std::ranges::find(loaded, second) != loaded.end());
+  REQUIRE(image.resident_tiles() == 2);
+  REQUIRE(image.commit(timeline_value) == 0);
+  // The second tile is requested again, so the first tile is the least recently used. It isn't evicted while the
+  // device may still be using it.
+  REQUIRE(impl.wait_for_timeline_value(timeline_value));
+  const auto pending = impl.current_timeline_value() + 1;
+  image.touch(first, pending);
+  image.touch(second, pending);
+  image.request(second);
+  image.request(third);
+  loaded.clear();
+  REQUIRE(image.commit(0) == 0);
+  REQUIRE(loaded.empty());
+  REQUIRE(image.is_resident(first));
+  REQUIRE(impl.wait_for_timeline_value(impl.submit(queue_type::primary, { })));
+  timeline_value = image.commit(0);
+  REQUIRE(loaded == std::vector<sparse_tile>{ third });
+  REQUIRE_FALSE(image.is_resident(first));
+  REQUIRE(image.is_resident(second));
+  REQUIRE(image.is_resident(third));
+  REQUIRE(image.resident_tiles() == 2);
+  REQUIRE(impl.wait_for_timeline_value(timeline_value));
+}
+
+int main(int argc, char** argv) {
+  return Catch::Session{ }.run(argc, argv);
+}
@@ -0,0 +1,124 @@
+#include <algorithm>
+#include <array>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+#include <catch2/catch_all.hpp>
+
+#include <megatech/vulkan.hpp>
+#include <megatech/vulkan/internal/base/device_impl.hpp>
+#include <megatech/vulkan/internal/base/worker_pool.hpp>
+#include <megatech/vulkan/internal/base/ktx2_texture.hpp>
+
+#include "fixtures.hpp"
+
+using megatech::vulkan::device;
+using megatech::vulkan::device_buffer;
+using megatech::vulkan::file_streamer;
+
+TEST_CASE_METHOD(device_fixture, "KTX2 textures should stream from the smallest mip level up.",
+                 "[streaming][adaptor-libvulkan]") {
+  using megatech::vulkan::internal::base::ktx2_texture;
+  using megatech::vulkan::internal::base::worker_pool;
+  // An uncompressed 8x8 VK_FORMAT_R8G8B8A8_UNORM texture with 4 levels, stored smallest level first.
+  auto contents = std::vector<char>(560);
+  const auto put = [&](const std::size_t offset, const std::uint64_t value, const std::size_t size) {
+    for (auto i = std::size_t{ 0 }; i < size; ++i)
+    {
+      contents[offset + i] = static_cast<char>(value >> (8 * i));
+    }
+  };
+  constexpr auto identifier = std::array<unsigned char, 12>{ 0xab, 'K', 'T', 'X', ' ', '2', '0', 0xbb, '\r', '\n',
+                                                             0x1a, '\n' };
+  std::ranges::copy(identifier, contents.begin());
+  put(12, VK_FORMAT_R8G8B8A8_UNORM, 4);
+  put(16, 1, 4);
+  put(20, 8, 4);
+  put(24, 8, 4);
+  put(36, 1, 4);
+  put(40, 4, 4);
+  put(48, 176, 4);
+  put(52, 44, 4);
+  put(176, 44, 4);
+  auto offset = std::size_t{ 220 };
+  for (auto level = 4; level-- > 0;)
+  {
+    const auto size = std::size_t{ 256 } >> (2 * level);
+    put(80 + level * 24, offset, 8);
+    put(88 + level * 24, size, 8);
+    put(96 + level * 24, size, 8);
+    offset += size;
+  }
+  const auto path = std::filesystem::temp_directory_path() / "megatech_vulkan_test_ktx2_texture.ktx2";
+  {
+    auto file = std::ofstream{ path, std::ios::binary };
+    file.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+  }
+  auto workers = std::make_shared<worker_pool>(2);
+  REQUIRE(workers->size() == 2);
+  REQUIRE(workers->enqueue([]() { return 42; }).get() == 42);
+  REQUIRE_THROWS(ktx2_texture{ dev.share_implementation(), path.string() + ".missing", 64, workers });
+  REQUIRE_THROWS(ktx2_texture{ dev.share_implementation(), path, 0, workers });
+  {
+    // The first 2 levels fit in the initial upload. Level 1 takes a whole frame, and level 0 takes 4 frames.
+    auto texture = ktx2_texture{ dev.share_implementation(), path, 64, workers };
+    REQUIRE(texture.image_info().mipLevels == 4);
+    REQUIRE(texture.image_info().extent.width == 8);
+    REQUIRE_FALSE(texture.is_complete());
+    auto timeline_value = std::uint64_t{ 0 };
+    auto frames = 0;
+    while (!texture.is_complete())
+    {
+      timeline_value = texture.stream();
+      REQUIRE(timeline_value > 0);
+      ++frames;
+    }
+    REQUIRE(frames == 5);
+    REQUIRE(texture.stream() == 0);
+    REQUIRE(dev.implementation().wait_for_timeline_value(timeline_value));
+    REQUIRE(texture.resident_level() == 0);
+  }
+  std::filesystem::remove(path);
+}
+
+TEST_CASE_METHOD(device_fixture, "File streamers should read files into device buffers.",
+                 "[streaming][adaptor-libvulkan]") {
+#ifdef __linux__
+  const auto path = std::filesystem::temp_directory_path() / "megatech_vulkan_test_file_streamer.bin";
+  auto contents = std::vector<char>(1000);
+  for (auto i = std::size_t{ 0 }; i < contents.size(); ++i)
+  {
+    contents[i] = static_cast<char>(i * 7);
+  }
+  {
+    auto file = std::ofstream{ path, std::ios::binary };
+    file.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+  }
+  auto buffer = device_buffer{ dev, 1024, true };
+  {
+    // A small ring forces reads to be split into chunks and the ring to wrap.
+    auto streamer = file_streamer{ dev, 64, 4 };
+    REQUIRE(streamer.staging_capacity() == 64);
+    REQUIRE_THROWS(streamer.read(path, 0, 1000, buffer, 512));
+    REQUIRE_THROWS(streamer.read(path.string() + ".missing", 0, 4, buffer));
+    streamer.read(path, 0, 1000, buffer, 24);
+    REQUIRE(streamer.flush().wait());
+    REQUIRE(streamer.pending() == 0);
+    streamer.read(path, 996, 8, buffer);
+    REQUIRE_THROWS(streamer.flush());
+  }
+  const auto data = buffer.data();
+  for (auto i = std::size_t{ 0 }; i < contents.size(); ++i)
+  {
+    REQUIRE(data[i + 24] == static_cast<std::byte>(contents[i]));
+  }
+  std::filesystem::remove(path);
+#else
+  REQUIRE_THROWS(file_streamer{ dev });
+#endif
+}
+
+int main(int argc, char** argv) {
+  return Catch::Session{ }.run(argc, argv);
+}
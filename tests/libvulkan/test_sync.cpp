@@ -0,0 +1,264 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <exception>
+#include <future>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch_all.hpp>
+
+#include <megatech/vulkan.hpp>
+#include <megatech/vulkan/internal/base/device_impl.hpp>
+#include <megatech/vulkan/internal/base/resource_state_tracker.hpp>
+#include <megatech/vulkan/internal/base/split_barrier.hpp>
+#include <megatech/vulkan/internal/base/command_buffer_pool.hpp>
+
+#include "fixtures.hpp"
+
+using megatech::vulkan::device;
+using megatech::vulkan::compute_kernel;
+using megatech::vulkan::compute_context;
+using megatech::vulkan::compute_completion;
+using megatech::vulkan::completion_reactor;
+using megatech::vulkan::completion_source;
+
+TEST_CASE_METHOD(device_fixture, "Resource state trackers should compute minimal barriers.",
+                 "[sync][adaptor-libvulkan]") {
+  using megatech::vulkan::internal::base::resource_state_tracker;
+  auto& impl = dev.implementation();
+  auto first = impl.create_buffer(256, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, 0, 0);
+  auto second = impl.create_buffer(256, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, 0, 0);
+  {
+    auto tracker = resource_state_tracker{ impl };
+    tracker.track_buffer(first.buffer);
+    tracker.track_buffer(second.buffer);
+    REQUIRE_THROWS(tracker.track_buffer(first.buffer));
+    tracker.use_buffer(first.buffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT);
+    tracker.use_buffer(second.buffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_READ_BIT);
+    REQUIRE(tracker.has_pending_uses());
+    auto dependency_info = tracker.resolve();
+    REQUIRE_FALSE(tracker.has_pending_uses());
+    REQUIRE(dependency_info.memoryBarrierCount == 0);
+    tracker.use_buffer(first.buffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_READ_BIT);
+    tracker.use_buffer(second.buffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_READ_BIT);
+    dependency_info = tracker.resolve();
+    REQUIRE(dependency_info.memoryBarrierCount == 1);
+    REQUIRE(dependency_info.bufferMemoryBarrierCount == 0);
+    REQUIRE(dependency_info.pMemoryBarriers->srcAccessMask == VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT);
+    tracker.use_buffer(first.buffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_READ_BIT);
+    REQUIRE(tracker.resolve().memoryBarrierCount == 0);
+    tracker.use_buffer(first.buffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT);
+    dependency_info = tracker.resolve();
+    REQUIRE(dependency_info.memoryBarrierCount == 1);
+    REQUIRE(dependency_info.pMemoryBarriers->srcAccessMask == VK_ACCESS_2_NONE);
+    // Externally synchronized work must be waited for by the first barrier so that the barrier chains with it.
+    tracker.untrack_buffer(second.buffer);
+    tracker.track_buffer(second.buffer, VK_QUEUE_FAMILY_IGNORED, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT);
+    tracker.use_buffer(second.buffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT);
+    dependency_info = tracker.resolve();
+    REQUIRE(dependency_info.memoryBarrierCount == 1);
+    REQUIRE(dependency_info.pMemoryBarriers->srcStageMask == VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT);
+  }
+  impl.destroy_buffer(second);
+  impl.destroy_buffer(first);
+}
+
+TEST_CASE_METHOD(device_fixture, "Split barriers should signal after producers and wait before consumers.",
+                 "[sync][adaptor-libvulkan]") {
+  using megatech::vulkan::internal::base::command_buffer_pool;
+  using megatech::vulkan::internal::base::queue_type;
+  using megatech::vulkan::internal::base::split_barrier;
+  auto& impl = dev.implementation();
+  auto commands = command_buffer_pool{ dev.share_implementation(), queue_type::primary };
+  auto barrier = split_barrier{ impl };
+  REQUIRE(barrier.event() != VK_NULL_HANDLE);
+  REQUIRE(barrier.empty());
+  auto memory_barrier = VkMemoryBarrier2{ };
+  memory_barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2;
+  memory_barrier.srcStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+  memory_barrier.srcAccessMask = VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT;
+  memory_barrier.dstStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+  memory_barrier.dstAccessMask = VK_ACCESS_2_SHADER_STORAGE_READ_BIT;
+  barrier.add(memory_barrier);
+  REQUIRE_FALSE(barrier.empty());
+  const auto command_buffer = commands.acquire();
+  REQUIRE_THROWS(barrier.wait(command_buffer));
+  barrier.signal(command_buffer);
+  REQUIRE_THROWS(barrier.add(memory_barrier));
+  REQUIRE_THROWS(barrier.signal(command_buffer));
+  barrier.wait(command_buffer);
+  const auto timeline_value = commands.submit(command_buffer);
+  const auto event = barrier.event();
+  barrier.retire(timeline_value);
+  REQUIRE(barrier.event() == VK_NULL_HANDLE);
+  REQUIRE(impl.wait_for_timeline_value(timeline_value));
+  auto& events = impl.events();
+  auto acquired = std::vector<VkEvent>{ };
+  for (auto i = std::size_t{ 0 }; i < events.size(); ++i)
+  {
+    acquired.emplace_back(events.acquire());
+  }
+  REQUIRE(std::ranges::find(acquired, event) != acquired.end());
+  for (const auto current : acquired)
+  {
+    events.release(current);
+  }
+  // Barriers that were never signaled return their events without being retired.
+  auto unused_event = VkEvent{ VK_NULL_HANDLE };
+  {
+    auto unused = split_barrier{ impl };
+    unused.add(memory_barrier);
+    unused_event = unused.event();
+  }
+  acquired.clear();
+  for (auto i = std::size_t{ 0 }; i < events.size(); ++i)
+  {
+    acquired.emplace_back(events.acquire());
+  }
+  REQUIRE(std::ranges::find(acquired, unused_event) != acquired.end());
+  for (const auto current : acquired)
+  {
+    events.release(current);
+  }
+}
+
+TEST_CASE_METHOD(device_fixture, "Sync object pools should recycle fences, semaphores, and events.",
+                 "[sync][adaptor-libvulkan]") {
+  auto& impl = dev.implementation();
+  auto& fences = impl.fences();
+  auto fence = fences.acquire();
+  REQUIRE(fence != VK_NULL_HANDLE);
+  REQUIRE(fences.size() == 1);
+  fences.release(fence);
+  REQUIRE(fences.acquire() == fence);
+  REQUIRE(fences.size() == 1);
+  auto other = VkFence{ };
+  auto worker = std::thread{ [&]() { other = fences.acquire(); } };
+  worker.join();
+  REQUIRE(other != fence);
+  REQUIRE(fences.size() == 2);
+  fences.release(other);
+  fences.release(fence);
+  auto stranded = VkFence{ };
+  worker = std::thread{ [&]() { stranded = fences.acquire(); fences.release(stranded); } };
+  worker.join();
+  const auto size = fences.size();
+  auto reused = VkFence{ };
+  worker = std::thread{ [&]() { reused = fences.acquire(); fences.release(reused); } };
+  worker.join();
+  REQUIRE(reused == stranded);
+  REQUIRE(fences.size() == size);
+  auto& semaphores = impl.semaphores();
+  const auto semaphore = semaphores.acquire();
+  semaphores.release(semaphore, impl.current_timeline_value() + 1);
+  REQUIRE(semaphores.acquire() != semaphore);
+  REQUIRE(semaphores.size() == 2);
+  auto& events = impl.events();
+  auto acquired = std::vector<VkEvent>{ };
+  for (auto i = std::size_t{ 0 }; i < 2 * events.cache_capacity; ++i)
+  {
+    acquired.emplace_back(events.acquire());
+  }
+  for (const auto event : acquired)
+  {
+    events.release(event);
+  }
+  for (auto i = std::size_t{ 0 }; i < 2 * events.cache_capacity; ++i)
+  {
+    events.acquire();
+  }
+  REQUIRE(events.size() == 2 * events.cache_capacity);
+}
+
+namespace {
+
+  struct detached_task final {
+    struct promise_type final {
+      detached_task get_return_object() { return { }; }
+      std::suspend_never initial_suspend() noexcept { return { }; }
+      std::suspend_never final_suspend() noexcept { return { }; }
+      void return_void() { }
+      void unhandled_exception() { std::terminate(); }
+    };
+  };
+
+  detached_task chain_dispatches(const completion_reactor& reactor, compute_context& context,
+                                 const compute_kernel& kernel, std::promise<bool>& done) {
+    try
+    {
+      const auto first = context.dispatch(kernel, std::span<const std::byte>{ }, 1);
+      co_await reactor.wait(first);
+      const auto second = context.dispatch(kernel, std::span<const std::byte>{ }, 1);
+      co_await reactor.wait(second);
+      done.set_value(first.is_ready() && second.is_ready());
+    }
+    catch (...)
+    {
+      done.set_exception(std::current_exception());
+    }
+  }
+
+}
+
+TEST_CASE_METHOD(device_fixture, "Completion reactors should resume coroutines when work completes.",
+                 "[sync][adaptor-libvulkan]") {
+  auto kernel = compute_kernel{ dev, empty_kernel, 0 };
+  auto context = compute_context{ dev };
+  auto resumed = std::atomic<std::size_t>{ 0 };
+  auto reactor = completion_reactor{ dev, [&resumed](const std::coroutine_handle<> handle) {
+    ++resumed;
+    handle.resume();
+  } };
+  auto done = std::array<std::promise<bool>, 4>{ };
+  for (auto& promise : done)
+  {
+    chain_dispatches(reactor, context, kernel, promise);
+  }
+  for (auto& promise : done)
+  {
+    auto result = promise.get_future();
+    REQUIRE(result.wait_for(std::chrono::seconds{ 10 }) == std::future_status::ready);
+    REQUIRE(result.get());
+  }
+  REQUIRE(resumed <= 2 * done.size());
+}
+
+TEST_CASE_METHOD(device_fixture, "Completion sources should turn device completion into readable file descriptors.",
+                 "[sync][adaptor-libvulkan]") {
+  if (!dev.supports_sync_fd())
+  {
+    REQUIRE_THROWS(completion_source{ dev });
+    return;
+  }
+  auto kernel = compute_kernel{ dev, empty_kernel, 0 };
+  auto context = compute_context{ dev };
+  auto source = completion_source{ dev };
+  REQUIRE(source.file_descriptor() != -1);
+  REQUIRE_THROWS(source.watch(context.dispatch(kernel, std::span<const std::byte>{ }, 1), { }));
+  auto completed = std::atomic<std::size_t>{ 0 };
+  const auto first = context.dispatch(kernel, std::span<const std::byte>{ }, 1);
+  source.watch(first, [&]() { ++completed; });
+  auto other = device{ physical_devices.front() };
+  REQUIRE_THROWS(other.export_sync_fd(first));
+  REQUIRE_THROWS(source.watch(compute_completion{ other.share_implementation(), 0 }, [&]() { ++completed; }));
+  source.watch(context.dispatch(kernel, std::span<const std::byte>{ }, 1), [&]() { ++completed; });
+  first.wait();
+  source.watch(first, [&]() { ++completed; });
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{ 10 };
+  while (source.size() > 0 && std::chrono::steady_clock::now() < deadline)
+  {
+    source.dispatch();
+    std::this_thread::sleep_for(std::chrono::milliseconds{ 1 });
+  }
+  REQUIRE(source.size() == 0);
+  REQUIRE(completed == 3);
+  REQUIRE(source.dispatch() == 0);
+}
+
+int main(int argc, char** argv) {
+  return Catch::Session{ }.run(argc, argv);
+}